@@ -45,6 +45,12 @@ public class Logger : ModuleRules
 			);
 		
 		
+		// 自动化测试中的本机上传服务
+		if (Target.Configuration != UnrealTargetConfiguration.Shipping)
+		{
+			PrivateDependencyModuleNames.Add("HTTPServer");
+		}
+		
 		DynamicallyLoadedModuleNames.AddRange(
 			new string[]
 			{
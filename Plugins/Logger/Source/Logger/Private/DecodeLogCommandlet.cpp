@@ -0,0 +1,76 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "DecodeLogCommandlet.h"
+#include "StructuredLogFormat.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Compression.h"
+#include "Misc/Parse.h"
+
+// gzip 末尾 4 字节为未压缩长度（小端）
+static bool UncompressGzip(const TArray<uint8>& compressed, TArray<uint8>& outRaw)
+{
+    if (compressed.Num() < 4)
+        return false;
+
+    uint32 rawSize = 0;
+    FMemory::Memcpy(&rawSize, compressed.GetData() + compressed.Num() - 4, sizeof(rawSize));
+    outRaw.SetNumUninitialized(rawSize);
+    return FCompression::UncompressMemory(NAME_Gzip, outRaw.GetData(), rawSize, compressed.GetData(), compressed.Num());
+}
+
+UDecodeLogCommandlet::UDecodeLogCommandlet()
+{
+    IsClient = false;
+    IsServer = false;
+    IsEditor = false;
+    LogToConsole = true;
+}
+
+int32 UDecodeLogCommandlet::Main(const FString& params)
+{
+    FString inPath;
+    if (!FParse::Value(*params, TEXT("In="), inPath))
+    {
+        UE_LOG(LogTemp, Error, TEXT("用法：-run=DecodeLog -In=<日志文件> [-Out=<输出文件>]"));
+        return 1;
+    }
+
+    FString outPath;
+    if (!FParse::Value(*params, TEXT("Out="), outPath))
+        outPath = inPath + TEXT(".txt");
+
+    TArray<uint8> data;
+    if (!FFileHelper::LoadFileToArray(data, *inPath))
+    {
+        UE_LOG(LogTemp, Error, TEXT("读取日志文件失败: %s"), *inPath);
+        return 1;
+    }
+
+    if (inPath.EndsWith(TEXT(".gz")))
+    {
+        TArray<uint8> raw;
+        if (!UncompressGzip(data, raw))
+        {
+            UE_LOG(LogTemp, Error, TEXT("解压失败: %s"), *inPath);
+            return 1;
+        }
+        data = MoveTemp(raw);
+    }
+
+    FStructuredLogDecoder decoder;
+    FString text;
+    const bool complete = decoder.Decode(data, text);
+    if (!FFileHelper::SaveStringToFile(text, *outPath, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM))
+    {
+        UE_LOG(LogTemp, Error, TEXT("写入失败: %s"), *outPath);
+        return 1;
+    }
+
+    if (!complete)
+        UE_LOG(LogTemp, Warning, TEXT("日志末尾数据不完整（可能仍在写入），已输出可解码的部分"));
+    if (decoder.GetUnknownEvents() > 0)
+        UE_LOG(LogTemp, Warning, TEXT("%d 条记录缺少格式定义"), decoder.GetUnknownEvents());
+
+    UE_LOG(LogTemp, Display, TEXT("已解码到: %s"), *outPath);
+    return 0;
+}
@@ -0,0 +1,21 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "DecodeLogCommandlet.generated.h"
+
+/**
+ * 将结构化日志（.blog 或压缩后的 .blog.gz）解码为文本
+ * 用法：UnrealEditor-Cmd <项目> -run=DecodeLog -In=<日志文件> [-Out=<输出文件>]，不指定 Out 时输出到 <日志文件>.txt
+ */
+UCLASS()
+class UDecodeLogCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+public:
+    UDecodeLogCommandlet();
+
+    virtual int32 Main(const FString& params) override;
+};
@@ -0,0 +1,156 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "LogSegmentIndex.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+
+// 索引文件每行的字段数
+static const int32 INDEX_FIELD_COUNT = 9;
+
+static FString FormatSegment(const FLogSegmentInfo& s)
+{
+    return FString::Printf(TEXT("%s\t%lld\t%d\t%lld\t%lld\t%lld\t%lld\t%lld\t%d"),
+        *s.fileName, s.day.GetTicks(), s.sequence, s.firstTime.GetTicks(), s.lastTime.GetTicks(),
+        s.startOffset, s.rawBytes, s.storedBytes, s.compressed ? 1 : 0);
+}
+
+static bool ParseSegment(const FString& line, FLogSegmentInfo& out)
+{
+    TArray<FString> fields;
+    line.ParseIntoArray(fields, TEXT("\t"), false);
+    if (fields.Num() != INDEX_FIELD_COUNT || fields[0].IsEmpty())
+        return false;
+
+    out.fileName = fields[0];
+    out.day = FDateTime(FCString::Atoi64(*fields[1]));
+    out.sequence = FCString::Atoi(*fields[2]);
+    out.firstTime = FDateTime(FCString::Atoi64(*fields[3]));
+    out.lastTime = FDateTime(FCString::Atoi64(*fields[4]));
+    out.startOffset = FCString::Atoi64(*fields[5]);
+    out.rawBytes = FCString::Atoi64(*fields[6]);
+    out.storedBytes = FCString::Atoi64(*fields[7]);
+    out.compressed = FCString::Atoi(*fields[8]) != 0;
+    return true;
+}
+
+void FLogSegmentIndex::Load(const FString& inIndexPath, const FString& inDirectory)
+{
+    FScopeLock lock(&mutex);
+    indexPath = inIndexPath;
+    segments.Reset();
+
+    TArray<FString> lines;
+    if (!FFileHelper::LoadFileToStringArray(lines, *indexPath))
+        return;
+
+    for (const FString& line : lines)
+    {
+        FLogSegmentInfo segment;
+        if (ParseSegment(line, segment) && IFileManager::Get().FileExists(*FPaths::Combine(inDirectory, segment.fileName)))
+            segments.Add(MoveTemp(segment));
+    }
+}
+
+void FLogSegmentIndex::Add(const FLogSegmentInfo& segment)
+{
+    FScopeLock lock(&mutex);
+    segments.Add(segment);
+    SaveLocked();
+}
+
+void FLogSegmentIndex::FinishCompression(const FString& rawName, bool succeeded, const FString& compressedName, int64 storedBytes)
+{
+    FScopeLock lock(&mutex);
+    for (FLogSegmentInfo& segment : segments)
+    {
+        if (segment.fileName != rawName)
+            continue;
+
+        segment.compressing = false;
+        if (succeeded)
+        {
+            segment.fileName = compressedName;
+            segment.storedBytes = storedBytes;
+            segment.compressed = true;
+            SaveLocked();
+        }
+        return;
+    }
+}
+
+int32 FLogSegmentIndex::NextSequence(const FDateTime& day) const
+{
+    FScopeLock lock(&mutex);
+    int32 sequence = 0;
+    for (const FLogSegmentInfo& segment : segments)
+    {
+        if (segment.day == day)
+            sequence = FMath::Max(sequence, segment.sequence);
+    }
+    return sequence + 1;
+}
+
+int64 FLogSegmentIndex::GetDayBytes(const FDateTime& day) const
+{
+    FScopeLock lock(&mutex);
+    int64 bytes = 0;
+    for (const FLogSegmentInfo& segment : segments)
+    {
+        if (segment.day == day)
+            bytes += segment.rawBytes;
+    }
+    return bytes;
+}
+
+TArray<FLogSegmentInfo> FLogSegmentIndex::RemoveExpired(const FDateTime& now, int32 retentionDays, int32 maxSegments)
+{
+    FScopeLock lock(&mutex);
+    TArray<FLogSegmentInfo> expired;
+    const FDateTime oldestDay = now.GetDate() - FTimespan::FromDays(FMath::Max(retentionDays, 1) - 1);
+
+    // 分段按归档顺序排列，从最早的开始移出
+    int32 remaining = segments.Num();
+    for (int32 i = 0; i < segments.Num();)
+    {
+        const FLogSegmentInfo& segment = segments[i];
+        const bool tooMany = maxSegments > 0 && remaining > maxSegments;
+        if ((segment.day < oldestDay || tooMany) && !segment.compressing)
+        {
+            expired.Add(segment);
+            segments.RemoveAt(i);
+            remaining--;
+            continue;
+        }
+        i++;
+    }
+
+    if (expired.Num() > 0)
+        SaveLocked();
+    return expired;
+}
+
+TArray<FLogSegmentInfo> FLogSegmentIndex::GetSegments() const
+{
+    FScopeLock lock(&mutex);
+    return segments;
+}
+
+void FLogSegmentIndex::SaveLocked() const
+{
+    if (indexPath.IsEmpty())
+        return;
+
+    FString text;
+    for (const FLogSegmentInfo& segment : segments)
+    {
+        text += FormatSegment(segment);
+        text += TEXT("\n");
+    }
+
+    // 先写临时文件再替换，避免写到一半时进程退出导致索引损坏
+    const FString tempPath = indexPath + TEXT(".tmp");
+    if (FFileHelper::SaveStringToFile(text, *tempPath, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM))
+        IFileManager::Get().Move(*indexPath, *tempPath, true, true);
+}
@@ -0,0 +1,63 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+
+// 一个已归档的日志分段
+struct FLogSegmentInfo
+{
+    // 日志目录下的文件名；压缩完成后为 .gz 文件
+    FString fileName;
+    // 所属日期（当天 0 点）
+    FDateTime day;
+    // 当天的第几个分段，从 1 开始
+    int32 sequence = 0;
+    // 分段内第一行与最后一行的时间
+    FDateTime firstTime;
+    FDateTime lastTime;
+    // 在当天日志中的起始偏移与长度（未压缩字节），拼接当天全部分段即为完整日志
+    int64 startOffset = 0;
+    int64 rawBytes = 0;
+    // 磁盘上的实际大小
+    int64 storedBytes = 0;
+    bool compressed = false;
+    // 后台压缩尚未完成（不持久化）
+    bool compressing = false;
+};
+
+/*
+ * 分段索引：记录已归档分段的时间范围与偏移，上传与按时间读取时只需打开相关分段
+ * 持久化为日志目录下的文本文件，每行一个分段，字段以 \t 分隔；可被写线程与压缩任务并发访问
+ */
+class FLogSegmentIndex
+{
+public:
+    // 从索引文件加载，文件不存在时为空索引；索引中记录但已不存在的分段会被丢弃
+    void Load(const FString& inIndexPath, const FString& inDirectory);
+
+    void Add(const FLogSegmentInfo& segment);
+
+    // 压缩任务结束后调用：成功时更新分段的文件名与大小，失败时保留未压缩文件
+    void FinishCompression(const FString& rawName, bool succeeded, const FString& compressedName, int64 storedBytes);
+
+    // 某天下一个分段的序号
+    int32 NextSequence(const FDateTime& day) const;
+
+    // 某天已归档分段的未压缩总字节数，即当天活动文件的起始偏移
+    int64 GetDayBytes(const FDateTime& day) const;
+
+    // 按保留策略移出过期分段并返回，由调用方删除文件；压缩中的分段暂不移出
+    TArray<FLogSegmentInfo> RemoveExpired(const FDateTime& now, int32 retentionDays, int32 maxSegments);
+
+    TArray<FLogSegmentInfo> GetSegments() const;
+
+private:
+    // 需持有 mutex
+    void SaveLocked() const;
+
+    mutable FCriticalSection mutex;
+    FString indexPath;
+    TArray<FLogSegmentInfo> segments;
+};
@@ -0,0 +1,517 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "LogSink.h"
+#include "StructuredLog.h"
+#include "StructuredLogFormat.h"
+#include "HAL/RunnableThread.h"
+#include "HAL/PlatformFileManager.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/FileManager.h"
+#include "HAL/Event.h"
+#include "GenericPlatform/GenericPlatformFile.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Compression.h"
+#include "Misc/ScopeLock.h"
+#include "Misc/Paths.h"
+#include "Async/Async.h"
+
+// 定时写盘的间隔
+static constexpr double FLUSH_INTERVAL_SEC = 0.2;
+
+// 缓冲超过该大小立即写盘
+static constexpr int32 FLUSH_THRESHOLD_BYTES = 64 * 1024;
+
+// 积压超过该行数时提前唤醒写线程，避免突发日志在队列中堆积
+static constexpr int32 WAKE_PENDING_LINES = 4096;
+
+// 活动文件中相邻检查点的最小间隔
+static constexpr int64 CHECKPOINT_INTERVAL_BYTES = 64 * 1024;
+
+// 退出时等待压缩任务的最长时间
+static constexpr double COMPRESSION_WAIT_SEC = 5.0;
+
+static FString FormatDay(const FDateTime& day)
+{
+    return FString::Printf(TEXT("%04d%02d%02d"), day.GetYear(), day.GetMonth(), day.GetDay());
+}
+
+// 在后台将分段压缩为 gzip，成功后删除原文件
+static void CompressSegment(TSharedRef<FLogSegmentIndex, ESPMode::ThreadSafe> index, const FString& directory, const FString& rawName)
+{
+    const FString rawPath = FPaths::Combine(directory, rawName);
+    const FString compressedName = rawName + TEXT(".gz");
+    const FString compressedPath = FPaths::Combine(directory, compressedName);
+
+    TArray<uint8> raw;
+    bool succeeded = FFileHelper::LoadFileToArray(raw, *rawPath);
+    int32 compressedSize = 0;
+    if (succeeded)
+    {
+        TArray<uint8> compressed;
+        compressedSize = FCompression::CompressMemoryBound(NAME_Gzip, raw.Num());
+        compressed.SetNumUninitialized(compressedSize);
+        succeeded = FCompression::CompressMemory(NAME_Gzip, compressed.GetData(), compressedSize, raw.GetData(), raw.Num());
+        if (succeeded)
+        {
+            compressed.SetNum(compressedSize, EAllowShrinking::No);
+            succeeded = FFileHelper::SaveArrayToFile(compressed, *compressedPath);
+        }
+    }
+
+    if (succeeded)
+        IFileManager::Get().Delete(*rawPath, false, true, true);
+    else
+        IFileManager::Get().Delete(*compressedPath, false, true, true);
+
+    index->FinishCompression(rawName, succeeded, compressedName, compressedSize);
+}
+
+FLogSink& FLogSink::Get()
+{
+    static FLogSink instance;
+    return instance;
+}
+
+FLogSink::FLogSink()
+    : index(MakeShared<FLogSegmentIndex, ESPMode::ThreadSafe>())
+    , wakeEvent(FPlatformProcess::GetSynchEventFromPool(false))
+    , wakePending(false)
+    , flushRequested(false)
+    , stopping(false)
+    , thread(nullptr)
+    , pendingCompressions(MakeShared<FThreadSafeCounter, ESPMode::ThreadSafe>())
+    , activeStartOffset(0)
+    , fileHandle(nullptr)
+    , activeBytes(0)
+    , rotateAtBytes(0)
+    , bufferedLines(0)
+    , lastWriteTime(0.0)
+{
+    buffer.Reserve(FLUSH_THRESHOLD_BYTES * 2);
+}
+
+FLogSink::~FLogSink()
+{
+    Shutdown();
+    FPlatformProcess::ReturnSynchEventToPool(wakeEvent);
+    wakeEvent = nullptr;
+}
+
+void FLogSink::Start(const FLogSinkSettings& inSettings)
+{
+    if (thread)
+        return;
+
+    settings = inSettings;
+    settings.maxSegmentBytes = FMath::Clamp<int64>(settings.maxSegmentBytes, FLUSH_THRESHOLD_BYTES, MAX_int32);
+    stopping = false;
+    thread = FRunnableThread::Create(this, TEXT("LogSink"), 0, TPri_BelowNormal);
+}
+
+void FLogSink::Shutdown()
+{
+    if (thread)
+    {
+        // Stop 后写线程会在退出前写出队列中剩余的日志
+        thread->Kill(true);
+        delete thread;
+        thread = nullptr;
+    }
+
+    const double deadline = FPlatformTime::Seconds() + COMPRESSION_WAIT_SEC;
+    while (pendingCompressions->GetValue() > 0 && FPlatformTime::Seconds() < deadline)
+        FPlatformProcess::SleepNoStats(0.01f);
+}
+
+void FLogSink::Enqueue(ELogWriterLevel level, FString&& message)
+{
+    queue.Enqueue({ level, Now(), MoveTemp(message), TArray<uint8>() });
+    OnEnqueued(level);
+}
+
+void FLogSink::EnqueueRecord(ELogWriterLevel level, TArrayView<const uint8> record)
+{
+    queue.Enqueue({ level, Now(), FString(), TArray<uint8>(record) });
+    OnEnqueued(level);
+}
+
+void FLogSink::OnEnqueued(ELogWriterLevel level)
+{
+    enqueuedLines.Increment();
+
+    // Error 需尽快落盘；其余情况由写线程定时取走，不在调用线程触发系统调用
+    const int32 pending = pendingLines.Increment();
+    if ((level == ELogWriterLevel::Error || pending >= WAKE_PENDING_LINES) && !wakePending.AtomicSet(true))
+        wakeEvent->Trigger();
+}
+
+bool FLogSink::Flush(double timeoutSec)
+{
+    const int64 target = enqueuedLines.GetValue();
+    if (writtenLines.GetValue() >= target)
+        return true;
+
+    if (!thread)
+        return false;
+
+    flushRequested = true;
+    wakeEvent->Trigger();
+
+    const double deadline = FPlatformTime::Seconds() + timeoutSec;
+    while (writtenLines.GetValue() < target)
+    {
+        if (FPlatformTime::Seconds() > deadline)
+            return false;
+        FPlatformProcess::SleepNoStats(0.001f);
+    }
+    return true;
+}
+
+FString FLogSink::GetActiveFilePath() const
+{
+    FScopeLock lock(&activeMutex);
+    return activePath;
+}
+
+void FLogSink::GetActiveFile(FString& outPath, FDateTime& outDay, int64& outStartOffset) const
+{
+    FScopeLock lock(&activeMutex);
+    outPath = activePath;
+    outDay = activeDay;
+    outStartOffset = activeStartOffset;
+}
+
+TArray<FLogSegmentInfo> FLogSink::GetSegments() const
+{
+    return index->GetSegments();
+}
+
+int64 FLogSink::FindActiveOffset(const FDateTime& since) const
+{
+    FScopeLock lock(&activeMutex);
+    int64 offset = 0;
+    for (const FLogCheckpoint& checkpoint : checkpoints)
+    {
+        if (checkpoint.time > since)
+            break;
+        offset = checkpoint.offset;
+    }
+    return offset;
+}
+
+uint32 FLogSink::Run()
+{
+    OpenSession();
+
+    lastWriteTime = FPlatformTime::Seconds();
+    while (!stopping)
+    {
+        wakeEvent->Wait(FTimespan::FromSeconds(FLUSH_INTERVAL_SEC));
+        wakePending = false;
+        Drain();
+    }
+
+    // 退出前写出剩余日志并关闭文件
+    Drain();
+    WriteBuffer(true);
+    delete fileHandle;
+    fileHandle = nullptr;
+    return 0;
+}
+
+void FLogSink::Stop()
+{
+    stopping = true;
+    wakeEvent->Trigger();
+}
+
+FDateTime FLogSink::Now() const
+{
+    return settings.clock ? settings.clock() : FDateTime::Now();
+}
+
+FString FLogSink::MakeActivePath(const FDateTime& day) const
+{
+    return FPaths::Combine(settings.directory, FString::Printf(TEXT("%s-%s%s"), *settings.baseName, *FormatDay(day), *settings.extension));
+}
+
+void FLogSink::OpenSession()
+{
+    IFileManager& fileManager = IFileManager::Get();
+    fileManager.MakeDirectory(*settings.directory, true);
+    index->Load(FPaths::Combine(settings.directory, settings.baseName + TEXT(".index")), settings.directory);
+
+    const FDateTime today = Now().GetDate();
+
+    // 上次运行遗留的往日活动文件（进程未跨天运行到滚动）直接归档
+    TArray<FString> names;
+    fileManager.FindFiles(names, *FPaths::Combine(settings.directory, settings.baseName + TEXT("-*") + settings.extension), true, false);
+    names.Sort();
+    for (const FString& name : names)
+    {
+        const FString date = name.LeftChop(settings.extension.Len()).RightChop(settings.baseName.Len() + 1);
+        if (date.Len() != 8 || !date.IsNumeric())
+            continue;
+
+        // 文件名只校验了是 8 位数字，非法日期（如 20261340）直接交给 FDateTime 会触发断言
+        const int32 year = FCString::Atoi(*date.Left(4));
+        const int32 month = FCString::Atoi(*date.Mid(4, 2));
+        const int32 dayOfMonth = FCString::Atoi(*date.Right(2));
+        if (!FDateTime::Validate(year, month, dayOfMonth, 0, 0, 0, 0))
+            continue;
+
+        const FDateTime day(year, month, dayOfMonth);
+        const FString path = FPaths::Combine(settings.directory, name);
+        const int64 size = fileManager.FileSize(*path);
+        if (day == today || size < 0)
+            continue;
+
+        if (size == 0)
+            fileManager.Delete(*path, false, true, true);
+        else
+            ArchiveFile(path, day, day, day + FTimespan::FromDays(1) - FTimespan(1), index->GetDayBytes(day), size);
+    }
+
+    // 当天的活动文件继续追加
+    const FString path = MakeActivePath(today);
+    activeBytes = FMath::Max<int64>(fileManager.FileSize(*path), 0);
+    rotateAtBytes = settings.maxSegmentBytes;
+    activeFirstTime = today;
+    activeLastTime = today;
+    {
+        FScopeLock lock(&activeMutex);
+        activePath = path;
+        activeDay = today;
+        activeStartOffset = index->GetDayBytes(today);
+        checkpoints.Reset();
+        if (activeBytes > 0)
+            checkpoints.Add({ today, 0 });
+    }
+    definedFormats.Reset();
+
+    ApplyRetention();
+}
+
+void FLogSink::Drain()
+{
+    bool sawError = false;
+    FLogEntry entry;
+    while (queue.Dequeue(entry))
+    {
+        pendingLines.Decrement();
+
+        // 跨天：先写完前一天的缓冲，再切换到新的活动文件
+        const FDateTime day = entry.time.GetDate();
+        if (day > activeDay)
+        {
+            WriteBuffer(true);
+            RotateActive(day);
+        }
+
+        sawError |= entry.level == ELogWriterLevel::Error;
+        FormatEntry(entry);
+        bufferedLines++;
+
+        if (buffer.Num() >= FLUSH_THRESHOLD_BYTES)
+            WriteBuffer(false);
+    }
+
+    const bool flush = flushRequested.AtomicSet(false);
+    if (sawError || flush || FPlatformTime::Seconds() - lastWriteTime >= FLUSH_INTERVAL_SEC)
+        WriteBuffer(sawError || flush);
+}
+
+void FLogSink::FormatEntry(const FLogEntry& entry)
+{
+    if (buffer.Num() == 0)
+        bufferFirstTime = entry.time;
+    bufferLastTime = entry.time;
+
+    if (entry.record.Num() > 0)
+    {
+        FormatRecord(entry);
+        return;
+    }
+
+    ANSICHAR prefix[24];
+    const int32 length = FCStringAnsi::Snprintf(prefix, sizeof(prefix), "[%02d:%02d:%02d.%03d] ",
+        entry.time.GetHour(), entry.time.GetMinute(), entry.time.GetSecond(), entry.time.GetMillisecond());
+    buffer.Append((const uint8*)prefix, FMath::Clamp(length, 0, (int32)sizeof(prefix) - 1));
+
+    FTCHARToUTF8 utf8(*entry.message, entry.message.Len());
+    buffer.Append((const uint8*)utf8.Get(), utf8.Length());
+    buffer.Add('\n');
+}
+
+void FLogSink::FormatRecord(const FLogEntry& entry)
+{
+    uint32 formatId = 0;
+    if (entry.record.Num() < (int32)sizeof(formatId))
+        return;
+    FMemory::Memcpy(&formatId, entry.record.GetData(), sizeof(formatId));
+
+    // 每个文件中首次出现的格式先写出定义，使单个文件可以独立解码
+    FStructuredLogDefinition definition;
+    const bool known = FindStructuredLogDefinition(formatId, definition);
+    if (known && !definedFormats.Contains(formatId))
+    {
+        definedFormats.Add(formatId);
+        AppendDefinitionRecord(buffer, formatId, definition);
+    }
+
+    buffer.Add((uint8)EStructuredRecordType::Event);
+    const int64 ticks = entry.time.GetTicks();
+    buffer.Append((const uint8*)&ticks, sizeof(ticks));
+    buffer.Append(entry.record);
+
+    // 回显到 UE_LOG 时才格式化
+    if (!known || (uint8)entry.level < (uint8)UE::LogWriter::GetEchoLevel())
+        return;
+
+    FString text;
+    int32 consumed = 0;
+    RenderStructuredArgs(definition.format, TArrayView<const uint8>(entry.record).Mid(sizeof(formatId)), text, consumed);
+    switch (entry.level)
+    {
+    case ELogWriterLevel::Error:
+        UE_LOG(LogTemp, Error, TEXT("[%s] %s"), *definition.category, *text);
+        break;
+    case ELogWriterLevel::Warning:
+        UE_LOG(LogTemp, Warning, TEXT("[%s] %s"), *definition.category, *text);
+        break;
+    default:
+        UE_LOG(LogTemp, Log, TEXT("[%s] %s"), *definition.category, *text);
+        break;
+    }
+}
+
+void FLogSink::WriteBuffer(bool flushToDisk)
+{
+    lastWriteTime = FPlatformTime::Seconds();
+    if (buffer.Num() == 0)
+        return;
+
+    if (EnsureFileOpen())
+    {
+        {
+            FScopeLock lock(&activeMutex);
+            if (checkpoints.Num() == 0 || activeBytes - checkpoints.Last().offset >= CHECKPOINT_INTERVAL_BYTES)
+                checkpoints.Add({ bufferFirstTime, activeBytes });
+        }
+
+        if (!fileHandle->Write(buffer.GetData(), buffer.Num()))
+        {
+            // 写失败时关闭句柄，下次重新打开；本批日志丢弃，避免缓冲无限增长
+            // 丢弃的数据中可能有格式定义，之后重新写出
+            delete fileHandle;
+            fileHandle = nullptr;
+            definedFormats.Reset();
+        }
+        else
+        {
+            if (flushToDisk)
+                fileHandle->Flush();
+
+            if (activeBytes == 0)
+                activeFirstTime = bufferFirstTime;
+            activeLastTime = bufferLastTime;
+            activeBytes += buffer.Num();
+        }
+    }
+
+    buffer.Reset();
+    writtenLines.Add(bufferedLines);
+    bufferedLines = 0;
+
+    if (activeBytes >= rotateAtBytes)
+        RotateActive(activeDay);
+}
+
+bool FLogSink::EnsureFileOpen()
+{
+    if (fileHandle)
+        return true;
+
+    const FString path = GetActiveFilePath();
+    if (path.IsEmpty())
+        return false;
+
+    // 追加写入，并允许其它进程（或上传）同时读取
+    fileHandle = FPlatformFileManager::Get().GetPlatformFile().OpenWrite(*path, true, true);
+    return fileHandle != nullptr;
+}
+
+void FLogSink::RotateActive(const FDateTime& newDay)
+{
+    delete fileHandle;
+    fileHandle = nullptr;
+
+    const int64 archivedBytes = activeBytes;
+    if (archivedBytes > 0 && !ArchiveFile(GetActiveFilePath(), activeDay, activeFirstTime, activeLastTime, activeStartOffset, archivedBytes))
+    {
+        // 按大小滚动时归档失败：继续追加到当前文件，偏移与检查点都不变，到下一个阈值再重试
+        // 跨天时仍切换到新文件，旧文件留在原处，由下次启动的 OpenSession 归档
+        if (newDay == activeDay)
+        {
+            rotateAtBytes = activeBytes + settings.maxSegmentBytes;
+            return;
+        }
+    }
+
+    activeBytes = 0;
+    rotateAtBytes = settings.maxSegmentBytes;
+    activeFirstTime = newDay;
+    activeLastTime = newDay;
+    {
+        // 同一天内按大小滚动时，新活动文件接在刚归档的分段之后
+        FScopeLock lock(&activeMutex);
+        activeStartOffset = newDay == activeDay ? activeStartOffset + archivedBytes : index->GetDayBytes(newDay);
+        activeDay = newDay;
+        activePath = MakeActivePath(newDay);
+        checkpoints.Reset();
+    }
+    definedFormats.Reset();
+
+    ApplyRetention();
+}
+
+bool FLogSink::ArchiveFile(const FString& path, const FDateTime& day, const FDateTime& firstTime, const FDateTime& lastTime, int64 startOffset, int64 bytes)
+{
+    FLogSegmentInfo segment;
+    segment.day = day;
+    segment.sequence = index->NextSequence(day);
+    segment.fileName = FString::Printf(TEXT("%s-%s.%d%s"), *settings.baseName, *FormatDay(day), segment.sequence, *settings.extension);
+    segment.firstTime = firstTime;
+    segment.lastTime = lastTime;
+    segment.startOffset = startOffset;
+    segment.rawBytes = bytes;
+    segment.storedBytes = bytes;
+    segment.compressing = settings.compressArchives;
+
+    // 不在写线程上重试等待，失败后由调用方在下一个阈值重试
+    if (!IFileManager::Get().Move(*FPaths::Combine(settings.directory, segment.fileName), *path, true, true, false, true))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("日志分段归档失败: %s"), *path);
+        return false;
+    }
+
+    index->Add(segment);
+    if (!settings.compressArchives)
+        return true;
+
+    pendingCompressions->Increment();
+    AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask,
+        [segmentIndex = index, counter = pendingCompressions, directory = settings.directory, rawName = segment.fileName]()
+    {
+        CompressSegment(segmentIndex, directory, rawName);
+        counter->Decrement();
+    });
+    return true;
+}
+
+void FLogSink::ApplyRetention()
+{
+    const TArray<FLogSegmentInfo> expired = index->RemoveExpired(Now(), settings.retentionDays, settings.maxArchivedSegments);
+    for (const FLogSegmentInfo& segment : expired)
+        IFileManager::Get().Delete(*FPaths::Combine(settings.directory, segment.fileName), false, true, true);
+}
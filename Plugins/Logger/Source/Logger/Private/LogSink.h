@@ -0,0 +1,153 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/Runnable.h"
+#include "HAL/ThreadSafeBool.h"
+#include "HAL/ThreadSafeCounter.h"
+#include "HAL/ThreadSafeCounter64.h"
+#include "Containers/Queue.h"
+#include "LogWriter.h"
+#include "LogSegmentIndex.h"
+
+class FRunnableThread;
+class IFileHandle;
+class FEvent;
+
+// 日志文件与滚动设置
+struct FLogSinkSettings
+{
+    // 日志目录
+    FString directory;
+    // 文件名前缀与扩展名：活动文件为 <baseName>-YYYYMMDD<extension>，归档分段为 <baseName>-YYYYMMDD.<序号><extension>[.gz]
+    FString baseName = TEXT("Logs");
+    FString extension = TEXT(".log");
+    // 活动文件超过该大小时滚动
+    int64 maxSegmentBytes = 16 * 1024 * 1024;
+    // 滚动出的分段在后台压缩为 gzip
+    bool compressArchives = true;
+    // 归档分段最多保留的天数与个数（<= 0 表示不限个数）
+    int32 retentionDays = 14;
+    int32 maxArchivedSegments = 64;
+    // 时钟（为空时使用 FDateTime::Now），会在任意线程调用，必须线程安全
+    TFunction<FDateTime()> clock;
+};
+
+/*
+ * 日志后台写入：任意线程入队（无锁），写线程保持文件句柄常开，批量写入
+ * 满足以下任一条件时写盘：距上次写盘超过 FLUSH_INTERVAL_SEC、缓冲超过 FLUSH_THRESHOLD_BYTES、出现 Error、调用 Flush
+ * 跨天或活动文件超过 maxSegmentBytes 时滚动：活动文件改名为归档分段，记入分段索引，在后台压缩并按保留策略清理
+ */
+class FLogSink : public FRunnable
+{
+public:
+    // 项目日志使用的全局实例
+    static FLogSink& Get();
+
+    FLogSink();
+    virtual ~FLogSink() override;
+
+    // 应用设置并启动写线程；已启动时忽略
+    void Start(const FLogSinkSettings& inSettings);
+
+    // 写出全部日志、等待压缩任务完成并停止写线程（模块卸载时调用）
+    void Shutdown();
+
+    // 入队一行日志，时间戳在调用时记录，格式化与写盘在写线程完成
+    void Enqueue(ELogWriterLevel level, FString&& message);
+
+    // 入队一条结构化记录（见 StructuredLogFormat.h），写线程补上时间戳与格式定义后原样写出
+    void EnqueueRecord(ELogWriterLevel level, TArrayView<const uint8> record);
+
+    // 阻塞直到此前入队的日志全部写入磁盘（如上传日志文件前），最多等待 timeoutSec
+    bool Flush(double timeoutSec = 2.0);
+
+    // 当前活动文件的完整路径
+    FString GetActiveFilePath() const;
+
+    // 当前活动文件、所属日期及其在当天日志中的起始偏移（此前已归档分段的总字节数），三者一致
+    void GetActiveFile(FString& outPath, FDateTime& outDay, int64& outStartOffset) const;
+
+    // 已归档的分段（按时间顺序）
+    TArray<FLogSegmentInfo> GetSegments() const;
+
+    // 活动文件中不晚于 since 的最近一个检查点的偏移，按时间读取末尾时从这里开始即可
+    int64 FindActiveOffset(const FDateTime& since) const;
+
+    virtual uint32 Run() override;
+    virtual void Stop() override;
+
+private:
+    struct FLogEntry
+    {
+        ELogWriterLevel level;
+        FDateTime time;
+        FString message;
+        // 非空时为结构化记录，message 不使用
+        TArray<uint8> record;
+    };
+
+    // 活动文件中的检查点：该偏移处那一行的时间
+    struct FLogCheckpoint
+    {
+        FDateTime time;
+        int64 offset;
+    };
+
+    FDateTime Now() const;
+    void OnEnqueued(ELogWriterLevel level);
+    FString MakeActivePath(const FDateTime& day) const;
+
+    // 以下仅写线程访问
+    void OpenSession();
+    void Drain();
+    void FormatEntry(const FLogEntry& entry);
+    void FormatRecord(const FLogEntry& entry);
+    void WriteBuffer(bool flushToDisk);
+    bool EnsureFileOpen();
+    void RotateActive(const FDateTime& newDay);
+    // 改名为归档分段并记入索引，失败时文件保持原样并返回 false
+    bool ArchiveFile(const FString& path, const FDateTime& day, const FDateTime& firstTime, const FDateTime& lastTime, int64 startOffset, int64 bytes);
+    void ApplyRetention();
+
+    FLogSinkSettings settings;
+    TSharedRef<FLogSegmentIndex, ESPMode::ThreadSafe> index;
+
+    TQueue<FLogEntry, EQueueMode::Mpsc> queue;
+    FEvent* wakeEvent;
+    FThreadSafeBool wakePending;
+    FThreadSafeBool flushRequested;
+    FThreadSafeBool stopping;
+    FRunnableThread* thread;
+
+    // 已入队/已写盘的行数，Flush 据此判断是否写完
+    FThreadSafeCounter64 enqueuedLines;
+    FThreadSafeCounter64 writtenLines;
+    // 尚未被写线程取走的行数，积压过多时提前唤醒写线程
+    FThreadSafeCounter pendingLines;
+    // 进行中的压缩任务数
+    TSharedRef<FThreadSafeCounter, ESPMode::ThreadSafe> pendingCompressions;
+
+    // 活动文件路径、日期、起始偏移与检查点，可被其它线程查询；写线程修改时持有 activeMutex，自身读取无需加锁
+    mutable FCriticalSection activeMutex;
+    FString activePath;
+    FDateTime activeDay;
+    int64 activeStartOffset;
+    TArray<FLogCheckpoint> checkpoints;
+
+    // 以下仅写线程访问
+    IFileHandle* fileHandle;
+    int64 activeBytes;
+    // 活动文件达到该大小时滚动；归档失败后推迟到下一个阈值再重试
+    int64 rotateAtBytes;
+    FDateTime activeFirstTime;
+    FDateTime activeLastTime;
+    TArray<uint8> buffer;
+    FDateTime bufferFirstTime;
+    FDateTime bufferLastTime;
+    int64 bufferedLines;
+    // 当前活动文件中已写出定义记录的格式 ID，切换文件时清空
+    TSet<uint32> definedFormats;
+    double lastWriteTime;
+};
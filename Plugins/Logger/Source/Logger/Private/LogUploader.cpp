@@ -0,0 +1,424 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "LogUploader.h"
+#include "LogSink.h"
+#include "HAL/PlatformFileManager.h"
+#include "HAL/FileManager.h"
+#include "HAL/ThreadSafeCounter.h"
+#include "GenericPlatform/GenericPlatformFile.h"
+#include "Misc/Compression.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/Guid.h"
+#include "Async/Async.h"
+#include "HttpModule.h"
+#include "Interfaces/IHttpRequest.h"
+#include "Interfaces/IHttpResponse.h"
+
+// 压缩时每次读取的原始数据大小，决定上传期间的峰值内存
+static constexpr int64 COMPRESS_CHUNK_BYTES = 1024 * 1024;
+
+static FThreadSafeCounter gActiveUploads;
+
+// ===================== FLogUploadStream =====================
+FLogUploadStream::FLogUploadStream(const FString& inPath, int64 inOffset, int64 inLength, TArray<uint8>&& inHead, TArray<uint8>&& inTail)
+    : path(inPath)
+    , offset(inOffset)
+    , length(inLength)
+    , head(MoveTemp(inHead))
+    , tail(MoveTemp(inTail))
+    , pos(0)
+{
+    SetIsLoading(true);
+    SetIsPersistent(false);
+    handle.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenRead(*path, true));
+}
+
+FLogUploadStream::~FLogUploadStream()
+{
+    Close();
+}
+
+void FLogUploadStream::Serialize(void* data, int64 num)
+{
+    uint8* out = (uint8*)data;
+    while (num > 0)
+    {
+        int64 copied = 0;
+        if (pos < head.Num())
+        {
+            copied = FMath::Min(num, head.Num() - pos);
+            FMemory::Memcpy(out, head.GetData() + pos, copied);
+        }
+        else if (pos < head.Num() + length)
+        {
+            // 日志文件可能仍在被写线程追加，只读取开始上传时确定的范围
+            const int64 filePos = pos - head.Num();
+            copied = FMath::Min(num, length - filePos);
+            if (!handle || !handle->Seek(offset + filePos) || !handle->Read(out, copied))
+            {
+                UE_LOG(LogTemp, Warning, TEXT("读取上传文件失败: %s"), *path);
+                FMemory::Memzero(out, num);
+                SetError();
+                pos += num;
+                return;
+            }
+        }
+        else if (pos < TotalSize())
+        {
+            const int64 tailPos = pos - head.Num() - length;
+            copied = FMath::Min(num, tail.Num() - tailPos);
+            FMemory::Memcpy(out, tail.GetData() + tailPos, copied);
+        }
+        else
+        {
+            SetError();
+            return;
+        }
+
+        out += copied;
+        pos += copied;
+        num -= copied;
+    }
+}
+
+void FLogUploadStream::Seek(int64 inPos)
+{
+    pos = FMath::Clamp<int64>(inPos, 0, TotalSize());
+}
+
+int64 FLogUploadStream::Tell()
+{
+    return pos;
+}
+
+int64 FLogUploadStream::TotalSize()
+{
+    return head.Num() + length + tail.Num();
+}
+
+bool FLogUploadStream::Close()
+{
+    handle.Reset();
+    return !IsError();
+}
+
+FString FLogUploadStream::GetArchiveName() const
+{
+    return path;
+}
+
+// ===================== FLogUploader =====================
+// 上传内容的一段：文件的 [offset, offset + length)，或已解压到内存的归档分段（data 非空）
+struct FLogUploadPart
+{
+    FString path;
+    int64 offset = 0;
+    int64 length = 0;
+    TArray<uint8> data;
+};
+
+// 一次上传的范围：按顺序拼接的各段，以及覆盖到的日期与当天日志的结束偏移
+struct FLogUploadRange
+{
+    TArray<FLogUploadPart> parts;
+    FString activePath;
+    FDateTime day;
+    int64 activeStart = 0;
+    int64 endOffset = 0;
+    // 续传起点，用于上传文件名
+    FDateTime fromDay;
+    int64 fromOffset = 0;
+};
+
+static TArray<uint8> ToUtf8(const FString& text)
+{
+    FTCHARToUTF8 utf8(*text, text.Len());
+    return TArray<uint8>((const uint8*)utf8.Get(), utf8.Length());
+}
+
+static FString FormatDay(const FDateTime& day)
+{
+    return FString::Printf(TEXT("%04d%02d%02d"), day.GetYear(), day.GetMonth(), day.GetDay());
+}
+
+// 归档分段跳过 skip 字节后的剩余部分；压缩任务可能在查询索引之后才完成，原文件不完整时改读 .gz
+static bool AddSegmentPart(const FString& directory, const FLogSegmentInfo& segment, int64 skip, TArray<FLogUploadPart>& parts)
+{
+    const FString path = FPaths::Combine(directory, segment.fileName);
+    if (!segment.compressed && IFileManager::Get().FileSize(*path) == segment.rawBytes)
+    {
+        parts.Add({ path, skip, segment.rawBytes - skip, TArray<uint8>() });
+        return true;
+    }
+
+    TArray<uint8> compressed;
+    TArray<uint8> raw;
+    raw.SetNumUninitialized((int32)segment.rawBytes);
+    if (!FFileHelper::LoadFileToArray(compressed, *(segment.compressed ? path : path + TEXT(".gz")))
+        || !FCompression::UncompressMemory(NAME_Gzip, raw.GetData(), raw.Num(), compressed.GetData(), compressed.Num()))
+    {
+        return false;
+    }
+
+    FLogUploadPart& part = parts.AddDefaulted_GetRef();
+    part.data.Append(raw.GetData() + skip, raw.Num() - (int32)skip);
+    part.length = part.data.Num();
+    return true;
+}
+
+// 确定续传起点之后的全部内容：起点当天剩余的归档分段、之后各天的归档分段，以及活动文件
+// 期间写线程可能正在滚动，活动文件与分段索引不一致时返回 false，由调用方重试
+static bool CollectRange(const FLogSink& sink, const FLogUploadParams& params, FLogUploadRange& out, FString& outError)
+{
+    sink.GetActiveFile(out.activePath, out.day, out.activeStart);
+    const int64 activeStart = out.activeStart;
+    if (out.activePath.IsEmpty())
+    {
+        outError = TEXT("日志未启动");
+        return true;
+    }
+
+    // 活动文件尚未创建时视为空
+    const int64 activeSize = FMath::Max<int64>(IFileManager::Get().FileSize(*out.activePath), 0);
+    out.endOffset = activeStart + activeSize;
+
+    out.fromDay = params.resumeDay;
+    out.fromOffset = params.resumeOffset;
+    if (out.fromDay.GetTicks() == 0 || out.fromDay > out.day || (out.fromDay == out.day && out.fromOffset > out.endOffset))
+    {
+        out.fromDay = out.day;
+        out.fromOffset = 0;
+    }
+
+    TArray<FLogSegmentInfo> segments = sink.GetSegments();
+    segments.Sort([](const FLogSegmentInfo& a, const FLogSegmentInfo& b)
+    {
+        return a.day != b.day ? a.day < b.day : a.sequence < b.sequence;
+    });
+
+    const FString directory = FPaths::GetPath(out.activePath);
+    for (const FLogSegmentInfo& segment : segments)
+    {
+        // 刚归档、活动文件偏移尚未更新的分段
+        if (segment.day == out.day && segment.startOffset >= activeStart)
+            return false;
+        if (segment.day < out.fromDay || segment.day > out.day)
+            continue;
+
+        const int64 skip = segment.day == out.fromDay ? FMath::Max<int64>(out.fromOffset - segment.startOffset, 0) : 0;
+        if (skip >= segment.rawBytes)
+            continue;
+        if (!AddSegmentPart(directory, segment, skip, out.parts))
+        {
+            outError = FString::Printf(TEXT("读取日志分段失败: %s"), *segment.fileName);
+            return true;
+        }
+    }
+
+    const int64 skip = out.fromDay == out.day ? FMath::Max<int64>(out.fromOffset - activeStart, 0) : 0;
+    if (skip < activeSize)
+        out.parts.Add({ out.activePath, skip, activeSize - skip, TArray<uint8>() });
+    return true;
+}
+
+// 逐块读取各段并交给 consume，每块不超过 COMPRESS_CHUNK_BYTES
+static bool ReadParts(const TArray<FLogUploadPart>& parts, TFunctionRef<bool(const uint8* data, int32 size)> consume)
+{
+    IPlatformFile& platformFile = FPlatformFileManager::Get().GetPlatformFile();
+    TArray<uint8> raw;
+    for (const FLogUploadPart& part : parts)
+    {
+        if (part.data.Num() > 0)
+        {
+            for (int32 done = 0; done < part.data.Num(); done += (int32)COMPRESS_CHUNK_BYTES)
+            {
+                if (!consume(part.data.GetData() + done, (int32)FMath::Min<int64>(part.data.Num() - done, COMPRESS_CHUNK_BYTES)))
+                    return false;
+            }
+            continue;
+        }
+
+        TUniquePtr<IFileHandle> input(platformFile.OpenRead(*part.path, true));
+        if (!input || !input->Seek(part.offset))
+            return false;
+        raw.SetNumUninitialized((int32)FMath::Min(part.length, COMPRESS_CHUNK_BYTES), EAllowShrinking::No);
+        for (int64 done = 0; done < part.length; )
+        {
+            const int32 chunk = (int32)FMath::Min(part.length - done, COMPRESS_CHUNK_BYTES);
+            if (!input->Read(raw.GetData(), chunk) || !consume(raw.GetData(), chunk))
+                return false;
+            done += chunk;
+        }
+    }
+    return true;
+}
+
+// 将各段拼接写入 outPath；compress 时每块是一段独立的 gzip 数据
+static bool WriteParts(const TArray<FLogUploadPart>& parts, bool compress, const FString& outPath)
+{
+    TUniquePtr<IFileHandle> output(FPlatformFileManager::Get().GetPlatformFile().OpenWrite(*outPath));
+    if (!output)
+        return false;
+
+    TArray<uint8> compressed;
+    if (compress)
+        compressed.SetNumUninitialized(FCompression::CompressMemoryBound(NAME_Gzip, (int32)COMPRESS_CHUNK_BYTES));
+    const bool ok = ReadParts(parts, [&](const uint8* data, int32 size)
+    {
+        if (!compress)
+            return output->Write(data, size);
+
+        int32 compressedSize = compressed.Num();
+        return FCompression::CompressMemory(NAME_Gzip, compressed.GetData(), compressedSize, data, size)
+            && output->Write(compressed.GetData(), compressedSize);
+    });
+    return ok && output->Flush();
+}
+
+static void FinishUpload(const FLogUploadParams& params, bool ok, const FString& response, const FDateTime& day, int64 endOffset)
+{
+    gActiveUploads.Decrement();
+    if (params.onComplete)
+        params.onComplete(ok, response, day, endOffset);
+}
+
+static void FailUpload(TSharedRef<FLogUploadParams, ESPMode::ThreadSafe> params, const FString& error, const FDateTime& day, int64 endOffset)
+{
+    AsyncTask(ENamedThreads::GameThread, [params, error, day, endOffset]()
+    {
+        FinishUpload(*params, false, error, day, endOffset);
+    });
+}
+
+// 后台线程：确定上传范围、按需压缩并构造请求体，然后回到游戏线程发出请求
+static void PrepareUpload(TSharedRef<FLogUploadParams, ESPMode::ThreadSafe> params)
+{
+    // 滚动与查询并发时重试的次数
+    const int32 MAX_ATTEMPTS = 3;
+
+    FLogSink& sink = params->sink ? *params->sink : FLogSink::Get();
+    // 先把队列中的日志写入文件，避免上传的内容缺少最近几行
+    sink.Flush();
+
+    for (int32 attempt = 0; attempt < MAX_ATTEMPTS; attempt++)
+    {
+        FLogUploadRange range;
+        FString error;
+        if (!CollectRange(sink, *params, range, error))
+            continue;
+        if (!error.IsEmpty())
+        {
+            FailUpload(params, error, range.day, 0);
+            return;
+        }
+        if (range.parts.Num() == 0)
+        {
+            FailUpload(params, TEXT("自上次上传后没有新的日志"), range.day, range.endOffset);
+            return;
+        }
+
+        FString fileName = FPaths::GetCleanFilename(range.activePath);
+        if (range.fromDay != range.day)
+            fileName = FString::Printf(TEXT("%s.from-%s-%lld%s"), *FPaths::GetBaseFilename(range.activePath), *FormatDay(range.fromDay), range.fromOffset, *FPaths::GetExtension(range.activePath, true));
+        else if (range.fromOffset > 0)
+            fileName = FString::Printf(TEXT("%s.from-%lld%s"), *FPaths::GetBaseFilename(range.activePath), range.fromOffset, *FPaths::GetExtension(range.activePath, true));
+
+        // 只有活动文件的一段时直接流式读取；多段或需压缩时先拼接到临时文件
+        FString uploadPath = range.parts[0].path;
+        int64 uploadOffset = range.parts[0].offset;
+        int64 uploadLength = range.parts[0].length;
+        FString tempPath;
+        if (params->compress || range.parts.Num() > 1 || range.parts[0].data.Num() > 0)
+        {
+            tempPath = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("LogUpload"), FGuid::NewGuid().ToString() + (params->compress ? TEXT(".gz") : TEXT(".log")));
+            IFileManager::Get().MakeDirectory(*FPaths::GetPath(tempPath), true);
+            if (!WriteParts(range.parts, params->compress, tempPath))
+            {
+                IFileManager::Get().Delete(*tempPath, false, true, true);
+                FailUpload(params, FString::Printf(TEXT("%s日志文件失败: %s"), params->compress ? TEXT("压缩") : TEXT("拼接"), *range.activePath), range.day, 0);
+                return;
+            }
+            uploadPath = tempPath;
+            uploadOffset = 0;
+            uploadLength = IFileManager::Get().FileSize(*tempPath);
+        }
+        if (params->compress)
+            fileName += TEXT(".gz");
+
+        // 构造 multipart/form-data
+        const FString boundary = FString::Printf(TEXT("----------------UEBoundary-%s"), *FGuid::NewGuid().ToString(EGuidFormats::Digits));
+        const FString headPart = FString::Printf(TEXT("--%s\r\nContent-Disposition: form-data; name=\"%s\"; filename=\"%s\"\r\nContent-Type: %s\r\n\r\n"),
+            *boundary, *params->fieldName, *fileName, params->compress ? TEXT("application/gzip") : TEXT("application/octet-stream"));
+        const FString tailPart = FString::Printf(TEXT("\r\n--%s--\r\n"), *boundary);
+
+        TSharedPtr<FLogUploadStream, ESPMode::ThreadSafe> body = MakeShared<FLogUploadStream, ESPMode::ThreadSafe>(
+            uploadPath, uploadOffset, uploadLength, ToUtf8(headPart), ToUtf8(tailPart));
+
+        // 读取期间活动文件被滚动时，已打开或拼接的可能是新的同名文件，重新确定范围
+        FString activePath;
+        FDateTime day;
+        int64 activeStart = 0;
+        sink.GetActiveFile(activePath, day, activeStart);
+        if (activePath != range.activePath || day != range.day || activeStart != range.activeStart)
+        {
+            body.Reset();
+            if (!tempPath.IsEmpty())
+                IFileManager::Get().Delete(*tempPath, false, true, true);
+            continue;
+        }
+
+        if (!body->IsOpen())
+        {
+            body.Reset();
+            if (!tempPath.IsEmpty())
+                IFileManager::Get().Delete(*tempPath, false, true, true);
+            FailUpload(params, FString::Printf(TEXT("打开上传文件失败: %s"), *uploadPath), range.day, 0);
+            return;
+        }
+
+        AsyncTask(ENamedThreads::GameThread, [params, body = body.ToSharedRef(), boundary, day = range.day, endOffset = range.endOffset, tempPath]()
+        {
+            TSharedRef<IHttpRequest, ESPMode::ThreadSafe> request = FHttpModule::Get().CreateRequest();
+            request->SetURL(params->url);
+            request->SetVerb(TEXT("POST"));
+            request->SetHeader(TEXT("Content-Type"), FString::Printf(TEXT("multipart/form-data; boundary=%s"), *boundary));
+            request->SetHeader(TEXT("Accept"), TEXT("application/json"));
+            request->SetContentFromStream(body);
+            request->OnProcessRequestComplete().BindLambda([params, day, endOffset, tempPath](FHttpRequestPtr req, FHttpResponsePtr resp, bool ok)
+            {
+                if (!tempPath.IsEmpty())
+                    IFileManager::Get().Delete(*tempPath, false, true, true);
+
+                const bool succeeded = ok && resp.IsValid() && EHttpResponseCodes::IsOk(resp->GetResponseCode());
+                FinishUpload(*params, succeeded, resp.IsValid() ? resp->GetContentAsString() : FString(), day, endOffset);
+            });
+            request->ProcessRequest();
+        });
+        return;
+    }
+
+    FailUpload(params, TEXT("日志正在滚动，请稍后再试"), FDateTime(), 0);
+}
+
+bool FLogUploader::Upload(FLogUploadParams&& params)
+{
+    if (gActiveUploads.Increment() > MAX_CONCURRENT_UPLOADS)
+    {
+        gActiveUploads.Decrement();
+        UE_LOG(LogTemp, Warning, TEXT("同时进行的日志上传已达上限 %d"), MAX_CONCURRENT_UPLOADS);
+        return false;
+    }
+
+    TSharedRef<FLogUploadParams, ESPMode::ThreadSafe> shared = MakeShared<FLogUploadParams, ESPMode::ThreadSafe>(MoveTemp(params));
+    AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask, [shared]()
+    {
+        PrepareUpload(shared);
+    });
+    return true;
+}
+
+int32 FLogUploader::GetActiveUploads()
+{
+    return gActiveUploads.GetValue();
+}
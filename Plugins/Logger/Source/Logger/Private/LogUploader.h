@@ -0,0 +1,74 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Serialization/Archive.h"
+
+class IFileHandle;
+class FLogSink;
+
+/*
+ * multipart/form-data 请求体：头部 + 文件 [offset, offset + length) + 尾部
+ * 构造时打开文件，之后由 HTTP 线程按需分块读取，文件内容不整体载入内存；上传期间文件被改名也仍读取原文件
+ */
+class FLogUploadStream : public FArchive
+{
+public:
+    FLogUploadStream(const FString& inPath, int64 inOffset, int64 inLength, TArray<uint8>&& inHead, TArray<uint8>&& inTail);
+    virtual ~FLogUploadStream() override;
+
+    virtual void Serialize(void* data, int64 num) override;
+    virtual void Seek(int64 inPos) override;
+    virtual int64 Tell() override;
+    virtual int64 TotalSize() override;
+    virtual bool Close() override;
+    virtual FString GetArchiveName() const override;
+
+    bool IsOpen() const
+    {
+        return handle.IsValid();
+    }
+
+private:
+    FString path;
+    int64 offset;
+    int64 length;
+    TArray<uint8> head;
+    TArray<uint8> tail;
+    TUniquePtr<IFileHandle> handle;
+    int64 pos;
+};
+
+struct FLogUploadParams
+{
+    FString url;
+    // 表单字段名（企业微信为 media）
+    FString fieldName = TEXT("media");
+    // 要上传的日志；为空时使用 FLogSink::Get()，上传前先写出它的队列
+    FLogSink* sink = nullptr;
+    // 续传：从 resumeDay 当天日志的 resumeOffset（上次成功上传的结束位置，按当天全部分段拼接计算）开始，
+    // 依次上传其后的归档分段与活动文件；resumeDay 为空或超出已有日志时上传当天的完整日志
+    FDateTime resumeDay;
+    int64 resumeOffset = 0;
+    // 上传前按块压缩为 gzip（多段 gzip，标准解压工具可直接解开）
+    bool compress = false;
+    // 在游戏线程回调：HTTP 是否成功（2xx）、响应内容，以及本次上传覆盖到的日期与当天日志的结束偏移
+    TFunction<void(bool ok, const FString& response, const FDateTime& day, int64 endOffset)> onComplete;
+};
+
+/*
+ * 日志文件上传：文件读取、压缩与请求体构造都在后台线程完成，请求体以流的形式交给 HTTP 模块
+ * 活动文件按大小滚动后会以同名新文件继续写入，因此续传位置按日期与当天的累计偏移记录，而不是文件路径
+ * 同时进行的上传数量不超过 MAX_CONCURRENT_UPLOADS，超出时直接拒绝
+ */
+class FLogUploader
+{
+public:
+    static constexpr int32 MAX_CONCURRENT_UPLOADS = 2;
+
+    // 开始上传，可在任意线程调用；返回 false 表示已达到并发上限
+    static bool Upload(FLogUploadParams&& params);
+
+    static int32 GetActiveUploads();
+};
@@ -2,9 +2,12 @@
 
 
 #include "LogWriter.h"
+#include "LogSink.h"
+#include "LogUploader.h"
+#include "StructuredLog.h"
+#include "StructuredLogFormat.h"
 #include "Misc/Paths.h"
 #include "HAL/FileManager.h"
-#include "Misc/FileHelper.h"
 #include "Misc/DateTime.h"
 #include "UObject/Package.h"
 #include "HAL/CriticalSection.h"
@@ -33,27 +36,24 @@ ULogWriter* ULogWriter::GetLogWriter()
 void ULogWriter::Log(const FString& message)
 {
     // 将所有日志写入统一文件
-    EnsureFilePathInitialized(combinedFilePath);
-    WriteLine(message, combinedFilePath);
+    WriteLine(ELogWriterLevel::Log, message);
 }
 
 void ULogWriter::Warning(const FString& message)
 {
-    EnsureFilePathInitialized(combinedFilePath);
-    WriteLine(message, combinedFilePath);
+    WriteLine(ELogWriterLevel::Warning, message);
 }
 
 void ULogWriter::Error(const FString& message)
 {
-    EnsureFilePathInitialized(combinedFilePath);
-    WriteLine(message, combinedFilePath);
+    // Error 会触发立即写盘
+    WriteLine(ELogWriterLevel::Error, message);
 }
 
 void ULogWriter::Initialize()
 {
-    FScopeLock lock(&writeLock);
+    // 写线程已在模块加载时启动（见 FLoggerModule::StartupModule），文件句柄由写线程持有
     const FString dir = FPaths::ProjectLogDir();
-    IFileManager::Get().MakeDirectory(*dir, true);
 
     // 用法：初始化时将日志目录路径打印到屏幕，持续5秒，便于确认目标文件夹位置
     const float DISPLAY_SECONDS = 5.0f;
@@ -61,31 +61,46 @@ void ULogWriter::Initialize()
         GEngine->AddOnScreenDebugMessage(-1, DISPLAY_SECONDS, FColor::Green, FString::Printf(TEXT("日志目录: %s"), *dir));
 }
 
-// 修改方法：使用数值组装日期字符串，避免格式串不生效
-FString ULogWriter::GetTodayLogFilePath() const
+void ULogWriter::WriteLine(ELogWriterLevel level, const FString& content)
 {
-    const FDateTime now = FDateTime::Now();
-    const FString date = FString::Printf(TEXT("%04d%02d%02d"), now.GetYear(), now.GetMonth(), now.GetDay());
-    // 统一使用 All-YYYYMMDD.log，不区分类别
-    return FPaths::Combine(FPaths::ProjectLogDir(), FString::Printf(TEXT("Logs-%s.log"), *date));
+    if (!LogWriterCategory_Default.IsEnabled(level))
+        return;
+
+    if ((uint8)level >= (uint8)UE::LogWriter::GetEchoLevel())
+    {
+        switch (level)
+        {
+        case ELogWriterLevel::Error:
+            UE_LOG(LogTemp, Error, TEXT("%s"), *content);
+            break;
+        case ELogWriterLevel::Warning:
+            UE_LOG(LogTemp, Warning, TEXT("%s"), *content);
+            break;
+        default:
+            UE_LOG(LogTemp, Log, TEXT("%s"), *content);
+            break;
+        }
+    }
+
+    FLogSink::Get().Enqueue(level, CopyTemp(content));
 }
 
-void ULogWriter::WriteLine(const FString& content, const FString& filePath)
+bool ULogWriter::SetCategoryLevel(const FString& category, ELogWriterLevel minLevel)
 {
-    FScopeLock lock(&writeLock);
-    const FDateTime now = FDateTime::Now();
-    const FString time = FString::Printf(TEXT("%02d:%02d:%02d.%03d"), now.GetHour(), now.GetMinute(), now.GetSecond(), now.GetMillisecond());
-    const FString line = FString::Printf(TEXT("[%s] %s\n"), *time, *content);
+    FStructuredLogCategory* found = FStructuredLogCategory::Find(*category);
+    if (!found)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("日志分类不存在: %s"), *category);
+        return false;
+    }
 
-    UE_LOG(LogTemp, Log, TEXT("%s"), *line);
-    FFileHelper::SaveStringToFile(line, *filePath, FFileHelper::EEncodingOptions::AutoDetect, &IFileManager::Get(), EFileWrite::FILEWRITE_Append);
+    found->SetMinLevel(minLevel);
+    return true;
 }
 
-void ULogWriter::EnsureFilePathInitialized(FString& filePath)
+void ULogWriter::SetEchoLevel(ELogWriterLevel minLevel)
 {
-    if (!filePath.IsEmpty()) return;
-    FScopeLock lock(&writeLock);
-    if (filePath.IsEmpty()) filePath = GetTodayLogFilePath();
+    UE::LogWriter::SetEchoLevel(minLevel);
 }
 
 // 设置企业微信机器人 webhook（完整 URL）
@@ -111,11 +126,9 @@ bool ULogWriter::ParseWeComKeyFromWebhook(const FString& webhook, FString& outKe
     return !outKey.IsEmpty();
 }
 
-// 异步将当天日志文件发送到企业微信机器人：upload_media -> send file
-void ULogWriter::SendLogFileToWeCom()
+// 异步将当前活动日志文件发送到企业微信机器人：upload_media -> send file
+void ULogWriter::SendLogFileToWeCom(bool compress, bool onlyNewContent)
 {
-    EnsureFilePathInitialized(combinedFilePath);
-
     if (wecomWebhook.IsEmpty())
     {
         UE_LOG(LogTemp, Warning, TEXT("未设置企业微信机器人 webhook"));
@@ -129,54 +142,24 @@ void ULogWriter::SendLogFileToWeCom()
         return;
     }
 
-    TArray<uint8> fileBytes;
-    if (!FFileHelper::LoadFileToArray(fileBytes, *combinedFilePath))
-    {
-        UE_LOG(LogTemp, Warning, TEXT("读取日志文件失败: %s"), *combinedFilePath);
-        return;
-    }
-
-    const FString uploadUrl = FString::Printf(TEXT("https://qyapi.weixin.qq.com/cgi-bin/webhook/upload_media?key=%s&type=file"), *key);
-
-    // 构造 multipart/form-data
-    const FString boundary = FString::Printf(TEXT("----------------UEBoundary-%d"), FDateTime::Now().GetTicks() & 0xFFFF);
-    const FString fileName = FPaths::GetCleanFilename(combinedFilePath);
-    FString headerPart = FString::Printf(TEXT("--%s\r\nContent-Disposition: form-data; name=\"media\"; filename=\"%s\"\r\nContent-Type: application/octet-stream\r\n\r\n"), *boundary, *fileName);
-    FString tailPart = FString::Printf(TEXT("\r\n--%s--\r\n"), *boundary);
-
-    TArray<uint8> body;
+    // 文件读取与请求体构造在后台线程完成，请求体按块流式发送，不整体载入内存
+    FLogUploadParams params;
+    params.url = FString::Printf(TEXT("https://qyapi.weixin.qq.com/cgi-bin/webhook/upload_media?key=%s&type=file"), *key);
+    params.compress = compress;
+    if (onlyNewContent)
     {
-        FTCHARToUTF8 h(*headerPart);
-        body.Append((uint8*)h.Get(), h.Length());
+        // 续传：只上传上次成功上传之后写入的部分，活动文件滚动也不会重复或遗漏
+        FScopeLock lock(&writeLock);
+        params.resumeDay = uploadedDay;
+        params.resumeOffset = uploadedOffset;
     }
-    body.Append(fileBytes);
+    params.onComplete = [this](bool ok, const FString& json, const FDateTime& day, int64 endOffset)
     {
-        FTCHARToUTF8 t(*tailPart);
-        body.Append((uint8*)t.Get(), t.Length());
-    }
-
-    // 发送上传请求
-    FHttpModule* http = &FHttpModule::Get();
-    if (!http)
-    {
-        UE_LOG(LogTemp, Warning, TEXT("HTTP 模块不可用"));
-        return;
-    }
-
-    TSharedRef<IHttpRequest, ESPMode::ThreadSafe> uploadReq = http->CreateRequest();
-    uploadReq->SetURL(uploadUrl);
-    uploadReq->SetVerb(TEXT("POST"));
-    uploadReq->SetHeader(TEXT("Content-Type"), FString::Printf(TEXT("multipart/form-data; boundary=%s"), *boundary));
-    uploadReq->SetHeader(TEXT("Accept"), TEXT("application/json"));
-    uploadReq->SetContent(body);
-    uploadReq->OnProcessRequestComplete().BindLambda([this](FHttpRequestPtr req, FHttpResponsePtr resp, bool ok)
-    {
-        if (!ok || !resp.IsValid())
+        if (!ok)
         {
-            UE_LOG(LogTemp, Warning, TEXT("上传日志到企业微信失败：网络或响应无效"));
+            UE_LOG(LogTemp, Warning, TEXT("上传日志到企业微信失败，响应: %s"), *json);
             return;
         }
-        const FString json = resp->GetContentAsString();
 
         // 解析 media_id
         FString mediaId;
@@ -194,6 +177,12 @@ void ULogWriter::SendLogFileToWeCom()
             return;
         }
 
+        {
+            FScopeLock lock(&writeLock);
+            uploadedDay = day;
+            uploadedOffset = endOffset;
+        }
+
         // 使用 webhook 发送文件消息
         TSharedRef<IHttpRequest, ESPMode::ThreadSafe> sendReq = FHttpModule::Get().CreateRequest();
         sendReq->SetURL(wecomWebhook);
@@ -222,6 +211,8 @@ void ULogWriter::SendLogFileToWeCom()
             UE_LOG(LogTemp, Log, TEXT("发送企业微信文件消息成功，响应: %s"), *s->GetContentAsString());
         });
         sendReq->ProcessRequest();
-    });
-    uploadReq->ProcessRequest();
+    };
+
+    if (!FLogUploader::Upload(MoveTemp(params)))
+        UE_LOG(LogTemp, Warning, TEXT("日志上传繁忙，请稍后再试"));
 }
@@ -1,18 +1,34 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "Logger.h"
+#include "LogSink.h"
+#include "StructuredLogFormat.h"
+#include "Misc/Paths.h"
 
 #define LOCTEXT_NAMESPACE "FLoggerModule"
 
 void FLoggerModule::StartupModule()
 {
 	// This code will execute after your module is loaded into memory; the exact timing is specified in the .uplugin file per-module
+
+	// 模块加载即启动两个写线程：在首次调用 ULogWriter::GetLogWriter 之前，LOGWRITER_LOG 与 ULogWriter 的日志也能落盘
+	// 所有日志统一写入 Logs-YYYYMMDD.log，不区分 Log/Warning/Error；跨天或超过大小时滚动为归档分段
+	const FString dir = FPaths::ProjectLogDir();
+	FLogSinkSettings settings;
+	settings.directory = dir;
+	settings.baseName = TEXT("Logs");
+	FLogSink::Get().Start(settings);
+	StartStructuredLog(dir);
 }
 
 void FLoggerModule::ShutdownModule()
 {
 	// This function may be called during shutdown to clean up your module.  For modules that support dynamic reloading,
 	// we call this function before unloading the module.
+
+	// 写出剩余日志并关闭文件
+	FLogSink::Get().Shutdown();
+	ShutdownStructuredLog();
 }
 
 #undef LOCTEXT_NAMESPACE
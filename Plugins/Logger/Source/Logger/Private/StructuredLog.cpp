@@ -0,0 +1,148 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "StructuredLog.h"
+#include "StructuredLogFormat.h"
+#include "LogSink.h"
+#include "Misc/ScopeRWLock.h"
+
+LOGWRITER_DEFINE_CATEGORY(Default, Log);
+
+// 分类链表头；分类均为静态对象，在静态初始化阶段注册，之后只读
+static FStructuredLogCategory* gCategoryHead = nullptr;
+
+static std::atomic<uint8> gEchoLevel((uint8)ELogWriterLevel::Log);
+
+// 格式定义注册表：调用点首次执行时写入，写线程查询
+struct FStructuredLogRegistry
+{
+    FRWLock lock;
+    TMap<uint32, FStructuredLogDefinition> definitions;
+};
+
+static FStructuredLogRegistry& GetRegistry()
+{
+    static FStructuredLogRegistry registry;
+    return registry;
+}
+
+static FLogSink& GetStructuredSink()
+{
+    static FLogSink sink;
+    return sink;
+}
+
+// ===================== FStructuredLogCategory =====================
+FStructuredLogCategory::FStructuredLogCategory(const TCHAR* inName, ELogWriterLevel defaultLevel)
+    : name(inName)
+    , minLevel((uint8)defaultLevel)
+    , next(gCategoryHead)
+{
+    gCategoryHead = this;
+}
+
+FStructuredLogCategory* FStructuredLogCategory::Find(const TCHAR* categoryName)
+{
+    for (FStructuredLogCategory* category = gCategoryHead; category; category = category->next)
+    {
+        if (FCString::Stricmp(category->name, categoryName) == 0)
+            return category;
+    }
+    return nullptr;
+}
+
+// ===================== FStructuredLogSite =====================
+FStructuredLogSite::FStructuredLogSite(uint32 inFormatId, const FStructuredLogCategory& inCategory, ELogWriterLevel inLevel, const TCHAR* inFormat)
+    : formatId(inFormatId)
+    , category(inCategory)
+    , level(inLevel)
+    , format(inFormat)
+{
+    FStructuredLogRegistry& registry = GetRegistry();
+    FWriteScopeLock lock(registry.lock);
+
+    FStructuredLogDefinition& definition = registry.definitions.FindOrAdd(formatId);
+    definition.category = category.GetName();
+    definition.level = level;
+    definition.format = format;
+}
+
+bool FindStructuredLogDefinition(uint32 formatId, FStructuredLogDefinition& outDefinition)
+{
+    FStructuredLogRegistry& registry = GetRegistry();
+    FReadScopeLock lock(registry.lock);
+
+    const FStructuredLogDefinition* definition = registry.definitions.Find(formatId);
+    if (!definition)
+        return false;
+
+    outDefinition = *definition;
+    return true;
+}
+
+void StartStructuredLog(const FString& directory)
+{
+    FLogSinkSettings settings;
+    settings.directory = directory;
+    settings.baseName = TEXT("StructuredLogs");
+    settings.extension = TEXT(".blog");
+    GetStructuredSink().Start(settings);
+}
+
+void ShutdownStructuredLog()
+{
+    GetStructuredSink().Shutdown();
+}
+
+bool FlushStructuredLog(double timeoutSec)
+{
+    return GetStructuredSink().Flush(timeoutSec);
+}
+
+FString GetStructuredLogFilePath()
+{
+    return GetStructuredSink().GetActiveFilePath();
+}
+
+namespace UE::LogWriter
+{
+    static void AppendUtf8(FRecordBuffer& out, const TCHAR* value, int32 length)
+    {
+        FTCHARToUTF8 utf8(value, length);
+        const uint16 size = (uint16)FMath::Min(utf8.Length(), (int32)MAX_uint16);
+        out.Add((uint8)EArgTag::String);
+        AppendRaw(out, size);
+        out.Append((const uint8*)utf8.Get(), size);
+    }
+
+    void AppendArg(FRecordBuffer& out, const TCHAR* value)
+    {
+        AppendUtf8(out, value ? value : TEXT(""), value ? FCString::Strlen(value) : 0);
+    }
+
+    void AppendArg(FRecordBuffer& out, const FString& value)
+    {
+        AppendUtf8(out, *value, value.Len());
+    }
+
+    void AppendArg(FRecordBuffer& out, const FName& value)
+    {
+        TCHAR buffer[NAME_SIZE];
+        const int32 length = value.ToString(buffer);
+        AppendUtf8(out, buffer, length);
+    }
+
+    void SubmitRecord(const FStructuredLogSite& site, FRecordBuffer& record)
+    {
+        GetStructuredSink().EnqueueRecord(site.level, record);
+    }
+
+    void SetEchoLevel(ELogWriterLevel level)
+    {
+        gEchoLevel.store((uint8)level, std::memory_order_relaxed);
+    }
+
+    ELogWriterLevel GetEchoLevel()
+    {
+        return (ELogWriterLevel)gEchoLevel.load(std::memory_order_relaxed);
+    }
+}
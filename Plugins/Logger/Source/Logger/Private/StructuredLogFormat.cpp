@@ -0,0 +1,177 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "StructuredLogFormat.h"
+#include "StructuredLog.h"
+
+using UE::LogWriter::EArgTag;
+
+// 顺序读取小端数值，越界后 ok 置为 false
+struct FRecordReader
+{
+    FRecordReader(TArrayView<const uint8> inData)
+        : data(inData)
+    {
+    }
+
+    template<typename T>
+    T Read()
+    {
+        T value{};
+        if (!ok || pos + (int32)sizeof(T) > data.Num())
+        {
+            ok = false;
+            return value;
+        }
+        FMemory::Memcpy(&value, data.GetData() + pos, sizeof(T));
+        pos += sizeof(T);
+        return value;
+    }
+
+    FString ReadString()
+    {
+        const int32 length = Read<uint16>();
+        if (!ok || pos + length > data.Num())
+        {
+            ok = false;
+            return FString();
+        }
+
+        FUTF8ToTCHAR converter((const ANSICHAR*)data.GetData() + pos, length);
+        pos += length;
+        return FString(converter.Get(), converter.Length());
+    }
+
+    TArrayView<const uint8> data;
+    int32 pos = 0;
+    bool ok = true;
+};
+
+static void AppendShortUtf8(TArray<uint8>& out, const FString& value)
+{
+    FTCHARToUTF8 utf8(*value, value.Len());
+    const int32 length = FMath::Min(utf8.Length(), (int32)MAX_uint16);
+    const uint16 prefix = (uint16)length;
+    out.Append((const uint8*)&prefix, sizeof(prefix));
+    out.Append((const uint8*)utf8.Get(), length);
+}
+
+static const TCHAR* GetLevelPrefix(ELogWriterLevel level)
+{
+    switch (level)
+    {
+    case ELogWriterLevel::Warning:
+        return TEXT("Warning: ");
+    case ELogWriterLevel::Error:
+        return TEXT("Error: ");
+    default:
+        return TEXT("");
+    }
+}
+
+void AppendDefinitionRecord(TArray<uint8>& out, uint32 formatId, const FStructuredLogDefinition& definition)
+{
+    out.Add((uint8)EStructuredRecordType::Definition);
+    out.Append((const uint8*)&formatId, sizeof(formatId));
+    out.Add((uint8)definition.level);
+    AppendShortUtf8(out, definition.category);
+    AppendShortUtf8(out, definition.format);
+}
+
+bool RenderStructuredArgs(const FString& format, TArrayView<const uint8> args, FString& outText, int32& outConsumed)
+{
+    FRecordReader reader(args);
+    const int32 count = reader.Read<uint8>();
+
+    outText.Reset(format.Len() + count * 8);
+    int32 cursor = 0;
+    for (int32 i = 0; i < count && reader.ok; i++)
+    {
+        // 参数多于占位符时追加在末尾
+        const int32 placeholder = format.Find(TEXT("{}"), ESearchCase::CaseSensitive, ESearchDir::FromStart, cursor);
+        if (placeholder == INDEX_NONE)
+        {
+            outText.AppendChars(*format + cursor, format.Len() - cursor);
+            outText += TEXT(" ");
+            cursor = format.Len();
+        }
+        else
+        {
+            outText.AppendChars(*format + cursor, placeholder - cursor);
+            cursor = placeholder + 2;
+        }
+
+        switch ((EArgTag)reader.Read<uint8>())
+        {
+        case EArgTag::Int:
+            outText += FString::Printf(TEXT("%lld"), reader.Read<int64>());
+            break;
+        case EArgTag::UInt:
+            outText += FString::Printf(TEXT("%llu"), reader.Read<uint64>());
+            break;
+        case EArgTag::Double:
+            outText += FString::SanitizeFloat(reader.Read<double>());
+            break;
+        case EArgTag::Bool:
+            outText += reader.Read<uint8>() ? TEXT("true") : TEXT("false");
+            break;
+        case EArgTag::String:
+            outText += reader.ReadString();
+            break;
+        default:
+            reader.ok = false;
+            break;
+        }
+    }
+
+    if (cursor < format.Len())
+        outText.AppendChars(*format + cursor, format.Len() - cursor);
+
+    outConsumed = reader.pos;
+    return reader.ok;
+}
+
+bool FStructuredLogDecoder::Decode(TArrayView<const uint8> data, FString& outText)
+{
+    FRecordReader reader(data);
+    while (reader.ok && reader.pos < data.Num())
+    {
+        const EStructuredRecordType type = (EStructuredRecordType)reader.Read<uint8>();
+        if (type == EStructuredRecordType::Definition)
+        {
+            const uint32 formatId = reader.Read<uint32>();
+            FStructuredLogDefinition definition;
+            definition.level = (ELogWriterLevel)reader.Read<uint8>();
+            definition.category = reader.ReadString();
+            definition.format = reader.ReadString();
+            if (reader.ok)
+                definitions.Add(formatId, MoveTemp(definition));
+            continue;
+        }
+
+        if (type != EStructuredRecordType::Event)
+            return false;
+
+        const FDateTime time(reader.Read<int64>());
+        const uint32 formatId = reader.Read<uint32>();
+        if (!reader.ok)
+            return false;
+
+        FString text;
+        int32 consumed = 0;
+        const FStructuredLogDefinition* definition = definitions.Find(formatId);
+        if (!RenderStructuredArgs(definition ? definition->format : FString::Printf(TEXT("<unknown format %08x>"), formatId),
+            data.Mid(reader.pos), text, consumed))
+        {
+            return false;
+        }
+        reader.pos += consumed;
+
+        if (!definition)
+            unknownEvents++;
+
+        outText += FString::Printf(TEXT("[%02d:%02d:%02d.%03d] [%s] %s%s\n"),
+            time.GetHour(), time.GetMinute(), time.GetSecond(), time.GetMillisecond(),
+            definition ? *definition->category : TEXT("?"), definition ? GetLevelPrefix(definition->level) : TEXT(""), *text);
+    }
+    return reader.ok;
+}
@@ -0,0 +1,62 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "LogWriter.h"
+
+/*
+ * 结构化日志文件（.blog）由连续的记录组成，数值均为小端：
+ *   定义记录：u8 类型(1) | u32 格式 ID | u8 级别 | u16 分类长度 + UTF-8 | u16 格式串长度 + UTF-8
+ *   事件记录：u8 类型(2) | i64 时间(FDateTime ticks) | u32 格式 ID | u8 参数个数 | 每个参数 u8 类型标记 + 值
+ * 每个文件中某个格式 ID 的定义记录先于它的第一条事件记录写出，因此单个文件即可独立解码
+ * 参数值：Int/UInt 为 8 字节，Double 为 8 字节，Bool 为 1 字节，String 为 u16 长度 + UTF-8
+ */
+enum class EStructuredRecordType : uint8
+{
+    Definition = 1,
+    Event = 2
+};
+
+struct FStructuredLogDefinition
+{
+    FString category;
+    ELogWriterLevel level = ELogWriterLevel::Log;
+    FString format;
+};
+
+// 运行时注册的格式定义（由 FStructuredLogSite 注册），写线程写出定义记录时查询
+bool FindStructuredLogDefinition(uint32 formatId, FStructuredLogDefinition& outDefinition);
+
+void AppendDefinitionRecord(TArray<uint8>& out, uint32 formatId, const FStructuredLogDefinition& definition);
+
+// 按格式串中的 {} 依次代入参数；args 指向参数个数字段，成功时 outConsumed 为参数部分的字节数
+bool RenderStructuredArgs(const FString& format, TArrayView<const uint8> args, FString& outText, int32& outConsumed);
+
+// 离线解码：逐条读取记录并渲染为与文本日志相同格式的行
+class FStructuredLogDecoder
+{
+public:
+    // 解码 data 中的全部记录并追加到 outText；遇到损坏的数据时停止并返回 false
+    bool Decode(TArrayView<const uint8> data, FString& outText);
+
+    // 找不到定义而无法渲染的事件数
+    int32 GetUnknownEvents() const
+    {
+        return unknownEvents;
+    }
+
+private:
+    TMap<uint32, FStructuredLogDefinition> definitions;
+    int32 unknownEvents = 0;
+};
+
+// 结构化日志写线程（日志目录下的 StructuredLogs-YYYYMMDD.blog），模块加载时启动、模块卸载时停止
+void StartStructuredLog(const FString& directory);
+void ShutdownStructuredLog();
+
+// 阻塞直到此前提交的记录全部写入磁盘，最多等待 timeoutSec；同 FLogSink::Flush
+bool FlushStructuredLog(double timeoutSec = 2.0);
+
+// 当前活动的结构化日志文件
+FString GetStructuredLogFilePath();
@@ -0,0 +1,247 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/AutomationTest.h"
+#include "LogSink.h"
+#include "HAL/FileManager.h"
+#include "Async/Async.h"
+#include "Misc/Paths.h"
+#include "Misc/FileHelper.h"
+#include "HAL/ThreadSafeCounter64.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace LogSinkTest
+{
+    // 每行固定长度：15 字节时间前缀 + 84 字节内容 + 换行
+    static constexpr int32 LINE_BYTES = 100;
+
+    // 独立目录与固定时钟，测试期间不会跨天滚动
+    static FLogSinkSettings MakeSettings(const TCHAR* name)
+    {
+        FLogSinkSettings settings;
+        settings.directory = FPaths::Combine(FPaths::AutomationTransientDir(), TEXT("Logger"), name);
+        settings.compressArchives = false;
+        settings.clock = []() { return FDateTime(2026, 1, 1, 12); };
+        IFileManager::Get().DeleteDirectory(*settings.directory, false, true);
+        return settings;
+    }
+
+    static FString MakeLine(int32 index)
+    {
+        return FString::Printf(TEXT("line %08d "), index).RightPad(LINE_BYTES - 16).Left(LINE_BYTES - 16);
+    }
+
+    static int64 FileSize(const FLogSink& sink)
+    {
+        return FMath::Max<int64>(IFileManager::Get().FileSize(*sink.GetActiveFilePath()), 0);
+    }
+
+    // 等待文件达到 bytes 字节，返回耗时（秒），超时返回负数
+    static double WaitForSize(const FLogSink& sink, int64 bytes, double timeoutSec = 2.0)
+    {
+        const double start = FPlatformTime::Seconds();
+        while (FileSize(sink) < bytes)
+        {
+            if (FPlatformTime::Seconds() - start > timeoutSec)
+                return -1.0;
+            FPlatformProcess::SleepNoStats(0.0005f);
+        }
+        return FPlatformTime::Seconds() - start;
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLogSinkFlushPolicyTest, "Logger.LogSink.FlushPolicy",
+    EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FLogSinkFlushPolicyTest::RunTest(const FString& Parameters)
+{
+    using namespace LogSinkTest;
+
+    FLogSink sink;
+    sink.Start(MakeSettings(TEXT("FlushPolicy")));
+    int32 nextLine = 0;
+    int64 expectedBytes = 0;
+
+    // 普通日志不唤醒写线程，在下一次定时写盘时写出
+    sink.Enqueue(ELogWriterLevel::Log, MakeLine(nextLine++));
+    expectedBytes += LINE_BYTES;
+    const double timerLatency = WaitForSize(sink, expectedBytes);
+    if (!TestTrue(TEXT("written by the timer"), timerLatency >= 0.0))
+        return false;
+    TestTrue(TEXT("within one interval"), timerLatency < 0.2 + 0.1);
+
+    // 刚写过盘，下一次定时写盘在约 200ms 后
+    sink.Enqueue(ELogWriterLevel::Log, MakeLine(nextLine++));
+    expectedBytes += LINE_BYTES;
+    FPlatformProcess::SleepNoStats(0.05f);
+    TestEqual(TEXT("log line waits for the timer"), FileSize(sink), expectedBytes - LINE_BYTES);
+
+    // Error 立即唤醒写线程，并带出之前缓冲的普通日志
+    sink.Enqueue(ELogWriterLevel::Error, MakeLine(nextLine++));
+    expectedBytes += LINE_BYTES;
+    const double errorLatency = WaitForSize(sink, expectedBytes);
+    if (!TestTrue(TEXT("error written"), errorLatency >= 0.0))
+        return false;
+    TestTrue(TEXT("error wakes the writer"), errorLatency < 0.1);
+
+    // 积压 4096 行时提前唤醒：每满 64KB 写一次，不足 64KB 的尾部留到下一次定时写盘
+    const int32 burstLines = 4096;
+    const int32 linesPerWrite = FMath::DivideAndRoundUp(64 * 1024, LINE_BYTES);
+    const int64 burstStart = expectedBytes;
+    for (int32 i = 0; i < burstLines; i++)
+        sink.Enqueue(ELogWriterLevel::Log, MakeLine(nextLine++));
+    expectedBytes += (int64)burstLines * LINE_BYTES;
+
+    const int64 thresholdBytes = burstStart + (int64)(burstLines / linesPerWrite) * linesPerWrite * LINE_BYTES;
+    const double burstLatency = WaitForSize(sink, thresholdBytes);
+    if (!TestTrue(TEXT("burst written"), burstLatency >= 0.0))
+        return false;
+    TestTrue(TEXT("backlog wakes the writer"), burstLatency < 0.1);
+    FPlatformProcess::SleepNoStats(0.02f);
+    TestEqual(TEXT("written in 64KB batches"), FileSize(sink), thresholdBytes);
+    TestTrue(TEXT("tail written by the timer"), WaitForSize(sink, expectedBytes) >= 0.0);
+
+    // Flush 等待此前入队的日志全部写出
+    sink.Enqueue(ELogWriterLevel::Warning, MakeLine(nextLine++));
+    expectedBytes += LINE_BYTES;
+    TestTrue(TEXT("flush"), sink.Flush());
+    TestEqual(TEXT("flushed"), FileSize(sink), expectedBytes);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLogSinkRotationTest, "Logger.LogSink.Rotation",
+    EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FLogSinkRotationTest::RunTest(const FString& Parameters)
+{
+    using namespace LogSinkTest;
+
+    // 时钟由测试推进，写线程随时可能读取
+    TSharedRef<FThreadSafeCounter64, ESPMode::ThreadSafe> clockTicks = MakeShared<FThreadSafeCounter64, ESPMode::ThreadSafe>(FDateTime(2026, 1, 1, 10).GetTicks());
+    FLogSinkSettings settings = MakeSettings(TEXT("Rotation"));
+    settings.clock = [clockTicks]() { return FDateTime(clockTicks->GetValue()); };
+    // 允许的下限 64KB；超过阈值的那次写盘后滚动，写线程何时醒来会影响分段的确切大小
+    settings.maxSegmentBytes = 64 * 1024;
+
+    // 上次运行遗留的往日活动文件被归档；日期非法的同名文件被跳过
+    IFileManager::Get().MakeDirectory(*settings.directory, true);
+    FFileHelper::SaveStringToFile(TEXT("leftover\n"), *FPaths::Combine(settings.directory, TEXT("Logs-20251231.log")));
+    FFileHelper::SaveStringToFile(TEXT("bad date\n"), *FPaths::Combine(settings.directory, TEXT("Logs-20251340.log")));
+
+    FLogSink sink;
+    sink.Start(settings);
+    int32 nextLine = 0;
+    auto writeLines = [&](int32 count)
+    {
+        for (int32 i = 0; i < count; i++)
+            sink.Enqueue(ELogWriterLevel::Log, MakeLine(nextLine++));
+        return sink.Flush();
+    };
+    auto waitForSegments = [&](int32 count)
+    {
+        const double deadline = FPlatformTime::Seconds() + 2.0;
+        while (sink.GetSegments().Num() < count && FPlatformTime::Seconds() < deadline)
+            FPlatformProcess::SleepNoStats(0.001f);
+        return sink.GetSegments();
+    };
+
+    if (!TestTrue(TEXT("first line"), writeLines(1)))
+        return false;
+    TArray<FLogSegmentInfo> segments = waitForSegments(1);
+    if (!TestEqual(TEXT("leftover archived"), segments.Num(), 1))
+        return false;
+    TestTrue(TEXT("leftover day"), segments[0].day == FDateTime(2025, 12, 31));
+    TestTrue(TEXT("bad date skipped"), IFileManager::Get().FileExists(*FPaths::Combine(settings.directory, TEXT("Logs-20251340.log"))));
+
+    // 按大小滚动：超过阈值的那次写盘后归档，剩余的行写入新的活动文件
+    if (!TestTrue(TEXT("size rotation"), writeLines(700)))
+        return false;
+    segments = waitForSegments(2);
+    if (!TestEqual(TEXT("size segment"), segments.Num(), 2))
+        return false;
+    TestEqual(TEXT("size segment name"), segments[1].fileName, FString(TEXT("Logs-20260101.1.log")));
+    TestEqual(TEXT("size segment offset"), segments[1].startOffset, (int64)0);
+    TestTrue(TEXT("size segment bytes"), segments[1].rawBytes >= settings.maxSegmentBytes);
+    TestEqual(TEXT("active after size rotation"), segments[1].rawBytes + FileSize(sink), (int64)(701 * LINE_BYTES));
+
+    // 跨天：前一天的活动文件接在当天已归档分段之后
+    clockTicks->Set(FDateTime(2026, 1, 2, 0, 0, 1).GetTicks());
+    if (!TestTrue(TEXT("day rotation"), writeLines(1)))
+        return false;
+    segments = waitForSegments(3);
+    if (!TestEqual(TEXT("day segment"), segments.Num(), 3))
+        return false;
+    TestEqual(TEXT("day segment name"), segments[2].fileName, FString(TEXT("Logs-20260101.2.log")));
+    TestEqual(TEXT("day segment offset"), segments[2].startOffset, segments[1].rawBytes);
+    TestTrue(TEXT("new day active file"), sink.GetActiveFilePath().EndsWith(TEXT("Logs-20260102.log")));
+    TestEqual(TEXT("new day active bytes"), FileSize(sink), (int64)LINE_BYTES);
+
+    // 归档失败（目标名被目录占用）：继续追加到当前文件，不产生分段，到下一个阈值再重试
+    const FString blocker = FPaths::Combine(settings.directory, TEXT("Logs-20260102.1.log"));
+    IFileManager::Get().MakeDirectory(*blocker, true);
+    AddExpectedMessage(TEXT("日志分段归档失败"), ELogVerbosity::Warning, EAutomationExpectedMessageFlags::Contains, 0, false);
+    if (!TestTrue(TEXT("failed rotation"), writeLines(700)))
+        return false;
+    FPlatformProcess::SleepNoStats(0.05f);
+    TestEqual(TEXT("no segment after failure"), sink.GetSegments().Num(), 3);
+    TestEqual(TEXT("kept appending"), FileSize(sink), (int64)(701 * LINE_BYTES));
+
+    IFileManager::Get().DeleteDirectory(*blocker, false, true);
+    if (!TestTrue(TEXT("retry rotation"), writeLines(700)))
+        return false;
+    segments = waitForSegments(4);
+    if (!TestEqual(TEXT("retried segment"), segments.Num(), 4))
+        return false;
+    TestEqual(TEXT("retried segment name"), segments[3].fileName, FString(TEXT("Logs-20260102.1.log")));
+    TestEqual(TEXT("retried segment offset"), segments[3].startOffset, (int64)0);
+    TestTrue(TEXT("retried at the next threshold"), segments[3].rawBytes >= 2 * settings.maxSegmentBytes);
+    TestEqual(TEXT("active after retry"), segments[3].rawBytes + FileSize(sink), (int64)(1401 * LINE_BYTES));
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLogSinkThroughputTest, "Logger.LogSink.Throughput",
+    EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FLogSinkThroughputTest::RunTest(const FString& Parameters)
+{
+    using namespace LogSinkTest;
+
+    FLogSinkSettings settings = MakeSettings(TEXT("Throughput"));
+    settings.maxSegmentBytes = MAX_int32;
+    FLogSink sink;
+    sink.Start(settings);
+
+    // 4 个线程同时写入，统计入队耗时（调用方开销）与全部落盘的耗时
+    const int32 numThreads = 4;
+    const int32 linesPerThread = 50000;
+    const FString line = MakeLine(0);
+
+    const double start = FPlatformTime::Seconds();
+    TArray<TFuture<double>> producers;
+    for (int32 t = 0; t < numThreads; t++)
+    {
+        producers.Add(Async(EAsyncExecution::Thread, [&sink, &line, linesPerThread]()
+        {
+            const double producerStart = FPlatformTime::Seconds();
+            for (int32 i = 0; i < linesPerThread; i++)
+                sink.Enqueue(ELogWriterLevel::Log, FString(line));
+            return FPlatformTime::Seconds() - producerStart;
+        }));
+    }
+
+    double enqueueSeconds = 0.0;
+    for (TFuture<double>& producer : producers)
+        enqueueSeconds = FMath::Max(enqueueSeconds, producer.Get());
+    if (!TestTrue(TEXT("flush"), sink.Flush(30.0)))
+        return false;
+    const double totalSeconds = FPlatformTime::Seconds() - start;
+
+    const int64 totalLines = (int64)numThreads * linesPerThread;
+    TestEqual(TEXT("bytes written"), FileSize(sink), totalLines * LINE_BYTES);
+    AddInfo(FString::Printf(TEXT("%lld lines from %d threads: enqueue %.1f ns/line, written in %.3fs (%.0f lines/s, %.1f MB/s)"),
+        totalLines, numThreads, enqueueSeconds * 1e9 / linesPerThread, totalSeconds,
+        totalLines / totalSeconds, totalLines * LINE_BYTES / totalSeconds / (1024.0 * 1024.0)));
+    return true;
+}
+
+#endif
@@ -0,0 +1,298 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/AutomationTest.h"
+#include "LogUploader.h"
+#include "LogSink.h"
+#include "HAL/FileManager.h"
+#include "HAL/ThreadSafeCounter64.h"
+#include "Misc/Paths.h"
+#include "HttpServerModule.h"
+#include "HttpServerRequest.h"
+#include "HttpServerResponse.h"
+#include "HttpRouteHandle.h"
+#include "IHttpRouter.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace LogUploaderTest
+{
+    static constexpr uint32 PORT = 18731;
+    // 每行固定长度：15 字节时间前缀 + 84 字节内容 + 换行
+    static constexpr int32 LINE_BYTES = 100;
+    static constexpr double STEP_TIMEOUT_SEC = 10.0;
+
+    static FString MakeLine(int32 index)
+    {
+        return FString::Printf(TEXT("line %08d "), index).RightPad(LINE_BYTES - 16).Left(LINE_BYTES - 16);
+    }
+
+    // 一次上传的结果
+    struct FUploadResult
+    {
+        bool ok = false;
+        FString response;
+        FDateTime day;
+        int64 endOffset = 0;
+    };
+
+    // 服务端收到的文件
+    struct FReceivedFile
+    {
+        FString fileName;
+        FString content;
+    };
+
+    // 各步骤共享的状态；HTTP 回调与服务端路由都在游戏线程执行
+    struct FState
+    {
+        FLogSink sink;
+        TSharedRef<FThreadSafeCounter64, ESPMode::ThreadSafe> clockTicks = MakeShared<FThreadSafeCounter64, ESPMode::ThreadSafe>(FDateTime(2026, 1, 1, 12).GetTicks());
+        TSharedPtr<IHttpRouter> router;
+        FHttpRouteHandle route;
+
+        int32 nextLine = 0;
+        TArray<FReceivedFile> received;
+        TArray<FUploadResult> results;
+        int32 pending = 0;
+        double stepStart = 0.0;
+
+        // 上次成功上传的位置
+        FDateTime uploadedDay;
+        int64 uploadedOffset = 0;
+
+        // 写入 count 行，返回它们在上传内容中的文本（时钟固定在整点）
+        FString WriteLines(int32 count)
+        {
+            FString text;
+            const FDateTime now(clockTicks->GetValue());
+            for (int32 i = 0; i < count; i++)
+            {
+                const FString line = MakeLine(nextLine++);
+                text += FString::Printf(TEXT("[%02d:%02d:%02d.%03d] %s\n"), now.GetHour(), now.GetMinute(), now.GetSecond(), now.GetMillisecond(), *line);
+                sink.Enqueue(ELogWriterLevel::Log, FString(line));
+            }
+            return text;
+        }
+
+        bool Upload(bool resume)
+        {
+            FLogUploadParams params;
+            params.url = FString::Printf(TEXT("http://127.0.0.1:%u/upload"), PORT);
+            params.sink = &sink;
+            if (resume)
+            {
+                params.resumeDay = uploadedDay;
+                params.resumeOffset = uploadedOffset;
+            }
+            params.onComplete = [this](bool ok, const FString& response, const FDateTime& day, int64 endOffset)
+            {
+                results.Add({ ok, response, day, endOffset });
+                if (ok)
+                {
+                    uploadedDay = day;
+                    uploadedOffset = endOffset;
+                }
+                pending--;
+            };
+
+            if (!FLogUploader::Upload(MoveTemp(params)))
+                return false;
+            pending++;
+            stepStart = FPlatformTime::Seconds();
+            return true;
+        }
+
+        // 等待进行中的上传全部完成；超时返回 true 以继续执行后续步骤（含清理），并记录错误
+        bool WaitForUploads(FAutomationTestBase& test)
+        {
+            if (pending == 0)
+                return true;
+            if (FPlatformTime::Seconds() - stepStart > STEP_TIMEOUT_SEC)
+            {
+                test.AddError(TEXT("upload timed out"));
+                pending = 0;
+                return true;
+            }
+            return false;
+        }
+    };
+
+    // multipart/form-data：取出文件名与文件内容
+    static bool ParseMultipart(const TArray<uint8>& body, FReceivedFile& out)
+    {
+        FUTF8ToTCHAR converter((const ANSICHAR*)body.GetData(), body.Num());
+        const FString text(converter.Length(), converter.Get());
+        const int32 contentStart = text.Find(TEXT("\r\n\r\n"));
+        const int32 contentEnd = text.Find(TEXT("\r\n--"), ESearchCase::CaseSensitive, ESearchDir::FromEnd);
+        const int32 nameStart = text.Find(TEXT("filename=\""));
+        if (contentStart == INDEX_NONE || contentEnd < contentStart + 4 || nameStart == INDEX_NONE)
+            return false;
+
+        const int32 nameEnd = text.Find(TEXT("\""), ESearchCase::CaseSensitive, ESearchDir::FromStart, nameStart + 10);
+        out.fileName = text.Mid(nameStart + 10, nameEnd - nameStart - 10);
+        out.content = text.Mid(contentStart + 4, contentEnd - contentStart - 4);
+        return true;
+    }
+
+    static bool Contains(const TArray<FLogSegmentInfo>& segments, const FDateTime& day)
+    {
+        return segments.ContainsByPredicate([&](const FLogSegmentInfo& segment) { return segment.day == day; });
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLogUploaderResumeTest, "Logger.LogUploader.Resume",
+    EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FLogUploaderResumeTest::RunTest(const FString& Parameters)
+{
+    using namespace LogUploaderTest;
+
+    TSharedRef<FState> state = MakeShared<FState>();
+    state->router = FHttpServerModule::Get().GetHttpRouter(PORT, true);
+    if (!TestTrue(TEXT("router"), state->router.IsValid()))
+        return false;
+    state->route = state->router->BindRoute(FHttpPath(TEXT("/upload")), EHttpServerRequestVerbs::VERB_POST,
+        FHttpRequestHandler::CreateLambda([state](const FHttpServerRequest& request, const FHttpResultCallback& onComplete)
+    {
+        FReceivedFile file;
+        const bool parsed = ParseMultipart(request.Body, file);
+        state->received.Add(MoveTemp(file));
+        onComplete(FHttpServerResponse::Create(parsed ? TEXT("{\"errcode\":0}") : TEXT("{\"errcode\":1}"), TEXT("application/json")));
+        return true;
+    }));
+    FHttpServerModule::Get().StartAllListeners();
+
+    // 64KB 即滚动，归档分段在后台压缩，续传时需从 .gz 中取出剩余部分
+    FLogSinkSettings settings;
+    settings.directory = FPaths::Combine(FPaths::AutomationTransientDir(), TEXT("Logger"), TEXT("Upload"));
+    settings.maxSegmentBytes = 64 * 1024;
+    settings.clock = [clockTicks = state->clockTicks]() { return FDateTime(clockTicks->GetValue()); };
+    IFileManager::Get().DeleteDirectory(*settings.directory, false, true);
+    state->sink.Start(settings);
+
+    // 1. 首次上传：当天的完整日志
+    TSharedRef<FString> expected = MakeShared<FString>(state->WriteLines(10));
+    TestTrue(TEXT("first upload"), state->Upload(false));
+
+    ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([this, state, expected]()
+    {
+        if (!state->WaitForUploads(*this))
+            return false;
+        if (TestEqual(TEXT("first received"), state->received.Num(), 1) && TestEqual(TEXT("first result"), state->results.Num(), 1))
+        {
+            TestTrue(TEXT("first ok"), state->results[0].ok);
+            TestTrue(TEXT("first day"), state->results[0].day == FDateTime(2026, 1, 1));
+            TestEqual(TEXT("first end offset"), state->results[0].endOffset, (int64)10 * LINE_BYTES);
+            TestEqual(TEXT("first file name"), state->received[0].fileName, FString(TEXT("Logs-20260101.log")));
+            TestTrue(TEXT("first content"), state->received[0].content == *expected);
+        }
+
+        // 2. 两次上传之间按大小滚动：同名的新活动文件不能套用旧偏移，归档分段的剩余部分先上传
+        *expected = state->WriteLines(1000);
+        TestTrue(TEXT("flush"), state->sink.Flush());
+        state->stepStart = FPlatformTime::Seconds();
+        return true;
+    }));
+
+    ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([this, state, expected]()
+    {
+        // 写线程在写盘后滚动，等分段记入索引
+        if (state->sink.GetSegments().Num() == 0 && FPlatformTime::Seconds() - state->stepStart < STEP_TIMEOUT_SEC)
+            return false;
+        TestTrue(TEXT("rotated by size"), state->sink.GetSegments().Num() > 0);
+        TestTrue(TEXT("resume after rotation"), state->Upload(true));
+        return true;
+    }));
+
+    ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([this, state, expected]()
+    {
+        if (!state->WaitForUploads(*this))
+            return false;
+        if (TestEqual(TEXT("second received"), state->received.Num(), 2) && TestEqual(TEXT("second result"), state->results.Num(), 2))
+        {
+            TestTrue(TEXT("second ok"), state->results[1].ok);
+            TestEqual(TEXT("second end offset"), state->results[1].endOffset, (int64)1010 * LINE_BYTES);
+            TestEqual(TEXT("second file name"), state->received[1].fileName, FString::Printf(TEXT("Logs-20260101.from-%d.log"), 10 * LINE_BYTES));
+            TestEqual(TEXT("second length"), state->received[1].content.Len(), expected->Len());
+            TestTrue(TEXT("second content"), state->received[1].content == *expected);
+        }
+
+        // 3. 两次上传之间跨天：前一天剩余的内容与新一天的日志一起上传
+        *expected = state->WriteLines(5);
+        state->clockTicks->Set(FDateTime(2026, 1, 2, 12).GetTicks());
+        *expected += state->WriteLines(7);
+        TestTrue(TEXT("flush"), state->sink.Flush());
+        state->stepStart = FPlatformTime::Seconds();
+        return true;
+    }));
+
+    ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([this, state, expected]()
+    {
+        FString activePath;
+        FDateTime day;
+        int64 activeStart = 0;
+        state->sink.GetActiveFile(activePath, day, activeStart);
+        if (day != FDateTime(2026, 1, 2) && FPlatformTime::Seconds() - state->stepStart < STEP_TIMEOUT_SEC)
+            return false;
+        TestTrue(TEXT("rotated by day"), day == FDateTime(2026, 1, 2));
+        TestTrue(TEXT("resume after day change"), state->Upload(true));
+        return true;
+    }));
+
+    ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([this, state, expected]()
+    {
+        if (!state->WaitForUploads(*this))
+            return false;
+        if (TestEqual(TEXT("third received"), state->received.Num(), 3) && TestEqual(TEXT("third result"), state->results.Num(), 3))
+        {
+            TestTrue(TEXT("third ok"), state->results[2].ok);
+            TestTrue(TEXT("third day"), state->results[2].day == FDateTime(2026, 1, 2));
+            TestEqual(TEXT("third end offset"), state->results[2].endOffset, (int64)7 * LINE_BYTES);
+            TestEqual(TEXT("third file name"), state->received[2].fileName, FString::Printf(TEXT("Logs-20260102.from-20260101-%d.log"), 1010 * LINE_BYTES));
+            TestTrue(TEXT("third content"), state->received[2].content == *expected);
+            TestTrue(TEXT("previous day archived"), Contains(state->sink.GetSegments(), FDateTime(2026, 1, 1)));
+        }
+
+        // 4. 没有新内容时不上传，续传位置不变
+        TestTrue(TEXT("nothing new"), state->Upload(true));
+        return true;
+    }));
+
+    ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([this, state, expected]()
+    {
+        if (!state->WaitForUploads(*this))
+            return false;
+        if (TestEqual(TEXT("nothing new result"), state->results.Num(), 4))
+        {
+            TestFalse(TEXT("nothing new fails"), state->results[3].ok);
+            TestEqual(TEXT("nothing new end offset"), state->results[3].endOffset, (int64)7 * LINE_BYTES);
+        }
+        TestEqual(TEXT("nothing new not sent"), state->received.Num(), 3);
+
+        // 5. 并发上限：第三个同时进行的上传被拒绝，前两个正常完成
+        AddExpectedMessage(TEXT("同时进行的日志上传已达上限"), ELogVerbosity::Warning, EAutomationExpectedMessageFlags::Contains, 1, false);
+        TestTrue(TEXT("concurrent 1"), state->Upload(false));
+        TestTrue(TEXT("concurrent 2"), state->Upload(false));
+        TestFalse(TEXT("concurrent limit"), state->Upload(false));
+        TestEqual(TEXT("active uploads"), FLogUploader::GetActiveUploads(), FLogUploader::MAX_CONCURRENT_UPLOADS);
+        return true;
+    }));
+
+    ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([this, state]()
+    {
+        if (!state->WaitForUploads(*this))
+            return false;
+        TestEqual(TEXT("concurrent results"), state->results.Num(), 6);
+        for (int32 i = 4; i < state->results.Num(); i++)
+            TestTrue(TEXT("concurrent ok"), state->results[i].ok);
+        TestEqual(TEXT("concurrent received"), state->received.Num(), 5);
+        TestEqual(TEXT("no active uploads"), FLogUploader::GetActiveUploads(), 0);
+
+        state->router->UnbindRoute(state->route);
+        state->sink.Shutdown();
+        return true;
+    }));
+    return true;
+}
+
+#endif
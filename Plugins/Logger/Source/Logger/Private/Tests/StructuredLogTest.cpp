@@ -0,0 +1,172 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/AutomationTest.h"
+#include "StructuredLog.h"
+#include "StructuredLogFormat.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Guid.h"
+#include "Misc/ScopeExit.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+LOGWRITER_DEFINE_CATEGORY(StructuredLogTest, Log);
+
+namespace StructuredLogTest
+{
+    static constexpr TCHAR VALUES_FORMAT[] = TEXT("{} int={} uint={} double={} bool={} name={} level={}");
+    static constexpr TCHAR FILTERED_FORMAT[] = TEXT("{} filtered");
+    static constexpr TCHAR WARNING_FORMAT[] = TEXT("{} warning");
+
+    // 读出 offset 之后写入的记录；此前的会话可能已写过本测试的格式定义，先补上定义使片段可以独立解码
+    static bool DecodeSince(int64 offset, FString& outText)
+    {
+        TArray<uint8> file;
+        if (!FFileHelper::LoadFileToArray(file, *GetStructuredLogFilePath()) || offset > file.Num())
+            return false;
+
+        TArray<uint8> data;
+        for (const TCHAR* format : { VALUES_FORMAT, FILTERED_FORMAT, WARNING_FORMAT })
+        {
+            const ELogWriterLevel level = format == WARNING_FORMAT ? ELogWriterLevel::Warning : ELogWriterLevel::Log;
+            const uint32 formatId = UE::LogWriter::MakeFormatId(TEXT("StructuredLogTest"), level, format);
+            FStructuredLogDefinition definition;
+            if (FindStructuredLogDefinition(formatId, definition))
+                AppendDefinitionRecord(data, formatId, definition);
+        }
+        data.Append(file.GetData() + offset, file.Num() - (int32)offset);
+
+        FStructuredLogDecoder decoder;
+        return decoder.Decode(data, outText) && decoder.GetUnknownEvents() == 0;
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStructuredLogRoundTripTest, "Logger.StructuredLog.RoundTrip",
+    EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FStructuredLogRoundTripTest::RunTest(const FString& Parameters)
+{
+    using namespace StructuredLogTest;
+
+    // 格式 ID 区分分类、级别与格式串
+    const uint32 formatId = UE::LogWriter::MakeFormatId(TEXT("StructuredLogTest"), ELogWriterLevel::Log, VALUES_FORMAT);
+    TestNotEqual(TEXT("id depends on the category"), formatId, UE::LogWriter::MakeFormatId(TEXT("Default"), ELogWriterLevel::Log, VALUES_FORMAT));
+    TestNotEqual(TEXT("id depends on the level"), formatId, UE::LogWriter::MakeFormatId(TEXT("StructuredLogTest"), ELogWriterLevel::Warning, VALUES_FORMAT));
+    TestNotEqual(TEXT("id depends on the format"), formatId, UE::LogWriter::MakeFormatId(TEXT("StructuredLogTest"), ELogWriterLevel::Log, FILTERED_FORMAT));
+
+    // 分类按名称查找时忽略大小写
+    TestTrue(TEXT("find category"), FStructuredLogCategory::Find(TEXT("structuredlogtest")) == &LogWriterCategory_StructuredLogTest);
+    TestNull(TEXT("unknown category"), FStructuredLogCategory::Find(TEXT("StructuredLogTestMissing")));
+
+    // 测试期间不回显到 UE_LOG，结束时恢复分类级别与回显级别
+    const ELogWriterLevel echoLevel = UE::LogWriter::GetEchoLevel();
+    UE::LogWriter::SetEchoLevel(ELogWriterLevel::Off);
+    ON_SCOPE_EXIT
+    {
+        UE::LogWriter::SetEchoLevel(echoLevel);
+        LogWriterCategory_StructuredLogTest.SetMinLevel(ELogWriterLevel::Log);
+    };
+
+    if (!TestTrue(TEXT("flush before"), FlushStructuredLog()))
+        return false;
+    const int64 offset = FMath::Max<int64>(IFileManager::Get().FileSize(*GetStructuredLogFilePath()), 0);
+
+    // 唯一标记，避免与同一文件中其他会话写入的记录混淆
+    const FString marker = FGuid::NewGuid().ToString();
+    LOGWRITER_LOG(StructuredLogTest, Log, VALUES_FORMAT, marker, -3, 7u, 2.5, true, FName(TEXT("Tracker")), ELogWriterLevel::Warning);
+
+    // 分类级别提高到 Warning 后，Log 调用点被过滤，Warning 照常写入
+    LogWriterCategory_StructuredLogTest.SetMinLevel(ELogWriterLevel::Warning);
+    TestFalse(TEXT("log disabled"), LogWriterCategory_StructuredLogTest.IsEnabled(ELogWriterLevel::Log));
+    TestTrue(TEXT("warning enabled"), LogWriterCategory_StructuredLogTest.IsEnabled(ELogWriterLevel::Warning));
+    LOGWRITER_LOG(StructuredLogTest, Log, FILTERED_FORMAT, marker);
+    LOGWRITER_LOG(StructuredLogTest, Warning, WARNING_FORMAT, marker);
+
+    if (!TestTrue(TEXT("flush after"), FlushStructuredLog()))
+        return false;
+    FString text;
+    if (!TestTrue(TEXT("decode"), DecodeSince(offset, text)))
+        return false;
+
+    TestTrue(TEXT("values"), text.Contains(FString::Printf(TEXT("] [StructuredLogTest] %s int=-3 uint=7 double=2.5 bool=true name=Tracker level=1\n"), *marker)));
+    TestTrue(TEXT("warning"), text.Contains(FString::Printf(TEXT("] [StructuredLogTest] Warning: %s warning\n"), *marker)));
+    TestFalse(TEXT("filtered"), text.Contains(FString::Printf(TEXT("%s filtered"), *marker)));
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStructuredLogThroughputTest, "Logger.StructuredLog.Throughput",
+    EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FStructuredLogThroughputTest::RunTest(const FString& Parameters)
+{
+    using namespace StructuredLogTest;
+
+    const int32 iterations = 1000000;
+    const uint32 formatId = UE::LogWriter::MakeFormatId(TEXT("StructuredLogTest"), ELogWriterLevel::Log, VALUES_FORMAT);
+    const FString marker = TEXT("bench");
+    const FName name(TEXT("Tracker"));
+
+    // 编码：调用方线程上按值捕获参数的开销（不含入队）
+    TArray<uint8> data;
+    FStructuredLogDefinition definition;
+    definition.category = TEXT("StructuredLogTest");
+    definition.format = VALUES_FORMAT;
+    AppendDefinitionRecord(data, formatId, definition);
+    const int32 headerBytes = data.Num();
+    const int64 ticks = FDateTime(2026, 1, 1, 12).GetTicks();
+
+    double start = FPlatformTime::Seconds();
+    int64 encodedBytes = 0;
+    for (int32 i = 0; i < iterations; i++)
+    {
+        UE::LogWriter::FRecordBuffer record;
+        UE::LogWriter::AppendRaw(record, formatId);
+        record.Add(7);
+        UE::LogWriter::AppendArg(record, marker);
+        UE::LogWriter::AppendArg(record, i);
+        UE::LogWriter::AppendArg(record, (uint32)i);
+        UE::LogWriter::AppendArg(record, i * 0.5);
+        UE::LogWriter::AppendArg(record, (i & 1) != 0);
+        UE::LogWriter::AppendArg(record, name);
+        UE::LogWriter::AppendArg(record, ELogWriterLevel::Warning);
+        encodedBytes += record.Num();
+
+        // 保留一部分作为解码输入
+        if (i < iterations / 10)
+        {
+            data.Add((uint8)EStructuredRecordType::Event);
+            data.Append((const uint8*)&ticks, sizeof(ticks));
+            data.Append(record.GetData(), record.Num());
+        }
+    }
+    const double encodeSeconds = FPlatformTime::Seconds() - start;
+    TestTrue(TEXT("encoded"), encodedBytes > 0);
+
+    // 被分类级别过滤的调用点只有一次原子读
+    LogWriterCategory_StructuredLogTest.SetMinLevel(ELogWriterLevel::Off);
+    ON_SCOPE_EXIT
+    {
+        LogWriterCategory_StructuredLogTest.SetMinLevel(ELogWriterLevel::Log);
+    };
+    start = FPlatformTime::Seconds();
+    for (int32 i = 0; i < iterations; i++)
+        LOGWRITER_LOG(StructuredLogTest, Log, FILTERED_FORMAT, i);
+    const double filteredSeconds = FPlatformTime::Seconds() - start;
+
+    // 解码：渲染为文本行
+    const int32 decodedRecords = iterations / 10;
+    FString text;
+    FStructuredLogDecoder decoder;
+    start = FPlatformTime::Seconds();
+    const bool decoded = decoder.Decode(data, text);
+    const double decodeSeconds = FPlatformTime::Seconds() - start;
+    TestTrue(TEXT("decode"), decoded);
+    TestEqual(TEXT("unknown events"), decoder.GetUnknownEvents(), 0);
+
+    AddInfo(FString::Printf(TEXT("encode %.1f ns/record (%.1f bytes), filtered call %.2f ns, decode %.0f records/s (%.1f MB/s)"),
+        encodeSeconds * 1e9 / iterations, (double)encodedBytes / iterations, filteredSeconds * 1e9 / iterations,
+        decodedRecords / decodeSeconds, (data.Num() - headerBytes) / decodeSeconds / (1024.0 * 1024.0)));
+    return true;
+}
+
+#endif
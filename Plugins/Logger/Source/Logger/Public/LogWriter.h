@@ -8,6 +8,16 @@
 #include "Misc/ScopeLock.h"
 #include "LogWriter.generated.h"
 
+UENUM(BlueprintType)
+enum class ELogWriterLevel : uint8
+{
+    Log,
+    Warning,
+    Error,
+    // 仅用于级别阈值：关闭全部输出
+    Off
+};
+
 /**
  * 
  */
@@ -26,28 +36,38 @@ public:
     UFUNCTION(BlueprintCallable, Category = "Logger")
         void Error(const FString& message);
 
+    // 设置分类的最低输出级别（运行时生效，低于该级别的日志在格式化前即被丢弃）；蓝图日志属于 Default 分类
+    // 返回 false 表示分类不存在
+    UFUNCTION(BlueprintCallable, Category = "Logger")
+        bool SetCategoryLevel(const FString& category, ELogWriterLevel minLevel);
+
+    // 设置同时输出到 UE_LOG 的最低级别，Off 表示只写日志文件
+    UFUNCTION(BlueprintCallable, Category = "Logger")
+        void SetEchoLevel(ELogWriterLevel minLevel);
+
     // 设置企业微信机器人 Webhook（需是完整 URL，例如：https://qyapi.weixin.qq.com/cgi-bin/webhook/send?key=XXXXXX）
     // 用法：在调用发送接口前先设置 Webhook；若未设置则发送会告警并退出
     UFUNCTION(BlueprintCallable, Category = "Logger")
         void SetWeComWebhook(const FString& webhookUrl);
 
-    // 向企业微信机器人发送当天的日志文件（异步）：
+    // 向企业微信机器人发送当前的活动日志文件（异步）：
     // 1) 解析 webhook 中的 key；2) 调用 upload_media 上传文件获取 media_id；3) 使用 webhook 发送 file 消息
+    // compress 为 true 时以 gzip 上传；onlyNewContent 为 true 时只上传上次成功上传之后追加的内容（含其间滚动出的归档分段），否则上传当天的完整日志
+    // 文件在后台线程分块读取，同时进行的上传数量有上限，超出时告警并放弃本次上传
     UFUNCTION(BlueprintCallable, Category = "Logger")
-        void SendLogFileToWeCom();
+        void SendLogFileToWeCom(bool compress = false, bool onlyNewContent = false);
 
 private:
-    // 所有日志统一写入该文件（按日期生成），不区分 Log/Warning/Error
-    FString combinedFilePath;
-
     // 企业微信机器人 webhook
     FString wecomWebhook;
     FCriticalSection writeLock;
+    // 上次成功上传覆盖到的日期与当天日志的结束偏移（按当天全部分段拼接计算），用于续传
+    FDateTime uploadedDay;
+    int64 uploadedOffset = 0;
 
     void Initialize();
-    void WriteLine(const FString& content, const FString& filePath);
-    void EnsureFilePathInitialized(FString& filePath);
-    FString GetTodayLogFilePath() const;
+    // 只入队，写盘由后台线程完成
+    void WriteLine(ELogWriterLevel level, const FString& content);
 
     // 从 webhook URL 中解析 key 参数，用于上传文件接口
     bool ParseWeComKeyFromWebhook(const FString& webhook, FString& outKey) const;
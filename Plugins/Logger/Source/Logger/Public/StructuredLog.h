@@ -0,0 +1,175 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "LogWriter.h"
+#include <atomic>
+
+/*
+ * 结构化日志（仅 C++）：
+ *   LOGWRITER_DEFINE_CATEGORY(Network, Log);                     // 在某个 .cpp 中定义分类及默认级别
+ *   LOGWRITER_LOG(Network, Warning, TEXT("重连 {} 次，耗时 {}s"), attempts, seconds);
+ * 先检查分类的运行时级别，未开启时只有一次原子读；开启时按值捕获参数写入紧凑的二进制记录，
+ * 格式串只以编译期算出的 ID 引用，格式化推迟到离线解码（DecodeLog 命令行工具）或回显 UE_LOG 时在写线程完成
+ * 记录写入日志目录下的 StructuredLogs-YYYYMMDD.blog，滚动与保留策略同文本日志
+ */
+
+// 一个日志分类，运行时级别可通过 ULogWriter::SetCategoryLevel 调整
+class LOGGER_API FStructuredLogCategory
+{
+public:
+    FStructuredLogCategory(const TCHAR* inName, ELogWriterLevel defaultLevel);
+
+    FORCEINLINE bool IsEnabled(ELogWriterLevel level) const
+    {
+        return (uint8)level >= minLevel.load(std::memory_order_relaxed);
+    }
+
+    void SetMinLevel(ELogWriterLevel level)
+    {
+        minLevel.store((uint8)level, std::memory_order_relaxed);
+    }
+
+    const TCHAR* GetName() const
+    {
+        return name;
+    }
+
+    // 按名称查找分类（忽略大小写），不存在时返回 nullptr
+    static FStructuredLogCategory* Find(const TCHAR* categoryName);
+
+private:
+    const TCHAR* name;
+    std::atomic<uint8> minLevel;
+    // 全部分类组成的单链表，静态初始化时注册，不分配内存
+    FStructuredLogCategory* next;
+};
+
+// 一个日志调用点：首次执行时注册格式串，写线程据此在每个日志文件中写出一次格式定义
+class LOGGER_API FStructuredLogSite
+{
+public:
+    FStructuredLogSite(uint32 inFormatId, const FStructuredLogCategory& inCategory, ELogWriterLevel inLevel, const TCHAR* inFormat);
+
+    uint32 formatId;
+    const FStructuredLogCategory& category;
+    ELogWriterLevel level;
+    const TCHAR* format;
+};
+
+namespace UE::LogWriter
+{
+    // 参数的类型标记
+    enum class EArgTag : uint8
+    {
+        Int = 1,
+        UInt = 2,
+        Double = 3,
+        Bool = 4,
+        String = 5
+    };
+
+    // 格式 ID：对分类名、级别与格式串做 FNV-1a 哈希，编译期算出
+    constexpr uint32 HashFormatText(uint32 hash, const TCHAR* text)
+    {
+        for (; *text; text++)
+            hash = (hash ^ (uint32)*text) * 16777619u;
+        return hash;
+    }
+
+    constexpr uint32 MakeFormatId(const TCHAR* category, ELogWriterLevel level, const TCHAR* format)
+    {
+        return HashFormatText((HashFormatText(2166136261u, category) ^ (uint32)level) * 16777619u, format);
+    }
+
+    typedef TArray<uint8, TInlineAllocator<128>> FRecordBuffer;
+
+    template<typename T>
+    FORCEINLINE void AppendRaw(FRecordBuffer& out, T value)
+    {
+        out.Append((const uint8*)&value, sizeof(T));
+    }
+
+    FORCEINLINE void AppendArg(FRecordBuffer& out, bool value)
+    {
+        out.Add((uint8)EArgTag::Bool);
+        out.Add(value ? 1 : 0);
+    }
+
+    FORCEINLINE void AppendArg(FRecordBuffer& out, double value)
+    {
+        out.Add((uint8)EArgTag::Double);
+        AppendRaw(out, value);
+    }
+
+    FORCEINLINE void AppendArg(FRecordBuffer& out, float value)
+    {
+        AppendArg(out, (double)value);
+    }
+
+    template<typename T>
+    FORCEINLINE typename TEnableIf<TIsIntegral<T>::Value && TIsSigned<T>::Value>::Type AppendArg(FRecordBuffer& out, T value)
+    {
+        out.Add((uint8)EArgTag::Int);
+        AppendRaw(out, (int64)value);
+    }
+
+    template<typename T>
+    FORCEINLINE typename TEnableIf<TIsIntegral<T>::Value && !TIsSigned<T>::Value>::Type AppendArg(FRecordBuffer& out, T value)
+    {
+        out.Add((uint8)EArgTag::UInt);
+        AppendRaw(out, (uint64)value);
+    }
+
+    template<typename T>
+    FORCEINLINE typename TEnableIf<TIsEnum<T>::Value>::Type AppendArg(FRecordBuffer& out, T value)
+    {
+        AppendArg(out, (int64)value);
+    }
+
+    // 字符串：u16 长度 + UTF-8
+    LOGGER_API void AppendArg(FRecordBuffer& out, const TCHAR* value);
+    LOGGER_API void AppendArg(FRecordBuffer& out, const FString& value);
+    LOGGER_API void AppendArg(FRecordBuffer& out, const FName& value);
+
+    // 提交一条记录（写线程补上时间戳）
+    LOGGER_API void SubmitRecord(const FStructuredLogSite& site, FRecordBuffer& record);
+
+    // 记录体：u32 格式 ID | u8 参数个数 | 每个参数 u8 类型标记 + 值
+    template<typename... ArgTypes>
+    void WriteRecord(const FStructuredLogSite& site, const ArgTypes&... args)
+    {
+        static_assert(sizeof...(ArgTypes) <= 255, "too many log arguments");
+
+        FRecordBuffer record;
+        AppendRaw(record, site.formatId);
+        record.Add((uint8)sizeof...(ArgTypes));
+        (AppendArg(record, args), ...);
+        SubmitRecord(site, record);
+    }
+
+    // 高于等于该级别的日志同时输出到 UE_LOG（默认 Log，即全部输出）
+    LOGGER_API void SetEchoLevel(ELogWriterLevel level);
+    LOGGER_API ELogWriterLevel GetEchoLevel();
+}
+
+#define LOGWRITER_DECLARE_CATEGORY_EXTERN(Name) \
+    extern FStructuredLogCategory LogWriterCategory_##Name;
+
+#define LOGWRITER_DEFINE_CATEGORY(Name, DefaultLevel) \
+    FStructuredLogCategory LogWriterCategory_##Name(TEXT(#Name), ELogWriterLevel::DefaultLevel)
+
+#define LOGWRITER_LOG(Category, Level, Format, ...) \
+    do \
+    { \
+        if (LogWriterCategory_##Category.IsEnabled(ELogWriterLevel::Level)) \
+        { \
+            static constexpr uint32 LogWriterFormatId = UE::LogWriter::MakeFormatId(TEXT(#Category), ELogWriterLevel::Level, Format); \
+            static const FStructuredLogSite LogWriterSite(LogWriterFormatId, LogWriterCategory_##Category, ELogWriterLevel::Level, Format); \
+            UE::LogWriter::WriteRecord(LogWriterSite, ##__VA_ARGS__); \
+        } \
+    } while (0)
+
+// 蓝图 Log/Warning/Error 使用的分类
+extern LOGGER_API FStructuredLogCategory LogWriterCategory_Default;
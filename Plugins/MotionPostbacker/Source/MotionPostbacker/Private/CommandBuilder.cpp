@@ -3,6 +3,7 @@
 
 #include "CommandBuilder.h"
 #include "CommandResolver.h"
+#include "TrackerWriter.h"
 #include "Json.h"
 #include "JsonUtilities.h"
 
@@ -16,13 +17,13 @@ static void CleanJson(FString& s)
 		s.Append(TEXT("\r\n"));
 }
 
-FString UCommandBuilder::GlobalConfigCommand(const FString& clipperSn, const FString& dummySn)
+FString UCommandBuilder::GlobalConfigCommand(const FString& clipperSn, const FString& dummySn, int32 fps)
 {
     FString outJson;
 
 	TSharedPtr<FJsonObject> root = MakeShareable(new FJsonObject());
 	root->SetStringField(TEXT("cmd"), TEXT("rescueAppConfig"));
-	root->SetNumberField(TEXT("fps"), 60);
+	root->SetNumberField(TEXT("fps"), fps);
 	root->SetNumberField(TEXT("engine"), 1);
 	root->SetStringField(TEXT("asepticClipper"), clipperSn);
 	root->SetStringField(TEXT("dummy"), dummySn);
@@ -158,93 +159,47 @@ FString UCommandBuilder::AnalysisCommand(EMotionType motionType)
     return outJson;
 }
 
-FString UCommandBuilder::TrackerDatas(const TArray<FTrackerData>& trackers)
+// 追踪器上报的前置条件：正在分析、当前模式需要上报且 bizId 有效
+static bool GetTrackerReportContext(EMotionType& outMode, FString& outBizId)
 {
-	FString outJson;
-
-	auto resolver = UCommandResolver::GetResolver();
+	UCommandResolver* resolver = UCommandResolver::GetResolver();
 #if !WITH_EDITOR
     if (!resolver->IsAnalyzing())
-		return outJson;
+		return false;
 #endif
 
-	TSharedPtr<FJsonObject> root = MakeShareable(new FJsonObject());
-	auto mode = resolver->GetCurrentMode();
-	switch (mode)
-	{
-		case EMotionType::Trajectory:
-			root->SetStringField(TEXT("cmd"), TEXT("trajectoryAnalysis"));
-			break;
+	outMode = resolver->GetCurrentMode();
+	if (!GetTrackerReportCmd(outMode))
+		return false;
 
-		case EMotionType::ZShape:
-			root->SetStringField(TEXT("cmd"), TEXT("zshapeTrajectoryAnalysis"));
-			break;
+	outBizId = resolver->GetBizId();
+	return !outBizId.IsEmpty();
+}
 
-		default:
-			return outJson;
-	}
-	const FString bizId = resolver ? resolver->GetBizId() : FString();
-	if (bizId.IsEmpty())
-		return outJson;
-	root->SetStringField(TEXT("bizId"), bizId);
-	root->SetStringField(TEXT("action"), TEXT("trReport"));
-	const int64 TimestampMs = static_cast<int64>((FDateTime::UtcNow() - FDateTime(1970,1,1)).GetTotalMilliseconds());
-	root->SetNumberField(TEXT("stamp"), (double)TimestampMs);
+FString UCommandBuilder::TrackerDatas(const TArray<FTrackerData>& trackers)
+{
+	// 每个线程复用一份 UTF-8 缓冲区，逐帧调用不再重复分配
+	static thread_local TArray<uint8> buffer;
+	if (!TrackerDatasBytes(trackers, buffer, false))
+		return FString();
 
-	TArray<TSharedPtr<FJsonValue>> trackersArray;
-	trackersArray.Reserve(trackers.Num());
+	FUTF8ToTCHAR converter((const ANSICHAR*)buffer.GetData(), buffer.Num());
+	return FString(converter.Length(), converter.Get());
+}
 
-	for (const FTrackerData& t : trackers)
-	{
-		TSharedPtr<FJsonObject> tObj = MakeShareable(new FJsonObject());
-		tObj->SetStringField(TEXT("sn"), t.sn);
-
-		// lt: [x, y, z]
-		{
-			TArray<TSharedPtr<FJsonValue>> ltArr;
-			ltArr.Add(MakeShareable(new FJsonValueNumber(t.lt.X)));
-			ltArr.Add(MakeShareable(new FJsonValueNumber(t.lt.Y)));
-			ltArr.Add(MakeShareable(new FJsonValueNumber(t.lt.Z)));
-			tObj->SetArrayField(TEXT("lt"), ltArr);
-		}
-
-		// lr: [x, y, z, w]
-		{
-			TArray<TSharedPtr<FJsonValue>> lrArr;
-			lrArr.Add(MakeShareable(new FJsonValueNumber(t.lr.X)));
-			lrArr.Add(MakeShareable(new FJsonValueNumber(t.lr.Y)));
-			lrArr.Add(MakeShareable(new FJsonValueNumber(t.lr.Z)));
-			lrArr.Add(MakeShareable(new FJsonValueNumber(t.lr.W)));
-			tObj->SetArrayField(TEXT("lr"), lrArr);
-		}
-
-		// gt: [x, y, z]
-		{
-			TArray<TSharedPtr<FJsonValue>> gtArr;
-			gtArr.Add(MakeShareable(new FJsonValueNumber(t.gt.X)));
-			gtArr.Add(MakeShareable(new FJsonValueNumber(t.gt.Y)));
-			gtArr.Add(MakeShareable(new FJsonValueNumber(t.gt.Z)));
-			tObj->SetArrayField(TEXT("gt"), gtArr);
-		}
-
-		// gr: [x, y, z, w]
-		{
-			TArray<TSharedPtr<FJsonValue>> grArr;
-			grArr.Add(MakeShareable(new FJsonValueNumber(t.gr.X)));
-			grArr.Add(MakeShareable(new FJsonValueNumber(t.gr.Y)));
-			grArr.Add(MakeShareable(new FJsonValueNumber(t.gr.Z)));
-			grArr.Add(MakeShareable(new FJsonValueNumber(t.gr.W)));
-			tObj->SetArrayField(TEXT("gr"), grArr);
-		}
-
-		tObj->SetBoolField(TEXT("isConfidence"), t.bIsConfidence);
-
-		trackersArray.Add(MakeShareable(new FJsonValueObject(tObj)));
-	}
+bool UCommandBuilder::TrackerDatasBytes(TArrayView<const FTrackerData> trackers, TArray<uint8>& outBytes, bool binary)
+{
+	outBytes.Reset();
 
-	root->SetArrayField(TEXT("trackerList"), trackersArray);
-    TSharedRef<TJsonWriter<>> writer = TJsonWriterFactory<>::Create(&outJson);
-    FJsonSerializer::Serialize(root.ToSharedRef(), writer);
-    CleanJson(outJson);
-    return outJson;
-}
\ No newline at end of file
+	EMotionType mode;
+	FString bizId;
+	if (!GetTrackerReportContext(mode, bizId))
+		return false;
+
+	const int64 timestampMs = static_cast<int64>((FDateTime::UtcNow() - FDateTime(1970,1,1)).GetTotalMilliseconds());
+	if (binary)
+		WriteTrackerReportBinary(outBytes, mode, bizId, timestampMs, trackers);
+	else
+		WriteTrackerReportJson(outBytes, mode, bizId, timestampMs, trackers);
+	return true;
+}
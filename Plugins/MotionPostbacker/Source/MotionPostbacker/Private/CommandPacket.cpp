@@ -0,0 +1,148 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "CommandPacket.h"
+#include "Serialization/JsonReader.h"
+
+// 当前读取位置所在的对象
+enum class ECommandScope : uint8
+{
+    Root,
+    Data,
+    Summary,
+    // 其它对象或数组，内部字段全部忽略
+    Other
+};
+
+// 兼容服务端以数字/字符串/布尔任一形式下发的字段，与 FJsonValue 的隐式转换保持一致
+static double ReadNumber(const TJsonReader<TCHAR>& reader, EJsonNotation notation)
+{
+    if (notation == EJsonNotation::Number)
+        return reader.GetValueAsNumber();
+    if (notation == EJsonNotation::String)
+        return FCString::Atod(*reader.GetValueAsString());
+    if (notation == EJsonNotation::Boolean)
+        return reader.GetValueAsBoolean() ? 1.0 : 0.0;
+    return 0.0;
+}
+
+static bool ReadBool(const TJsonReader<TCHAR>& reader, EJsonNotation notation)
+{
+    if (notation == EJsonNotation::Boolean)
+        return reader.GetValueAsBoolean();
+    if (notation == EJsonNotation::Number)
+        return reader.GetValueAsNumber() != 0.0;
+    if (notation == EJsonNotation::String)
+        return reader.GetValueAsString().ToBool();
+    return false;
+}
+
+static void ReadString(const TJsonReader<TCHAR>& reader, EJsonNotation notation, FString& out)
+{
+    if (notation == EJsonNotation::String)
+        out = reader.GetValueAsString();
+    else if (notation == EJsonNotation::Number)
+        out = reader.GetValueAsNumberString();
+}
+
+static void ReadSummaryField(const TJsonReader<TCHAR>& reader, EJsonNotation notation, FCommandSummary& summary)
+{
+    const FString& key = reader.GetIdentifier();
+    if (key == TEXT("score"))
+        summary.score = ReadNumber(reader, notation);
+    else if (key == TEXT("sphereDiameter"))
+        summary.sphereDiameter = ReadNumber(reader, notation);
+    else if (key == TEXT("is1cmFromInjurySite"))
+        summary.is1cmFromInjurySite = ReadBool(reader, notation);
+    else if (key == TEXT("isSpiral"))
+        summary.isSpiral = ReadBool(reader, notation);
+    else if (key == TEXT("isInOrder"))
+        summary.isInOrder = ReadBool(reader, notation);
+    else if (key == TEXT("isZ"))
+        summary.isZ = ReadBool(reader, notation);
+    else if (key == TEXT("isArmsStraight"))
+        summary.isArmsStraight = ReadBool(reader, notation);
+    else if (key == TEXT("isPerpendicular"))
+        summary.isPerpendicular = ReadBool(reader, notation);
+}
+
+bool FCommandPacket::Parse(FStringView json, FString& outError)
+{
+    // 直接在原始字符上读取，不拷贝整行
+    TSharedRef<TJsonReader<TCHAR>> reader = TJsonReaderFactory<TCHAR>::CreateFromView(json);
+
+    EJsonNotation notation = EJsonNotation::Null;
+    if (!reader->ReadNext(notation) || notation != EJsonNotation::ObjectStart)
+    {
+        outError = TEXT("根节点不是 JSON 对象");
+        return false;
+    }
+
+    TArray<ECommandScope, TInlineAllocator<8>> scopes;
+    scopes.Add(ECommandScope::Root);
+    while (scopes.Num() > 0)
+    {
+        if (!reader->ReadNext(notation) || notation == EJsonNotation::Error)
+        {
+            outError = reader->GetErrorMessage();
+            return false;
+        }
+
+        const ECommandScope scope = scopes.Last();
+        switch (notation)
+        {
+        case EJsonNotation::ObjectStart:
+            if (scope == ECommandScope::Root && reader->GetIdentifier() == TEXT("data"))
+            {
+                hasData = true;
+                scopes.Add(ECommandScope::Data);
+            }
+            else if (scope == ECommandScope::Data && reader->GetIdentifier() == TEXT("summary"))
+            {
+                hasSummary = true;
+                scopes.Add(ECommandScope::Summary);
+            }
+            else
+            {
+                scopes.Add(ECommandScope::Other);
+            }
+            break;
+
+        case EJsonNotation::ArrayStart:
+            scopes.Add(ECommandScope::Other);
+            break;
+
+        case EJsonNotation::ObjectEnd:
+        case EJsonNotation::ArrayEnd:
+            scopes.Pop(EAllowShrinking::No);
+            break;
+
+        default:
+            if (scope == ECommandScope::Root)
+            {
+                const FString& key = reader->GetIdentifier();
+                if (key == TEXT("cmd"))
+                    ReadString(*reader, notation, cmd);
+                else if (key == TEXT("code"))
+                    code = (int32)ReadNumber(*reader, notation);
+                else if (key == TEXT("msg"))
+                    ReadString(*reader, notation, msg);
+            }
+            else if (scope == ECommandScope::Data)
+            {
+                const FString& key = reader->GetIdentifier();
+                if (key == TEXT("action"))
+                    ReadString(*reader, notation, action);
+                else if (key == TEXT("bizId"))
+                    ReadString(*reader, notation, bizId);
+                else if (key == TEXT("isFinish"))
+                    isFinish = ReadBool(*reader, notation);
+            }
+            else if (scope == ECommandScope::Summary)
+            {
+                ReadSummaryField(*reader, notation, summary);
+            }
+            break;
+        }
+    }
+    return true;
+}
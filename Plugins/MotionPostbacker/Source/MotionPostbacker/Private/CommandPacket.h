@@ -0,0 +1,38 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// 服务端指令中解析器关心的字段；不构建 JSON DOM，其余字段在流式读取时直接跳过
+struct FCommandSummary
+{
+    bool is1cmFromInjurySite = false;
+    bool isSpiral = false;
+    bool isInOrder = false;
+    bool isZ = false;
+    bool isArmsStraight = false;
+    bool isPerpendicular = false;
+    double sphereDiameter = 0.0;
+    double score = 0.0;
+};
+
+struct FCommandPacket
+{
+    FString cmd;
+    int32 code = 0;
+    FString msg;
+
+    // data 对象及其字段
+    bool hasData = false;
+    FString action;
+    FString bizId;
+    bool isFinish = false;
+
+    // data.summary
+    bool hasSummary = false;
+    FCommandSummary summary;
+
+    // 按 SAX 方式逐个读取 token 填充上面的字段，失败时返回 false 并写出错误信息
+    bool Parse(FStringView json, FString& outError);
+};
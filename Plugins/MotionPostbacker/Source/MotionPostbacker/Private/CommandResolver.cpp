@@ -1,8 +1,7 @@
 // Fill out your copyright notice in the Description page of Project Settings.
 #include "CommandResolver.h"
 #include "UObject/Package.h"
-#include "Json.h"
-#include "JsonUtilities.h"
+#include "CommandPacket.h"
 #include "Misc/ScopeLock.h"
 #include "Engine/Engine.h"
 
@@ -23,148 +22,212 @@ bool UCommandResolver::ShouldSendTrackerData()
     return !currentBizId.IsEmpty() && isAnalyzing;
 }
 
-// 从缓冲区中提取下一个完整的 JSON 对象（按花括号配平，忽略字符串中的括号与转义）
-static int32 FindJsonObjectEnd(const FString& s, int32 startIndex)
+void UCommandResolver::SetAnalyzing(bool analyzing)
 {
-    int32 depth = 0;
-    bool inString = false;
-    bool escapeNext = false;
-    for (int32 i = startIndex; i < s.Len(); i++)
-    {
-        const TCHAR ch = s[i];
-        if (escapeNext)
-        {
-            escapeNext = false;
-            continue;
-        }
+    isAnalyzing = analyzing;
+    onAnalysisStateChanged.Broadcast(analyzing);
+}
 
-        if (ch == '\\')
-        {
-            escapeNext = true;
-            continue;
-        }
+// 去掉包首尾空白（含 CRLF 的 '\r'）以及 '{' 之前的噪声（如 BOM、协议前缀）
+static FStringView TrimPacket(FStringView packet)
+{
+    packet = packet.TrimStartAndEnd();
+    int32 startBrace = INDEX_NONE;
+    if (packet.FindChar(TEXT('{'), startBrace) && startBrace > 0)
+        packet.RightChopInline(startBrace);
+    return packet;
+}
 
-        if (ch == '"')
-        {
-            inString = !inString;
-            continue;
-        }
+void UCommandResolver::Resolve(const FString& json)
+{
+    // 粘包与半包处理：基于换行符 '\n' 分包，兼容 CRLF；
+    // 数据只追加到缓冲区尾部并从上次扫描位置继续找换行，包以视图交付，整批处理完后才一次性丢弃已消费的部分
+    recvBuffer.Append(*json, json.Len());
 
-        if (inString)
+    int32 lineStart = 0;
+    for (int32 i = recvScanPos; i < recvBuffer.Num(); i++)
+    {
+        if (recvBuffer[i] != TEXT('\n'))
             continue;
 
-        if (ch == '{') depth++;
-        else if (ch == '}')
-        {
-            depth--;
-            if (depth == 0) return i;
-        }
+        const FStringView packet = TrimPacket(FStringView(recvBuffer.GetData() + lineStart, i - lineStart));
+        lineStart = i + 1;
+        if (!packet.IsEmpty())
+            ResolveOne(packet);
+    }
+
+    if (lineStart > 0)
+        recvBuffer.RemoveAt(0, lineStart, EAllowShrinking::No);
+    recvScanPos = recvBuffer.Num();
+
+    // 缓冲区过大（异常数据或服务端错误）时清空并提醒
+    if (recvBuffer.Num() > 1 * 1024 * 1024)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Resolve: 缓冲区超过 1MB，疑似异常数据，清空缓冲。"));
+        recvBuffer.Reset();
+        recvScanPos = 0;
     }
-    return INDEX_NONE;
 }
 
-// 移除缓冲区起始处的噪声（如非打印字符、协议前缀），聚焦到第一个 '{'
-static void StripNonJsonPrefix(FString& buffer)
+void UCommandResolver::ResolveFrame(const FString& json)
 {
-    buffer.TrimStartInline();
-    const int32 startBrace = buffer.Find(TEXT("{"));
-    if (startBrace == INDEX_NONE)
+    const FStringView packet = FStringView(json).TrimStartAndEnd();
+    if (!packet.IsEmpty())
+        ResolveOne(packet);
+}
+
+// 指令路由键：对小写化后的 "cmd" 或 "cmd/action" 做 FNV-1a 哈希；constexpr，路由表的键在编译期算出
+static constexpr uint64 HashCommandText(uint64 hash, const TCHAR* text)
+{
+    for (; *text; text++)
     {
-        // 没有 '{'，保留少量噪声等待下一次数据；避免无限增长
-        if (buffer.Len() > 4096) buffer.Reset();
-        return;
+        const TCHAR ch = (*text >= TEXT('A') && *text <= TEXT('Z')) ? (TCHAR)(*text - TEXT('A') + TEXT('a')) : *text;
+        hash = (hash ^ (uint64)ch) * 1099511628211ull;
     }
-    if (startBrace > 0) buffer.RemoveAt(0, startBrace);
+    return hash;
 }
 
-static bool ExtractNextJsonObject(FString& buffer, FString& outObject)
+static constexpr uint64 CommandKey(const TCHAR* cmd)
 {
-    // 基于换行符 '\n' 的分包重组，兼容 CRLF。若无完整行则等待后续数据。
-    const int32 newlineIndex = buffer.Find(TEXT("\n"));
-    if (newlineIndex == INDEX_NONE) return false;
-
-    outObject = buffer.Left(newlineIndex);
-    buffer.RemoveAt(0, newlineIndex + 1);
+    return HashCommandText(14695981039346656037ull, cmd);
+}
 
-    // 去除 Windows 风格结尾的 '\r'
-    if (outObject.Len() > 0 && outObject[outObject.Len() - 1] == '\r')
-        outObject.RemoveAt(outObject.Len() - 1);
+static constexpr uint64 CommandKey(const TCHAR* cmd, const TCHAR* action)
+{
+    return HashCommandText(HashCommandText(CommandKey(cmd), TEXT("/")), action);
+}
 
-    // 兼容可能存在的前置噪声/BOM，保留此前的前缀清理逻辑
-    StripNonJsonPrefix(outObject);
+typedef void (UCommandResolver::*FCommandHandler)(const FCommandPacket&);
 
-    outObject.TrimStartAndEndInline();
-    buffer.TrimStartInline();
-    return !outObject.IsEmpty();
+struct FCommandRoute
+{
+    uint64 key;
+    // 指令级路由：label 为提示信息中的模块名，需再按 action 分发；label 为空表示直接交给 handler
+    const TCHAR* label;
+    FCommandHandler handler;
+};
+
+// 指令表与子指令表分开建索引：cmd 本身带 "/" 时（如 "onCprAnalysis/begin"）只会在指令表中查找，
+// 不会命中子指令的 handler 而绕过 DispatchAction 对 code 与 data 的校验
+static TMap<uint64, const FCommandRoute*> BuildRouteMap(TArrayView<const FCommandRoute> routes)
+{
+    TMap<uint64, const FCommandRoute*> map;
+    for (const FCommandRoute& route : routes)
+    {
+        ensureMsgf(!map.Contains(route.key), TEXT("CommandResolver: 指令路由键冲突"));
+        map.Add(route.key, &route);
+    }
+    return map;
 }
 
-void UCommandResolver::Resolve(const FString& json)
+// 新增动作类型时在指令表登记指令，并在子指令表登记各子指令的 handler 即可
+const FCommandRoute* UCommandResolver::FindCommand(uint64 key)
 {
-    // 粘包与半包处理：
-    recvBuffer.Append(json);
-
-    FString packet;
-    while (ExtractNextJsonObject(recvBuffer, packet))
+    static const FCommandRoute COMMANDS[] =
     {
-        packet.TrimStartAndEndInline();
-
-        if (packet.IsEmpty()) 
-            continue;
-
-        ResolveOne(packet);
-    }
+        { CommandKey(TEXT("onRescueAppConfig")), nullptr, &UCommandResolver::OnRescueAppConfig },
+        { CommandKey(TEXT("onTrajectoryAnalysis")), TEXT("无菌钳"), nullptr },
+        { CommandKey(TEXT("onCprAnalysis")), TEXT("CPR"), nullptr },
+        // Z形轨迹记录回传：兼容服务端不带 on 前缀的写法（大小写已在哈希时统一）
+        { CommandKey(TEXT("onZShapeTrajectoryAnalysis")), TEXT("Z形轨迹"), nullptr },
+        { CommandKey(TEXT("zshapeTrajectoryAnalysis")), TEXT("Z形轨迹"), nullptr },
+    };
+
+    static const TMap<uint64, const FCommandRoute*> routeMap = BuildRouteMap(MakeArrayView(COMMANDS));
+    const FCommandRoute* const* found = routeMap.Find(key);
+    return found ? *found : nullptr;
+}
 
-    // 缓冲区过大（异常数据或服务端错误）时清空并提醒
-    if (recvBuffer.Len() > 1 * 1024 * 1024)
+const FCommandRoute* UCommandResolver::FindAction(uint64 key)
+{
+    static const FCommandRoute ACTIONS[] =
     {
-        UE_LOG(LogTemp, Warning, TEXT("Resolve: 缓冲区超过 1MB，疑似异常数据，清空缓冲。"));
-        recvBuffer.Reset();
-    }
+        { CommandKey(TEXT("onTrajectoryAnalysis"), TEXT("begin")), nullptr, &UCommandResolver::OnTrajectoryAnalysis_Begin },
+        { CommandKey(TEXT("onTrajectoryAnalysis"), TEXT("stop")), nullptr, &UCommandResolver::OnTrajectoryAnalysis_Stop },
+        { CommandKey(TEXT("onTrajectoryAnalysis"), TEXT("trReport")), nullptr, &UCommandResolver::OnTrajectoryAnalysis_TrReport },
+        { CommandKey(TEXT("onTrajectoryAnalysis"), TEXT("result")), nullptr, &UCommandResolver::OnTrajectoryAnalysis_Result },
+
+        { CommandKey(TEXT("onCprAnalysis"), TEXT("begin")), nullptr, &UCommandResolver::OnCprAnalysis_Begin },
+        { CommandKey(TEXT("onCprAnalysis"), TEXT("stop")), nullptr, &UCommandResolver::OnCprAnalysis_End },
+        { CommandKey(TEXT("onCprAnalysis"), TEXT("result")), nullptr, &UCommandResolver::OnCprAnalysis_Result },
+
+        { CommandKey(TEXT("onZShapeTrajectoryAnalysis"), TEXT("begin")), nullptr, &UCommandResolver::OnZShapeTrajectoryAnalysis_Begin },
+        { CommandKey(TEXT("onZShapeTrajectoryAnalysis"), TEXT("stop")), nullptr, &UCommandResolver::OnZShapeTrajectoryAnalysis_Stop },
+        { CommandKey(TEXT("onZShapeTrajectoryAnalysis"), TEXT("trReport")), nullptr, &UCommandResolver::OnZShapeTrajectoryAnalysis_TrReport },
+        { CommandKey(TEXT("onZShapeTrajectoryAnalysis"), TEXT("result")), nullptr, &UCommandResolver::OnZShapeTrajectoryAnalysis_Result },
+        { CommandKey(TEXT("zshapeTrajectoryAnalysis"), TEXT("begin")), nullptr, &UCommandResolver::OnZShapeTrajectoryAnalysis_Begin },
+        { CommandKey(TEXT("zshapeTrajectoryAnalysis"), TEXT("stop")), nullptr, &UCommandResolver::OnZShapeTrajectoryAnalysis_Stop },
+        { CommandKey(TEXT("zshapeTrajectoryAnalysis"), TEXT("trReport")), nullptr, &UCommandResolver::OnZShapeTrajectoryAnalysis_TrReport },
+        { CommandKey(TEXT("zshapeTrajectoryAnalysis"), TEXT("result")), nullptr, &UCommandResolver::OnZShapeTrajectoryAnalysis_Result },
+    };
+
+    static const TMap<uint64, const FCommandRoute*> routeMap = BuildRouteMap(MakeArrayView(ACTIONS));
+    const FCommandRoute* const* found = routeMap.Find(key);
+    return found ? *found : nullptr;
 }
 
-// 处理单条 JSON 指令
-void UCommandResolver::ResolveOne(const FString& json)
+// 处理单条 JSON 指令：流式读取所需字段，不构建 DOM
+void UCommandResolver::ResolveOne(FStringView json)
 {
-    TSharedPtr<FJsonObject> jsonObject;
-    TSharedRef<TJsonReader<TCHAR>> reader = TJsonReaderFactory<TCHAR>::Create(json);
-    if (!FJsonSerializer::Deserialize(reader, jsonObject) || !jsonObject.IsValid())
+    FCommandPacket packet;
+    FString parseError;
+    if (!packet.Parse(json, parseError))
     {
-        FString err = FString::Printf(TEXT("Resolve: 无法解析为合法的 JSON: %s"), *json);
+        FString err = FString::Printf(TEXT("Resolve: 无法解析为合法的 JSON(%s): %.*s"), *parseError, json.Len(), json.GetData());
         UE_LOG(LogTemp, Warning, TEXT("%s"), *err);
         return;
     }
 
-    const FString cmd = jsonObject->GetStringField(TEXT("cmd"));
+    const FCommandRoute* command = FindCommand(CommandKey(*packet.cmd));
+    if (!command)
+        return;
 
-    if (cmd.Equals(TEXT("onTrajectoryAnalysis"), ESearchCase::IgnoreCase))
+    // 不区分 action 的指令直接交给 handler
+    if (!command->label)
     {
-        OnTrajectoryAnalysis(jsonObject);
+        (this->*command->handler)(packet);
         return;
     }
 
-    if (cmd.Equals(TEXT("onCprAnalysis"), ESearchCase::IgnoreCase))
+    DispatchAction(*command, packet);
+}
+
+// 动作分析指令：统一校验 code 与 data，再按 data.action 查表分发
+void UCommandResolver::DispatchAction(const FCommandRoute& command, const FCommandPacket& packet)
+{
+    if (packet.code != SUCCESS_CODE)
     {
-        OnCprAnalysis(jsonObject);
+        const FString result = FString::Printf(TEXT("%s, %s"), command.label, *packet.msg);
+        UE_LOG(LogTemp, Warning, TEXT("%s"), *result);
+        onMessageUpdate.Broadcast(result, EMessageType::Message);
         return;
     }
 
-    // Z形轨迹记录回传：兼容服务端不同大小写/前缀
-    if (cmd.Equals(TEXT("onZshapeTrajectoryAnalysis"), ESearchCase::IgnoreCase)
-        || cmd.Equals(TEXT("onZShapeTrajectoryAnalysis"), ESearchCase::IgnoreCase)
-        || cmd.Equals(TEXT("zshapeTrajectoryAnalysis"), ESearchCase::IgnoreCase))
+    // data 缺失时各字段均为默认值，需单独提示
+    if (!packet.hasData)
     {
-        OnZShapeTrajectoryAnalysis(jsonObject);
+        const FString warn = FString::Printf(TEXT("%s: data 字段缺失或非法"), command.label);
+        UE_LOG(LogTemp, Warning, TEXT("%s"), *warn);
+        onMessageUpdate.Broadcast(warn, EMessageType::Message);
         return;
     }
 
-    if (cmd.Equals(TEXT("onRescueAppConfig"), ESearchCase::IgnoreCase))
-        OnRescueAppConfig(jsonObject);
+    const FCommandRoute* route = FindAction(CommandKey(*packet.cmd, *packet.action));
+    if (!route)
+    {
+        const FString warn = FString::Printf(TEXT("%s, 未知子指令: %s"), command.label, *packet.action);
+        UE_LOG(LogTemp, Warning, TEXT("%s"), *warn);
+        onMessageUpdate.Broadcast(warn, EMessageType::Message);
+        return;
+    }
+
+    (this->*route->handler)(packet);
 }
 
-void UCommandResolver::OnRescueAppConfig(const TSharedPtr<FJsonObject>& json)
+void UCommandResolver::OnRescueAppConfig(const FCommandPacket& packet)
 {
-    const int32 code = json->HasField(TEXT("code")) ? (int32)json->GetNumberField(TEXT("code")) : 0;
-    const FString msg = json->HasField(TEXT("msg")) ? json->GetStringField(TEXT("msg")) : TEXT("");
+    const int32 code = packet.code;
+    const FString& msg = packet.msg;
 
     FString uiText;
     if (code == SUCCESS_CODE)
@@ -176,99 +239,39 @@ void UCommandResolver::OnRescueAppConfig(const TSharedPtr<FJsonObject>& json)
 }
 
 // -------------------------- Trajectory --------------------------
-void UCommandResolver::OnTrajectoryAnalysis(const TSharedPtr<FJsonObject>& json)
+void UCommandResolver::OnTrajectoryAnalysis_Begin(const FCommandPacket& packet)
 {
-    const int32 code = json->HasField(TEXT("code")) ? (int32)json->GetNumberField(TEXT("code")) : 0;
-    const FString msg = json->HasField(TEXT("msg")) ? json->GetStringField(TEXT("msg")) : TEXT("");
-
-    if (code != SUCCESS_CODE)
-    {
-        FString result = FString::Printf(TEXT("无菌钳, %s"), *msg);
-        UE_LOG(LogTemp, Warning, TEXT("%s"), *result);
-        onMessageUpdate.Broadcast(result, EMessageType::Message);
-        return;
-    }
-
-    // 安全读取 data，避免字段缺失导致崩溃
-    const TSharedPtr<FJsonObject>* dataPtr = nullptr;
-    if (!json->TryGetObjectField(TEXT("data"), dataPtr) || !(dataPtr && dataPtr->IsValid()))
-    {
-        const FString warn = TEXT("无菌钳: data 字段缺失或非法");
-        UE_LOG(LogTemp, Warning, TEXT("%s"), *warn);
-        onMessageUpdate.Broadcast(warn, EMessageType::Message);
-        return;
-    }
-    const TSharedPtr<FJsonObject> data = *dataPtr;
-    const FString action = data->HasField(TEXT("action")) ? data->GetStringField(TEXT("action")) : TEXT("");
-
-    if (action.Equals(TEXT("begin"), ESearchCase::IgnoreCase))
-        OnTrajectoryAnalysis_Begin(json);
-    else if (action.Equals(TEXT("stop"), ESearchCase::IgnoreCase))
-        OnTrajectoryAnalysis_Stop(json);
-    else if (action.Equals(TEXT("trReport"), ESearchCase::IgnoreCase))
-        OnTrajectoryAnalysis_TrReport(json);
-    else if (action.Equals(TEXT("result"), ESearchCase::IgnoreCase))
-        OnTrajectoryAnalysis_Result(json);
-    else
-    {
-        const FString warn = FString::Printf(TEXT("无菌钳, 未知子指令: %s"), *action);
-        UE_LOG(LogTemp, Warning, TEXT("%s"), *warn);
-        onMessageUpdate.Broadcast(warn, EMessageType::Message);
-    }
-}
-
-void UCommandResolver::OnTrajectoryAnalysis_Begin(const TSharedPtr<FJsonObject>& json)
-{
-    const TSharedPtr<FJsonObject>* dataPtr = nullptr;
-    if (!json->TryGetObjectField(TEXT("data"), dataPtr) || !(dataPtr && dataPtr->IsValid()))
-    {
-        const FString warn = TEXT("无菌钳: data 字段缺失或非法");
-        UE_LOG(LogTemp, Warning, TEXT("%s"), *warn);
-        onMessageUpdate.Broadcast(warn, EMessageType::Message);
-        return;
-    }
-    isAnalyzing = true;
-    (*dataPtr)->TryGetStringField(TEXT("bizId"), currentBizId);
+    currentBizId = packet.bizId;
     currentMode = EMotionType::Trajectory;
     UE_LOG(LogTemp, Log, TEXT("无菌钳轨迹分析: 已开始"));
     onMessageUpdate.Broadcast(TEXT("无菌钳轨迹分析: 已开始"), EMessageType::Message);
-    onAnalysisStateChanged.Broadcast(true);
+    SetAnalyzing(true);
 }
 
-void UCommandResolver::OnTrajectoryAnalysis_Stop(const TSharedPtr<FJsonObject>& json)
+void UCommandResolver::OnTrajectoryAnalysis_Stop(const FCommandPacket& packet)
 {
     UE_LOG(LogTemp, Log, TEXT("无菌钳轨迹分析: 已停止"));
     onMessageUpdate.Broadcast(TEXT("无菌钳轨迹分析: 已停止"), EMessageType::Message);
-    onAnalysisStateChanged.Broadcast(false);
+    SetAnalyzing(false);
 }
 
-void UCommandResolver::OnTrajectoryAnalysis_TrReport(const TSharedPtr<FJsonObject>& json)
+void UCommandResolver::OnTrajectoryAnalysis_TrReport(const FCommandPacket& packet)
 {
     //啥也不用干
 }
 
-void UCommandResolver::OnTrajectoryAnalysis_Result(const TSharedPtr<FJsonObject>& json)
+void UCommandResolver::OnTrajectoryAnalysis_Result(const FCommandPacket& packet)
 {
-    const TSharedPtr<FJsonObject>* dataPtr = nullptr;
-    if (!json->TryGetObjectField(TEXT("data"), dataPtr) || !(dataPtr && dataPtr->IsValid()))
-    {
-        const FString warn = TEXT("无菌钳: data 字段缺失或非法");
-        UE_LOG(LogTemp, Warning, TEXT("%s"), *warn);
-        onMessageUpdate.Broadcast(warn, EMessageType::Message);
-        return;
-    }
-    const TSharedPtr<FJsonObject> data = *dataPtr;
-    const bool isFinish = data->HasField(TEXT("isFinish")) ? data->GetBoolField(TEXT("isFinish")) : false;
-    if (isFinish)
+    if (packet.isFinish)
     {
-        const TSharedPtr<FJsonObject>* summaryPtr = nullptr;
-        if (data->TryGetObjectField(TEXT("summary"), summaryPtr) && summaryPtr && summaryPtr->IsValid())
+        if (packet.hasSummary)
         {
-            const bool is1cmFromInjurySite = (*summaryPtr)->HasField(TEXT("is1cmFromInjurySite")) ? (*summaryPtr)->GetBoolField(TEXT("is1cmFromInjurySite")) : false;
-            const bool isSpiral = (*summaryPtr)->HasField(TEXT("isSpiral")) ? (*summaryPtr)->GetBoolField(TEXT("isSpiral")) : false;
-            const bool isInOrder = (*summaryPtr)->HasField(TEXT("isInOrder")) ? (*summaryPtr)->GetBoolField(TEXT("isInOrder")) : false;
-            const double sphereDiameter = (*summaryPtr)->HasField(TEXT("sphereDiameter")) ? (*summaryPtr)->GetNumberField(TEXT("sphereDiameter")) : 0.0;
-            const double score = (*summaryPtr)->HasField(TEXT("score")) ? (*summaryPtr)->GetNumberField(TEXT("score")) : 0.0;
+            const FCommandSummary& summary = packet.summary;
+            const bool is1cmFromInjurySite = summary.is1cmFromInjurySite;
+            const bool isSpiral = summary.isSpiral;
+            const bool isInOrder = summary.isInOrder;
+            const double sphereDiameter = summary.sphereDiameter;
+            const double score = summary.score;
             
             FString result = FString::Printf(TEXT("避开穿刺点1cm: %s\n螺旋式消毒: %s\n方向和顺序: %s\n消毒直径: %.2f米\n得分: %.2f"),
                 is1cmFromInjurySite ? TEXT("是") : TEXT("否"),
@@ -281,13 +284,6 @@ void UCommandResolver::OnTrajectoryAnalysis_Result(const TSharedPtr<FJsonObject>
             //{
             //    // 在屏幕上显示分析结果 5 秒，便于用户查看
             //    GEngine->AddOnScreenDebugMessage(-1, 5.0f, FColor::Green, result);
-            //    // 同时显示对应的 JSON 字符串 5 秒
-            //    FString jsonText;
-            //    {
-            //        TSharedRef<TJsonWriter<TCHAR>> writer = TJsonWriterFactory<TCHAR>::Create(&jsonText);
-            //        FJsonSerializer::Serialize(json.ToSharedRef(), writer);
-            //    }
-            //    GEngine->AddOnScreenDebugMessage(-1, 5.0f, FColor::Cyan, jsonText);
             //}
             onMessageUpdate.Broadcast(result, EMessageType::AnalysisResult);
         }
@@ -300,89 +296,32 @@ void UCommandResolver::OnTrajectoryAnalysis_Result(const TSharedPtr<FJsonObject>
 }
 
 // -------------------------- CPR --------------------------
-void UCommandResolver::OnCprAnalysis(const TSharedPtr<FJsonObject>& json)
+void UCommandResolver::OnCprAnalysis_Begin(const FCommandPacket& packet)
 {
-    int32 code = 0; FString msg;
-    json->TryGetNumberField(TEXT("code"), code);
-    json->TryGetStringField(TEXT("msg"), msg);
-    const TSharedPtr<FJsonObject>* dataPtr = nullptr;
-    if (!json->TryGetObjectField(TEXT("data"), dataPtr) || !(dataPtr && dataPtr->IsValid()))
-    {
-        const FString warn = TEXT("CPR: data 字段缺失或非法");
-        UE_LOG(LogTemp, Warning, TEXT("%s"), *warn);
-        onMessageUpdate.Broadcast(warn, EMessageType::Message);
-        return;
-    }
-    FString action; (*dataPtr)->TryGetStringField(TEXT("action"), action);
-
-    if (code == SUCCESS_CODE)
-    {
-        if (action.Equals(TEXT("begin"), ESearchCase::IgnoreCase)) 
-            OnCprAnalysis_Begin(json);
-        else if (action.Equals(TEXT("stop"), ESearchCase::IgnoreCase)) 
-            OnCprAnalysis_End(json);
-        else if (action.Equals(TEXT("result"), ESearchCase::IgnoreCase))
-            OnCprAnalysis_Result(json);
-        else
-        {
-            const FString warn = FString::Printf(TEXT("CPR, 未知子指令: %s"), *action);
-            UE_LOG(LogTemp, Warning, TEXT("%s"), *warn);
-            onMessageUpdate.Broadcast(warn, EMessageType::Message);
-        }
-    }
-    else
-    {
-        const FString warn = FString::Printf(TEXT("CPR: %s"), *msg);
-        UE_LOG(LogTemp, Warning, TEXT("%s"), *warn);
-        onMessageUpdate.Broadcast(warn, EMessageType::Message);
-    }
-}
-
-void UCommandResolver::OnCprAnalysis_Begin(const TSharedPtr<FJsonObject>& json)
-{
-    const TSharedPtr<FJsonObject>* dataPtr = nullptr;
-    if (!json->TryGetObjectField(TEXT("data"), dataPtr) || !(dataPtr && dataPtr->IsValid()))
-    {
-        const FString warn = TEXT("CPR: data 字段缺失或非法");
-        UE_LOG(LogTemp, Warning, TEXT("%s"), *warn);
-        onMessageUpdate.Broadcast(warn, EMessageType::Message);
-        return;
-    }
-    (*dataPtr)->TryGetStringField(TEXT("bizId"), currentBizId);
+    currentBizId = packet.bizId;
     currentMode = EMotionType::Cpr;
     UE_LOG(LogTemp, Log, TEXT("CPR 分析: 已开始"));
     onMessageUpdate.Broadcast(TEXT("CPR 分析: 已开始"), EMessageType::Message);
-    onAnalysisStateChanged.Broadcast(true);
+    SetAnalyzing(true);
 }
 
-void UCommandResolver::OnCprAnalysis_End(const TSharedPtr<FJsonObject>& json)
+void UCommandResolver::OnCprAnalysis_End(const FCommandPacket& packet)
 {
     UE_LOG(LogTemp, Log, TEXT("CPR 分析: 已停止"));
     onMessageUpdate.Broadcast(TEXT("CPR 分析: 已停止"), EMessageType::Message);
-    onAnalysisStateChanged.Broadcast(false);
+    SetAnalyzing(false);
 }
 
-void UCommandResolver::OnCprAnalysis_Result(const TSharedPtr<FJsonObject>& json)
+void UCommandResolver::OnCprAnalysis_Result(const FCommandPacket& packet)
 {
-    const TSharedPtr<FJsonObject>* dataPtr = nullptr;
-    if (!json->TryGetObjectField(TEXT("data"), dataPtr) || !(dataPtr && dataPtr->IsValid()))
-    {
-        const FString warn = TEXT("CPR: data 字段缺失或非法");
-        UE_LOG(LogTemp, Warning, TEXT("%s"), *warn);
-        onMessageUpdate.Broadcast(warn, EMessageType::Message);
-        return;
-    }
-    const TSharedPtr<FJsonObject> data = *dataPtr;
-    const bool isFinish = data->HasField(TEXT("isFinish")) ? data->GetBoolField(TEXT("isFinish")) : false;
-    if (isFinish)
+    if (packet.isFinish)
     {
-        const TSharedPtr<FJsonObject>* summaryPtr = nullptr;
-
-        if (data->TryGetObjectField(TEXT("summary"), summaryPtr) && summaryPtr && summaryPtr->IsValid())
+        if (packet.hasSummary)
         {
-            const bool isArmsStraight = (*summaryPtr)->HasField(TEXT("isArmsStraight")) ? (*summaryPtr)->GetBoolField(TEXT("isArmsStraight")) : false;
-            const bool isPerpendicular = (*summaryPtr)->HasField(TEXT("isPerpendicular")) ? (*summaryPtr)->GetBoolField(TEXT("isPerpendicular")) : false;
-            const double scoreNum = (*summaryPtr)->HasField(TEXT("score")) ? (*summaryPtr)->GetNumberField(TEXT("score")) : 0.0;
+            const FCommandSummary& summary = packet.summary;
+            const bool isArmsStraight = summary.isArmsStraight;
+            const bool isPerpendicular = summary.isPerpendicular;
+            const double scoreNum = summary.score;
 
             FString result = FString::Printf(TEXT("CPR 结果: \n手臂是否伸直: %s\n按压是否垂直: %s\n得分: %.2f"),
                 isArmsStraight ? TEXT("是") : TEXT("否"),
@@ -394,13 +333,6 @@ void UCommandResolver::OnCprAnalysis_Result(const TSharedPtr<FJsonObject>& json)
             //{
             //    // 在屏幕上显示 CPR 结果 5 秒
             //    GEngine->AddOnScreenDebugMessage(-1, 5.0f, FColor::Green, result);
-            //    // 同时显示对应的 JSON 字符串 5 秒
-            //    FString jsonText;
-            //    {
-            //        TSharedRef<TJsonWriter<TCHAR>> writer = TJsonWriterFactory<TCHAR>::Create(&jsonText);
-            //        FJsonSerializer::Serialize(json.ToSharedRef(), writer);
-            //    }
-            //    GEngine->AddOnScreenDebugMessage(-1, 5.0f, FColor::Cyan, jsonText);
             //}
             onMessageUpdate.Broadcast(result, EMessageType::AnalysisResult);
         }
@@ -413,97 +345,39 @@ void UCommandResolver::OnCprAnalysis_Result(const TSharedPtr<FJsonObject>& json)
 }
 
 // -------------------------- ZShape --------------------------
-void UCommandResolver::OnZShapeTrajectoryAnalysis(const TSharedPtr<FJsonObject>& json)
-{
-    int32 code = 0; FString msg;
-    json->TryGetNumberField(TEXT("code"), code);
-    json->TryGetStringField(TEXT("msg"), msg);
-    const TSharedPtr<FJsonObject>* dataPtr = nullptr;
-    if (!json->TryGetObjectField(TEXT("data"), dataPtr) || !(dataPtr && dataPtr->IsValid()))
-    {
-        const FString warn = TEXT("Z形轨迹: data 字段缺失或非法");
-        UE_LOG(LogTemp, Warning, TEXT("%s"), *warn);
-        onMessageUpdate.Broadcast(warn, EMessageType::Message);
-        return;
-    }
-    FString action; (*dataPtr)->TryGetStringField(TEXT("action"), action);
-
-    if (code != SUCCESS_CODE)
-    {
-        const FString result = FString::Printf(TEXT("Z形轨迹, %s"), *msg);
-        UE_LOG(LogTemp, Warning, TEXT("%s"), *result);
-        onMessageUpdate.Broadcast(result, EMessageType::Message);
-        return;
-    }
-
-    if (action.Equals(TEXT("begin"), ESearchCase::IgnoreCase))
-        OnZShapeTrajectoryAnalysis_Begin(json);
-    else if (action.Equals(TEXT("stop"), ESearchCase::IgnoreCase))
-        OnZShapeTrajectoryAnalysis_Stop(json);
-    else if (action.Equals(TEXT("trReport"), ESearchCase::IgnoreCase))
-        OnZShapeTrajectoryAnalysis_TrReport(json);
-    else if (action.Equals(TEXT("result"), ESearchCase::IgnoreCase))
-        OnZShapeTrajectoryAnalysis_Result(json);
-    else
-    {
-        const FString warn = FString::Printf(TEXT("Z形轨迹记录\n未知子指令: %s"), *action);
-        UE_LOG(LogTemp, Warning, TEXT("%s"), *warn);
-        onMessageUpdate.Broadcast(warn, EMessageType::Message);
-    }
-}
-
-void UCommandResolver::OnZShapeTrajectoryAnalysis_Begin(const TSharedPtr<FJsonObject>& json)
+void UCommandResolver::OnZShapeTrajectoryAnalysis_Begin(const FCommandPacket& packet)
 {
-    const TSharedPtr<FJsonObject>* dataPtr = nullptr;
-    if (!json->TryGetObjectField(TEXT("data"), dataPtr) || !(dataPtr && dataPtr->IsValid()))
-    {
-        const FString warn = TEXT("Z形轨迹: data 字段缺失或非法");
-        UE_LOG(LogTemp, Warning, TEXT("%s"), *warn);
-        onMessageUpdate.Broadcast(warn, EMessageType::Message);
-        return;
-    }
-    isAnalyzing = true;
-    (*dataPtr)->TryGetStringField(TEXT("bizId"), currentBizId);
+    currentBizId = packet.bizId;
     currentMode = EMotionType::ZShape;
     const FString info = FString::Printf(TEXT("Z形轨迹分析: 已开始"), *currentBizId);
     UE_LOG(LogTemp, Log, TEXT("%s"), *info);
     onMessageUpdate.Broadcast(info, EMessageType::Message);
-    onAnalysisStateChanged.Broadcast(true);
+    SetAnalyzing(true);
 }
 
-void UCommandResolver::OnZShapeTrajectoryAnalysis_Stop(const TSharedPtr<FJsonObject>& json)
+void UCommandResolver::OnZShapeTrajectoryAnalysis_Stop(const FCommandPacket& packet)
 {
     UE_LOG(LogTemp, Log, TEXT("Z形轨迹记录: 已停止"));
     onMessageUpdate.Broadcast(TEXT("Z形轨迹记录: 已停止"), EMessageType::Message);
-    onAnalysisStateChanged.Broadcast(false);
+    SetAnalyzing(false);
 }
 
-void UCommandResolver::OnZShapeTrajectoryAnalysis_TrReport(const TSharedPtr<FJsonObject>& json)
+void UCommandResolver::OnZShapeTrajectoryAnalysis_TrReport(const FCommandPacket& packet)
 {
 
 }
 
-void UCommandResolver::OnZShapeTrajectoryAnalysis_Result(const TSharedPtr<FJsonObject>& json)
+void UCommandResolver::OnZShapeTrajectoryAnalysis_Result(const FCommandPacket& packet)
 {
-    const TSharedPtr<FJsonObject>* dataPtr = nullptr;
-    if (!json->TryGetObjectField(TEXT("data"), dataPtr) || !(dataPtr && dataPtr->IsValid()))
-    {
-        const FString warn = TEXT("Z形轨迹: data 字段缺失或非法");
-        UE_LOG(LogTemp, Warning, TEXT("%s"), *warn);
-        onMessageUpdate.Broadcast(warn, EMessageType::Message);
-        return;
-    }
-    const TSharedPtr<FJsonObject> data = *dataPtr;
-    const bool isFinish = data->HasField(TEXT("isFinish")) ? data->GetBoolField(TEXT("isFinish")) : false;
-    if (isFinish)
+    if (packet.isFinish)
     {
-        const TSharedPtr<FJsonObject>* summaryPtr = nullptr;
-        if (data->TryGetObjectField(TEXT("summary"), summaryPtr) && summaryPtr && summaryPtr->IsValid())
+        if (packet.hasSummary)
         {
-            const bool is1cmFromInjurySite = (*summaryPtr)->HasField(TEXT("is1cmFromInjurySite")) ? (*summaryPtr)->GetBoolField(TEXT("is1cmFromInjurySite")) : false;
-            const bool isZ = (*summaryPtr)->HasField(TEXT("isZ")) ? (*summaryPtr)->GetBoolField(TEXT("isZ")) : false;
-            const bool isInOrder = (*summaryPtr)->HasField(TEXT("isInOrder")) ? (*summaryPtr)->GetBoolField(TEXT("isInOrder")) : false;
-            const double scoreNum = (*summaryPtr)->HasField(TEXT("score")) ? (*summaryPtr)->GetNumberField(TEXT("score")) : 0.0;
+            const FCommandSummary& summary = packet.summary;
+            const bool is1cmFromInjurySite = summary.is1cmFromInjurySite;
+            const bool isZ = summary.isZ;
+            const bool isInOrder = summary.isInOrder;
+            const double scoreNum = summary.score;
 
             const FString result = FString::Printf(TEXT("避开穿刺点1cm: %s\nZ形消毒: %s\n方向和顺序: %s\n得分: %.0f，满分100"),
                 is1cmFromInjurySite ? TEXT("是") : TEXT("否"),
@@ -516,13 +390,6 @@ void UCommandResolver::OnZShapeTrajectoryAnalysis_Result(const TSharedPtr<FJsonO
             //{
             //    // 在屏幕上显示 Z 形轨迹结果 5 秒
             //    GEngine->AddOnScreenDebugMessage(-1, 5.0f, FColor::Green, result);
-            //    // 同时显示对应的 JSON 字符串 5 秒
-            //    FString jsonText;
-            //    {
-            //        TSharedRef<TJsonWriter<TCHAR>> writer = TJsonWriterFactory<TCHAR>::Create(&jsonText);
-            //        FJsonSerializer::Serialize(json.ToSharedRef(), writer);
-            //    }
-            //    GEngine->AddOnScreenDebugMessage(-1, 5.0f, FColor::Cyan, jsonText);
             //}
             onMessageUpdate.Broadcast(result, EMessageType::AnalysisResult);
         }
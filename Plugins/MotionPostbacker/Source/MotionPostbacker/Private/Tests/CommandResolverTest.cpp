@@ -0,0 +1,78 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/AutomationTest.h"
+#include "CommandResolver.h"
+#include "UObject/Package.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+// 每个用例使用独立的解析器，不影响 GetResolver() 返回的全局实例
+static UCommandResolver* NewTestResolver()
+{
+    UCommandResolver* resolver = NewObject<UCommandResolver>(GetTransientPackage());
+    resolver->SetAnalyzing(false);
+    return resolver;
+}
+
+static FString MakeCommand(const TCHAR* cmd, int32 code, const TCHAR* action, const TCHAR* bizId)
+{
+    return FString::Printf(TEXT("{\"cmd\":\"%s\",\"code\":%d,\"msg\":\"\",\"data\":{\"action\":\"%s\",\"bizId\":\"%s\"}}\n"), cmd, code, action, bizId);
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCommandResolverRouteTest, "MotionPostbacker.CommandResolver.Route",
+    EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FCommandResolverRouteTest::RunTest(const FString& Parameters)
+{
+    // 指令按 cmd 查表，再按 data.action 分发
+    UCommandResolver* resolver = NewTestResolver();
+    resolver->Resolve(MakeCommand(TEXT("onZShapeTrajectoryAnalysis"), 1000, TEXT("begin"), TEXT("biz-1")));
+    TestTrue(TEXT("begin starts the analysis"), resolver->IsAnalyzing());
+    TestEqual(TEXT("begin sets the bizId"), resolver->GetBizId(), FString(TEXT("biz-1")));
+    TestEqual(TEXT("begin sets the mode"), (int32)resolver->GetCurrentMode(), (int32)EMotionType::ZShape);
+    resolver->Resolve(MakeCommand(TEXT("onZShapeTrajectoryAnalysis"), 1000, TEXT("stop"), TEXT("biz-1")));
+    TestFalse(TEXT("stop ends the analysis"), resolver->IsAnalyzing());
+
+    // 路由键不区分大小写，不带 on 前缀的写法同样可用
+    resolver = NewTestResolver();
+    resolver->Resolve(MakeCommand(TEXT("ZSHAPETRAJECTORYANALYSIS"), 1000, TEXT("Begin"), TEXT("biz-2")));
+    TestTrue(TEXT("case insensitive route"), resolver->IsAnalyzing());
+    TestEqual(TEXT("case insensitive route bizId"), resolver->GetBizId(), FString(TEXT("biz-2")));
+
+    // 两条指令在同一次输入中到达
+    resolver = NewTestResolver();
+    resolver->Resolve(MakeCommand(TEXT("onCprAnalysis"), 1000, TEXT("begin"), TEXT("cpr-1")) + MakeCommand(TEXT("onCprAnalysis"), 1000, TEXT("stop"), TEXT("cpr-2")));
+    TestEqual(TEXT("cpr begin sets the mode"), (int32)resolver->GetCurrentMode(), (int32)EMotionType::Cpr);
+    TestEqual(TEXT("cpr stop keeps the bizId"), resolver->GetBizId(), FString(TEXT("cpr-1")));
+    TestFalse(TEXT("cpr stop ends the analysis"), resolver->IsAnalyzing());
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCommandResolverRejectTest, "MotionPostbacker.CommandResolver.Reject",
+    EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FCommandResolverRejectTest::RunTest(const FString& Parameters)
+{
+    // cmd 本身写成 "cmd/action" 时不能命中子指令的 handler
+    UCommandResolver* resolver = NewTestResolver();
+    resolver->Resolve(MakeCommand(TEXT("onZShapeTrajectoryAnalysis/begin"), 500, TEXT(""), TEXT("biz-1")));
+    TestFalse(TEXT("cmd/action as cmd"), resolver->IsAnalyzing());
+    TestTrue(TEXT("cmd/action as cmd bizId"), resolver->GetBizId().IsEmpty());
+
+    // 失败的 code 不分发
+    resolver->Resolve(MakeCommand(TEXT("onZShapeTrajectoryAnalysis"), 500, TEXT("begin"), TEXT("biz-1")));
+    TestFalse(TEXT("failed code"), resolver->IsAnalyzing());
+
+    // 未知子指令与未知指令均被忽略
+    resolver->Resolve(MakeCommand(TEXT("onZShapeTrajectoryAnalysis"), 1000, TEXT("pause"), TEXT("biz-1")));
+    resolver->Resolve(MakeCommand(TEXT("onUnknownAnalysis"), 1000, TEXT("begin"), TEXT("biz-1")));
+    TestFalse(TEXT("unknown action or command"), resolver->IsAnalyzing());
+    TestTrue(TEXT("unknown action or command bizId"), resolver->GetBizId().IsEmpty());
+
+    // 缺少 data 时不分发
+    resolver->Resolve(TEXT("{\"cmd\":\"onZShapeTrajectoryAnalysis\",\"code\":1000}\n"));
+    TestFalse(TEXT("missing data"), resolver->IsAnalyzing());
+    return true;
+}
+
+#endif
@@ -0,0 +1,194 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/AutomationTest.h"
+#include "TrackerDeltaCodec.h"
+#include "TrackerWriter.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+// 第 frame 帧的模拟数据：两个追踪器做平移与旋转，第二个追踪器的置信度隔帧变化
+static TArray<FTrackerData> MakeTrackerFrame(int32 frame)
+{
+    TArray<FTrackerData> trackers;
+    for (int32 i = 0; i < 2; i++)
+    {
+        FTrackerData& t = trackers.AddDefaulted_GetRef();
+        t.sn = FString::Printf(TEXT("PT-%d"), i);
+        t.lt = FVector(0.1 * frame + i, -0.05 * frame, 1.2 + 0.01 * i);
+        t.lr = FQuat(FVector::UpVector, 0.02 * frame + i);
+        t.gt = t.lt + FVector(10.0, 20.0, 0.0);
+        t.gr = FQuat(FVector::ForwardVector, -0.03 * frame) * t.lr;
+        t.bIsConfidence = i == 0 || frame % 2 == 0;
+    }
+    return trackers;
+}
+
+// 解码结果与原始数据在量化误差内一致；q 与 -q 视为同一旋转
+static bool ReportMatches(FAutomationTestBase& test, const FTrackerReport& report, int64 stampMs, const TArray<FTrackerData>& expected)
+{
+    bool matches = test.TestEqual(TEXT("stamp"), report.stampMs, stampMs)
+        && test.TestEqual(TEXT("bizId"), report.bizId, FString(TEXT("biz-1")))
+        && test.TestEqual(TEXT("motionType"), (int32)report.motionType, (int32)EMotionType::Cpr)
+        && test.TestEqual(TEXT("tracker count"), report.trackers.Num(), expected.Num());
+
+    const float positionTolerance = (float)(0.5 / TRACKER_POSITION_SCALE) + UE_KINDA_SMALL_NUMBER;
+    for (int32 i = 0; matches && i < expected.Num(); i++)
+    {
+        const FTrackerData& got = report.trackers[i];
+        const FTrackerData& want = expected[i];
+        matches = test.TestEqual(TEXT("sn"), got.sn, want.sn)
+            && test.TestEqual(TEXT("isConfidence"), got.bIsConfidence, want.bIsConfidence)
+            && test.TestEqual(TEXT("lt"), got.lt, want.lt, positionTolerance)
+            && test.TestEqual(TEXT("gt"), got.gt, want.gt, positionTolerance)
+            && test.TestTrue(TEXT("lr"), FMath::Abs(got.lr | want.lr) > 1.0 - 1e-6)
+            && test.TestTrue(TEXT("gr"), FMath::Abs(got.gr | want.gr) > 1.0 - 1e-6);
+    }
+    return matches;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTrackerDeltaCodecRoundTripTest, "MotionPostbacker.TrackerDeltaCodec.RoundTrip",
+    EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FTrackerDeltaCodecRoundTripTest::RunTest(const FString& Parameters)
+{
+    FTrackerDeltaEncoder encoder(4);
+    FTrackerDeltaDecoder decoder;
+
+    for (int32 frame = 0; frame < 10; frame++)
+    {
+        const TArray<FTrackerData> trackers = MakeTrackerFrame(frame);
+        const int64 stampMs = 1000 + frame * 11;
+
+        TArray<uint8> datagram;
+        encoder.Encode(datagram, EMotionType::Cpr, TEXT("biz-1"), stampMs, trackers);
+
+        TArray<FTrackerReport> reports;
+        if (!TestEqual(TEXT("decode result"), (int32)decoder.Decode(datagram, reports), (int32)ETrackerDecodeResult::Ok)
+            || !TestEqual(TEXT("report count"), reports.Num(), 1)
+            || !ReportMatches(*this, reports[0], stampMs, trackers))
+        {
+            AddInfo(FString::Printf(TEXT("frame %d"), frame));
+            return false;
+        }
+    }
+
+    TestEqual(TEXT("lost packets"), decoder.GetLostPackets(), 0);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTrackerDeltaCodecLossRecoveryTest, "MotionPostbacker.TrackerDeltaCodec.LossRecovery",
+    EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FTrackerDeltaCodecLossRecoveryTest::RunTest(const FString& Parameters)
+{
+    // 关键帧间隔 4：第 0、4、8 帧为索引表 + 关键帧；丢弃携带首个索引表的第 0 帧与增量帧第 5 帧
+    FTrackerDeltaEncoder encoder(4);
+    FTrackerDeltaDecoder decoder;
+
+    for (int32 frame = 0; frame < 12; frame++)
+    {
+        const TArray<FTrackerData> trackers = MakeTrackerFrame(frame);
+        const int64 stampMs = 1000 + frame * 11;
+
+        TArray<uint8> datagram;
+        encoder.Encode(datagram, EMotionType::Cpr, TEXT("biz-1"), stampMs, trackers);
+        if (frame == 0 || frame == 5)
+            continue;
+
+        TArray<FTrackerReport> reports;
+        const ETrackerDecodeResult result = decoder.Decode(datagram, reports);
+
+        // 丢包后到下一个关键帧之前的增量帧都无法还原
+        const bool lost = frame < 4 || (frame > 5 && frame < 8);
+        if (lost)
+        {
+            if (!TestEqual(TEXT("decode result while waiting"), (int32)result, (int32)ETrackerDecodeResult::NeedKeyframe)
+                || !TestEqual(TEXT("reports while waiting"), reports.Num(), 0))
+            {
+                AddInfo(FString::Printf(TEXT("frame %d"), frame));
+                return false;
+            }
+            continue;
+        }
+
+        if (!TestEqual(TEXT("decode result"), (int32)result, (int32)ETrackerDecodeResult::Ok)
+            || !TestEqual(TEXT("report count"), reports.Num(), 1)
+            || !ReportMatches(*this, reports[0], stampMs, trackers))
+        {
+            AddInfo(FString::Printf(TEXT("frame %d"), frame));
+            return false;
+        }
+    }
+
+    TestFalse(TEXT("needs keyframe"), decoder.NeedsKeyframe());
+    // 第 5 帧的增量帧丢失；第 0 帧丢失时解码端尚未收到任何序号，无法计入
+    TestEqual(TEXT("lost packets"), decoder.GetLostPackets(), 1);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTrackerDeltaCodecSameBatchRecoveryTest, "MotionPostbacker.TrackerDeltaCodec.SameBatchRecovery",
+    EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FTrackerDeltaCodecSameBatchRecoveryTest::RunTest(const FString& Parameters)
+{
+    // 关键帧间隔 4：第 1 帧丢失后，第 2-5 帧在同一次输入中到达
+    FTrackerDeltaEncoder encoder(4);
+    FTrackerDeltaDecoder decoder;
+
+    TArray<uint8> batch;
+    for (int32 frame = 0; frame < 6; frame++)
+    {
+        TArray<uint8> datagram;
+        encoder.Encode(datagram, EMotionType::Cpr, TEXT("biz-1"), 1000 + frame * 11, MakeTrackerFrame(frame));
+        if (frame == 0)
+        {
+            TArray<FTrackerReport> reports;
+            TestEqual(TEXT("first frame"), (int32)decoder.Decode(datagram, reports), (int32)ETrackerDecodeResult::Ok);
+        }
+        else if (frame > 1)
+        {
+            batch.Append(datagram);
+        }
+    }
+
+    // 第 2、3 帧的增量被跳过，第 4 帧的关键帧与其后的增量照常还原
+    TArray<FTrackerReport> reports;
+    if (!TestEqual(TEXT("batch result"), (int32)decoder.Decode(batch, reports), (int32)ETrackerDecodeResult::Ok)
+        || !TestEqual(TEXT("report count"), reports.Num(), 2))
+    {
+        return false;
+    }
+    TestTrue(TEXT("keyframe"), ReportMatches(*this, reports[0], 1000 + 4 * 11, MakeTrackerFrame(4)));
+    TestTrue(TEXT("delta after keyframe"), ReportMatches(*this, reports[1], 1000 + 5 * 11, MakeTrackerFrame(5)));
+    TestEqual(TEXT("lost packets"), decoder.GetLostPackets(), 1);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTrackerDeltaCodecTableChangeTest, "MotionPostbacker.TrackerDeltaCodec.TableChange",
+    EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FTrackerDeltaCodecTableChangeTest::RunTest(const FString& Parameters)
+{
+    FTrackerDeltaEncoder encoder(60);
+    FTrackerDeltaDecoder decoder;
+
+    TArray<uint8> datagram;
+    TArray<FTrackerReport> reports;
+    encoder.Encode(datagram, EMotionType::Cpr, TEXT("biz-1"), 1000, MakeTrackerFrame(0));
+    TestEqual(TEXT("first frame"), (int32)decoder.Decode(datagram, reports), (int32)ETrackerDecodeResult::Ok);
+
+    // 追踪器减少时立即发送新索引表与关键帧，解码端不必等到下一个关键帧间隔
+    TArray<FTrackerData> trackers = MakeTrackerFrame(1);
+    trackers.RemoveAt(0);
+    datagram.Reset();
+    reports.Reset();
+    encoder.Encode(datagram, EMotionType::Cpr, TEXT("biz-1"), 1011, trackers);
+    if (!TestEqual(TEXT("changed table"), (int32)decoder.Decode(datagram, reports), (int32)ETrackerDecodeResult::Ok)
+        || !TestEqual(TEXT("report count"), reports.Num(), 1))
+    {
+        return false;
+    }
+    return ReportMatches(*this, reports[0], 1011, trackers);
+}
+
+#endif
@@ -0,0 +1,498 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "TrackerDeltaCodec.h"
+#include "TrackerWriter.h"
+
+// 标志位
+static const uint8 DELTA_FLAG_CONFIDENCE = 1 << 0;
+static const uint8 DELTA_FLAG_LT = 1 << 1;
+static const uint8 DELTA_FLAG_LR = 1 << 2;
+static const uint8 DELTA_FLAG_GT = 1 << 3;
+static const uint8 DELTA_FLAG_GR = 1 << 4;
+
+// 索引表中追踪器数量与字符串长度的上限（u8）
+static const int32 DELTA_MAX_ENTRIES = 255;
+
+// -------------------------- 量化 --------------------------
+static void QuantizePosition(const FVector& v, int32 out[3])
+{
+    const double limit = (double)MAX_int32;
+    out[0] = (int32)FMath::Clamp(FMath::RoundHalfFromZero(v.X * TRACKER_POSITION_SCALE), -limit, limit);
+    out[1] = (int32)FMath::Clamp(FMath::RoundHalfFromZero(v.Y * TRACKER_POSITION_SCALE), -limit, limit);
+    out[2] = (int32)FMath::Clamp(FMath::RoundHalfFromZero(v.Z * TRACKER_POSITION_SCALE), -limit, limit);
+}
+
+static FVector DequantizePosition(const int32 q[3])
+{
+    return FVector(q[0] / TRACKER_POSITION_SCALE, q[1] / TRACKER_POSITION_SCALE, q[2] / TRACKER_POSITION_SCALE);
+}
+
+// reference 为上一次的量化值：q 与 -q 表示同一旋转，取与上一次同侧的符号，避免符号翻转产生大差值
+static void QuantizeRotation(const FQuat& q, const int16* reference, int16 out[4])
+{
+    const FQuat n = q.SizeSquared() > UE_SMALL_NUMBER ? q.GetNormalized() : FQuat::Identity;
+    double c[4] = { n.X, n.Y, n.Z, n.W };
+
+    double dot = 0.0;
+    for (int32 i = 0; i < 4; i++)
+        dot += reference ? c[i] * reference[i] : (i == 3 ? c[i] : 0.0);
+    const double sign = dot < 0.0 ? -1.0 : 1.0;
+
+    for (int32 i = 0; i < 4; i++)
+        out[i] = (int16)FMath::Clamp(FMath::RoundToInt(c[i] * sign * TRACKER_ROTATION_SCALE), -32767, 32767);
+}
+
+static FQuat DequantizeRotation(const int16 q[4])
+{
+    const FQuat result(q[0] / TRACKER_ROTATION_SCALE, q[1] / TRACKER_ROTATION_SCALE, q[2] / TRACKER_ROTATION_SCALE, q[3] / TRACKER_ROTATION_SCALE);
+    return result.SizeSquared() > UE_SMALL_NUMBER ? result.GetNormalized() : FQuat::Identity;
+}
+
+// -------------------------- 写入 --------------------------
+template<typename T>
+static FORCEINLINE void AppendLittleEndian(TArray<uint8>& out, T value)
+{
+    for (int32 i = 0; i < (int32)sizeof(T); i++)
+        out.Add((uint8)((uint64)value >> (i * 8)));
+}
+
+// zigzag + LEB128：绝对值小的差值只占 1 字节
+static void AppendVarint(TArray<uint8>& out, int64 value)
+{
+    uint64 zigzag = ((uint64)value << 1) ^ (uint64)(value >> 63);
+    while (zigzag >= 0x80)
+    {
+        out.Add((uint8)(zigzag | 0x80));
+        zigzag >>= 7;
+    }
+    out.Add((uint8)zigzag);
+}
+
+// u8 长度 + UTF-8，超过 255 字节的部分被截断
+static void AppendShortString(TArray<uint8>& out, const FString& value)
+{
+    FTCHARToUTF8 utf8(*value, value.Len());
+    const int32 length = FMath::Min(utf8.Length(), DELTA_MAX_ENTRIES);
+    out.Add((uint8)length);
+    out.Append((const uint8*)utf8.Get(), length);
+}
+
+// -------------------------- 读取 --------------------------
+// 顺序读取，越界后 ok 置为 false，之后的读取均返回 0
+struct FDeltaReader
+{
+    FDeltaReader(TArrayView<const uint8> inData)
+        : data(inData)
+    {
+    }
+
+    bool AtEnd() const
+    {
+        return pos >= data.Num();
+    }
+
+    template<typename T>
+    T ReadLittleEndian()
+    {
+        if (!ok || pos + (int32)sizeof(T) > data.Num())
+        {
+            ok = false;
+            return 0;
+        }
+
+        uint64 value = 0;
+        for (int32 i = 0; i < (int32)sizeof(T); i++)
+            value |= (uint64)data[pos++] << (i * 8);
+        return (T)value;
+    }
+
+    int64 ReadVarint()
+    {
+        uint64 zigzag = 0;
+        for (int32 shift = 0; shift < 64; shift += 7)
+        {
+            const uint8 byte = ReadLittleEndian<uint8>();
+            if (!ok)
+                return 0;
+
+            zigzag |= (uint64)(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0)
+                return (int64)(zigzag >> 1) ^ -(int64)(zigzag & 1);
+        }
+        ok = false;
+        return 0;
+    }
+
+    FString ReadShortString()
+    {
+        const int32 length = ReadLittleEndian<uint8>();
+        if (!ok || pos + length > data.Num())
+        {
+            ok = false;
+            return FString();
+        }
+
+        FUTF8ToTCHAR converter((const ANSICHAR*)data.GetData() + pos, length);
+        pos += length;
+        return FString(converter.Get(), converter.Length());
+    }
+
+    TArrayView<const uint8> data;
+    int32 pos = 0;
+    bool ok = true;
+};
+
+// ===================== FTrackerDeltaEncoder =====================
+FTrackerDeltaEncoder::FTrackerDeltaEncoder(int32 inKeyframeInterval)
+    : keyframeInterval(FMath::Max(inKeyframeInterval, 1))
+    , tableId(0)
+    , hasTable(false)
+    , tableMotionType(EMotionType::Trajectory)
+    , keyframePending(true)
+    , framesSinceKeyframe(0)
+    , sequence(0)
+    , lastStampMs(0)
+{
+}
+
+void FTrackerDeltaEncoder::Reset()
+{
+    hasTable = false;
+    keyframePending = true;
+    sequence = 0;
+}
+
+void FTrackerDeltaEncoder::ForceKeyframe()
+{
+    // 丢失的可能正是索引表，随关键帧一并重发
+    hasTable = false;
+    keyframePending = true;
+}
+
+void FTrackerDeltaEncoder::Encode(TArray<uint8>& out, EMotionType motionType, const FString& bizId, int64 stampMs, TArrayView<const FTrackerData> trackers)
+{
+    const TArrayView<const FTrackerData> entries = trackers.Left(DELTA_MAX_ENTRIES);
+    const bool tableChanged = !hasTable || !TableMatches(motionType, bizId, entries);
+    if (tableChanged || keyframePending || framesSinceKeyframe >= keyframeInterval - 1)
+    {
+        // 每个关键帧前都重发索引表：携带索引表的数据报丢失时，解码端最多等待一个关键帧间隔即可恢复
+        WriteIndexTable(out, motionType, bizId, entries, tableChanged);
+        WriteKeyframe(out, stampMs, entries);
+    }
+    else
+    {
+        WriteDelta(out, stampMs, entries);
+    }
+}
+
+bool FTrackerDeltaEncoder::TableMatches(EMotionType motionType, const FString& bizId, TArrayView<const FTrackerData> trackers) const
+{
+    if (motionType != tableMotionType || trackers.Num() != tableSns.Num() || !bizId.Equals(tableBizId, ESearchCase::CaseSensitive))
+        return false;
+
+    for (int32 i = 0; i < trackers.Num(); i++)
+    {
+        if (!trackers[i].sn.Equals(tableSns[i], ESearchCase::CaseSensitive))
+            return false;
+    }
+    return true;
+}
+
+void FTrackerDeltaEncoder::WriteHeader(TArray<uint8>& out, ETrackerPacketType type)
+{
+    out.Add(TRACKER_DELTA_VERSION);
+    out.Add((uint8)type);
+    AppendLittleEndian<uint16>(out, sequence++);
+}
+
+void FTrackerDeltaEncoder::WriteIndexTable(TArray<uint8>& out, EMotionType motionType, const FString& bizId, TArrayView<const FTrackerData> trackers, bool newTable)
+{
+    // 内容未变的重发沿用原 tableId
+    if (newTable)
+    {
+        tableId++;
+        hasTable = true;
+        tableMotionType = motionType;
+        tableBizId = bizId;
+        tableSns.Reset(trackers.Num());
+        for (const FTrackerData& t : trackers)
+            tableSns.Add(t.sn);
+    }
+
+    WriteHeader(out, ETrackerPacketType::IndexTable);
+    out.Add(tableId);
+    out.Add((uint8)motionType);
+    AppendShortString(out, bizId);
+    out.Add((uint8)trackers.Num());
+    for (const FTrackerData& t : trackers)
+        AppendShortString(out, t.sn);
+}
+
+void FTrackerDeltaEncoder::WriteKeyframe(TArray<uint8>& out, int64 stampMs, TArrayView<const FTrackerData> trackers)
+{
+    WriteHeader(out, ETrackerPacketType::Keyframe);
+    out.Add(tableId);
+    AppendLittleEndian<int64>(out, stampMs);
+
+    poses.SetNum(trackers.Num());
+    for (int32 i = 0; i < trackers.Num(); i++)
+    {
+        const FTrackerData& t = trackers[i];
+        FTrackerQuantizedPose& pose = poses[i];
+        QuantizePosition(t.lt, pose.lt);
+        QuantizeRotation(t.lr, nullptr, pose.lr);
+        QuantizePosition(t.gt, pose.gt);
+        QuantizeRotation(t.gr, nullptr, pose.gr);
+        pose.isConfidence = t.bIsConfidence;
+
+        out.Add(pose.isConfidence ? DELTA_FLAG_CONFIDENCE : 0);
+        for (int32 c = 0; c < 3; c++)
+            AppendLittleEndian<int32>(out, pose.lt[c]);
+        for (int32 c = 0; c < 4; c++)
+            AppendLittleEndian<int16>(out, pose.lr[c]);
+        for (int32 c = 0; c < 3; c++)
+            AppendLittleEndian<int32>(out, pose.gt[c]);
+        for (int32 c = 0; c < 4; c++)
+            AppendLittleEndian<int16>(out, pose.gr[c]);
+    }
+
+    keyframePending = false;
+    framesSinceKeyframe = 0;
+    lastStampMs = stampMs;
+}
+
+void FTrackerDeltaEncoder::WriteDelta(TArray<uint8>& out, int64 stampMs, TArrayView<const FTrackerData> trackers)
+{
+    WriteHeader(out, ETrackerPacketType::Delta);
+    out.Add(tableId);
+    AppendVarint(out, stampMs - lastStampMs);
+
+    for (int32 i = 0; i < trackers.Num(); i++)
+    {
+        const FTrackerData& t = trackers[i];
+        FTrackerQuantizedPose& pose = poses[i];
+
+        FTrackerQuantizedPose next;
+        QuantizePosition(t.lt, next.lt);
+        QuantizeRotation(t.lr, pose.lr, next.lr);
+        QuantizePosition(t.gt, next.gt);
+        QuantizeRotation(t.gr, pose.gr, next.gr);
+        next.isConfidence = t.bIsConfidence;
+
+        uint8 flags = next.isConfidence ? DELTA_FLAG_CONFIDENCE : 0;
+        if (FMemory::Memcmp(next.lt, pose.lt, sizeof(next.lt)) != 0)
+            flags |= DELTA_FLAG_LT;
+        if (FMemory::Memcmp(next.lr, pose.lr, sizeof(next.lr)) != 0)
+            flags |= DELTA_FLAG_LR;
+        if (FMemory::Memcmp(next.gt, pose.gt, sizeof(next.gt)) != 0)
+            flags |= DELTA_FLAG_GT;
+        if (FMemory::Memcmp(next.gr, pose.gr, sizeof(next.gr)) != 0)
+            flags |= DELTA_FLAG_GR;
+
+        out.Add(flags);
+        if (flags & DELTA_FLAG_LT)
+        {
+            for (int32 c = 0; c < 3; c++)
+                AppendVarint(out, (int64)next.lt[c] - pose.lt[c]);
+        }
+        if (flags & DELTA_FLAG_LR)
+        {
+            for (int32 c = 0; c < 4; c++)
+                AppendVarint(out, (int64)next.lr[c] - pose.lr[c]);
+        }
+        if (flags & DELTA_FLAG_GT)
+        {
+            for (int32 c = 0; c < 3; c++)
+                AppendVarint(out, (int64)next.gt[c] - pose.gt[c]);
+        }
+        if (flags & DELTA_FLAG_GR)
+        {
+            for (int32 c = 0; c < 4; c++)
+                AppendVarint(out, (int64)next.gr[c] - pose.gr[c]);
+        }
+
+        // 以量化后的值为基准，与解码端保持一致
+        pose = next;
+    }
+
+    framesSinceKeyframe++;
+    lastStampMs = stampMs;
+}
+
+// ===================== FTrackerDeltaDecoder =====================
+FTrackerDeltaDecoder::FTrackerDeltaDecoder()
+{
+    Reset();
+}
+
+void FTrackerDeltaDecoder::Reset()
+{
+    hasTable = false;
+    tableId = 0;
+    motionType = EMotionType::Trajectory;
+    bizId.Reset();
+    sns.Reset();
+    hasSequence = false;
+    lastSequence = 0;
+    waitingKeyframe = true;
+    lostPackets = 0;
+    lastStampMs = 0;
+    poses.Reset();
+}
+
+void FTrackerDeltaDecoder::CheckSequence(uint16 received)
+{
+    const uint16 expected = (uint16)(lastSequence + 1);
+    if (hasSequence && received != expected)
+    {
+        lostPackets += (uint16)(received - expected);
+        waitingKeyframe = true;
+    }
+    hasSequence = true;
+    lastSequence = received;
+}
+
+void FTrackerDeltaDecoder::OutputReport(TArray<FTrackerReport>& outReports) const
+{
+    FTrackerReport& report = outReports.AddDefaulted_GetRef();
+    report.motionType = motionType;
+    report.bizId = bizId;
+    report.stampMs = lastStampMs;
+    report.trackers.SetNum(poses.Num());
+    for (int32 i = 0; i < poses.Num(); i++)
+    {
+        const FTrackerQuantizedPose& pose = poses[i];
+        FTrackerData& t = report.trackers[i];
+        t.sn = sns[i];
+        t.lt = DequantizePosition(pose.lt);
+        t.lr = DequantizeRotation(pose.lr);
+        t.gt = DequantizePosition(pose.gt);
+        t.gr = DequantizeRotation(pose.gr);
+        t.bIsConfidence = pose.isConfidence;
+    }
+}
+
+ETrackerDecodeResult FTrackerDeltaDecoder::Decode(TArrayView<const uint8> data, TArray<FTrackerReport>& outReports)
+{
+    FDeltaReader reader(data);
+    while (!reader.AtEnd())
+    {
+        const uint8 version = reader.ReadLittleEndian<uint8>();
+        const ETrackerPacketType type = (ETrackerPacketType)reader.ReadLittleEndian<uint8>();
+        const uint16 sequence = reader.ReadLittleEndian<uint16>();
+        if (!reader.ok || version != TRACKER_DELTA_VERSION)
+            return ETrackerDecodeResult::Malformed;
+
+        CheckSequence(sequence);
+
+        if (type == ETrackerPacketType::IndexTable)
+        {
+            const uint8 newTableId = reader.ReadLittleEndian<uint8>();
+            const EMotionType newMotionType = (EMotionType)reader.ReadLittleEndian<uint8>();
+            FString newBizId = reader.ReadShortString();
+            const int32 count = reader.ReadLittleEndian<uint8>();
+            TArray<FString> newSns;
+            newSns.Reserve(count);
+            for (int32 i = 0; i < count && reader.ok; i++)
+                newSns.Add(reader.ReadShortString());
+
+            if (!reader.ok)
+                return ETrackerDecodeResult::Malformed;
+
+            hasTable = true;
+            tableId = newTableId;
+            motionType = newMotionType;
+            bizId = MoveTemp(newBizId);
+            sns = MoveTemp(newSns);
+            // 新索引表之后必须先有关键帧
+            waitingKeyframe = true;
+            continue;
+        }
+
+        const uint8 packetTableId = reader.ReadLittleEndian<uint8>();
+        if (!reader.ok)
+            return ETrackerDecodeResult::Malformed;
+
+        // 索引表未知时无法确定包长，本次输入中剩余的数据包一并放弃
+        if (!hasTable || packetTableId != tableId)
+        {
+            waitingKeyframe = true;
+            return ETrackerDecodeResult::NeedKeyframe;
+        }
+
+        if (type == ETrackerPacketType::Keyframe)
+        {
+            const int64 stampMs = reader.ReadLittleEndian<int64>();
+            TArray<FTrackerQuantizedPose> keyPoses;
+            keyPoses.SetNum(sns.Num());
+            for (FTrackerQuantizedPose& pose : keyPoses)
+            {
+                pose.isConfidence = (reader.ReadLittleEndian<uint8>() & DELTA_FLAG_CONFIDENCE) != 0;
+                for (int32 c = 0; c < 3; c++)
+                    pose.lt[c] = reader.ReadLittleEndian<int32>();
+                for (int32 c = 0; c < 4; c++)
+                    pose.lr[c] = reader.ReadLittleEndian<int16>();
+                for (int32 c = 0; c < 3; c++)
+                    pose.gt[c] = reader.ReadLittleEndian<int32>();
+                for (int32 c = 0; c < 4; c++)
+                    pose.gr[c] = reader.ReadLittleEndian<int16>();
+            }
+
+            if (!reader.ok)
+                return ETrackerDecodeResult::Malformed;
+
+            poses = MoveTemp(keyPoses);
+            lastStampMs = stampMs;
+            waitingKeyframe = false;
+            OutputReport(outReports);
+        }
+        else if (type == ETrackerPacketType::Delta)
+        {
+            // 基准帧已丢失时增量无法还原，但索引表已知、包长可以确定：照常解析后丢弃，同一批中后续的关键帧仍可还原
+            const int64 stampMs = lastStampMs + reader.ReadVarint();
+            TArray<FTrackerQuantizedPose> nextPoses = poses;
+            if (waitingKeyframe)
+                nextPoses.SetNum(sns.Num());
+            for (FTrackerQuantizedPose& pose : nextPoses)
+            {
+                const uint8 flags = reader.ReadLittleEndian<uint8>();
+                pose.isConfidence = (flags & DELTA_FLAG_CONFIDENCE) != 0;
+                if (flags & DELTA_FLAG_LT)
+                {
+                    for (int32 c = 0; c < 3; c++)
+                        pose.lt[c] = (int32)(pose.lt[c] + reader.ReadVarint());
+                }
+                if (flags & DELTA_FLAG_LR)
+                {
+                    for (int32 c = 0; c < 4; c++)
+                        pose.lr[c] = (int16)(pose.lr[c] + reader.ReadVarint());
+                }
+                if (flags & DELTA_FLAG_GT)
+                {
+                    for (int32 c = 0; c < 3; c++)
+                        pose.gt[c] = (int32)(pose.gt[c] + reader.ReadVarint());
+                }
+                if (flags & DELTA_FLAG_GR)
+                {
+                    for (int32 c = 0; c < 4; c++)
+                        pose.gr[c] = (int16)(pose.gr[c] + reader.ReadVarint());
+                }
+            }
+
+            if (!reader.ok)
+                return ETrackerDecodeResult::Malformed;
+            if (waitingKeyframe)
+                continue;
+
+            poses = MoveTemp(nextPoses);
+            lastStampMs = stampMs;
+            OutputReport(outReports);
+        }
+        else
+        {
+            return ETrackerDecodeResult::Malformed;
+        }
+    }
+
+    return waitingKeyframe ? ETrackerDecodeResult::NeedKeyframe : ETrackerDecodeResult::Ok;
+}
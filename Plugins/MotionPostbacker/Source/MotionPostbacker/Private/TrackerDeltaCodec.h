@@ -0,0 +1,135 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Enums.h"
+#include "TrackerData.h"
+
+// 增量编码的版本号，与 TRACKER_BINARY_VERSION 共用首字节，服务端据此区分两种二进制格式
+static const uint8 TRACKER_DELTA_VERSION = 2;
+
+// 四元数分量的量化倍数：int16 表示 [-1, 1]，误差约 1.5e-5
+static constexpr double TRACKER_ROTATION_SCALE = 32767.0;
+
+/*
+ * 追踪器增量流格式（小端），每个数据包：u8 版本号 | u8 包类型 | u16 序号
+ *   索引表：u8 tableId | u8 motionType | u8 bizId 长度 + UTF-8 | u8 追踪器数量 | 每个追踪器 u8 sn 长度 + UTF-8
+ *   关键帧：u8 tableId | i64 stamp | 每个追踪器：u8 标志位 | i32x3 lt | i16x4 lr | i32x3 gt | i16x4 gr
+ *   增量帧：u8 tableId | varint stamp 差值 | 每个追踪器：u8 标志位 | 有变化的字段按分量写 varint 差值
+ * 标志位：bit0 isConfidence，bit1~4 依次表示增量帧中 lt/lr/gt/gr 有变化
+ * 位置按 TRACKER_POSITION_SCALE 量化，四元数按 TRACKER_ROTATION_SCALE 逐分量量化；varint 为 zigzag + LEB128
+ * 差值基于双方一致的量化状态计算，误差不随增量帧累积
+ */
+enum class ETrackerPacketType : uint8
+{
+    IndexTable = 0,
+    Keyframe = 1,
+    Delta = 2
+};
+
+// 一帧解码结果
+struct FTrackerReport
+{
+    EMotionType motionType = EMotionType::Trajectory;
+    FString bizId;
+    int64 stampMs = 0;
+    TArray<FTrackerData> trackers;
+};
+
+// 编码双方保存的单个追踪器量化状态
+struct FTrackerQuantizedPose
+{
+    int32 lt[3] = { 0, 0, 0 };
+    int16 lr[4] = { 0, 0, 0, 0 };
+    int32 gt[3] = { 0, 0, 0 };
+    int16 gr[4] = { 0, 0, 0, 0 };
+    bool isConfidence = false;
+};
+
+class FTrackerDeltaEncoder
+{
+public:
+    // keyframeInterval：每隔多少帧发送一次关键帧，<= 1 表示每帧都是关键帧
+    explicit FTrackerDeltaEncoder(int32 inKeyframeInterval = 60);
+
+    // 新会话：下一帧重新发送索引表与关键帧
+    void Reset();
+
+    // 对端可能丢失了数据（丢包、重连）：下一帧重新发送索引表与关键帧
+    void ForceKeyframe();
+
+    // 编码一帧并追加到 out 末尾；每个关键帧前都先写出索引表，sn 列表、bizId 或模式变化时立即发送新索引表与关键帧
+    // 索引表与随后的关键帧写入同一次调用的输出，应放在同一个网络帧（数据报）中发送
+    void Encode(TArray<uint8>& out, EMotionType motionType, const FString& bizId, int64 stampMs, TArrayView<const FTrackerData> trackers);
+
+private:
+    bool TableMatches(EMotionType motionType, const FString& bizId, TArrayView<const FTrackerData> trackers) const;
+    void WriteIndexTable(TArray<uint8>& out, EMotionType motionType, const FString& bizId, TArrayView<const FTrackerData> trackers, bool newTable);
+    void WriteKeyframe(TArray<uint8>& out, int64 stampMs, TArrayView<const FTrackerData> trackers);
+    void WriteDelta(TArray<uint8>& out, int64 stampMs, TArrayView<const FTrackerData> trackers);
+    void WriteHeader(TArray<uint8>& out, ETrackerPacketType type);
+
+    const int32 keyframeInterval;
+
+    // 当前索引表
+    uint8 tableId;
+    bool hasTable;
+    EMotionType tableMotionType;
+    FString tableBizId;
+    TArray<FString> tableSns;
+
+    bool keyframePending;
+    int32 framesSinceKeyframe;
+    uint16 sequence;
+    int64 lastStampMs;
+    TArray<FTrackerQuantizedPose> poses;
+};
+
+enum class ETrackerDecodeResult : uint8
+{
+    Ok,
+    // 检测到丢包或缺少索引表，后续增量帧被丢弃，直到收到新的关键帧
+    NeedKeyframe,
+    // 数据不完整或格式错误
+    Malformed
+};
+
+class FTrackerDeltaDecoder
+{
+public:
+    FTrackerDeltaDecoder();
+
+    void Reset();
+
+    // 解码 data 中的全部数据包，每个关键帧/增量帧追加一条到 outReports
+    ETrackerDecodeResult Decode(TArrayView<const uint8> data, TArray<FTrackerReport>& outReports);
+
+    bool NeedsKeyframe() const
+    {
+        return waitingKeyframe;
+    }
+
+    // 按序号缺口统计的累计丢包数
+    int32 GetLostPackets() const
+    {
+        return lostPackets;
+    }
+
+private:
+    void CheckSequence(uint16 received);
+    void OutputReport(TArray<FTrackerReport>& outReports) const;
+
+    bool hasTable;
+    uint8 tableId;
+    EMotionType motionType;
+    FString bizId;
+    TArray<FString> sns;
+
+    bool hasSequence;
+    uint16 lastSequence;
+    bool waitingKeyframe;
+    int32 lostPackets;
+    int64 lastStampMs;
+    TArray<FTrackerQuantizedPose> poses;
+};
@@ -0,0 +1,408 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "TrackerSampler.h"
+#include "CommandResolver.h"
+#include "TrackerWriter.h"
+#include "TrackerDeltaCodec.h"
+#include "Connector.h"
+#include "HAL/Runnable.h"
+#include "HAL/RunnableThread.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/ThreadSafeBool.h"
+#include "HAL/ThreadSafeCounter.h"
+#include "Misc/ScopeLock.h"
+
+// 剩余等待时间小于该值时改为让出时间片，弥补 Sleep 的调度粒度
+static constexpr double SAMPLER_SPIN_THRESHOLD_SEC = 0.002;
+
+// 统计实测频率与抖动的平滑系数
+static constexpr double SAMPLER_STATS_SMOOTHING = 0.05;
+
+// 采样环形缓冲区（SoA）：第 i 个采样槽中第 t 个追踪器的数据位于下标 i * trackerCount + t
+// 容量在启动时一次分配，运行期间不再分配内存
+struct FTrackerSampleRing
+{
+    void Init(int32 inTrackerCount, int32 inCapacity)
+    {
+        trackerCount = inTrackerCount;
+        capacity = inCapacity;
+        stamps.SetNumZeroed(capacity);
+        lt.SetNumZeroed(capacity * trackerCount);
+        gt.SetNumZeroed(capacity * trackerCount);
+        lr.Init(FQuat::Identity, capacity * trackerCount);
+        gr.Init(FQuat::Identity, capacity * trackerCount);
+        confidence.SetNumZeroed(capacity * trackerCount);
+        Clear();
+    }
+
+    void Clear()
+    {
+        head = 0;
+        count = 0;
+    }
+
+    // 取得下一个写入槽；环满时覆盖最早的采样（发送端跟不上时丢旧保新）
+    int32 Push(int64 stampMs)
+    {
+        const int32 slot = (head + count) % capacity;
+        if (count == capacity)
+            head = (head + 1) % capacity;
+        else
+            count++;
+        stamps[slot] = stampMs;
+        return slot;
+    }
+
+    int32 SlotAt(int32 index) const
+    {
+        return (head + index) % capacity;
+    }
+
+    void Store(int32 slot, int32 tracker, const FTrackerData& data)
+    {
+        const int32 i = slot * trackerCount + tracker;
+        lt[i] = data.lt;
+        lr[i] = data.lr;
+        gt[i] = data.gt;
+        gr[i] = data.gr;
+        confidence[i] = data.bIsConfidence ? 1 : 0;
+    }
+
+    void Load(int32 slot, int32 tracker, FTrackerData& data) const
+    {
+        const int32 i = slot * trackerCount + tracker;
+        data.lt = lt[i];
+        data.lr = lr[i];
+        data.gt = gt[i];
+        data.gr = gr[i];
+        data.bIsConfidence = confidence[i] != 0;
+    }
+
+    int32 trackerCount = 0;
+    int32 capacity = 0;
+    int32 head = 0;
+    int32 count = 0;
+
+    TArray<int64> stamps;
+    TArray<FVector> lt;
+    TArray<FQuat> lr;
+    TArray<FVector> gt;
+    TArray<FQuat> gr;
+    TArray<uint8> confidence;
+};
+
+class FTrackerSamplerWorker : public FRunnable
+{
+public:
+    FTrackerSamplerWorker(const FConnectorSender& inSender, const TArray<FString>& trackerSns, TFunction<bool(const FString&, FTrackerData&)> inPoseSource,
+        float inSampleRate, int32 inSamplesPerFrame, bool inUseBinary, bool inUseDelta, int32 keyframeInterval)
+        : sender(inSender)
+        , poseSource(MoveTemp(inPoseSource))
+        , period(1.0 / FMath::Clamp(inSampleRate, 1.0f, 500.0f))
+        , samplesPerFrame(FMath::Clamp(inSamplesPerFrame, 1, 64))
+        , useBinary(inUseBinary)
+        , useDelta(inUseDelta)
+        , stopping(false)
+        , contextAnalyzing(false)
+        , contextMode(EMotionType::Trajectory)
+        , analyzing(false)
+        , mode(EMotionType::Trajectory)
+        , deltaEncoder(keyframeInterval)
+        , lossCount(inSender.GetLossCount())
+        , measuredInterval(period)
+        , jitterSquared(0.0)
+        , lastSampleTime(0.0)
+    {
+        scratch.SetNum(trackerSns.Num());
+        for (int32 i = 0; i < trackerSns.Num(); i++)
+        {
+            scratch[i].sn = trackerSns[i];
+            scratch[i].lr = FQuat::Identity;
+            scratch[i].gr = FQuat::Identity;
+        }
+
+        // 预留两个网络帧的采样，发送偶尔跟不上时不至于立即丢数据
+        ring.Init(trackerSns.Num(), samplesPerFrame * 2);
+
+        // 时间戳：启动时以 UTC 毫秒对齐一次，之后只按单调时钟递增，不受系统校时影响
+        epochBaseMs = static_cast<int64>((FDateTime::UtcNow() - FDateTime(1970, 1, 1)).GetTotalMilliseconds());
+        monotonicBase = FPlatformTime::Seconds();
+    }
+
+    // 游戏线程调用：更新 bizId 与模式
+    void SetContext(bool inAnalyzing, EMotionType inMode, const FString& inBizId)
+    {
+        FScopeLock lock(&contextMutex);
+        contextAnalyzing = inAnalyzing;
+        contextMode = inMode;
+        contextBizId = inBizId;
+        contextVersion.Increment();
+    }
+
+    void GetStats(float& outRate, float& outJitterMs) const
+    {
+        FScopeLock lock(&statsMutex);
+        outRate = measuredInterval > 0.0 ? (float)(1.0 / measuredInterval) : 0.0f;
+        outJitterMs = (float)(FMath::Sqrt(jitterSquared) * 1000.0);
+    }
+
+    virtual uint32 Run() override
+    {
+        double next = FPlatformTime::Seconds();
+        while (!stopping)
+        {
+            next += period;
+            WaitUntil(next);
+
+            // 落后超过一个周期（如断点、系统挂起）时重新对齐，不补采
+            const double now = FPlatformTime::Seconds();
+            if (now - next > period)
+                next = now;
+
+            UpdateStats(now);
+            SampleOnce(now);
+        }
+        return 0;
+    }
+
+    virtual void Stop() override
+    {
+        stopping = true;
+    }
+
+private:
+    void WaitUntil(double target)
+    {
+        while (!stopping)
+        {
+            const double remaining = target - FPlatformTime::Seconds();
+            if (remaining <= 0.0)
+                return;
+
+            if (remaining > SAMPLER_SPIN_THRESHOLD_SEC)
+                FPlatformProcess::SleepNoStats((float)(remaining - SAMPLER_SPIN_THRESHOLD_SEC));
+            else
+                FPlatformProcess::YieldThread();
+        }
+    }
+
+    void UpdateStats(double now)
+    {
+        if (lastSampleTime > 0.0)
+        {
+            const double interval = now - lastSampleTime;
+            const double deviation = interval - period;
+            FScopeLock lock(&statsMutex);
+            measuredInterval += (interval - measuredInterval) * SAMPLER_STATS_SMOOTHING;
+            jitterSquared += (deviation * deviation - jitterSquared) * SAMPLER_STATS_SMOOTHING;
+        }
+        lastSampleTime = now;
+    }
+
+    // 上下文只在游戏线程修改时才拷贝，避免每个采样周期复制字符串
+    void RefreshContext()
+    {
+        const int32 version = contextVersion.GetValue();
+        if (version == appliedVersion)
+            return;
+
+        FScopeLock lock(&contextMutex);
+        appliedVersion = contextVersion.GetValue();
+        analyzing = contextAnalyzing;
+        mode = contextMode;
+        bizId = contextBizId;
+    }
+
+    void SampleOnce(double now)
+    {
+        RefreshContext();
+        if (!analyzing || bizId.IsEmpty() || !sender.IsConnected())
+        {
+            ring.Clear();
+            return;
+        }
+
+        const int64 stampMs = epochBaseMs + (int64)((now - monotonicBase) * 1000.0);
+        const int32 slot = ring.Push(stampMs);
+        for (int32 t = 0; t < scratch.Num(); t++)
+        {
+            FTrackerData& data = scratch[t];
+            if (!poseSource || !poseSource(data.sn, data))
+                data.bIsConfidence = false;
+            ring.Store(slot, t, data);
+        }
+
+        if (ring.count >= samplesPerFrame)
+            Flush();
+    }
+
+    // 将环中的全部采样编码为一个网络帧发送
+    void Flush()
+    {
+        // 对端可能缺失了之前的帧，增量编码需从索引表与关键帧重新开始
+        const int64 currentLoss = sender.GetLossCount();
+        if (currentLoss != lossCount)
+        {
+            lossCount = currentLoss;
+            deltaEncoder.ForceKeyframe();
+        }
+
+        frame.Reset();
+        for (int32 i = 0; i < ring.count; i++)
+        {
+            const int32 slot = ring.SlotAt(i);
+            for (int32 t = 0; t < scratch.Num(); t++)
+                ring.Load(slot, t, scratch[t]);
+
+            if (useDelta)
+                deltaEncoder.Encode(frame, mode, bizId, ring.stamps[slot], scratch);
+            else if (useBinary)
+                WriteTrackerReportBinary(frame, mode, bizId, ring.stamps[slot], scratch);
+            else
+                WriteTrackerReportJson(frame, mode, bizId, ring.stamps[slot], scratch);
+        }
+        ring.Clear();
+
+        if (frame.Num() > 0)
+            sender.SendFrame(frame);
+    }
+
+    FConnectorSender sender;
+    TFunction<bool(const FString&, FTrackerData&)> poseSource;
+    const double period;
+    const int32 samplesPerFrame;
+    const bool useBinary;
+    const bool useDelta;
+    FThreadSafeBool stopping;
+
+    // 游戏线程写入的上下文
+    FCriticalSection contextMutex;
+    FThreadSafeCounter contextVersion;
+    bool contextAnalyzing;
+    EMotionType contextMode;
+    FString contextBizId;
+
+    // 以下仅采样线程访问
+    int32 appliedVersion = -1;
+    bool analyzing;
+    EMotionType mode;
+    FString bizId;
+    int64 epochBaseMs;
+    double monotonicBase;
+    FTrackerSampleRing ring;
+    // 每个追踪器的最近一次位姿（sn 在启动时设置），编码时复用
+    TArray<FTrackerData> scratch;
+    TArray<uint8> frame;
+    FTrackerDeltaEncoder deltaEncoder;
+    // 上次检查时连接的中断计数
+    int64 lossCount;
+
+    mutable FCriticalSection statsMutex;
+    double measuredInterval;
+    double jitterSquared;
+    double lastSampleTime;
+};
+
+// ===================== UTrackerSampler =====================
+void UTrackerSampler::BeginDestroy()
+{
+    Stop();
+    Super::BeginDestroy();
+}
+
+bool UTrackerSampler::Start(AConnector* connector, const TArray<FString>& trackerSns)
+{
+    Stop();
+
+    if (!connector || trackerSns.Num() == 0)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("TrackerSampler: connector 为空或未指定追踪器"));
+        return false;
+    }
+
+    const FConnectorSender sender = connector->GetSender();
+    if (!sender.IsValid())
+    {
+        UE_LOG(LogTemp, Warning, TEXT("TrackerSampler: connector 尚未连接"));
+        return false;
+    }
+
+    if (!poseSource)
+        UE_LOG(LogTemp, Warning, TEXT("TrackerSampler: 未设置 poseSource，上报的位姿均为不可信"));
+
+    // 二进制与增量帧本身不带分隔符，String 模式的 TCP 字节流上对端无法切分
+    if ((useBinaryEncoding || useDeltaEncoding) && !sender.PreservesFrameBoundaries())
+    {
+        UE_LOG(LogTemp, Error, TEXT("TrackerSampler: 二进制/增量编码需要 connector 使用 LengthPrefixed 分帧（或 UDP），请在 TryConnectServer 之前设置 framingMode"));
+        return false;
+    }
+
+    worker = MakeShared<FTrackerSamplerWorker, ESPMode::ThreadSafe>(sender, trackerSns, poseSource, sampleRate, samplesPerFrame, useBinaryEncoding, useDeltaEncoding, keyframeInterval);
+    UCommandResolver* resolver = UCommandResolver::GetResolver();
+    PushContext(resolver->IsAnalyzing());
+    resolver->onAnalysisStateChanged.AddUniqueDynamic(this, &UTrackerSampler::OnAnalysisStateChanged);
+
+    thread = FRunnableThread::Create(worker.Get(), TEXT("TrackerSampler"), 0, TPri_AboveNormal);
+    if (!thread)
+    {
+        UE_LOG(LogTemp, Error, TEXT("TrackerSampler: 创建采样线程失败"));
+        Stop();
+        return false;
+    }
+
+    UE_LOG(LogTemp, Log, TEXT("TrackerSampler: 已启动，%.1fHz，每帧 %d 个采样，追踪器 %d 个"), sampleRate, samplesPerFrame, trackerSns.Num());
+    return true;
+}
+
+void UTrackerSampler::Stop()
+{
+    if (thread)
+    {
+        thread->Kill(true);
+        delete thread;
+        thread = nullptr;
+    }
+
+    // 未启动过则不访问 resolver，避免在销毁阶段重新创建单例
+    if (!worker)
+        return;
+    worker.Reset();
+    UCommandResolver::GetResolver()->onAnalysisStateChanged.RemoveDynamic(this, &UTrackerSampler::OnAnalysisStateChanged);
+}
+
+float UTrackerSampler::GetMeasuredRate() const
+{
+    float rate = 0.0f, jitter = 0.0f;
+    if (worker)
+        worker->GetStats(rate, jitter);
+    return rate;
+}
+
+float UTrackerSampler::GetJitterMs() const
+{
+    float rate = 0.0f, jitter = 0.0f;
+    if (worker)
+        worker->GetStats(rate, jitter);
+    return jitter;
+}
+
+void UTrackerSampler::OnAnalysisStateChanged(bool isAnalyzing)
+{
+    PushContext(isAnalyzing);
+}
+
+void UTrackerSampler::PushContext(bool isAnalyzing)
+{
+    if (!worker)
+        return;
+
+    UCommandResolver* resolver = UCommandResolver::GetResolver();
+    // 与 UCommandBuilder::TrackerDatas 一致：编辑器下不要求处于分析中，便于调试
+#if WITH_EDITOR
+    const bool analyzing = true;
+#else
+    const bool analyzing = isAnalyzing;
+#endif
+    const EMotionType mode = resolver->GetCurrentMode();
+    worker->SetContext(analyzing && GetTrackerReportCmd(mode) != nullptr, mode, resolver->GetBizId());
+}
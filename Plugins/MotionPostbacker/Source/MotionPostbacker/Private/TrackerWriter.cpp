@@ -0,0 +1,299 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "TrackerWriter.h"
+
+// smallest-three 每个分量的位数与最大量化值
+static const int32 QUAT_COMPONENT_BITS = 15;
+static const uint32 QUAT_COMPONENT_MAX = (1u << QUAT_COMPONENT_BITS) - 1;
+
+// JSON 中浮点数保留的小数位数（厘米/四元数分量下远小于追踪器精度）
+static const int64 JSON_FRACTION_SCALE = 1000000;
+static const int32 JSON_FRACTION_DIGITS = 6;
+
+const ANSICHAR* GetTrackerReportCmd(EMotionType motionType)
+{
+    switch (motionType)
+    {
+    case EMotionType::Trajectory:
+        return "trajectoryAnalysis";
+    case EMotionType::ZShape:
+        return "zshapeTrajectoryAnalysis";
+    default:
+        return nullptr;
+    }
+}
+
+// -------------------------- JSON --------------------------
+static FORCEINLINE void AppendRaw(TArray<uint8>& out, const ANSICHAR* text)
+{
+    out.Append((const uint8*)text, FCStringAnsi::Strlen(text));
+}
+
+static FORCEINLINE void AppendChar(TArray<uint8>& out, ANSICHAR ch)
+{
+    out.Add((uint8)ch);
+}
+
+static void AppendUnsigned(TArray<uint8>& out, uint64 value, int32 minDigits = 1)
+{
+    ANSICHAR digits[24];
+    int32 count = 0;
+    do
+    {
+        digits[count++] = (ANSICHAR)('0' + value % 10);
+        value /= 10;
+    } while (value > 0 || count < minDigits);
+
+    while (count > 0)
+        out.Add((uint8)digits[--count]);
+}
+
+static void AppendInteger(TArray<uint8>& out, int64 value)
+{
+    if (value < 0)
+    {
+        AppendChar(out, '-');
+        AppendUnsigned(out, (uint64)(-(value + 1)) + 1);
+        return;
+    }
+    AppendUnsigned(out, (uint64)value);
+}
+
+// 定点格式化：保留 6 位小数并去掉末尾的 0，用整数运算代替 printf
+static void AppendNumber(TArray<uint8>& out, double value)
+{
+    // JSON 无法表示 NaN/Inf
+    if (!FMath::IsFinite(value))
+    {
+        AppendChar(out, '0');
+        return;
+    }
+
+    // 超出定点范围的值极少出现，退回通用格式
+    if (FMath::Abs(value) >= 1.0e12)
+    {
+        ANSICHAR buffer[32];
+        const int32 length = FCStringAnsi::Snprintf(buffer, sizeof(buffer), "%.17g", value);
+        out.Append((const uint8*)buffer, FMath::Clamp(length, 0, (int32)sizeof(buffer) - 1));
+        return;
+    }
+
+    int64 scaled = (int64)FMath::RoundHalfFromZero(value * (double)JSON_FRACTION_SCALE);
+    if (scaled < 0)
+    {
+        AppendChar(out, '-');
+        scaled = -scaled;
+    }
+
+    AppendUnsigned(out, (uint64)(scaled / JSON_FRACTION_SCALE));
+    int64 fraction = scaled % JSON_FRACTION_SCALE;
+    if (fraction == 0)
+        return;
+
+    int32 digits = JSON_FRACTION_DIGITS;
+    while (fraction % 10 == 0)
+    {
+        fraction /= 10;
+        digits--;
+    }
+    AppendChar(out, '.');
+    AppendUnsigned(out, (uint64)fraction, digits);
+}
+
+// 写出带引号的字符串，按 JSON 规则转义
+static void AppendString(TArray<uint8>& out, const FString& value)
+{
+    AppendChar(out, '"');
+    FTCHARToUTF8 utf8(*value, value.Len());
+    const ANSICHAR* text = utf8.Get();
+    for (int32 i = 0; i < utf8.Length(); i++)
+    {
+        const ANSICHAR ch = text[i];
+        switch (ch)
+        {
+        case '"':  AppendRaw(out, "\\\""); break;
+        case '\\': AppendRaw(out, "\\\\"); break;
+        case '\n': AppendRaw(out, "\\n"); break;
+        case '\r': AppendRaw(out, "\\r"); break;
+        case '\t': AppendRaw(out, "\\t"); break;
+        default:
+            if ((uint8)ch < 0x20)
+            {
+                ANSICHAR escaped[8];
+                FCStringAnsi::Snprintf(escaped, sizeof(escaped), "\\u%04x", (uint32)(uint8)ch);
+                AppendRaw(out, escaped);
+            }
+            else
+            {
+                AppendChar(out, ch);
+            }
+            break;
+        }
+    }
+    AppendChar(out, '"');
+}
+
+static void AppendVector(TArray<uint8>& out, const FVector& v)
+{
+    AppendChar(out, '[');
+    AppendNumber(out, v.X);
+    AppendChar(out, ',');
+    AppendNumber(out, v.Y);
+    AppendChar(out, ',');
+    AppendNumber(out, v.Z);
+    AppendChar(out, ']');
+}
+
+static void AppendQuat(TArray<uint8>& out, const FQuat& q)
+{
+    AppendChar(out, '[');
+    AppendNumber(out, q.X);
+    AppendChar(out, ',');
+    AppendNumber(out, q.Y);
+    AppendChar(out, ',');
+    AppendNumber(out, q.Z);
+    AppendChar(out, ',');
+    AppendNumber(out, q.W);
+    AppendChar(out, ']');
+}
+
+void WriteTrackerReportJson(TArray<uint8>& out, EMotionType motionType, const FString& bizId, int64 stampMs, TArrayView<const FTrackerData> trackers)
+{
+    const ANSICHAR* cmd = GetTrackerReportCmd(motionType);
+    if (!cmd)
+        return;
+
+    AppendRaw(out, "{\"cmd\":\"");
+    AppendRaw(out, cmd);
+    AppendRaw(out, "\",\"bizId\":");
+    AppendString(out, bizId);
+    AppendRaw(out, ",\"action\":\"trReport\",\"stamp\":");
+    AppendInteger(out, stampMs);
+    AppendRaw(out, ",\"trackerList\":[");
+
+    for (int32 i = 0; i < trackers.Num(); i++)
+    {
+        const FTrackerData& t = trackers[i];
+        if (i > 0)
+            AppendChar(out, ',');
+
+        AppendRaw(out, "{\"sn\":");
+        AppendString(out, t.sn);
+        AppendRaw(out, ",\"lt\":");
+        AppendVector(out, t.lt);
+        AppendRaw(out, ",\"lr\":");
+        AppendQuat(out, t.lr);
+        AppendRaw(out, ",\"gt\":");
+        AppendVector(out, t.gt);
+        AppendRaw(out, ",\"gr\":");
+        AppendQuat(out, t.gr);
+        AppendRaw(out, t.bIsConfidence ? ",\"isConfidence\":true}" : ",\"isConfidence\":false}");
+    }
+
+    AppendRaw(out, "]}\r\n");
+}
+
+// -------------------------- Binary --------------------------
+template<typename T>
+static FORCEINLINE void AppendLittleEndian(TArray<uint8>& out, T value)
+{
+    for (int32 i = 0; i < (int32)sizeof(T); i++)
+        out.Add((uint8)((uint64)value >> (i * 8)));
+}
+
+// u8 长度 + UTF-8，超过 255 字节的部分被截断
+static void AppendShortString(TArray<uint8>& out, const FString& value)
+{
+    FTCHARToUTF8 utf8(*value, value.Len());
+    const int32 length = FMath::Min(utf8.Length(), 255);
+    out.Add((uint8)length);
+    out.Append((const uint8*)utf8.Get(), length);
+}
+
+static void AppendPosition(TArray<uint8>& out, const FVector& v)
+{
+    const double limit = (double)MAX_int32;
+    AppendLittleEndian<int32>(out, (int32)FMath::Clamp(FMath::RoundHalfFromZero(v.X * TRACKER_POSITION_SCALE), -limit, limit));
+    AppendLittleEndian<int32>(out, (int32)FMath::Clamp(FMath::RoundHalfFromZero(v.Y * TRACKER_POSITION_SCALE), -limit, limit));
+    AppendLittleEndian<int32>(out, (int32)FMath::Clamp(FMath::RoundHalfFromZero(v.Z * TRACKER_POSITION_SCALE), -limit, limit));
+}
+
+static void AppendRotation(TArray<uint8>& out, const FQuat& q)
+{
+    const uint64 packed = EncodeQuatSmallestThree(q);
+    for (int32 i = 0; i < 6; i++)
+        out.Add((uint8)(packed >> (i * 8)));
+}
+
+void WriteTrackerReportBinary(TArray<uint8>& out, EMotionType motionType, const FString& bizId, int64 stampMs, TArrayView<const FTrackerData> trackers)
+{
+    const int32 count = FMath::Min(trackers.Num(), 255);
+    out.Add(TRACKER_BINARY_VERSION);
+    out.Add((uint8)motionType);
+    AppendLittleEndian<int64>(out, stampMs);
+    AppendShortString(out, bizId);
+    out.Add((uint8)count);
+
+    for (int32 i = 0; i < count; i++)
+    {
+        const FTrackerData& t = trackers[i];
+        AppendShortString(out, t.sn);
+        out.Add(t.bIsConfidence ? 1 : 0);
+        AppendPosition(out, t.lt);
+        AppendRotation(out, t.lr);
+        AppendPosition(out, t.gt);
+        AppendRotation(out, t.gr);
+    }
+}
+
+uint64 EncodeQuatSmallestThree(const FQuat& q)
+{
+    // 未初始化或退化的四元数按单位四元数处理
+    FQuat n = q.SizeSquared() > UE_SMALL_NUMBER ? q.GetNormalized() : FQuat::Identity;
+    double c[4] = { n.X, n.Y, n.Z, n.W };
+
+    int32 largest = 0;
+    for (int32 i = 1; i < 4; i++)
+    {
+        if (FMath::Abs(c[i]) > FMath::Abs(c[largest]))
+            largest = i;
+    }
+
+    // q 与 -q 表示同一旋转，翻转使最大分量为正，解码时即可由其余三个分量还原
+    const double sign = c[largest] < 0.0 ? -1.0 : 1.0;
+
+    uint64 packed = (uint64)largest;
+    for (int32 i = 0; i < 4; i++)
+    {
+        if (i == largest)
+            continue;
+
+        // 其余分量的取值范围为 [-1/√2, 1/√2]
+        const double normalized = (c[i] * sign * UE_DOUBLE_SQRT_2 + 1.0) * 0.5;
+        const uint32 quantized = (uint32)FMath::Clamp(FMath::RoundToInt(normalized * QUAT_COMPONENT_MAX), 0, (int32)QUAT_COMPONENT_MAX);
+        packed = (packed << QUAT_COMPONENT_BITS) | quantized;
+    }
+    return packed;
+}
+
+FQuat DecodeQuatSmallestThree(uint64 packed)
+{
+    double c[4];
+    const int32 largest = (int32)((packed >> (QUAT_COMPONENT_BITS * 3)) & 3);
+
+    double sumSquares = 0.0;
+    int32 shift = QUAT_COMPONENT_BITS * 2;
+    for (int32 i = 0; i < 4; i++)
+    {
+        if (i == largest)
+            continue;
+
+        const uint32 quantized = (uint32)((packed >> shift) & QUAT_COMPONENT_MAX);
+        c[i] = ((double)quantized / QUAT_COMPONENT_MAX * 2.0 - 1.0) / UE_DOUBLE_SQRT_2;
+        sumSquares += c[i] * c[i];
+        shift -= QUAT_COMPONENT_BITS;
+    }
+    c[largest] = FMath::Sqrt(FMath::Max(0.0, 1.0 - sumSquares));
+
+    return FQuat(c[0], c[1], c[2], c[3]);
+}
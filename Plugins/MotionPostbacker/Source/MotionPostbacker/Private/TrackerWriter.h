@@ -0,0 +1,30 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Enums.h"
+#include "TrackerData.h"
+
+// 二进制编码的版本号，格式变化时递增，服务端据此选择解码方式
+static const uint8 TRACKER_BINARY_VERSION = 1;
+
+// 二进制编码中位置的量化倍数：1 个单位 = 0.01 厘米，int32 可表示 ±21 公里
+static constexpr double TRACKER_POSITION_SCALE = 100.0;
+
+// trReport 指令的 cmd，motionType 不支持上报时返回 nullptr
+const ANSICHAR* GetTrackerReportCmd(EMotionType motionType);
+
+// 追踪器上报（JSON）：直接格式化进 UTF-8 缓冲区并以 \r\n 结尾，字段与顺序与原 DOM 序列化一致
+// 追加到 out 末尾，便于多条记录拼成一个网络帧；调用方负责复用与清空缓冲区
+void WriteTrackerReportJson(TArray<uint8>& out, EMotionType motionType, const FString& bizId, int64 stampMs, TArrayView<const FTrackerData> trackers);
+
+// 追踪器上报（紧凑二进制，小端）：
+//   u8 版本号 | u8 motionType | i64 stamp | u8 bizId 长度 + UTF-8 | u8 追踪器数量
+//   每个追踪器：u8 sn 长度 + UTF-8 | u8 标志位(bit0 isConfidence) | i32x3 lt | 6B lr | i32x3 gt | 6B gr
+// 位置按 TRACKER_POSITION_SCALE 量化，四元数为 smallest-three 编码（2 位最大分量下标 + 3 x 15 位）
+void WriteTrackerReportBinary(TArray<uint8>& out, EMotionType motionType, const FString& bizId, int64 stampMs, TArrayView<const FTrackerData> trackers);
+
+// smallest-three 四元数编解码，结果为 48 位（低 6 字节有效）
+uint64 EncodeQuatSmallestThree(const FQuat& q);
+FQuat DecodeQuatSmallestThree(uint64 packed);
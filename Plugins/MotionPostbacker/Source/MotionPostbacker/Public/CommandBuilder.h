@@ -18,9 +18,10 @@ public:
 	/// </summary>
 	/// <param name="clipperSn"> 无菌钳传感器 </param>
 	/// <param name="dummySn"> 假人传感器 </param>
+	/// <param name="fps"> 追踪器上报频率，应与 UTrackerSampler 的 sampleRate 一致 </param>
 	/// <returns> command Json </returns>
     UFUNCTION(BlueprintPure, Category = "CommandBuilder")
-    static FString GlobalConfigCommand(const FString& clipperSn, const FString& dummySn);
+    static FString GlobalConfigCommand(const FString& clipperSn, const FString& dummySn, int32 fps = 60);
 
 	/// <summary>
 	/// 开始动作分析指令
@@ -53,4 +54,13 @@ public:
 	/// <returns> command Json </returns>
     UFUNCTION(BlueprintPure, Category = "CommandBuilder")
     static FString TrackerDatas(const TArray<FTrackerData>& trackers);
+
+	/// <summary>
+	/// 追踪器数据上报（仅 C++）：直接写入 UTF-8/二进制缓冲区，不构建 JSON DOM，可配合 AConnector::SendFrame 发送
+	/// </summary>
+	/// <param name="trackers"> FTrackerData 数组 </param>
+	/// <param name="outBytes"> 输出缓冲区，原内容被覆盖，容量保留以便逐帧复用 </param>
+	/// <param name="binary"> 是否使用紧凑二进制编码（版本号 + 量化位置 + smallest-three 四元数），需服务端支持 </param>
+	/// <returns> 是否需要上报（未在分析或 bizId 为空时为 false） </returns>
+    static bool TrackerDatasBytes(TArrayView<const FTrackerData> trackers, TArray<uint8>& outBytes, bool binary = false);
 };
@@ -6,11 +6,12 @@
 #include "UObject/Object.h"
 #include "UObject/ObjectMacros.h"
 #include "HAL/CriticalSection.h"
-#include "Runtime/Json/Public/Dom/JsonObject.h"
-#include "Runtime/Core/Public/Templates/SharedPointer.h"
 #include "Enums.h"
 #include "CommandResolver.generated.h"
 
+struct FCommandPacket;
+struct FCommandRoute;
+
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FAnalysisStateDelegate, bool, isAnalyzing);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FMessageDelegate, const FString&, message, EMessageType, messageType);
 
@@ -37,16 +38,23 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Motion")
 		void Resolve(const FString& json);
 
+	// 分帧模式（EConnectorFraming::LengthPrefixed）下每次收到的都是完整的一条指令，跳过粘包处理直接解析
+	UFUNCTION(BlueprintCallable, Category = "Motion")
+		void ResolveFrame(const FString& json);
+
+	// 更新分析状态并广播 onAnalysisStateChanged（即便状态未变，bizId 或模式也可能已更新）
 	UFUNCTION(BlueprintCallable, Category = "Motion")
-		void SetAnalyzing(bool analyzing) { isAnalyzing = analyzing; }
+		void SetAnalyzing(bool analyzing);
 	EMotionType GetCurrentMode() { return currentMode; }
 	bool IsAnalyzing() { return isAnalyzing; }
 
 private:
     // 处理单条 JSON 指令（已按粘包拆分后的一个包）
-    void ResolveOne(const FString& json);
+    void ResolveOne(FStringView json);
     // 粘包处理缓冲区：累积未完整的包体，待下次补齐后再解析
-    FString recvBuffer;
+    TArray<TCHAR> recvBuffer;
+    // recvBuffer 中已确认不含换行的长度，下次只扫描新到达的数据
+    int32 recvScanPos = 0;
 
     static const int32 SUCCESS_CODE = 1000;
     static UCommandResolver* Instance;
@@ -56,25 +64,27 @@ private:
 	bool isAnalyzing;
 	FString currentBizId;
 
-	void OnRescueAppConfig(const TSharedPtr<FJsonObject>& json);
+	// 按路由键查找指令（"cmd"）与子指令（"cmd/action"）的 handler，两张路由表见 CommandResolver.cpp
+	static const FCommandRoute* FindCommand(uint64 key);
+	static const FCommandRoute* FindAction(uint64 key);
+	void DispatchAction(const FCommandRoute& command, const FCommandPacket& packet);
+
+	void OnRescueAppConfig(const FCommandPacket& packet);
 
 	// trajectory
-	void OnTrajectoryAnalysis(const TSharedPtr<FJsonObject>& json);
-	void OnTrajectoryAnalysis_Begin(const TSharedPtr<FJsonObject>& json);
-	void OnTrajectoryAnalysis_Stop(const TSharedPtr<FJsonObject>& json);
-	void OnTrajectoryAnalysis_TrReport(const TSharedPtr<FJsonObject>& json);
-	void OnTrajectoryAnalysis_Result(const TSharedPtr<FJsonObject>& json);
+	void OnTrajectoryAnalysis_Begin(const FCommandPacket& packet);
+	void OnTrajectoryAnalysis_Stop(const FCommandPacket& packet);
+	void OnTrajectoryAnalysis_TrReport(const FCommandPacket& packet);
+	void OnTrajectoryAnalysis_Result(const FCommandPacket& packet);
 
 	// cpr
-	void OnCprAnalysis(const TSharedPtr<FJsonObject>& json);
-	void OnCprAnalysis_Begin(const TSharedPtr<FJsonObject>& json);
-	void OnCprAnalysis_End(const TSharedPtr<FJsonObject>& json);
-	void OnCprAnalysis_Result(const TSharedPtr<FJsonObject>& json);
+	void OnCprAnalysis_Begin(const FCommandPacket& packet);
+	void OnCprAnalysis_End(const FCommandPacket& packet);
+	void OnCprAnalysis_Result(const FCommandPacket& packet);
 
 	// zshape
-	void OnZShapeTrajectoryAnalysis(const TSharedPtr<FJsonObject>& json);
-	void OnZShapeTrajectoryAnalysis_Begin(const TSharedPtr<FJsonObject>& json);
-	void OnZShapeTrajectoryAnalysis_Stop(const TSharedPtr<FJsonObject>& json);
-	void OnZShapeTrajectoryAnalysis_TrReport(const TSharedPtr<FJsonObject>& json);
-	void OnZShapeTrajectoryAnalysis_Result(const TSharedPtr<FJsonObject>& json);
+	void OnZShapeTrajectoryAnalysis_Begin(const FCommandPacket& packet);
+	void OnZShapeTrajectoryAnalysis_Stop(const FCommandPacket& packet);
+	void OnZShapeTrajectoryAnalysis_TrReport(const FCommandPacket& packet);
+	void OnZShapeTrajectoryAnalysis_Result(const FCommandPacket& packet);
 };
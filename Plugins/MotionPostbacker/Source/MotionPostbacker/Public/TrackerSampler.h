@@ -0,0 +1,87 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Object.h"
+#include "UObject/ObjectMacros.h"
+#include "Enums.h"
+#include "TrackerData.h"
+#include "TrackerSampler.generated.h"
+
+class AConnector;
+class FRunnableThread;
+
+/*
+ * 追踪器采样器：独立线程按固定频率采集追踪器位姿，写入预分配的环形缓冲区，
+ * 攒够 samplesPerFrame 个采样后编码为一个网络帧，经 FConnectorSender 直接发送，全程不经过游戏线程
+ */
+UCLASS(BlueprintType)
+class MOTIONPOSTBACKER_API UTrackerSampler : public UObject
+{
+	GENERATED_BODY()
+public:
+	virtual void BeginDestroy() override;
+
+	// 采样频率（Hz），对下一次 Start 生效；应与 GlobalConfigCommand 上报的 fps 一致
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Motion", meta = (ClampMin = "1", ClampMax = "500"))
+		float sampleRate = 60.0f;
+
+	// 每个网络帧打包的采样数：多个采样合并为一次发送，降低系统调用与包头开销
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Motion", meta = (ClampMin = "1", ClampMax = "64"))
+		int32 samplesPerFrame = 1;
+
+	// 使用紧凑二进制编码（需服务端支持，且 connector 使用 LengthPrefixed 分帧或 UDP），否则为逐行 JSON
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Motion")
+		bool useBinaryEncoding = false;
+
+	// 使用增量编码（需服务端支持，优先于 useBinaryEncoding）：sn 只随索引表在每个关键帧前发送，其余为量化差值
+	// 发送队列丢弃消息或重连后自动重发索引表与关键帧
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Motion")
+		bool useDeltaEncoding = false;
+
+	// 增量编码下每隔多少个采样发送一次关键帧；UDP 下对端丢包只能靠关键帧恢复，不宜过大
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Motion", meta = (ClampMin = "1", ClampMax = "600"))
+		int32 keyframeInterval = 60;
+
+	// 位姿采样回调（仅 C++，需在 Start 之前设置）：在采样线程调用，必须线程安全
+	// 返回 false 表示该追踪器本次无数据，沿用上一次的位姿并标记为不可信
+	TFunction<bool(const FString& sn, FTrackerData& outData)> poseSource;
+
+	/// <summary>
+	/// 开始采样
+	/// </summary>
+	/// <param name="connector"> 发送所用的连接，需已调用 TryConnectServer </param>
+	/// <param name="trackerSns"> 需要采样的追踪器序列号 </param>
+	/// <returns> 是否成功启动 </returns>
+	UFUNCTION(BlueprintCallable, Category = "Motion")
+		bool Start(AConnector* connector, const TArray<FString>& trackerSns);
+
+	/// <summary>
+	/// 停止采样，等待采样线程退出（最多一个采样周期）
+	/// </summary>
+	UFUNCTION(BlueprintCallable, Category = "Motion")
+		void Stop();
+
+	UFUNCTION(BlueprintPure, Category = "Motion")
+		bool IsRunning() const { return thread != nullptr; }
+
+	// 实测采样频率（Hz）
+	UFUNCTION(BlueprintPure, Category = "Motion")
+		float GetMeasuredRate() const;
+
+	// 采样间隔相对目标周期的抖动（毫秒，均方根）
+	UFUNCTION(BlueprintPure, Category = "Motion")
+		float GetJitterMs() const;
+
+private:
+	// 分析开始/结束时同步 bizId 与模式到采样线程
+	UFUNCTION()
+		void OnAnalysisStateChanged(bool isAnalyzing);
+
+	// isAnalyzing 取自状态变化通知本身，不再回读 resolver，避免与通知顺序不一致
+	void PushContext(bool isAnalyzing);
+
+	TSharedPtr<class FTrackerSamplerWorker, ESPMode::ThreadSafe> worker;
+	FRunnableThread* thread = nullptr;
+};
@@ -0,0 +1,242 @@
+// Copyright PICO Technology Co., Ltd. All rights reserved.
+// This plugin incorporates portions of the Unreal® Engine. Unreal® is a trademark or registered trademark of Epic Games, Inc. in the United States of America and elsewhere.
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "PXR_BoundaryGeometry.h"
+#include "PXR_HMDFunctionLibrary.h"
+
+// Median splits keep the tree balanced, so this covers far more edges than a boundary has
+static constexpr int32 BoundaryStackSize = 64;
+
+void FPXRBoundaryGeometry::Build(TArray<FVector>&& InPoints)
+{
+	Reset();
+	Points = MoveTemp(InPoints);
+	const int32 NumEdges = Points.Num();
+	if (!IsValid())
+	{
+		return;
+	}
+
+	double TwiceArea = 0.0;
+	for (int32 I = 0; I < NumEdges; I++)
+	{
+		const FVector& A = Points[I];
+		const FVector& B = Points[(I + 1) % NumEdges];
+		TwiceArea += A.X * B.Y - B.X * A.Y;
+	}
+	Winding = TwiceArea >= 0.0 ? 1.0f : -1.0f;
+
+	Edges.Reserve(NumEdges);
+	for (int32 I = 0; I < NumEdges; I++)
+	{
+		Edges.Add(I);
+	}
+	Nodes.Reserve(2 * FMath::DivideAndRoundUp(NumEdges, LeafSize));
+	BuildNode(0, NumEdges);
+
+	StartX.SetNumUninitialized(NumEdges);
+	StartY.SetNumUninitialized(NumEdges);
+	DeltaX.SetNumUninitialized(NumEdges);
+	DeltaY.SetNumUninitialized(NumEdges);
+	InvLengthSquared.SetNumUninitialized(NumEdges);
+	for (int32 I = 0; I < NumEdges; I++)
+	{
+		const FVector& A = Points[Edges[I]];
+		const FVector& B = Points[(Edges[I] + 1) % NumEdges];
+		StartX[I] = (float)A.X;
+		StartY[I] = (float)A.Y;
+		DeltaX[I] = (float)(B.X - A.X);
+		DeltaY[I] = (float)(B.Y - A.Y);
+		const float LengthSquared = DeltaX[I] * DeltaX[I] + DeltaY[I] * DeltaY[I];
+		InvLengthSquared[I] = LengthSquared > 0.0f ? 1.0f / LengthSquared : 0.0f;
+	}
+}
+
+void FPXRBoundaryGeometry::Reset()
+{
+	Points.Reset();
+	StartX.Reset();
+	StartY.Reset();
+	DeltaX.Reset();
+	DeltaY.Reset();
+	InvLengthSquared.Reset();
+	Edges.Reset();
+	Nodes.Reset();
+	Winding = 1.0f;
+}
+
+int32 FPXRBoundaryGeometry::BuildNode(int32 First, int32 Count)
+{
+	const int32 NumPoints = Points.Num();
+	auto GetEdgeStart = [this](int32 Edge) { return FVector2f((float)Points[Edge].X, (float)Points[Edge].Y); };
+	auto GetEdgeEnd = [this, NumPoints](int32 Edge) { return FVector2f((float)Points[(Edge + 1) % NumPoints].X, (float)Points[(Edge + 1) % NumPoints].Y); };
+
+	const int32 NodeIndex = Nodes.AddDefaulted();
+	FVector2f Min(MAX_flt, MAX_flt);
+	FVector2f Max(-MAX_flt, -MAX_flt);
+	FVector2f CenterMin(MAX_flt, MAX_flt);
+	FVector2f CenterMax(-MAX_flt, -MAX_flt);
+	for (int32 I = First; I < First + Count; I++)
+	{
+		const FVector2f Start = GetEdgeStart(Edges[I]);
+		const FVector2f End = GetEdgeEnd(Edges[I]);
+		Min = FVector2f::Min(Min, FVector2f::Min(Start, End));
+		Max = FVector2f::Max(Max, FVector2f::Max(Start, End));
+		const FVector2f Center = (Start + End) * 0.5f;
+		CenterMin = FVector2f::Min(CenterMin, Center);
+		CenterMax = FVector2f::Max(CenterMax, Center);
+	}
+	Nodes[NodeIndex].Min = Min;
+	Nodes[NodeIndex].Max = Max;
+
+	if (Count <= LeafSize)
+	{
+		Nodes[NodeIndex].Index = First;
+		Nodes[NodeIndex].Count = Count;
+		return NodeIndex;
+	}
+
+	// Split at the median edge center along the longer axis; the left child directly follows its parent
+	const bool bSplitX = CenterMax.X - CenterMin.X >= CenterMax.Y - CenterMin.Y;
+	MakeArrayView(Edges.GetData() + First, Count).Sort([&](int32 A, int32 B)
+		{
+			const FVector2f CenterA = GetEdgeStart(A) + GetEdgeEnd(A);
+			const FVector2f CenterB = GetEdgeStart(B) + GetEdgeEnd(B);
+			return bSplitX ? CenterA.X < CenterB.X : CenterA.Y < CenterB.Y;
+		});
+	const int32 LeftCount = Count / 2;
+	BuildNode(First, LeftCount);
+	const int32 RightIndex = BuildNode(First + LeftCount, Count - LeftCount);
+	Nodes[NodeIndex].Index = RightIndex;
+	Nodes[NodeIndex].Count = 0;
+	return NodeIndex;
+}
+
+float FPXRBoundaryGeometry::GetBoxDistanceSquared(const FNode& Node, const FVector2f& Point)
+{
+	const float DX = FMath::Max3(Node.Min.X - Point.X, 0.0f, Point.X - Node.Max.X);
+	const float DY = FMath::Max3(Node.Min.Y - Point.Y, 0.0f, Point.Y - Node.Max.Y);
+	return DX * DX + DY * DY;
+}
+
+bool FPXRBoundaryGeometry::IsInside(const FVector& Point) const
+{
+	if (!IsValid())
+	{
+		return false;
+	}
+
+	// Crossing number of a ray towards +X, only visiting the nodes the ray passes through
+	const float PX = (float)Point.X;
+	const float PY = (float)Point.Y;
+	bool bInside = false;
+	int32 Stack[BoundaryStackSize];
+	int32 StackSize = 0;
+	Stack[StackSize++] = 0;
+	while (StackSize > 0)
+	{
+		const int32 NodeIndex = Stack[--StackSize];
+		const FNode& Node = Nodes[NodeIndex];
+		if (Node.Max.X < PX || Node.Min.Y > PY || Node.Max.Y < PY)
+		{
+			continue;
+		}
+
+		if (Node.Count == 0)
+		{
+			Stack[StackSize++] = NodeIndex + 1;
+			Stack[StackSize++] = Node.Index;
+			continue;
+		}
+
+		for (int32 I = Node.Index; I < Node.Index + Node.Count; I++)
+		{
+			const float Y0 = StartY[I];
+			const float Y1 = StartY[I] + DeltaY[I];
+			if ((Y0 > PY) != (Y1 > PY) && PX < StartX[I] + (PY - Y0) * DeltaX[I] / DeltaY[I])
+			{
+				bInside = !bInside;
+			}
+		}
+	}
+	return bInside;
+}
+
+float FPXRBoundaryGeometry::GetClosestPoint(const FVector& Point, FVector& OutClosestPoint, FVector& OutNormal) const
+{
+	if (!IsValid())
+	{
+		OutClosestPoint = FVector::ZeroVector;
+		OutNormal = FVector::ZeroVector;
+		return MAX_flt;
+	}
+
+	const FVector2f P((float)Point.X, (float)Point.Y);
+	float BestDistanceSquared = MAX_flt;
+	int32 BestEdge = 0;
+	float BestT = 0.0f;
+
+	int32 Stack[BoundaryStackSize];
+	int32 StackSize = 0;
+	Stack[StackSize++] = 0;
+	while (StackSize > 0)
+	{
+		const int32 NodeIndex = Stack[--StackSize];
+		const FNode& Node = Nodes[NodeIndex];
+		if (GetBoxDistanceSquared(Node, P) >= BestDistanceSquared)
+		{
+			continue;
+		}
+
+		if (Node.Count == 0)
+		{
+			// Visit the nearer child first so that the other one is more likely to be culled
+			const int32 Left = NodeIndex + 1;
+			const int32 Right = Node.Index;
+			const bool bLeftFirst = GetBoxDistanceSquared(Nodes[Left], P) <= GetBoxDistanceSquared(Nodes[Right], P);
+			Stack[StackSize++] = bLeftFirst ? Right : Left;
+			Stack[StackSize++] = bLeftFirst ? Left : Right;
+			continue;
+		}
+
+		for (int32 I = Node.Index; I < Node.Index + Node.Count; I++)
+		{
+			const float T = FMath::Clamp(((P.X - StartX[I]) * DeltaX[I] + (P.Y - StartY[I]) * DeltaY[I]) * InvLengthSquared[I], 0.0f, 1.0f);
+			const float DX = StartX[I] + DeltaX[I] * T - P.X;
+			const float DY = StartY[I] + DeltaY[I] * T - P.Y;
+			const float DistanceSquared = DX * DX + DY * DY;
+			if (DistanceSquared < BestDistanceSquared)
+			{
+				BestDistanceSquared = DistanceSquared;
+				BestEdge = I;
+				BestT = T;
+			}
+		}
+	}
+
+	const int32 PointIndex = Edges[BestEdge];
+	const FVector& Start = Points[PointIndex];
+	const FVector& End = Points[(PointIndex + 1) % Points.Num()];
+	OutClosestPoint = FMath::Lerp(Start, End, (double)BestT);
+	OutNormal = FVector(-DeltaY[BestEdge] * Winding, DeltaX[BestEdge] * Winding, 0.0f).GetSafeNormal();
+	return FMath::Sqrt(BestDistanceSquared);
+}
+
+bool FPXRBoundaryGeometry::TestSpheres(TArrayView<const FVector> Centers, float Radius, TArrayView<FPICOXRBoundaryTestResult> OutResults) const
+{
+	check(Centers.Num() == OutResults.Num());
+	if (!IsValid())
+	{
+		return false;
+	}
+
+	for (int32 I = 0; I < Centers.Num(); I++)
+	{
+		FPICOXRBoundaryTestResult& Result = OutResults[I];
+		Result.IsInside = IsInside(Centers[I]);
+		Result.ClosestDistance = GetClosestPoint(Centers[I], Result.ClosestPoint, Result.ClosestPointNormal);
+		Result.IsTriggering = !Result.IsInside || Result.ClosestDistance <= Radius;
+	}
+	return true;
+}
@@ -0,0 +1,65 @@
+// Copyright PICO Technology Co., Ltd. All rights reserved.
+// This plugin incorporates portions of the Unreal® Engine. Unreal® is a trademark or registered trademark of Epic Games, Inc. in the United States of America and elsewhere.
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+#include "CoreMinimal.h"
+
+struct FPICOXRBoundaryTestResult;
+
+// Closed boundary polygon in Unreal tracking space, with a bounding volume hierarchy over its edges in the XY plane.
+// The boundary is a vertical wall, so queries measure distances in XY; the closest point takes the height of the edge.
+// Edges are stored as structure of arrays in tree order and leaves hold at most LeafSize of them, so leaf loops are
+// short straight runs over contiguous floats.
+class FPXRBoundaryGeometry
+{
+public:
+	void Build(TArray<FVector>&& InPoints);
+	void Reset();
+
+	const TArray<FVector>& GetPoints() const
+	{
+		return Points;
+	}
+
+	bool IsValid() const
+	{
+		return Points.Num() >= 3;
+	}
+
+	bool IsInside(const FVector& Point) const;
+
+	// Distance to the closest edge in XY, ClosestPoint on that edge and the edge normal pointing into the polygon
+	float GetClosestPoint(const FVector& Point, FVector& OutClosestPoint, FVector& OutNormal) const;
+
+	// Spheres of the given radius; a sphere triggers when it reaches the boundary or its center is outside.
+	// Results are written in the order of the centers; returns false if there is no boundary.
+	bool TestSpheres(TArrayView<const FVector> Centers, float Radius, TArrayView<FPICOXRBoundaryTestResult> OutResults) const;
+
+private:
+	static constexpr int32 LeafSize = 4;
+
+	struct FNode
+	{
+		FVector2f Min;
+		FVector2f Max;
+		// Leaf: first edge and edge count. Inner node: index of the right child (the left one directly follows the node) and 0.
+		int32 Index;
+		int32 Count;
+	};
+
+	int32 BuildNode(int32 First, int32 Count);
+	static float GetBoxDistanceSquared(const FNode& Node, const FVector2f& Point);
+
+	TArray<FVector> Points;
+	// Edge I goes from (StartX[I], StartY[I]) along (DeltaX[I], DeltaY[I]), in BVH order; Edges maps back to Points
+	TArray<float> StartX;
+	TArray<float> StartY;
+	TArray<float> DeltaX;
+	TArray<float> DeltaY;
+	TArray<float> InvLengthSquared;
+	TArray<int32> Edges;
+	TArray<FNode> Nodes;
+	// +1 for counter clockwise polygons, -1 for clockwise ones, to orient the edge normals inwards
+	float Winding = 1.0f;
+};
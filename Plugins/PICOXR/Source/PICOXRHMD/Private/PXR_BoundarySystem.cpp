@@ -8,6 +8,7 @@
 #include "XRThreadUtils.h"
 #include "Engine/Engine.h"
 #include "PXR_HMDModule.h"
+#include "PXR_HMD.h"
 
 UPICOXRBoundarySystem* UPICOXRBoundarySystem::BoundaryInstance = nullptr;
 UPICOXRBoundarySystem* UPICOXRBoundarySystem::GetInstance()
@@ -33,6 +34,22 @@ UPICOXRBoundarySystem::~UPICOXRBoundarySystem()
 {
 }
 
+void UPICOXRBoundarySystem::BeginDestroy()
+{
+	TSharedPtr<IXRTrackingSystem, ESPMode::ThreadSafe> HMD = BoundHMD.Pin();
+	if (HMD.IsValid())
+	{
+		for (const TPair<PxrStructureType, FDelegateHandle>& Handle : InvalidationHandles)
+		{
+			static_cast<FPICOXRHMD*>(HMD.Get())->GetEventBus().Unsubscribe(Handle.Key, Handle.Value);
+		}
+	}
+	InvalidationHandles.Reset();
+	BoundHMD.Reset();
+
+	Super::BeginDestroy();
+}
+
 bool UPICOXRBoundarySystem::UPxr_GetConfigured()
 {
 #if PLATFORM_ANDROID
@@ -123,29 +140,100 @@ bool UPICOXRBoundarySystem::UPxr_TestPoint(FVector Point, bool bIsPlayArea, bool
 
 TArray<FVector> UPICOXRBoundarySystem::UPxr_GetGeometry(bool bIsPlayArea)
 {
-	TArray<FVector> BoundaryGeometry; 
+	return GetCachedGeometry(bIsPlayArea).GetPoints();
+}
+
+bool UPICOXRBoundarySystem::UPxr_TestSpheres(TArrayView<const FVector> Centers, float Radius, bool bIsPlayArea, TArray<FPICOXRBoundaryTestResult>& OutResults)
+{
+	OutResults.SetNum(Centers.Num());
+	return GetCachedGeometry(bIsPlayArea).TestSpheres(Centers, Radius, OutResults);
+}
+
+void UPICOXRBoundarySystem::InvalidateGeometryCache()
+{
+	for (FGeometryCache& Cache : GeometryCaches)
+	{
+		Cache.bFetched = false;
+	}
+}
+
+const FPXRBoundaryGeometry& UPICOXRBoundarySystem::GetCachedGeometry(bool bIsPlayArea)
+{
+	check(IsInGameThread());
+	BindInvalidationEvents();
+
+	FGeometryCache& Cache = GeometryCaches[bIsPlayArea ? 1 : 0];
+	if (!Cache.bFetched || !BoundHMD.IsValid())
+	{
+		Cache.RuntimePoints.Reset();
 #if PLATFORM_ANDROID
-	uint32_t pointsCountOutput = 0;
-	PxrVector3f* outPointsFirst = nullptr;
-	FPICOXRHMDModule::GetPluginWrapper().GetBoundaryGeometry(bIsPlayArea, 0, &pointsCountOutput, outPointsFirst);
-	if (pointsCountOutput <= 0)
+		uint32_t pointsCountOutput = 0;
+		FPICOXRHMDModule::GetPluginWrapper().GetBoundaryGeometry(bIsPlayArea, 0, &pointsCountOutput, nullptr);
+		if (pointsCountOutput > 0)
+		{
+			FetchBuffer.SetNumUninitialized(pointsCountOutput, EAllowShrinking::No);
+			if (FPICOXRHMDModule::GetPluginWrapper().GetBoundaryGeometry(bIsPlayArea, pointsCountOutput, &pointsCountOutput, FetchBuffer.GetData()) == 0)
+			{
+				Cache.RuntimePoints.Reserve(pointsCountOutput);
+				for (uint32_t i = 0; i < pointsCountOutput; i++)
+				{
+					Cache.RuntimePoints.Add(FVector(FetchBuffer[i].x, FetchBuffer[i].y, FetchBuffer[i].z));
+				}
+			}
+		}
+#endif
+		Cache.bFetched = true;
+		Cache.WorldToMetersScale = 0.0f;
+	}
+
+	const float WorldToMetersScale = GEngine && GEngine->XRSystem.IsValid() ? GEngine->XRSystem->GetWorldToMetersScale() : 100.0f;
+	if (Cache.WorldToMetersScale != WorldToMetersScale)
+	{
+		TArray<FVector> Points;
+		Points.Reserve(Cache.RuntimePoints.Num());
+		for (const FVector& RuntimePoint : Cache.RuntimePoints)
+		{
+			Points.Add(FPICOXRUtils::ConvertXRVectorToUnrealVector(RuntimePoint, WorldToMetersScale));
+		}
+		Cache.Geometry.Build(MoveTemp(Points));
+		Cache.WorldToMetersScale = WorldToMetersScale;
+	}
+	return Cache.Geometry;
+}
+
+void UPICOXRBoundarySystem::BindInvalidationEvents()
+{
+	if (BoundHMD.IsValid())
 	{
-		return BoundaryGeometry;
+		return;
 	}
 
-	PxrVector3f* Data = new PxrVector3f[pointsCountOutput];
-	if (FPICOXRHMDModule::GetPluginWrapper().GetBoundaryGeometry(bIsPlayArea, pointsCountOutput, &pointsCountOutput, Data) == 0)
+	// A previously bound HMD was destroyed along with its subscriptions
+	InvalidationHandles.Reset();
+	BoundHMD.Reset();
+
+	static FName SystemName(TEXT("PICOXRHMD"));
+	if (GEngine && GEngine->XRSystem.IsValid() && (GEngine->XRSystem->GetSystemName() == SystemName))
 	{
-		for (uint32_t i = 0; i < pointsCountOutput; i++)
+		BoundHMD = GEngine->XRSystem;
+		FPICOXRHMD* HMD = static_cast<FPICOXRHMD*>(GEngine->XRSystem.Get());
+
+		// There is no boundary changed event: the boundary is edited in the system UI, which takes the session out of
+		// focus, and a system recenter or a tracking change moves it in tracking space
+		for (PxrStructureType EventType : { PXR_TYPE_EVENT_DATA_SESSION_STATE_CHANGED, PXR_TYPE_EVENT_DATA_SESSION_STATE_READY,
+			PXR_TYPE_EVENT_TRACKING_STATE_CHANGED, PXR_TYPE_EVENT_DATA_HMD_KEY })
 		{
-			FVector TempVector = FVector(Data[i].x, Data[i].y, Data[i].z);
-			TempVector = FPICOXRUtils::ConvertXRVectorToUnrealVector(TempVector, GEngine->XRSystem->GetWorldToMetersScale());
-			BoundaryGeometry.Add(TempVector);
+			InvalidationHandles.Emplace(EventType, HMD->GetEventBus().Subscribe(EventType, FPICOPollEventDelegate::FDelegate::CreateUObject(this, &UPICOXRBoundarySystem::OnInvalidatingEvent)));
 		}
+
+		// Whatever was cached was fetched without this HMD reporting changes
+		InvalidateGeometryCache();
 	}
-	delete[]Data;
-#endif
-	return BoundaryGeometry;
+}
+
+void UPICOXRBoundarySystem::OnInvalidatingEvent(PxrEventDataBuffer* Event)
+{
+	InvalidateGeometryCache();
 }
 
 FVector UPICOXRBoundarySystem::UPxr_GetDimensions(bool bIsPlayArea)
@@ -6,8 +6,13 @@
 #include "CoreMinimal.h"
 #include "Engine/Texture2D.h"
 #include "UObject/Object.h"
+#include "PXR_Plugin_Types.h"
+#include "PXR_BoundaryGeometry.h"
 #include "PXR_BoundarySystem.generated.h"
 
+class IXRTrackingSystem;
+struct FPICOXRBoundaryTestResult;
+
 UCLASS()
 class UPICOXRBoundarySystem : public UObject
 {
@@ -21,6 +26,8 @@ public:
 
 	~UPICOXRBoundarySystem();
 
+	virtual void BeginDestroy() override;
+
 	bool UPxr_GetConfigured();
 
 	bool UPxr_GetEnabled();
@@ -35,11 +42,36 @@ public:
 
 	TArray<FVector> UPxr_GetGeometry(bool BoundaryType);
 
+	bool UPxr_TestSpheres(TArrayView<const FVector> Centers, float Radius, bool BoundaryType, TArray<FPICOXRBoundaryTestResult>& OutResults);
+
+	// The geometry is fetched again on the next query
+	void InvalidateGeometryCache();
+
 	FVector UPxr_GetDimensions(bool BoundaryType);
 
 	int UPxr_SetSeeThroughBackground(bool value);
 
 private:
+	// Boundary geometry of the outer boundary (0) or the play area (1), fetched from the runtime once per change
+	const FPXRBoundaryGeometry& GetCachedGeometry(bool BoundaryType);
+	void BindInvalidationEvents();
+	void OnInvalidatingEvent(PxrEventDataBuffer* Event);
+
+	struct FGeometryCache
+	{
+		// Runtime coordinates, kept to rebuild the geometry when the world to meters scale changes
+		TArray<FVector> RuntimePoints;
+		FPXRBoundaryGeometry Geometry;
+		float WorldToMetersScale = 0.0f;
+		bool bFetched = false;
+	};
+	FGeometryCache GeometryCaches[2];
+	TArray<PxrVector3f> FetchBuffer;
+	// Without an HMD to report boundary changes, the geometry is fetched on every query.
+	// Weak, as the HMD can be destroyed and recreated; its event bus and the subscriptions below go with it.
+	TWeakPtr<IXRTrackingSystem, ESPMode::ThreadSafe> BoundHMD;
+	TArray<TPair<PxrStructureType, FDelegateHandle>> InvalidationHandles;
+
 	FIntPoint CurrentImageSize;
 	UTexture2D* CameraTextureLeft;
 	UTexture2D* CameraTextureRight;
@@ -4,21 +4,203 @@
 
 
 #include "PXR_Cubemap.h"
-#include "Engine/StaticMeshActor.h"
-#include "GameFramework/PlayerController.h"
-#include "Kismet/GameplayStatics.h"
+#include "PXR_CubemapCapture.h"
+#include "PXR_HMDModule.h"
+#include "PXR_Log.h"
+#include "Async/Async.h"
 #include "IImageWrapper.h"
 #include "IImageWrapperModule.h"
-#include "ImageUtils.h"
 #include "TimerManager.h"
 #include "Components/SceneCaptureComponent2D.h"
 #include "Engine/TextureRenderTarget2D.h"
 #include "Engine/World.h"
 #include "Misc/FileHelper.h"
 #include "Modules/ModuleManager.h"
+#include "RenderingThread.h"
 #include "TextureResource.h"
 #include "Misc/Paths.h"
 
+static FColor ReadCubemapColor(EPixelFormat Format, const uint8* Pixel)
+{
+	switch (Format)
+	{
+	case PF_B8G8R8A8:
+		return *(const FColor*)Pixel;
+	case PF_R8G8B8A8:
+		return FColor(Pixel[0], Pixel[1], Pixel[2], Pixel[3]);
+	case PF_A16B16G16R16:
+	{
+		// Same conversion as ReadPixels, which gamma corrects 16 bit and float targets
+		const uint16* Value = (const uint16*)Pixel;
+		return FLinearColor(Value[0] / 65535.0f, Value[1] / 65535.0f, Value[2] / 65535.0f, Value[3] / 65535.0f).ToFColor(true);
+	}
+	default:
+		return FLinearColor(*(const FFloat16Color*)Pixel).ToFColor(true);
+	}
+}
+
+// EXR captures are scene color, linear in every format, so 8 bit values are not sRGB decoded. 8 and 16 bit targets
+// clamp the scene color to [0, 1]; only PF_FloatRGBA keeps its full range.
+static FLinearColor ReadCubemapLinearColor(EPixelFormat Format, const uint8* Pixel)
+{
+	switch (Format)
+	{
+	case PF_B8G8R8A8:
+		return (*(const FColor*)Pixel).ReinterpretAsLinear();
+	case PF_R8G8B8A8:
+		return FColor(Pixel[0], Pixel[1], Pixel[2], Pixel[3]).ReinterpretAsLinear();
+	case PF_A16B16G16R16:
+	{
+		const uint16* Value = (const uint16*)Pixel;
+		return FLinearColor(Value[0] / 65535.0f, Value[1] / 65535.0f, Value[2] / 65535.0f, Value[3] / 65535.0f);
+	}
+	default:
+		return FLinearColor(*(const FFloat16Color*)Pixel);
+	}
+}
+
+bool IsSupportedCubemapFormat(EPixelFormat Format)
+{
+	return Format == PF_B8G8R8A8 || Format == PF_R8G8B8A8 || Format == PF_A16B16G16R16 || Format == PF_FloatRGBA;
+}
+
+// Each face is converted straight into its place in the strip
+void StitchCubemapFaces(const FPXRCubemapCapture& Capture, TArray64<FColor>& OutStrip)
+{
+	const int32 Res = Capture.Resolution;
+	const int32 Stride = Res * CubemapFaceCount;
+	const int32 BytesPerPixel = GPixelFormats[Capture.Format].BlockBytes;
+	OutStrip.SetNumUninitialized((int64)Stride * Res);
+	for (int32 cubeFaceIdx = 0; cubeFaceIdx < CubemapFaceCount; ++cubeFaceIdx)
+	{
+		const uint8* Face = Capture.Faces[cubeFaceIdx].GetData();
+		for (int32 y = 0; y < Res; ++y)
+		{
+			FColor* Row = OutStrip.GetData() + (int64)y * Stride + cubeFaceIdx * Res;
+			for (int32 x = 0; x < Res; ++x)
+			{
+				Row[x] = ReadCubemapColor(Capture.Format, Face + ((int64)y * Res + x) * BytesPerPixel);
+				Row[x].A = 255;
+			}
+		}
+	}
+}
+
+void StitchCubemapFaces(const FPXRCubemapCapture& Capture, TArray64<FFloat16Color>& OutStrip)
+{
+	const int32 Res = Capture.Resolution;
+	const int32 Stride = Res * CubemapFaceCount;
+	const int32 BytesPerPixel = GPixelFormats[Capture.Format].BlockBytes;
+	OutStrip.SetNumUninitialized((int64)Stride * Res);
+	for (int32 cubeFaceIdx = 0; cubeFaceIdx < CubemapFaceCount; ++cubeFaceIdx)
+	{
+		const uint8* Face = Capture.Faces[cubeFaceIdx].GetData();
+		for (int32 y = 0; y < Res; ++y)
+		{
+			FFloat16Color* Row = OutStrip.GetData() + (int64)y * Stride + cubeFaceIdx * Res;
+			for (int32 x = 0; x < Res; ++x)
+			{
+				FLinearColor Color = ReadCubemapLinearColor(Capture.Format, Face + ((int64)y * Res + x) * BytesPerPixel);
+				Color.A = 1.0f;
+				Row[x] = FFloat16Color(Color);
+			}
+		}
+	}
+}
+
+bool EncodeCubemap(FPXRCubemapCapture& Capture)
+{
+	TSharedPtr<IImageWrapper> ImageWrapper = Capture.ImageWrapperModule->CreateImageWrapper(Capture.bEXR ? EImageFormat::EXR : EImageFormat::PNG);
+	if (!ImageWrapper.IsValid())
+	{
+		PXR_LOGE(PxrUnreal, "Cubemap encoder not available for %s", PLATFORM_CHAR(*Capture.Filename));
+		return false;
+	}
+
+	const int32 Stride = Capture.Resolution * CubemapFaceCount;
+	if (Capture.bEXR)
+	{
+		TArray64<FFloat16Color> WholeCubemapData;
+		StitchCubemapFaces(Capture, WholeCubemapData);
+		ImageWrapper->SetRaw(WholeCubemapData.GetData(), WholeCubemapData.Num() * sizeof(FFloat16Color), Stride, Capture.Resolution, ERGBFormat::RGBAF, 16);
+	}
+	else
+	{
+		TArray64<FColor> WholeCubemapData;
+		StitchCubemapFaces(Capture, WholeCubemapData);
+		ImageWrapper->SetRaw(WholeCubemapData.GetData(), WholeCubemapData.Num() * sizeof(FColor), Stride, Capture.Resolution, ERGBFormat::BGRA, 8);
+	}
+
+	for (TArray<uint8>& Face : Capture.Faces)
+	{
+		Face.Empty();
+	}
+
+	const TArray64<uint8> CompressedData = ImageWrapper->GetCompressed((int32)EImageCompressionQuality::Default);
+	return CompressedData.Num() > 0 && FFileHelper::SaveArrayToFile(CompressedData, *Capture.Filename);
+}
+
+// Copies out the faces of the captures whose readbacks have completed and hands them to the encode task
+static void PollCubemapReadbacks_RenderThread(const TArray<FPXRCubemapCapturePtr>& Captures)
+{
+	check(IsInRenderingThread());
+
+	for (const FPXRCubemapCapturePtr& Capture : Captures)
+	{
+		if (Capture->State != EPXRCubemapCaptureState::Readback)
+		{
+			continue;
+		}
+
+		bool bReady = true;
+		for (const TUniquePtr<FRHIGPUTextureReadback>& Readback : Capture->Readbacks)
+		{
+			bReady = bReady && Readback->IsReady();
+		}
+		if (!bReady)
+		{
+			continue;
+		}
+
+		const int32 BytesPerPixel = GPixelFormats[Capture->Format].BlockBytes;
+		const int32 RowSizeInBytes = Capture->Resolution * BytesPerPixel;
+		bool bLocked = true;
+		for (int32 cubeFaceIdx = 0; cubeFaceIdx < CubemapFaceCount; ++cubeFaceIdx)
+		{
+			TUniquePtr<FRHIGPUTextureReadback>& Readback = Capture->Readbacks[cubeFaceIdx];
+			int32 RowPitchInPixels = 0;
+			const uint8* Data = (const uint8*)Readback->Lock(RowPitchInPixels);
+			if (Data)
+			{
+				TArray<uint8>& Face = Capture->Faces[cubeFaceIdx];
+				Face.SetNumUninitialized(RowSizeInBytes * Capture->Resolution);
+				for (uint32 y = 0; y < Capture->Resolution; ++y)
+				{
+					FMemory::Memcpy(Face.GetData() + y * RowSizeInBytes, Data + (int64)y * RowPitchInPixels * BytesPerPixel, RowSizeInBytes);
+				}
+				Readback->Unlock();
+			}
+			bLocked = bLocked && Data != nullptr;
+			Readback.Reset();
+		}
+
+		if (!bLocked)
+		{
+			PXR_LOGE(PxrUnreal, "Cubemap readback failed for %s", PLATFORM_CHAR(*Capture->Filename));
+			Capture->bSaved = false;
+			Capture->State = EPXRCubemapCaptureState::Done;
+			continue;
+		}
+
+		Capture->State = EPXRCubemapCaptureState::Encoding;
+		AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask, [Capture]()
+			{
+				Capture->bSaved = EncodeCubemap(*Capture);
+				Capture->State = EPXRCubemapCaptureState::Done;
+			});
+	}
+}
+
 // Sets default values
 APXR_Cubemap::APXR_Cubemap()
 {
@@ -34,6 +216,12 @@ void APXR_Cubemap::BeginPlay()
 
 }
 
+void APXR_Cubemap::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	ReleaseCaptureComponents();
+	Super::EndPlay(EndPlayReason);
+}
+
 // Called every frame
 void APXR_Cubemap::Tick(float DeltaTime)
 {
@@ -43,99 +231,207 @@ void APXR_Cubemap::Tick(float DeltaTime)
 
 bool APXR_Cubemap::SaveCubeMap_PICO()
 {
-	Location = GetRootComponent()->GetComponentLocation();
-	Orientation = GetRootComponent()->GetComponentQuat();
+	Location = GetActorLocation();
+	Orientation = GetActorQuat();
 
-	const FVector ZAxis(0, 0, 1);
-	const FVector YAxis(0, 1, 0);
+	TArray<FTransform> ProbeTransforms;
+	ProbeTransforms.Add(FTransform(Orientation, Location));
+	return StartCaptures(MoveTemp(ProbeTransforms), false);
+}
 
-	const FQuat FaceOrientations[] = {
-										{ZAxis, PI / 2}, { ZAxis, -PI / 2},// right, left
-										{YAxis, -PI / 2}, { YAxis, PI / 2},   // top, bottom
-										{ZAxis, 0}, { ZAxis, -PI},// front, back
-	};
+bool APXR_Cubemap::SaveCubeMapSequence_PICO(const TArray<FTransform>& ProbeTransforms)
+{
+	return StartCaptures(TArray<FTransform>(ProbeTransforms), true);
+}
+
+bool APXR_Cubemap::IsCapturing() const
+{
+	return Captures.Num() > 0 || NextProbe < PendingProbes.Num();
+}
 
-	for (int i = 0; i < 6; ++i)
+bool APXR_Cubemap::StartCaptures(TArray<FTransform>&& ProbeTransforms, bool bNumbered)
+{
+	if (IsCapturing())
+	{
+		PXR_LOGE(PxrUnreal, "Cubemap capture already in progress");
+		return false;
+	}
+	if (!GetWorld() || ProbeTransforms.Num() == 0 || CaptureBoxSideRes == 0)
+	{
+		return false;
+	}
+	if (!IsSupportedCubemapFormat(CaptureFormat))
 	{
-		USceneCaptureComponent2D* CaptureComponent = NewObject<USceneCaptureComponent2D>();
-		CaptureComponent->SetVisibility(true);
-		CaptureComponent->SetHiddenInGame(false);
+		PXR_LOGE(PxrUnreal, "Cubemap capture format %s is not supported", PLATFORM_CHAR(GetPixelFormatString(CaptureFormat)));
+		return false;
+	}
 
-		//Different from 4.27,not have this property
-		//CaptureComponent->CaptureStereoPass = EStereoscopicPass::eSSP_FULL;//LEFT_EYE; //??
-		CaptureComponent->FOVAngle = 90.f;
-		CaptureComponent->bCaptureEveryFrame = true;
-		CaptureComponent->CaptureSource = ESceneCaptureSource::SCS_FinalColorLDR;
+	InitCaptureComponents();
 
-		const FName TargetName = MakeUniqueObjectName(this, UTextureRenderTarget2D::StaticClass(), TEXT("SceneCaptureTextureTarget"));
-		CaptureComponent->TextureTarget = NewObject<UTextureRenderTarget2D>(this, TargetName);
-		CaptureComponent->TextureTarget->InitCustomFormat(CaptureBoxSideRes, CaptureBoxSideRes, CaptureFormat, false);
+	OutputDir = FPaths::ProjectSavedDir() + TEXT("/Cubemaps");
+	IFileManager::Get().MakeDirectory(*OutputDir);
 
-		CaptureComponents.Add(CaptureComponent);
+	const FString Date = FDateTime::Now().ToString(TEXT("%m.%d-%H.%M.%S"));
+	const TCHAR* Extension = bSaveAsEXR ? TEXT("exr") : TEXT("png");
+	PendingFilenames.Reset(ProbeTransforms.Num());
+	for (int32 i = 0; i < ProbeTransforms.Num(); ++i)
+	{
+		PendingFilenames.Add(bNumbered
+			? OutputDir + FString::Printf(TEXT("/Cubemap-%d-%s-%03d.%s"), CaptureBoxSideRes, *Date, i, Extension)
+			: OutputDir + FString::Printf(TEXT("/Cubemap-%d-%s.%s"), CaptureBoxSideRes, *Date, Extension));
+	}
+	PendingProbes = MoveTemp(ProbeTransforms);
+	NextProbe = 0;
+	isCatchImageWP = false;
+	bBatchSaved = true;
+
+	PollCaptures();
+	return true;
+}
 
-		CaptureComponent->RegisterComponentWithWorld(GWorld);
+void APXR_Cubemap::InitCaptureComponents()
+{
+	if (CaptureComponents.Num() != CubemapFaceCount)
+	{
+		ReleaseCaptureComponents();
+		for (int32 i = 0; i < CubemapFaceCount; ++i)
+		{
+			USceneCaptureComponent2D* CaptureComponent = NewObject<USceneCaptureComponent2D>(this);
+			CaptureComponent->FOVAngle = 90.f;
+			// Only captured on request
+			CaptureComponent->bCaptureEveryFrame = false;
+			CaptureComponent->bCaptureOnMovement = false;
 
-		CaptureComponent->SetWorldLocationAndRotation(Location, Orientation * FaceOrientations[i]);
+			const FName TargetName = MakeUniqueObjectName(this, UTextureRenderTarget2D::StaticClass(), TEXT("SceneCaptureTextureTarget"));
+			CaptureComponent->TextureTarget = NewObject<UTextureRenderTarget2D>(this, TargetName);
 
-		CaptureComponent->UpdateContent();
+			CaptureComponent->RegisterComponentWithWorld(GetWorld());
+			CaptureComponents.Add(CaptureComponent);
+		}
 	}
 
-	FActorSpawnParameters SpawnInfo;
-	SpawnInfo.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
-	SpawnInfo.bNoFail = true;
-	SpawnInfo.ObjectFlags = RF_Transient;
-	AStaticMeshActor* InGameActor;
-	InGameActor = GetWorld()->SpawnActor<AStaticMeshActor>(SpawnInfo);
+	// Targets are only recreated when the resolution or format changed since the last capture
+	for (USceneCaptureComponent2D* CaptureComponent : CaptureComponents)
+	{
+		// EXR keeps the linear scene color, PNG the tonemapped and gamma-encoded final color
+		CaptureComponent->CaptureSource = bSaveAsEXR ? ESceneCaptureSource::SCS_FinalColorHDR : ESceneCaptureSource::SCS_FinalColorLDR;
+		UTextureRenderTarget2D* TextureTarget = CaptureComponent->TextureTarget;
+		if (TextureTarget->SizeX != (int32)CaptureBoxSideRes || TextureTarget->SizeY != (int32)CaptureBoxSideRes || TextureTarget->OverrideFormat != CaptureFormat)
+		{
+			TextureTarget->InitCustomFormat(CaptureBoxSideRes, CaptureBoxSideRes, CaptureFormat, false);
+		}
+	}
+}
 
-	OutputDir = FPaths::ProjectSavedDir() + TEXT("/Cubemaps");
-	IFileManager::Get().MakeDirectory(*OutputDir);
+void APXR_Cubemap::CaptureProbe(const FTransform& ProbeTransform, const FString& Filename)
+{
+	const FVector ZAxis(0, 0, 1);
+	const FVector YAxis(0, 1, 0);
 
-	auto CopyRT2D = [this]()
-	{
-		IImageWrapperModule& ImageWrapperModule = FModuleManager::LoadModuleChecked<IImageWrapperModule>(FName("ImageWrapper"));
-		TSharedPtr<IImageWrapper> ImageWrapper = ImageWrapperModule.CreateImageWrapper(EImageFormat::PNG);
+	const FQuat FaceOrientations[] = {
+										{ZAxis, PI / 2}, { ZAxis, -PI / 2},// right, left
+										{YAxis, -PI / 2}, { YAxis, PI / 2},   // top, bottom
+										{ZAxis, 0}, { ZAxis, -PI},// front, back
+	};
 
-		TArray<FColor> OneFaceSurface, WholeCubemapData;
-		OneFaceSurface.AddUninitialized(CaptureBoxSideRes * CaptureBoxSideRes);
-		WholeCubemapData.AddUninitialized(CaptureBoxSideRes * 6 * CaptureBoxSideRes);
+	TArray<FTextureRenderTargetResource*, TInlineAllocator<CubemapFaceCount>> Resources;
+	for (int32 i = 0; i < CubemapFaceCount; ++i)
+	{
+		USceneCaptureComponent2D* CaptureComponent = CaptureComponents[i];
+		CaptureComponent->SetWorldLocationAndRotation(ProbeTransform.GetLocation(), ProbeTransform.GetRotation() * FaceOrientations[i]);
+		CaptureComponent->CaptureScene();
+		Resources.Add(CaptureComponent->TextureTarget->GameThread_GetRenderTargetResource());
+	}
 
-		for (int cubeFaceIdx = 0; cubeFaceIdx < 6; ++cubeFaceIdx)
+	FPXRCubemapCapturePtr Capture = MakeShared<FPXRCubemapCapture, ESPMode::ThreadSafe>();
+	Capture->Filename = Filename;
+	Capture->Resolution = CaptureBoxSideRes;
+	Capture->Format = CaptureFormat;
+	Capture->bEXR = bSaveAsEXR;
+	Capture->ImageWrapperModule = &FModuleManager::LoadModuleChecked<IImageWrapperModule>(FName("ImageWrapper"));
+	Captures.Add(Capture);
+
+	// Queued after the captures, so the copies see the rendered faces; the targets can be reused right away
+	ENQUEUE_RENDER_COMMAND(PXRCubemapReadback)(
+		[Capture, Resources](FRHICommandListImmediate& RHICmdList)
 		{
-			auto RenderTarget = CaptureComponents[cubeFaceIdx]->TextureTarget->GameThread_GetRenderTargetResource();
-			RenderTarget->ReadPixelsPtr(OneFaceSurface.GetData(), FReadSurfaceDataFlags());
-
-			for (FColor& Color : OneFaceSurface)
+			for (int32 cubeFaceIdx = 0; cubeFaceIdx < CubemapFaceCount; ++cubeFaceIdx)
 			{
-				Color.A = 255;
+				Capture->Readbacks[cubeFaceIdx] = MakeUnique<FRHIGPUTextureReadback>(TEXT("PXRCubemapReadback"));
+				Capture->Readbacks[cubeFaceIdx]->EnqueueCopy(RHICmdList, Resources[cubeFaceIdx]->GetRenderTargetTexture());
 			}
+		});
+}
 
-			const uint32 Stride = CaptureBoxSideRes * 6;
-			const uint32 XOff = cubeFaceIdx * CaptureBoxSideRes;
-			const uint32 StripSizeInBytes = CaptureBoxSideRes * sizeof(FColor);
-			for (uint32 y = 0; y < CaptureBoxSideRes; ++y)
-			{
-				FMemory::Memcpy(WholeCubemapData.GetData() + XOff + y * Stride, OneFaceSurface.GetData() + y * CaptureBoxSideRes, StripSizeInBytes);
-			}
+void APXR_Cubemap::PollCaptures()
+{
+	for (int32 i = 0; i < Captures.Num();)
+	{
+		if (Captures[i]->State != EPXRCubemapCaptureState::Done)
+		{
+			++i;
+			continue;
 		}
 
-		ImageWrapper->SetRaw(WholeCubemapData.GetData(), WholeCubemapData.GetAllocatedSize(), CaptureBoxSideRes * 6, CaptureBoxSideRes, ERGBFormat::BGRA, 8);
-		const TArray64<uint8>& PNGData = ImageWrapper->GetCompressed(100);
-		const FString Filename = OutputDir + FString::Printf(TEXT("/Cubemap-%d-%s.png"), CaptureBoxSideRes, *FDateTime::Now().ToString(TEXT("%m.%d-%H.%M.%S")));
-
-		isCatchImageWP = FFileHelper::SaveArrayToFile(PNGData, *Filename);
-
-		for (int i = 0; i < CaptureComponents.Num(); ++i)
+		if (Captures[i]->bSaved)
 		{
-			CaptureComponents[i]->UnregisterComponent();
+			PXR_LOGI(PxrUnreal, "Cubemap saved to %s", PLATFORM_CHAR(*Captures[i]->Filename));
 		}
-		CaptureComponents.SetNum(0);
+		else
+		{
+			PXR_LOGE(PxrUnreal, "Failed to save cubemap %s", PLATFORM_CHAR(*Captures[i]->Filename));
+		}
+		bBatchSaved = bBatchSaved && Captures[i]->bSaved;
+		Captures.RemoveAt(i);
+	}
 
-	};
+	// One probe per frame, so that a sequence spreads its scene captures
+	if (NextProbe < PendingProbes.Num() && Captures.Num() < FMath::Max(MaxProbesInFlight, 1))
+	{
+		CaptureProbe(PendingProbes[NextProbe], PendingFilenames[NextProbe]);
+		++NextProbe;
+	}
 
-	FTimerHandle TimerHandle;
-	GetWorld()->GetTimerManager().SetTimer(TimerHandle, CopyRT2D, 0.001f, false, 0);
+	if (Captures.Num() > 0)
+	{
+		ENQUEUE_RENDER_COMMAND(PXRCubemapPoll)(
+			[PollingCaptures = Captures](FRHICommandListImmediate& RHICmdList)
+			{
+				PollCubemapReadbacks_RenderThread(PollingCaptures);
+			});
+	}
 
-	return isCatchImageWP;
+	if (IsCapturing())
+	{
+		PollTimerHandle = GetWorld()->GetTimerManager().SetTimerForNextTick(this, &APXR_Cubemap::PollCaptures);
+	}
+	else
+	{
+		isCatchImageWP = bBatchSaved;
+		PendingProbes.Reset();
+		PendingFilenames.Reset();
+		NextProbe = 0;
+	}
+}
+
+void APXR_Cubemap::ReleaseCaptureComponents()
+{
+	if (UWorld* World = GetWorld())
+	{
+		World->GetTimerManager().ClearTimer(PollTimerHandle);
+	}
+
+	// Captures still reading back or encoding finish on their own, they hold no reference to the actor
+	Captures.Reset();
+	PendingProbes.Reset();
+	PendingFilenames.Reset();
+	NextProbe = 0;
+
+	for (int i = 0; i < CaptureComponents.Num(); ++i)
+	{
+		CaptureComponents[i]->UnregisterComponent();
+	}
+	CaptureComponents.SetNum(0);
 }
 
 void APXR_Cubemap::PXR_CubemapHandler()
@@ -144,4 +440,3 @@ void APXR_Cubemap::PXR_CubemapHandler()
 	SaveCubeMap_PICO();
 #endif
 }
-
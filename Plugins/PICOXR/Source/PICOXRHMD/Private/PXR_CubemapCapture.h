@@ -0,0 +1,52 @@
+// Copyright PICO Technology Co., Ltd. All rights reserved.
+// This plugin incorporates portions of the Unreal® Engine. Unreal® is a trademark or registered trademark of Epic Games, Inc. in the United States of America and elsewhere.
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+#include "CoreMinimal.h"
+#include "PixelFormat.h"
+#include "RHIGPUReadback.h"
+#include <atomic>
+
+class IImageWrapperModule;
+
+static constexpr int32 CubemapFaceCount = 6;
+
+enum class EPXRCubemapCaptureState : int32
+{
+	// Faces copied to staging textures, waiting for the GPU
+	Readback,
+	Encoding,
+	Done,
+};
+
+struct FPXRCubemapCapture
+{
+	FString Filename;
+	uint32 Resolution = 0;
+	EPixelFormat Format = PF_Unknown;
+	// EXR captures hold linear scene color (SCS_FinalColorHDR) in every format, PNG captures gamma-encoded final color
+	bool bEXR = false;
+	IImageWrapperModule* ImageWrapperModule = nullptr;
+
+	// Render thread
+	TUniquePtr<FRHIGPUTextureReadback> Readbacks[CubemapFaceCount];
+	// Tightly packed rows, filled on the render thread and consumed by the encode task
+	TArray<uint8> Faces[CubemapFaceCount];
+
+	std::atomic<EPXRCubemapCaptureState> State{ EPXRCubemapCaptureState::Readback };
+	// Valid once Done
+	bool bSaved = false;
+};
+
+typedef TSharedPtr<FPXRCubemapCapture, ESPMode::ThreadSafe> FPXRCubemapCapturePtr;
+
+bool IsSupportedCubemapFormat(EPixelFormat Format);
+
+// Stitch the faces of the capture into a 6N x N strip (right, left, top, bottom, front, back) with an opaque alpha:
+// 8 bit color for PNG, linear half float color for EXR
+void StitchCubemapFaces(const FPXRCubemapCapture& Capture, TArray64<FColor>& OutStrip);
+void StitchCubemapFaces(const FPXRCubemapCapture& Capture, TArray64<FFloat16Color>& OutStrip);
+
+// Background thread. Stitches, compresses and saves the capture, then frees its faces.
+bool EncodeCubemap(FPXRCubemapCapture& Capture);
@@ -6,10 +6,26 @@
 #include "XRThreadUtils.h"
 #include "PXR_Log.h"
 #include "PXR_HMDModule.h"
+#include "HAL/IConsoleManager.h"
 
 uint32 GPICOHMDLayerDeletionFrameNumber = 0;
 const uint32 NUM_FRAMES_TO_WAIT_FOR_LAYER_DELETE = 3;
 const uint32 NUM_FRAMES_TO_WAIT_FOR_PXR_LAYER_DELETE = 7;
+const uint32 NUM_FRAMES_TO_KEEP_POOLED_LAYER = 90;
+
+static TAutoConsoleVariable<int32> CVarPICOLayersMaxDestroysPerFrame(
+	TEXT("pico.Layers.MaxDestroysPerFrame"),
+	8,
+	TEXT("Maximum number of expired stereo layers and native layers destroyed per frame, the rest wait for the next frames.\n")
+	TEXT("0: No limit"),
+	ECVF_RenderThreadSafe);
+
+static TAutoConsoleVariable<int32> CVarPICOLayersPoolSize(
+	TEXT("pico.Layers.PoolSize"),
+	4,
+	TEXT("Number of destroyed stereo layers whose native layer is kept for reuse by a new layer with the same create parameters.\n")
+	TEXT("0: Off"),
+	ECVF_RenderThreadSafe);
 
 void FDelayDeleteLayerManager::AddLayerToDeferredDeletionQueue(const FPICOLayerPtr& ptr)
 {
@@ -19,9 +35,8 @@ void FDelayDeleteLayerManager::AddLayerToDeferredDeletionQueue(const FPICOLayerP
 	{
 		Entry.ID = ptr->GetID();
 	}
-	Entry.FrameEnqueued = GPICOHMDLayerDeletionFrameNumber;
 	Entry.EntryType = DelayDeleteLayerEntry::DelayDeleteLayerEntryType::Layer;
-	DeferredDeletionArray.Add(Entry);
+	AddEntry(MoveTemp(Entry), NUM_FRAMES_TO_WAIT_FOR_LAYER_DELETE);
 }
 
 void FDelayDeleteLayerManager::AddPxrLayerToDeferredDeletionQueue(const uint32 ID, const uint32 layerID)
@@ -29,40 +44,140 @@ void FDelayDeleteLayerManager::AddPxrLayerToDeferredDeletionQueue(const uint32 I
 	DelayDeleteLayerEntry Entry;
 	Entry.ID = ID;
 	Entry.PxrLayerId = layerID;
-	Entry.FrameEnqueued = GPICOHMDLayerDeletionFrameNumber;
 	Entry.EntryType = DelayDeleteLayerEntry::DelayDeleteLayerEntryType::PxrLayer;
-	DeferredDeletionArray.Add(Entry);
+	AddEntry(MoveTemp(Entry), NUM_FRAMES_TO_WAIT_FOR_PXR_LAYER_DELETE);
+}
+
+void FDelayDeleteLayerManager::AddEntry(DelayDeleteLayerEntry&& Entry, uint32 FramesToWait)
+{
+	static_assert(NUM_FRAMES_TO_WAIT_FOR_PXR_LAYER_DELETE + 1 < NumBuckets, "Deletion ring too small for the wait");
+
+	// Handled once more than FramesToWait frames have passed
+	Buckets[(GPICOHMDLayerDeletionFrameNumber + FramesToWait + 1) % NumBuckets].Add(MoveTemp(Entry));
+	NumQueuedEntries++;
+}
+
+void FDelayDeleteLayerManager::MoveBucketToExpired(uint32 BucketIndex)
+{
+	TArray<DelayDeleteLayerEntry>& Bucket = Buckets[BucketIndex];
+	for (DelayDeleteLayerEntry& Entry : Bucket)
+	{
+		ExpiredEntries.Add(MoveTemp(Entry));
+	}
+	Bucket.Reset();
 }
 
 void FDelayDeleteLayerManager::HandleLayerDeferredDeletionQueue_RenderThread(bool bDeleteImmediately)
 {
-	for (int32 Index = DeferredDeletionArray.Num() - 1; Index >= 0; --Index)
+	check(IsInRenderingThread());
+
+	if (bDeleteImmediately)
 	{
-		DelayDeleteLayerEntry* Entry = &DeferredDeletionArray[Index];
-		if (Entry->EntryType == DelayDeleteLayerEntry::DelayDeleteLayerEntryType::Layer)
+		// Releasing stereo layers queues their native layers, so repeat until nothing is left
+		LayerPool.Reset();
+		while (NumQueuedEntries > 0)
 		{
-			if (bDeleteImmediately || GPICOHMDLayerDeletionFrameNumber > Entry->FrameEnqueued + NUM_FRAMES_TO_WAIT_FOR_LAYER_DELETE)
+			for (uint32 BucketIndex = 0; BucketIndex < NumBuckets; BucketIndex++)
 			{
-				PXR_LOGI(PxrUnreal, "Destroying UELayerID:%d", Entry->ID);
-				DeferredDeletionArray.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+				MoveBucketToExpired(BucketIndex);
 			}
+			DestroyExpiredEntries(ExpiredEntries.Num(), false);
+		}
+	}
+	else
+	{
+		MoveBucketToExpired(GPICOHMDLayerDeletionFrameNumber % NumBuckets);
+
+		const int32 PoolSize = FMath::Max(CVarPICOLayersPoolSize.GetValueOnRenderThread(), 0);
+		while (LayerPool.Num() > PoolSize || (LayerPool.Num() > 0 && GPICOHMDLayerDeletionFrameNumber - LayerPool[0].FramePooled > NUM_FRAMES_TO_KEEP_POOLED_LAYER))
+		{
+			LayerPool.RemoveAt(0, 1, EAllowShrinking::No);
 		}
-		else if (Entry->EntryType == DelayDeleteLayerEntry::DelayDeleteLayerEntryType::PxrLayer)
+
+		const int32 MaxDestroys = CVarPICOLayersMaxDestroysPerFrame.GetValueOnRenderThread();
+		DestroyExpiredEntries(MaxDestroys > 0 ? FMath::Min(MaxDestroys, ExpiredEntries.Num()) : ExpiredEntries.Num(), PoolSize > 0);
+	}
+
+	++GPICOHMDLayerDeletionFrameNumber;
+}
+
+void FDelayDeleteLayerManager::DestroyExpiredEntries(int32 MaxEntries, bool bAllowPooling)
+{
+	if (MaxEntries <= 0)
+	{
+		return;
+	}
+
+	TArray<TPair<uint32, uint32>> PxrLayers;
+	for (int32 Index = 0; Index < MaxEntries; ++Index)
+	{
+		// Releasing a stereo layer may queue its native layer, which only ever goes into a later bucket
+		DelayDeleteLayerEntry& Entry = ExpiredEntries[Index];
+		if (Entry.EntryType == DelayDeleteLayerEntry::DelayDeleteLayerEntryType::Layer)
 		{
-			if (bDeleteImmediately || GPICOHMDLayerDeletionFrameNumber > Entry->FrameEnqueued + NUM_FRAMES_TO_WAIT_FOR_PXR_LAYER_DELETE)
+			PXR_LOGI(PxrUnreal, "Destroying UELayerID:%d", Entry.ID);
+			if (bAllowPooling)
 			{
-				ExecuteOnRHIThread_DoNotWait([ID = Entry->ID, PxrLayerId = Entry->PxrLayerId]()
-				{
-					PXR_LOGI(PxrUnreal, "Destroying ID:%d, PxrLayerID:%d", ID, PxrLayerId);
+				PoolOrReleaseLayer(Entry.Layer);
+			}
+			Entry.Layer.Reset();
+		}
+		else if (Entry.EntryType == DelayDeleteLayerEntry::DelayDeleteLayerEntryType::PxrLayer)
+		{
+			PxrLayers.Emplace(Entry.ID, Entry.PxrLayerId);
+		}
+	}
+	ExpiredEntries.RemoveAt(0, MaxEntries, EAllowShrinking::No);
+	NumQueuedEntries -= MaxEntries;
+
+	if (PxrLayers.Num() > 0)
+	{
+		ExecuteOnRHIThread_DoNotWait([PxrLayers = MoveTemp(PxrLayers)]()
+		{
+			for (const TPair<uint32, uint32>& PxrLayer : PxrLayers)
+			{
+				PXR_LOGI(PxrUnreal, "Destroying ID:%d, PxrLayerID:%d", PxrLayer.Key, PxrLayer.Value);
 #if PLATFORM_ANDROID
-					FPICOXRHMDModule::GetPluginWrapper().DestroyLayer(PxrLayerId);
+				FPICOXRHMDModule::GetPluginWrapper().DestroyLayer(PxrLayer.Value);
 #endif
-				});
-				DeferredDeletionArray.RemoveAtSwap(Index, 1, EAllowShrinking::No);
 			}
-		}
+		});
+	}
+}
 
+void FDelayDeleteLayerManager::PoolOrReleaseLayer(FPICOLayerPtr& Layer)
+{
+	if (!Layer.IsValid() || !Layer->CanBePooled())
+	{
+		Layer.Reset();
+		return;
 	}
 
-	++GPICOHMDLayerDeletionFrameNumber;
-}
\ No newline at end of file
+	if (LayerPool.Num() >= FMath::Max(CVarPICOLayersPoolSize.GetValueOnRenderThread(), 1))
+	{
+		LayerPool.RemoveAt(0, 1, EAllowShrinking::No);
+	}
+
+	PooledLayerEntry PooledLayer;
+	PooledLayer.Layer = MoveTemp(Layer);
+	PooledLayer.FramePooled = GPICOHMDLayerDeletionFrameNumber;
+	LayerPool.Add(MoveTemp(PooledLayer));
+}
+
+FPICOLayerPtr FDelayDeleteLayerManager::AcquirePooledLayer_RenderThread(const FPICOXRStereoLayer* InLayer)
+{
+	check(IsInRenderingThread());
+
+	// Most recently pooled first
+	for (int32 Index = LayerPool.Num() - 1; Index >= 0; --Index)
+	{
+		if (InLayer->IfCanReuseLayers(LayerPool[Index].Layer.Get()))
+		{
+			FPICOLayerPtr Layer = MoveTemp(LayerPool[Index].Layer);
+			LayerPool.RemoveAt(Index, 1, EAllowShrinking::No);
+			PXR_LOGI(PxrUnreal, "Reusing native layer of UELayerID:%d for UELayerID:%d", Layer->GetID(), InLayer->GetID());
+			return Layer;
+		}
+	}
+	return nullptr;
+}
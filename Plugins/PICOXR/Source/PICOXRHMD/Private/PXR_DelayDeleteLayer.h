@@ -5,12 +5,23 @@
 #pragma once
 #include "PXR_StereoLayer.h"
 
+// Render thread deferred destruction of stereo layers and of the native layers behind them.
+// Entries are put into a ring of per-frame buckets at the frame they expire, so a frame only visits what expires in it.
+// At most pico.Layers.MaxDestroysPerFrame expired entries are destroyed per frame, the rest go first on the next one,
+// and the native layers destroyed in a frame are sent to the RHI thread in a single command.
+// A stereo layer that expires as the only owner of its native layer is kept in a small pool (pico.Layers.PoolSize)
+// for a few frames, so that a new layer with the same create parameters takes its native layer and swapchains over.
 class FDelayDeleteLayerManager
 {
 public:
 	void AddLayerToDeferredDeletionQueue(const FPICOLayerPtr& ptr);
 	void AddPxrLayerToDeferredDeletionQueue(const uint32 ID, const uint32 layerID);
 	void HandleLayerDeferredDeletionQueue_RenderThread(bool bDeleteImmediately = false);
+	// Removes a pooled layer whose native layer InLayer can reuse from the pool; null if there is none
+	FPICOLayerPtr AcquirePooledLayer_RenderThread(const FPICOXRStereoLayer* InLayer);
+	// Entries waiting for their frame or for the destroy budget
+	int32 GetNumQueuedEntries() const { return NumQueuedEntries; }
+	int32 GetNumPooledLayers() const { return LayerPool.Num(); }
 
 private:
 	struct DelayDeleteLayerEntry
@@ -22,12 +33,31 @@ private:
 		};
 
 		FPICOLayerPtr Layer;
-		uint32 ID;
-		uint32 PxrLayerId;
-		
-		uint32 FrameEnqueued;
+		uint32 ID = 0;
+		uint32 PxrLayerId = 0;
+
 		DelayDeleteLayerEntryType EntryType;
 	};
 
-	TArray<DelayDeleteLayerEntry> DeferredDeletionArray;
-};
\ No newline at end of file
+	struct PooledLayerEntry
+	{
+		FPICOLayerPtr Layer;
+		uint32 FramePooled;
+	};
+
+	// Must be larger than the longest wait, so that an entry never lands in the bucket being handled
+	static constexpr uint32 NumBuckets = 16;
+
+	void AddEntry(DelayDeleteLayerEntry&& Entry, uint32 FramesToWait);
+	void MoveBucketToExpired(uint32 BucketIndex);
+	void DestroyExpiredEntries(int32 MaxEntries, bool bAllowPooling);
+	void PoolOrReleaseLayer(FPICOLayerPtr& Layer);
+
+	TArray<DelayDeleteLayerEntry> Buckets[NumBuckets];
+	// Expired entries left over by the budget, oldest first
+	TArray<DelayDeleteLayerEntry> ExpiredEntries;
+	// Oldest first
+	TArray<PooledLayerEntry> LayerPool;
+	// Entries in the buckets and in ExpiredEntries
+	int32 NumQueuedEntries = 0;
+};
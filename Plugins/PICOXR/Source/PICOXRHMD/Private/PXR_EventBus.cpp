@@ -0,0 +1,150 @@
+// Copyright PICO Technology Co., Ltd. All rights reserved.
+// This plugin incorporates portions of the Unreal® Engine. Unreal® is a trademark or registered trademark of Epic Games, Inc. in the United States of America and elsewhere.
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "PXR_EventBus.h"
+#include "Algo/Reverse.h"
+#include "Misc/Crc.h"
+
+FPXREventBus::FPXREventBus()
+{
+	SetCoalesced(PXR_TYPE_EVENT_DATA_SEETHROUGH_STATE_CHANGED);
+	SetCoalesced(PXR_TYPE_EVENT_FOVEATION_LEVEL_CHANGED);
+	SetCoalesced(PXR_TYPE_EVENT_FRUSTUM_STATE_CHANGED);
+	SetCoalesced(PXR_TYPE_EVENT_RENDER_TEXTURE_CHANGED);
+	SetCoalesced(PXR_TYPE_EVENT_TARGET_FRAME_RATE_STATE_CHANGED);
+	SetCoalesced(PXR_TYPE_EVENT_HARDIPD_STATE_CHANGED);
+	SetCoalesced(PXR_TYPE_EVENT_DATA_REFRESH_RATE_CHANGED);
+	SetCoalesced(PXR_TYPE_EVENT_HMD_BATTERY_CHANGED);
+	SetCoalesced(PXR_TYPE_EVENT_EXT_DEV_BATTERY_STATE_EVENT, [](const PxrEventDataBuffer& Event)
+		{
+			const PxrEventDataExtDevBatteryEvent& BatteryEvent = reinterpret_cast<const PxrEventDataExtDevBatteryEvent&>(Event);
+			return (uint64)FCrc::MemCrc32(BatteryEvent.trackerSN, FCStringAnsi::Strnlen(BatteryEvent.trackerSN, UE_ARRAY_COUNT(BatteryEvent.trackerSN)));
+		});
+	SetCoalesced(PXR_TYPE_EVENT_DATA_SENSE_DATA_UPDATED, [](const PxrEventDataBuffer& Event)
+		{
+			return (uint64)reinterpret_cast<const PxrEventDataSenseDataUpdated&>(Event).provider;
+		});
+
+	SetDeferrable(PXR_TYPE_EVENT_HMD_BATTERY_CHANGED);
+	SetDeferrable(PXR_TYPE_EVENT_EXT_DEV_BATTERY_STATE_EVENT);
+	SetDeferrable(PXR_TYPE_EVENT_DATA_SENSE_DATA_UPDATED);
+}
+
+FDelegateHandle FPXREventBus::Subscribe(PxrStructureType Type, FPICOPollEventDelegate::FDelegate&& Handler)
+{
+	check(IsInGameThread());
+	return Types.FindOrAdd(Type).Subscribers.Add(MoveTemp(Handler));
+}
+
+void FPXREventBus::Unsubscribe(PxrStructureType Type, FDelegateHandle Handle)
+{
+	check(IsInGameThread());
+	if (FTypeInfo* Info = Types.Find(Type))
+	{
+		Info->Subscribers.Remove(Handle);
+	}
+}
+
+void FPXREventBus::SetCoalesced(PxrStructureType Type, FCoalesceKeyFunc KeyFunc)
+{
+	FTypeInfo& Info = Types.FindOrAdd(Type);
+	Info.bCoalesced = true;
+	Info.KeyFunc = MoveTemp(KeyFunc);
+}
+
+void FPXREventBus::SetDeferrable(PxrStructureType Type)
+{
+	Types.FindOrAdd(Type).bDeferrable = true;
+}
+
+void FPXREventBus::Dispatch(int32 EventCount, PxrEventDataBuffer** Events, double DeferredBudgetSeconds, TFunctionRef<void(PxrEventDataBuffer*)> Handler)
+{
+	check(IsInGameThread());
+	const bool bDefer = DeferredBudgetSeconds > 0.0;
+	const int32 FirstNewDeferred = Deferred.Num();
+
+	// Walk the poll backwards so that the first event seen for a coalesced key is the one that is kept
+	Immediate.Reset();
+	SeenKeys.Reset();
+	for (int32 Index = EventCount - 1; Index >= 0; Index--)
+	{
+		PxrEventDataBuffer* Event = Events[Index];
+		const FTypeInfo* Info = Types.Find(Event->type);
+		if (!Info)
+		{
+			Immediate.Add(Event);
+			continue;
+		}
+
+		const uint64 Key = Info->bCoalesced ? MakeCoalesceKey(*Info, *Event) : 0;
+		if (Info->bCoalesced)
+		{
+			const TPair<PxrStructureType, uint64> TypeKey(Event->type, Key);
+			if (SeenKeys.Contains(TypeKey))
+			{
+				continue;
+			}
+			SeenKeys.Add(TypeKey);
+		}
+
+		if (!bDefer || !Info->bDeferrable)
+		{
+			Immediate.Add(Event);
+			continue;
+		}
+
+		// A newer value replaces one still waiting from an earlier poll
+		FDeferredEvent* Pending = Info->bCoalesced
+			? Deferred.FindByPredicate([Event, Key](const FDeferredEvent& Entry) { return Entry.Event.type == Event->type && Entry.Key == Key; })
+			: nullptr;
+		if (Pending)
+		{
+			Pending->Event = *Event;
+		}
+		else
+		{
+			Deferred.Add(FDeferredEvent{ *Event, Key });
+		}
+	}
+	Algo::Reverse(Immediate);
+	TArrayView<FDeferredEvent> NewDeferred = MakeArrayView(Deferred).Slice(FirstNewDeferred, Deferred.Num() - FirstNewDeferred);
+	Algo::Reverse(NewDeferred);
+
+	for (PxrEventDataBuffer* Event : Immediate)
+	{
+		Broadcast(Event, Handler);
+	}
+
+	// Deferred events, oldest first; at least one per poll so that the queue always drains
+	const double Deadline = FPlatformTime::Seconds() + DeferredBudgetSeconds;
+	int32 Dispatched = 0;
+	while (Dispatched < Deferred.Num())
+	{
+		Broadcast(&Deferred[Dispatched++].Event, Handler);
+		if (bDefer && FPlatformTime::Seconds() >= Deadline)
+		{
+			break;
+		}
+	}
+	Deferred.RemoveAt(0, Dispatched, EAllowShrinking::No);
+}
+
+void FPXREventBus::ResetDeferred()
+{
+	Deferred.Reset();
+}
+
+uint64 FPXREventBus::MakeCoalesceKey(const FTypeInfo& Info, const PxrEventDataBuffer& Event)
+{
+	return Info.KeyFunc ? Info.KeyFunc(Event) : 0;
+}
+
+void FPXREventBus::Broadcast(PxrEventDataBuffer* Event, TFunctionRef<void(PxrEventDataBuffer*)> Handler)
+{
+	Handler(Event);
+	if (const FTypeInfo* Info = Types.Find(Event->type))
+	{
+		Info->Subscribers.Broadcast(Event);
+	}
+}
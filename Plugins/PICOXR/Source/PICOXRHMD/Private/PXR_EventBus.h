@@ -0,0 +1,64 @@
+// Copyright PICO Technology Co., Ltd. All rights reserved.
+// This plugin incorporates portions of the Unreal® Engine. Unreal® is a trademark or registered trademark of Epic Games, Inc. in the United States of America and elsewhere.
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+#include "CoreMinimal.h"
+#include "PXR_Plugin_Types.h"
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FPICOPollEventDelegate, PxrEventDataBuffer* /*EventData*/);
+
+// Game thread dispatch of the events returned by one PollEvent.
+//
+// Coalesced types are state notifications where only the latest value matters (frustum, foveation, refresh rate...):
+// of several events of such a type in one poll, only the last one is dispatched. A key function splits a type by
+// payload, e.g. per sense data provider.
+// Deferrable types are dispatched after all other events, within a time budget per poll; what does not fit carries
+// over to the next poll, still coalesced against newer events. A budget of 0 dispatches everything in order.
+//
+// Each event goes to the handler passed to Dispatch first, then to the subscribers of its type.
+class PICOXRHMD_API FPXREventBus
+{
+public:
+	typedef TFunction<uint64(const PxrEventDataBuffer&)> FCoalesceKeyFunc;
+
+	// Registers the default coalesced and deferrable types
+	FPXREventBus();
+
+	FDelegateHandle Subscribe(PxrStructureType Type, FPICOPollEventDelegate::FDelegate&& Handler);
+	void Unsubscribe(PxrStructureType Type, FDelegateHandle Handle);
+
+	void SetCoalesced(PxrStructureType Type, FCoalesceKeyFunc KeyFunc = nullptr);
+	void SetDeferrable(PxrStructureType Type);
+
+	void Dispatch(int32 EventCount, PxrEventDataBuffer** Events, double DeferredBudgetSeconds, TFunctionRef<void(PxrEventDataBuffer*)> Handler);
+
+	// Drops deferred events, e.g. when the session ends
+	void ResetDeferred();
+
+private:
+	struct FTypeInfo
+	{
+		bool bCoalesced = false;
+		bool bDeferrable = false;
+		FCoalesceKeyFunc KeyFunc;
+		FPICOPollEventDelegate Subscribers;
+	};
+
+	struct FDeferredEvent
+	{
+		PxrEventDataBuffer Event;
+		// Only used for coalesced types
+		uint64 Key;
+	};
+
+	static uint64 MakeCoalesceKey(const FTypeInfo& Info, const PxrEventDataBuffer& Event);
+	void Broadcast(PxrEventDataBuffer* Event, TFunctionRef<void(PxrEventDataBuffer*)> Handler);
+
+	TMap<PxrStructureType, FTypeInfo> Types;
+	TArray<FDeferredEvent> Deferred;
+
+	// Scratch, kept to avoid allocating per poll
+	TArray<PxrEventDataBuffer*> Immediate;
+	TArray<TPair<PxrStructureType, uint64>> SeenKeys;
+};
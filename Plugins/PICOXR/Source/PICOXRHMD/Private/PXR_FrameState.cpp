@@ -0,0 +1,114 @@
+// Copyright PICO Technology Co., Ltd. All rights reserved.
+// This plugin incorporates portions of the Unreal® Engine. Unreal® is a trademark or registered trademark of Epic Games, Inc. in the United States of America and elsewhere.
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "PXR_FrameState.h"
+#include "Algo/BinarySearch.h"
+
+FPXRFrameStatePtr FPXRFrameStateRing::Acquire_GameThread(const FGameSettings& InSettings, const FPXRGameFrame& InFrame, const TMap<uint32, FPICOLayerPtr>& LayerMap)
+{
+	check(IsInGameThread());
+
+	FPXRFrameStatePtr& State = Slots[NextSlot];
+	NextSlot = (NextSlot + 1) % NumSlots;
+
+	// Unique means the render thread has run (and destroyed) the command that referenced this slot
+	if (!State.IsValid() || !State.IsUnique())
+	{
+		State = MakeShareable(new FPXRFrameState());
+	}
+
+	// Settings and frame are kept by the render thread until the next frame replaces them
+	if (State->Settings.IsValid() && State->Settings.IsUnique())
+	{
+		*State->Settings = InSettings;
+	}
+	else
+	{
+		State->Settings = InSettings.Clone();
+	}
+
+	if (State->Frame.IsValid() && State->Frame.IsUnique())
+	{
+		*State->Frame = InFrame;
+	}
+	else
+	{
+		State->Frame = InFrame.CloneMyself();
+	}
+
+	State->Changes.Reset();
+	SyncLayerSources(LayerMap, State->Changes);
+
+	State->Layers.Reset();
+	for (FLayerSource& Entry : LayerSources)
+	{
+		const FPICOLayerPtr& Layer = LayerMap.FindChecked(Entry.ID);
+		const IStereoLayers::FLayerDesc& Desc = Layer->GetPXRLayerDesc();
+		const bool bContinuousUpdate = (Desc.Flags & IStereoLayers::LAYER_FLAG_TEX_CONTINUOUS_UPDATE) && Desc.Texture.IsValid();
+
+		if (!Entry.Template.IsValid() || Entry.Source != Layer)
+		{
+			const bool bAdded = !Entry.Template.IsValid();
+			Entry.Source = Layer;
+			// The template also carries any pending texture update
+			Entry.Template = Layer->CloneMyself();
+			Entry.Template->Generation = NextGeneration++;
+			(bAdded ? State->Changes.Added : State->Changes.DescChanged).Add(Entry.Template);
+		}
+		else if (Layer->IsTextureMarkedForUpdate() && !bContinuousUpdate)
+		{
+			// Continuous-update layers are copied by the render thread every frame, so only a one-off
+			// MarkTextureForUpdate has to be forwarded
+			State->Changes.TextureChanged.Add(Entry.ID);
+		}
+		Layer->MarkTextureForUpdate(bContinuousUpdate);
+
+		State->Layers.Add(Entry.Template);
+	}
+
+	return State;
+}
+
+void FPXRFrameStateRing::Reset()
+{
+	for (FPXRFrameStatePtr& State : Slots)
+	{
+		State.Reset();
+	}
+	NextSlot = 0;
+	LayerSources.Reset();
+}
+
+void FPXRFrameStateRing::SyncLayerSources(const TMap<uint32, FPICOLayerPtr>& LayerMap, FPXRLayerChangeSet& OutChanges)
+{
+	bool bInSync = LayerSources.Num() == LayerMap.Num();
+	for (int32 Index = 0; bInSync && Index < LayerSources.Num(); Index++)
+	{
+		bInSync = LayerMap.Contains(LayerSources[Index].ID);
+	}
+
+	if (bInSync)
+	{
+		return;
+	}
+
+	LayerSources.RemoveAll([&LayerMap, &OutChanges](const FLayerSource& Entry)
+		{
+			if (LayerMap.Contains(Entry.ID))
+			{
+				return false;
+			}
+			OutChanges.Removed.Add(Entry.ID);
+			return true;
+		});
+
+	for (const TPair<uint32, FPICOLayerPtr>& Pair : LayerMap)
+	{
+		const int32 Index = Algo::LowerBoundBy(LayerSources, Pair.Key, &FLayerSource::ID);
+		if (Index == LayerSources.Num() || LayerSources[Index].ID != Pair.Key)
+		{
+			LayerSources.Insert(FLayerSource{ Pair.Key, nullptr, nullptr }, Index);
+		}
+	}
+}
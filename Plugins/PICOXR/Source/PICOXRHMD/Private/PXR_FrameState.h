@@ -0,0 +1,83 @@
+// Copyright PICO Technology Co., Ltd. All rights reserved.
+// This plugin incorporates portions of the Unreal® Engine. Unreal® is a trademark or registered trademark of Epic Games, Inc. in the United States of America and elsewhere.
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+#include "CoreMinimal.h"
+#include "PXR_HMDSettings.h"
+#include "PXR_GameFrame.h"
+#include "PXR_StereoLayer.h"
+
+// Layer changes since the previous frame state, each list sorted by layer ID.
+struct FPXRLayerChangeSet
+{
+	// Templates of new layers
+	TArray<FPICOLayerPtr> Added;
+	TArray<uint32> Removed;
+	// Templates of layers whose desc changed; only these need their swapchains re-validated
+	TArray<FPICOLayerPtr> DescChanged;
+	// Layers marked for a one-off texture copy, desc unchanged
+	TArray<uint32> TextureChanged;
+
+	void Reset()
+	{
+		Added.Reset();
+		Removed.Reset();
+		DescChanged.Reset();
+		TextureChanged.Reset();
+	}
+
+	bool IsEmpty() const
+	{
+		return Added.Num() == 0 && Removed.Num() == 0 && DescChanged.Num() == 0 && TextureChanged.Num() == 0;
+	}
+};
+
+// Everything the render thread needs for one frame.
+class FPXRFrameState : public TSharedFromThis<FPXRFrameState, ESPMode::ThreadSafe>
+{
+public:
+	FSettingsPtr Settings;
+	FPXRGameFramePtr Frame;
+	// Templates of all layers, sorted by ID. A template is an immutable copy of the game thread layer, taken only when
+	// that layer is added or its desc changes, and stamped with a new Generation; a render thread layer object whose
+	// Generation matches the template is up to date. Used when the render thread has to rebuild its layer list.
+	TArray<FPICOLayerPtr> Layers;
+	// Applied on top of the previous frame state in the common case
+	FPXRLayerChangeSet Changes;
+};
+
+typedef TSharedPtr<FPXRFrameState, ESPMode::ThreadSafe> FPXRFrameStatePtr;
+
+// Preallocated frame states for the game-to-render handoff.
+// A state (and its Settings / Frame objects) is overwritten in place once the render thread has released it, which
+// with three slots is the normal case; if the render thread is still holding it, a new one is allocated instead.
+// Layers are tracked by ID in a sorted list that is only re-sorted when layers are added or removed, and only
+// layers whose game thread object was replaced (SetLayerDesc, eye layer updates) are copied.
+class FPXRFrameStateRing
+{
+public:
+	static constexpr int32 NumSlots = 3;
+
+	// Game thread. Returns a frame state holding copies of InSettings, InFrame and the current layers.
+	FPXRFrameStatePtr Acquire_GameThread(const FGameSettings& InSettings, const FPXRGameFrame& InFrame, const TMap<uint32, FPICOLayerPtr>& LayerMap);
+
+	void Reset();
+
+private:
+	struct FLayerSource
+	{
+		uint32 ID;
+		// Game thread layer the template was taken from; a different pointer in the layer map means the desc changed
+		FPICOLayerPtr Source;
+		FPICOLayerPtr Template;
+	};
+
+	// Adds and removes entries so that LayerSources matches the IDs in LayerMap, recording removed IDs in OutChanges
+	void SyncLayerSources(const TMap<uint32, FPICOLayerPtr>& LayerMap, FPXRLayerChangeSet& OutChanges);
+
+	FPXRFrameStatePtr Slots[NumSlots];
+	int32 NextSlot = 0;
+	uint32 NextGeneration = 1;
+	TArray<FLayerSource> LayerSources;
+};
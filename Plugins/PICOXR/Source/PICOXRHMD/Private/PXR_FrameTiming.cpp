@@ -0,0 +1,310 @@
+// Copyright PICO Technology Co., Ltd. All rights reserved.
+// This plugin incorporates portions of the Unreal® Engine. Unreal® is a trademark or registered trademark of Epic Games, Inc. in the United States of America and elsewhere.
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "PXR_FrameTiming.h"
+#include "PXR_HMDModule.h"
+#include "PXR_Log.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+DECLARE_FLOAT_COUNTER_STAT(TEXT("GameThread (ms)"), STAT_PICOTiming_GameThread, STATGROUP_PICOTiming);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("WaitFrame (ms)"), STAT_PICOTiming_WaitFrame, STATGROUP_PICOTiming);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("RenderPickup (ms)"), STAT_PICOTiming_RenderPickup, STATGROUP_PICOTiming);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("RHIThread (ms)"), STAT_PICOTiming_RHIThread, STATGROUP_PICOTiming);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("LateUpdateDelta (ms)"), STAT_PICOTiming_LateUpdateDelta, STATGROUP_PICOTiming);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("MotionToPhoton (ms)"), STAT_PICOTiming_MotionToPhoton, STATGROUP_PICOTiming);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("MotionToPhoton p99 (ms)"), STAT_PICOTiming_MotionToPhotonP99, STATGROUP_PICOTiming);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("FrameInterval (ms)"), STAT_PICOTiming_FrameInterval, STATGROUP_PICOTiming);
+DECLARE_DWORD_COUNTER_STAT(TEXT("MissedFrames"), STAT_PICOTiming_MissedFrames, STATGROUP_PICOTiming);
+
+static TAutoConsoleVariable<int32> CVarPICOTimingEnabled(
+	TEXT("pico.Timing.Enabled"),
+	1,
+	TEXT("Records frame stage timestamps for the PICOTiming stats and pico.Timing.ExportCSV.\n")
+	TEXT("0: Off\n")
+	TEXT("1: On (default)"),
+	ECVF_Default);
+
+static const TCHAR* const StageNames[] =
+{
+	TEXT("GameFrameBegin"),
+	TEXT("WaitFrameBegin"),
+	TEXT("WaitFrameEnd"),
+	TEXT("PoseSampled"),
+	TEXT("RenderFrameBegin"),
+	TEXT("BeginRendering"),
+	TEXT("LateUpdate"),
+	TEXT("RHIBeginFrame"),
+	TEXT("RHIEndFrame"),
+};
+static_assert(UE_ARRAY_COUNT(StageNames) == (int32)EPXRFrameStage::Count, "StageNames out of date");
+
+static const TCHAR* const MetricNames[] =
+{
+	TEXT("GameThreadMs"),
+	TEXT("WaitFrameMs"),
+	TEXT("RenderPickupMs"),
+	TEXT("RHIThreadMs"),
+	TEXT("LateUpdateDeltaMs"),
+	TEXT("MotionToPhotonMs"),
+	TEXT("FrameIntervalMs"),
+};
+static_assert(UE_ARRAY_COUNT(MetricNames) == (int32)EPXRFrameMetric::Count, "MetricNames out of date");
+
+FPXRFrameTiming& FPXRFrameTiming::Get()
+{
+	static FPXRFrameTiming Instance;
+	return Instance;
+}
+
+double FPXRFrameTiming::Now() const
+{
+	const FClockFunc ClockFunc = Clock.load(std::memory_order_relaxed);
+	return ClockFunc ? ClockFunc() : FPlatformTime::Seconds();
+}
+
+void FPXRFrameTiming::SetClock(FClockFunc InClock)
+{
+	check(IsInGameThread());
+	Clock.store(InClock, std::memory_order_relaxed);
+	// Frames in flight mix both clocks; Reset drops them along with the history
+	Reset();
+}
+
+void FPXRFrameTiming::Mark(uint32 FrameNumber, EPXRFrameStage Stage)
+{
+	if (CVarPICOTimingEnabled.GetValueOnAnyThread() == 0)
+	{
+		return;
+	}
+
+	FFrameSlot& Slot = Slots[FrameNumber % NumSlots];
+	if (Stage == EPXRFrameStage::GameFrameBegin)
+	{
+		check(IsInGameThread());
+		// A frame that was not rendered keeps its number for the next game frame and its slot
+		if (Slot.FrameNumber.load(std::memory_order_relaxed) != FrameNumber)
+		{
+			// Clear the mask first so that the new number is never seen with the stages of the frame it replaces
+			Slot.StageMask.store(0, std::memory_order_relaxed);
+			Slot.FrameNumber.store(FrameNumber, std::memory_order_release);
+		}
+	}
+	else if (Slot.FrameNumber.load(std::memory_order_acquire) != FrameNumber)
+	{
+		// Began while disabled, or already overwritten by a frame NumSlots later
+		return;
+	}
+
+	// Each stage is written by a single thread, and published by its bit in the mask
+	Slot.Timestamps[(int32)Stage] = Now();
+	Slot.StageMask.fetch_or(1u << (uint32)Stage, std::memory_order_release);
+}
+
+void FPXRFrameTiming::Update_GameThread(float DisplayRefreshRate)
+{
+	check(IsInGameThread());
+	const uint32 EndFrameBit = 1u << (uint32)EPXRFrameStage::RHIEndFrame;
+	const double DisplayPeriod = DisplayRefreshRate > 0.0f ? 1.0 / DisplayRefreshRate : 0.0;
+
+	// Slots are only claimed on the game thread, so a completed frame cannot change under us
+	Completed.Reset();
+	for (FFrameSlot& Slot : Slots)
+	{
+		const uint32 Mask = Slot.StageMask.load(std::memory_order_acquire);
+		const uint32 FrameNumber = Slot.FrameNumber.load(std::memory_order_relaxed);
+		if (!(Mask & EndFrameBit) || (bHasCompletedFrame && (int32)(FrameNumber - LastCompletedFrame) <= 0))
+		{
+			continue;
+		}
+
+		FFrameRecord& Record = Completed.AddDefaulted_GetRef();
+		Record.FrameNumber = FrameNumber;
+		Record.StageMask = Mask;
+		FMemory::Memcpy(Record.Timestamps, Slot.Timestamps, sizeof(Record.Timestamps));
+	}
+	Completed.Sort([](const FFrameRecord& A, const FFrameRecord& B) { return (int32)(A.FrameNumber - B.FrameNumber) < 0; });
+
+	for (FFrameRecord& Record : Completed)
+	{
+		auto HasStage = [&Record](EPXRFrameStage Stage)
+		{
+			return (Record.StageMask & (1u << (uint32)Stage)) != 0;
+		};
+		auto Delta = [&Record, &HasStage](EPXRFrameStage From, EPXRFrameStage To)
+		{
+			return HasStage(From) && HasStage(To) ? (float)((Record.Timestamps[(int32)To] - Record.Timestamps[(int32)From]) * 1000.0) : 0.0f;
+		};
+
+		float* Metrics = Record.Metrics;
+		Metrics[(int32)EPXRFrameMetric::GameThread] = Delta(EPXRFrameStage::GameFrameBegin, EPXRFrameStage::RenderFrameBegin);
+		Metrics[(int32)EPXRFrameMetric::WaitFrame] = Delta(EPXRFrameStage::WaitFrameBegin, EPXRFrameStage::WaitFrameEnd);
+		Metrics[(int32)EPXRFrameMetric::RenderPickup] = Delta(EPXRFrameStage::RenderFrameBegin, EPXRFrameStage::BeginRendering);
+		Metrics[(int32)EPXRFrameMetric::RHIThread] = Delta(EPXRFrameStage::RHIBeginFrame, EPXRFrameStage::RHIEndFrame);
+		Metrics[(int32)EPXRFrameMetric::LateUpdateDelta] = Delta(EPXRFrameStage::PoseSampled, EPXRFrameStage::LateUpdate);
+
+		// Estimated on the local clock only: the runtime's predicted display time is in a different time base
+		const EPXRFrameStage PoseStage = HasStage(EPXRFrameStage::LateUpdate) ? EPXRFrameStage::LateUpdate : EPXRFrameStage::PoseSampled;
+		const float SubmitMs = Delta(PoseStage, EPXRFrameStage::RHIEndFrame);
+		Metrics[(int32)EPXRFrameMetric::MotionToPhoton] = HasStage(PoseStage) ? SubmitMs + (float)(DisplayPeriod * 1000.0) : 0.0f;
+
+		const double EndFrameTime = Record.Timestamps[(int32)EPXRFrameStage::RHIEndFrame];
+		double Interval = LastEndFrameTime > 0.0 ? EndFrameTime - LastEndFrameTime : 0.0;
+		if (Interval > MaxFrameIntervalSeconds)
+		{
+			Interval = 0.0;
+		}
+		Metrics[(int32)EPXRFrameMetric::FrameInterval] = (float)(Interval * 1000.0);
+		Record.MissedFrames = DisplayPeriod > 0.0 && Interval > DisplayPeriod * 1.5 ? FMath::RoundToInt(Interval / DisplayPeriod) - 1 : 0;
+
+		TotalMissedFrames += Record.MissedFrames;
+		LastEndFrameTime = EndFrameTime;
+		LastCompletedFrame = Record.FrameNumber;
+		bHasCompletedFrame = true;
+		AddRecord(Record);
+	}
+
+	if (Completed.Num() > 0)
+	{
+		const float* Metrics = Completed.Last().Metrics;
+		SET_FLOAT_STAT(STAT_PICOTiming_GameThread, Metrics[(int32)EPXRFrameMetric::GameThread]);
+		SET_FLOAT_STAT(STAT_PICOTiming_WaitFrame, Metrics[(int32)EPXRFrameMetric::WaitFrame]);
+		SET_FLOAT_STAT(STAT_PICOTiming_RenderPickup, Metrics[(int32)EPXRFrameMetric::RenderPickup]);
+		SET_FLOAT_STAT(STAT_PICOTiming_RHIThread, Metrics[(int32)EPXRFrameMetric::RHIThread]);
+		SET_FLOAT_STAT(STAT_PICOTiming_LateUpdateDelta, Metrics[(int32)EPXRFrameMetric::LateUpdateDelta]);
+		SET_FLOAT_STAT(STAT_PICOTiming_MotionToPhoton, Metrics[(int32)EPXRFrameMetric::MotionToPhoton]);
+		SET_FLOAT_STAT(STAT_PICOTiming_FrameInterval, Metrics[(int32)EPXRFrameMetric::FrameInterval]);
+		SET_DWORD_STAT(STAT_PICOTiming_MissedFrames, TotalMissedFrames);
+
+		// Sorting the history every frame is not worth it for a stat
+		if (LastCompletedFrame % 60 == 0)
+		{
+			SET_FLOAT_STAT(STAT_PICOTiming_MotionToPhotonP99, GetPercentile(EPXRFrameMetric::MotionToPhoton, 0.99f));
+		}
+	}
+}
+
+void FPXRFrameTiming::RestartFrameInterval()
+{
+	check(IsInGameThread());
+	LastEndFrameTime = 0.0;
+}
+
+void FPXRFrameTiming::AddRecord(const FFrameRecord& Record)
+{
+	if (History.Num() < HistorySize)
+	{
+		History.Add(Record);
+	}
+	else
+	{
+		History[HistoryNext] = Record;
+	}
+	HistoryNext = (HistoryNext + 1) % HistorySize;
+}
+
+float FPXRFrameTiming::GetPercentile(EPXRFrameMetric Metric, float Percentile) const
+{
+	TArray<float, TInlineAllocator<HistorySize>> Values;
+	for (const FFrameRecord& Record : History)
+	{
+		if (Record.Metrics[(int32)Metric] > 0.0f)
+		{
+			Values.Add(Record.Metrics[(int32)Metric]);
+		}
+	}
+	if (Values.Num() == 0)
+	{
+		return 0.0f;
+	}
+
+	Values.Sort();
+	return Values[FMath::Clamp(FMath::CeilToInt(Percentile * Values.Num()) - 1, 0, Values.Num() - 1)];
+}
+
+void FPXRFrameTiming::Reset()
+{
+	check(IsInGameThread());
+	for (FFrameSlot& Slot : Slots)
+	{
+		Slot.StageMask.store(0, std::memory_order_relaxed);
+	}
+	bHasCompletedFrame = false;
+	LastCompletedFrame = 0;
+	LastEndFrameTime = 0.0;
+	TotalMissedFrames = 0;
+	History.Reset();
+	HistoryNext = 0;
+}
+
+bool FPXRFrameTiming::ExportCSV(const FString& Path) const
+{
+	check(IsInGameThread());
+	FString Csv = TEXT("Frame");
+	for (const TCHAR* StageName : StageNames)
+	{
+		Csv += FString::Printf(TEXT(",%sMs"), StageName);
+	}
+	for (const TCHAR* MetricName : MetricNames)
+	{
+		Csv += FString::Printf(TEXT(",%s"), MetricName);
+	}
+	Csv += TEXT(",MissedFrames\n");
+
+	// Oldest first; stage times are relative to GameFrameBegin, empty when the stage was not reached
+	const int32 First = History.Num() < HistorySize ? 0 : HistoryNext;
+	for (int32 Index = 0; Index < History.Num(); Index++)
+	{
+		const FFrameRecord& Record = History[(First + Index) % History.Num()];
+		const double BaseTime = Record.Timestamps[(int32)EPXRFrameStage::GameFrameBegin];
+		Csv += FString::Printf(TEXT("%u"), Record.FrameNumber);
+		for (int32 Stage = 0; Stage < (int32)EPXRFrameStage::Count; Stage++)
+		{
+			Csv += (Record.StageMask & (1u << Stage)) ? FString::Printf(TEXT(",%.3f"), (Record.Timestamps[Stage] - BaseTime) * 1000.0) : FString(TEXT(","));
+		}
+		for (float Value : Record.Metrics)
+		{
+			Csv += FString::Printf(TEXT(",%.3f"), Value);
+		}
+		Csv += FString::Printf(TEXT(",%d\n"), Record.MissedFrames);
+	}
+
+	if (!FFileHelper::SaveStringToFile(Csv, *Path))
+	{
+		PXR_LOGE(PxrUnreal, "Failed to write frame timing to %s", PLATFORM_CHAR(*Path));
+		return false;
+	}
+	PXR_LOGI(PxrUnreal, "Wrote %d frames of timing to %s", History.Num(), PLATFORM_CHAR(*Path));
+	return true;
+}
+
+void FPXRFrameTiming::LogSummary() const
+{
+	check(IsInGameThread());
+	PXR_LOGI(PxrUnreal, "Frame timing over %d frames, %u missed frames", History.Num(), TotalMissedFrames);
+	for (int32 Metric = 0; Metric < (int32)EPXRFrameMetric::Count; Metric++)
+	{
+		PXR_LOGI(PxrUnreal, "%s p50:%.2f p90:%.2f p99:%.2f", PLATFORM_CHAR(MetricNames[Metric]),
+			GetPercentile((EPXRFrameMetric)Metric, 0.5f), GetPercentile((EPXRFrameMetric)Metric, 0.9f), GetPercentile((EPXRFrameMetric)Metric, 0.99f));
+	}
+}
+
+static FAutoConsoleCommand CPICOTimingExportCSV(
+	TEXT("pico.Timing.ExportCSV"),
+	TEXT("Writes the per-frame stage timings and derived latencies of the last frames to a CSV file.\n")
+	TEXT("Usage: pico.Timing.ExportCSV [File]"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+		{
+			const FString Path = Args.Num() > 0 ? Args[0] : FPaths::ProjectSavedDir() / TEXT("PICOFrameTiming.csv");
+			FPXRFrameTiming::Get().ExportCSV(Path);
+		}));
+
+static FAutoConsoleCommand CPICOTimingSummary(
+	TEXT("pico.Timing.Summary"),
+	TEXT("Logs p50/p90/p99 of the frame timing metrics over the last frames."),
+	FConsoleCommandDelegate::CreateLambda([]()
+		{
+			FPXRFrameTiming::Get().LogSummary();
+		}));
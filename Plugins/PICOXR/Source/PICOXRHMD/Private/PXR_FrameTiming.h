@@ -0,0 +1,118 @@
+// Copyright PICO Technology Co., Ltd. All rights reserved.
+// This plugin incorporates portions of the Unreal® Engine. Unreal® is a trademark or registered trademark of Epic Games, Inc. in the United States of America and elsewhere.
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include <atomic>
+
+DECLARE_STATS_GROUP(TEXT("PICOTiming"), STATGROUP_PICOTiming, STATCAT_Advanced);
+
+enum class EPXRFrameStage : uint8
+{
+	GameFrameBegin,
+	WaitFrameBegin,
+	WaitFrameEnd,
+	// Head pose sampled for the game frame
+	PoseSampled,
+	// Frame handed to the render thread
+	RenderFrameBegin,
+	BeginRendering,
+	LateUpdate,
+	RHIBeginFrame,
+	// EndFrame returned
+	RHIEndFrame,
+	Count
+};
+
+enum class EPXRFrameMetric : uint8
+{
+	// GameFrameBegin to RenderFrameBegin
+	GameThread,
+	WaitFrame,
+	// RenderFrameBegin to BeginRendering
+	RenderPickup,
+	// RHIBeginFrame to RHIEndFrame
+	RHIThread,
+	// PoseSampled to LateUpdate
+	LateUpdateDelta,
+	// Pose used for the frame (late update if any) to RHIEndFrame, plus one refresh period of scanout
+	MotionToPhoton,
+	// Between consecutive RHIEndFrame
+	FrameInterval,
+	Count
+};
+
+// Frame pacing telemetry for the HMD frame loop.
+// Mark records a stage timestamp for a frame from any thread without locking: each frame owns a slot in a small ring,
+// claimed on the game thread at GameFrameBegin, and every stage sets its bit in the slot's mask after writing its
+// timestamp. Once per frame the game thread folds the frames that reached RHIEndFrame into a history of metrics,
+// counts missed refreshes from the frame intervals and updates STATGROUP_PICOTiming. Intervals across a splash, focus
+// loss or pause are not frame drops: the HMD restarts the interval there, and intervals longer than
+// MaxFrameIntervalSeconds are never counted as missed frames.
+// Console: pico.Timing.ExportCSV [File], pico.Timing.Summary
+class FPXRFrameTiming
+{
+public:
+	static FPXRFrameTiming& Get();
+
+	void Mark(uint32 FrameNumber, EPXRFrameStage Stage);
+
+	// Game thread
+	void Update_GameThread(float DisplayRefreshRate);
+	// The next completed frame starts a new frame interval instead of measuring from the last one
+	void RestartFrameInterval();
+	bool ExportCSV(const FString& Path) const;
+	void LogSummary() const;
+	void Reset();
+
+	typedef double (*FClockFunc)();
+	// Replaces FPlatformTime::Seconds, e.g. with the trace time of a replay; nullptr restores it. Drops the history.
+	void SetClock(FClockFunc InClock);
+
+	uint32 GetMissedFrames() const
+	{
+		return TotalMissedFrames;
+	}
+
+private:
+	static constexpr int32 NumSlots = 16;
+	static constexpr int32 HistorySize = 600;
+	// Longer gaps are stalls or suspended rendering, not missed refreshes
+	static constexpr double MaxFrameIntervalSeconds = 0.5;
+
+	struct FFrameSlot
+	{
+		std::atomic<uint32> FrameNumber{ 0 };
+		std::atomic<uint32> StageMask{ 0 };
+		double Timestamps[(int32)EPXRFrameStage::Count] = {};
+	};
+
+	struct FFrameRecord
+	{
+		uint32 FrameNumber;
+		uint32 StageMask;
+		double Timestamps[(int32)EPXRFrameStage::Count];
+		// Milliseconds, 0 when a stage is missing
+		float Metrics[(int32)EPXRFrameMetric::Count];
+		int32 MissedFrames;
+	};
+
+	double Now() const;
+	void AddRecord(const FFrameRecord& Record);
+	// Percentile (0-1) of one metric over the history, ignoring frames without it
+	float GetPercentile(EPXRFrameMetric Metric, float Percentile) const;
+
+	FFrameSlot Slots[NumSlots];
+	std::atomic<FClockFunc> Clock{ nullptr };
+
+	// Game thread
+	bool bHasCompletedFrame = false;
+	uint32 LastCompletedFrame = 0;
+	double LastEndFrameTime = 0.0;
+	uint32 TotalMissedFrames = 0;
+	TArray<FFrameRecord> History;
+	int32 HistoryNext = 0;
+	TArray<FFrameRecord> Completed;
+};
@@ -23,6 +23,8 @@
 #include "Misc/CoreDelegates.h"
 #include "GameFramework/GameUserSettings.h"
 #include "PICO_MRCSceneCapture2D.h"
+#include "Algo/BinarySearch.h"
+#include "PXR_FrameTiming.h"
 
 #define PICO_PAUSED_IDLE_FPS 10
 
@@ -95,6 +97,13 @@ static TAutoConsoleVariable<int32> CVarPICOBlendModeSetting(
 	TEXT("2: Additive Mode, Eye Buffer will not clip by Alpha\n"),
 	ECVF_Scalability | ECVF_RenderThreadSafe);
 
+static TAutoConsoleVariable<float> CVarPICOEventDeferredBudgetMs(
+	TEXT("pico.Events.DeferredBudgetMs"),
+	0.0f,
+	TEXT("Time per frame for dispatching deferrable runtime events (MR data updates, battery changes); the rest waits for the next frame.\n")
+	TEXT("0: Dispatch all events in the frame they are polled (Default)\n"),
+	ECVF_Default);
+
 float FPICOXRHMD::IpdValue = 0.f;
 FName FPICOXRHMD::GetSystemName() const
 {
@@ -628,6 +637,7 @@ void FPICOXRHMD::OnBeginRendering_RenderThread(FRHICommandListImmediate& RHICmdL
 	FAndroidApplication::GetJavaEnv();
 #endif
 	
+	FPXRFrameTiming::Get().Mark(GameFrame_RenderThread->FrameNumber, EPXRFrameStage::BeginRendering);
 	OnRHIFrameBegin_RenderThread();
 }
 
@@ -1046,8 +1056,6 @@ void FPICOXRHMD::UpdateStereoRenderingParams()
 	CheckInGameThread();
 	
 	FPICOLayerPtr* EyeLayerFound = PXRLayerMap.Find(0);
-	FPICOXRStereoLayer* EyeLayer = new FPICOXRStereoLayer(**EyeLayerFound);
-	*EyeLayerFound = MakeShareable(EyeLayer);
 
 	uint32 Layout = 1;
 
@@ -1101,20 +1109,39 @@ void FPICOXRHMD::UpdateStereoRenderingParams()
 	UpdateRenderTargetAndViewport();
 
 	{
+		const FPICOXRStereoLayer& CurrentEyeLayer = **EyeLayerFound;
+#ifdef PICO_CUSTOM_ENGINE
+		bool bEnableEyeTrackingFoveationRendering = CurrentEyeLayer.bEnableEyeTrackingFoveationRendering;
 		if (RHIString == TEXT("Vulkan"))
 		{
 			//Vulkan needs to detect whether there is a change in tracking mode. If there is a change, it needs to recreate the SwapChain of FFR.
-			#ifdef PICO_CUSTOM_ENGINE
-			FPICOXRHMDModule::GetPluginWrapper().GetEyeTrackingFoveationRenderingState(&EyeLayer->bEnableEyeTrackingFoveationRendering);
-			#endif
+			FPICOXRHMDModule::GetPluginWrapper().GetEyeTrackingFoveationRenderingState(&bEnableEyeTrackingFoveationRendering);
 		}
+#endif
 
 		const bool EnableSubsampled = CVarPICOEnableSubsampledLayout.GetValueOnAnyThread() == 1 && GameSettings->FoveatedRenderingLevel != PxrFoveationLevel::PXR_FOVEATION_LEVEL_NONE;
-		EyeLayer->SetEyeLayerDesc(GameSettings->RenderTargetSize.X, GameSettings->RenderTargetSize.Y, Layout, 1, 1, RHIString, EnableSubsampled);
-		EyeLayer->bNeedsTexSrgbCreate = GameSettings->Flags.bsRGBEyeBuffer;
+		const PxrLayerParam EyeLayerParam = CurrentEyeLayer.MakeEyeLayerCreateParam(GameSettings->RenderTargetSize.X, GameSettings->RenderTargetSize.Y, Layout, 1, 1, RHIString, EnableSubsampled);
+		const bool bNeedsTexSrgbCreate = GameSettings->Flags.bsRGBEyeBuffer;
+
+		// This runs every frame; replacing layer 0 makes the frame state copy it to the render thread again,
+		// so it is only replaced when its create params actually change
+		if (!CurrentEyeLayer.HasSameCreateParam(EyeLayerParam) || CurrentEyeLayer.bNeedsTexSrgbCreate != bNeedsTexSrgbCreate
+#ifdef PICO_CUSTOM_ENGINE
+			|| CurrentEyeLayer.bEnableEyeTrackingFoveationRendering != bEnableEyeTrackingFoveationRendering
+#endif
+			)
+		{
+			FPICOXRStereoLayer* EyeLayer = new FPICOXRStereoLayer(CurrentEyeLayer);
+			EyeLayer->SetEyeLayerCreateParam(EyeLayerParam);
+			EyeLayer->bNeedsTexSrgbCreate = bNeedsTexSrgbCreate;
+#ifdef PICO_CUSTOM_ENGINE
+			EyeLayer->bEnableEyeTrackingFoveationRendering = bEnableEyeTrackingFoveationRendering;
+#endif
+			*EyeLayerFound = MakeShareable(EyeLayer);
+		}
 	}
 
-	if (!EyeLayer->IfCanReuseLayers(PXREyeLayer_RenderThread.Get()))
+	if (!(*EyeLayerFound)->IfCanReuseLayers(PXREyeLayer_RenderThread.Get()))
 	{
 		AllocateEyeLayer();
 	}
@@ -1243,6 +1270,8 @@ void FPICOXRHMD::Shutdown()
 
 	GameSettings.Reset();
 	PXRLayerMap.Reset();
+	FrameStateRing.Reset();
+	EventBus.ResetDeferred();
 }
 
 void FPICOXRHMD::PollEvent()
@@ -1255,8 +1284,13 @@ void FPICOXRHMD::PollEvent()
 	if (Ret)
 	{
 		PXR_LOGD(PxrUnreal,"PollEvent EventCount :%d",EventCount);
-		ProcessEvent(EventCount, EventData);
 	}
+	else
+	{
+		EventCount = 0;
+	}
+	// Also runs without new events so that deferred events keep draining
+	ProcessEvent(EventCount, EventData);
 #endif
 }
 
@@ -1493,6 +1527,7 @@ void FPICOXRHMD::InitEyeLayer_RenderThread(FRHICommandListImmediate& RHICmdList)
 		{
 			PXRLayers_RenderThread.Add(EyeLayer);
 		}
+		bLayersNeedFullSync_RenderThread = true;
 #ifdef PICO_CUSTOM_ENGINE
 		if (EyeLayer->GetMotionVectorSwapChain().IsValid())
 		{
@@ -1611,182 +1646,183 @@ void FPICOXRHMD::UpdateFoveationOffsets_RenderThread()
 #endif
 void FPICOXRHMD::ProcessEvent(int32 EventCount, PxrEventDataBuffer** EventData)
 {
-	if (EventCount ==0 || !EventData)
+	const double DeferredBudgetSeconds = CVarPICOEventDeferredBudgetMs.GetValueOnGameThread() / 1000.0;
+	EventBus.Dispatch(EventData ? EventCount : 0, EventData, DeferredBudgetSeconds, [this](PxrEventDataBuffer* Event)
+		{
+			HandleEvent(Event);
+		});
+}
+
+void FPICOXRHMD::HandleEvent(PxrEventDataBuffer* Event)
+{
+	PXR_LOGD(PxrUnreal,"ProcessEvent EventType:%d",Event->type);
+	switch(Event->type)
 	{
-		return;
+	case PXR_TYPE_EVENT_DATA_SESSION_STATE_READY:
+	{
+		PXR_LOGI(PxrUnreal, "Session Ready!");
+		BeginXR();
+		break;
 	}
-	for (int i = 0; i < EventCount; i++)
+	case PXR_TYPE_EVENT_DATA_SESSION_STATE_STOPPING:
 	{
-		PxrEventDataBuffer* Event = EventData[i];
-		PXR_LOGD(PxrUnreal,"ProcessEvent EventCount:%d,EventType[%d]:%d",EventCount,i,Event->type);
-		switch(Event->type)
-		{
-		case PXR_TYPE_EVENT_DATA_SESSION_STATE_READY:
-		{
-			PXR_LOGI(PxrUnreal, "Session Ready!");
-			BeginXR();
-			break;
-		}
-		case PXR_TYPE_EVENT_DATA_SESSION_STATE_STOPPING:
-		{
-			PXR_LOGI(PxrUnreal, "Session Stopping!");
-			EndXR();
-			break;
-		}
-		case PXR_TYPE_EVENT_DATA_SEETHROUGH_STATE_CHANGED:
-		{
-			const PxrEventDataSeethroughStateChanged SeeThroughData = *reinterpret_cast<const PxrEventDataSeethroughStateChanged*>(Event);
-			OnSeeThroughStateChange(SeeThroughData.state);
-			break;
-		}
-		case PXR_TYPE_EVENT_FOVEATION_LEVEL_CHANGED:
-		{
-			const PxrEventDataFoveationLevelChanged FoveationData = *reinterpret_cast<const PxrEventDataFoveationLevelChanged*>(Event);
-			OnFoveationLevelChange(FoveationData.level);
-			break;
-		}
-		case PXR_TYPE_EVENT_FRUSTUM_STATE_CHANGED:
-		{
-			const PxrEventDataFrustumChanged FrustumData = *reinterpret_cast<const PxrEventDataFrustumChanged*>(Event);
-			OnFrustumStateChange();
-			break;
-		}
-		case PXR_TYPE_EVENT_RENDER_TEXTURE_CHANGED:
-		{
-			const PxrEventDataRenderTextureChanged RenderTextureChanged = *reinterpret_cast<const PxrEventDataRenderTextureChanged*>(Event);
-			OnRenderTextureChange(RenderTextureChanged.width,RenderTextureChanged.height);
-			break;
-		}
-		case PXR_TYPE_EVENT_TARGET_FRAME_RATE_STATE_CHANGED:
-		{
-			const PxrEventDataTargetFrameRateChanged FrameRateChanged = *reinterpret_cast<const PxrEventDataTargetFrameRateChanged*>(Event);
-			OnTargetFrameRateChange(FrameRateChanged.frameRate);
-			break;
-		}
+		PXR_LOGI(PxrUnreal, "Session Stopping!");
+		EndXR();
+		break;
+	}
+	case PXR_TYPE_EVENT_DATA_SEETHROUGH_STATE_CHANGED:
+	{
+		const PxrEventDataSeethroughStateChanged SeeThroughData = *reinterpret_cast<const PxrEventDataSeethroughStateChanged*>(Event);
+		OnSeeThroughStateChange(SeeThroughData.state);
+		break;
+	}
+	case PXR_TYPE_EVENT_FOVEATION_LEVEL_CHANGED:
+	{
+		const PxrEventDataFoveationLevelChanged FoveationData = *reinterpret_cast<const PxrEventDataFoveationLevelChanged*>(Event);
+		OnFoveationLevelChange(FoveationData.level);
+		break;
+	}
+	case PXR_TYPE_EVENT_FRUSTUM_STATE_CHANGED:
+	{
+		const PxrEventDataFrustumChanged FrustumData = *reinterpret_cast<const PxrEventDataFrustumChanged*>(Event);
+		OnFrustumStateChange();
+		break;
+	}
+	case PXR_TYPE_EVENT_RENDER_TEXTURE_CHANGED:
+	{
+		const PxrEventDataRenderTextureChanged RenderTextureChanged = *reinterpret_cast<const PxrEventDataRenderTextureChanged*>(Event);
+		OnRenderTextureChange(RenderTextureChanged.width,RenderTextureChanged.height);
+		break;
+	}
+	case PXR_TYPE_EVENT_TARGET_FRAME_RATE_STATE_CHANGED:
+	{
+		const PxrEventDataTargetFrameRateChanged FrameRateChanged = *reinterpret_cast<const PxrEventDataTargetFrameRateChanged*>(Event);
+		OnTargetFrameRateChange(FrameRateChanged.frameRate);
+		break;
+	}
 
-		case PXR_TYPE_EVENT_DATA_CONTROLLER:
-		{
-			const PxrEventDataControllerChanged Controller = *reinterpret_cast<const PxrEventDataControllerChanged*>(Event);
-			ProcessControllerEvent(Controller);
-			break;
-		}
+	case PXR_TYPE_EVENT_DATA_CONTROLLER:
+	{
+		const PxrEventDataControllerChanged Controller = *reinterpret_cast<const PxrEventDataControllerChanged*>(Event);
+		ProcessControllerEvent(Controller);
+		break;
+	}
 
-		case PXR_TYPE_EVENT_HARDIPD_STATE_CHANGED:
-		{
-			const PxrEventDataHardIPDStateChanged IPDState = *reinterpret_cast<const PxrEventDataHardIPDStateChanged*>(Event);
-			IpdValue = IPDState.ipd;
-			PXR_LOGD(PxrUnreal,"ProcessEvent PXR_TYPE_EVENT_HARDIPD_STATE_CHANGED IPD:%f",IPDState.ipd);
-			EventManager->IpdChangedDelegate.Broadcast(IPDState.ipd);
-			UPICOXRHMDFunctionLibrary::PICOXRIPDChangedCallback.ExecuteIfBound(IPDState.ipd);
-			break;
-		}
-		case PXR_TYPE_EVENT_DATA_HMD_KEY:
-		{
-			const PxrEventDataHmdKey HomeKey = *reinterpret_cast<const PxrEventDataHmdKey*>(Event);
-			EventManager->LongHomePressedDelegate.Broadcast();
-			EventManager->RawLongHomePressedDelegate.Broadcast();
-			if (FCoreDelegates::VRHeadsetRecenter.IsBound())
-			{
-				FCoreDelegates::VRHeadsetRecenter.Broadcast();
-			}
-			break;
-		}
-		case PXR_TYPE_EVENT_DATA_MRC_STATUS:
-		{
-			const PxrEventDataMrcStatusChanged MRC = *reinterpret_cast<const PxrEventDataMrcStatusChanged*>(Event);
-			MRCEnabled = MRC.mrc_status == 0 ? true : false;
-			break;
-		}
-		case PXR_TYPE_EVENT_DATA_REFRESH_RATE_CHANGED:
-		{
-			const PxrEventDataRefreshRateChanged RateState = *reinterpret_cast<const PxrEventDataRefreshRateChanged*>(Event);
-			PXR_LOGD(PxrUnreal, "ProcessEvent PXR_TYPE_EVENT_DATA_REFRESH_RATE_CHANGED Rate:%f", RateState.refrashRate);
-			DisplayRefreshRate = RateState.refrashRate;
-			EventManager->RefreshRateChangedDelegate.Broadcast(RateState.refrashRate);
-			break;
-		}
-		case PXR_TYPE_EVENT_DATA_SESSION_STATE_CHANGED:
-		{
-			const PxrEventDataSessionStateChanged sessionStateChanged = *reinterpret_cast<const PxrEventDataSessionStateChanged*>(Event);
-			inputFocusState = sessionStateChanged.state == PXR_SESSION_STATE_FOCUSED;
-			break;
-		}
-		case PXR_TYPE_EVENT_HMD_BATTERY_CHANGED:
+	case PXR_TYPE_EVENT_HARDIPD_STATE_CHANGED:
+	{
+		const PxrEventDataHardIPDStateChanged IPDState = *reinterpret_cast<const PxrEventDataHardIPDStateChanged*>(Event);
+		IpdValue = IPDState.ipd;
+		PXR_LOGD(PxrUnreal,"ProcessEvent PXR_TYPE_EVENT_HARDIPD_STATE_CHANGED IPD:%f",IPDState.ipd);
+		EventManager->IpdChangedDelegate.Broadcast(IPDState.ipd);
+		UPICOXRHMDFunctionLibrary::PICOXRIPDChangedCallback.ExecuteIfBound(IPDState.ipd);
+		break;
+	}
+	case PXR_TYPE_EVENT_DATA_HMD_KEY:
+	{
+		const PxrEventDataHmdKey HomeKey = *reinterpret_cast<const PxrEventDataHmdKey*>(Event);
+		EventManager->LongHomePressedDelegate.Broadcast();
+		EventManager->RawLongHomePressedDelegate.Broadcast();
+		if (FCoreDelegates::VRHeadsetRecenter.IsBound())
 		{
-			const PxrEventHmdBatteryChanged BatteryStateChanged = *reinterpret_cast<const PxrEventHmdBatteryChanged*>(Event);
-			PXR_LOGD(PxrUnreal, "ProcessEvent PXR_TYPE_EVENT_HMD_BATTERY_CHANGED BatteryState:%d", BatteryStateChanged.value);
-			EventManager->BatteryStateChangedDelegate.Broadcast(BatteryStateChanged.value);
-			CurrentHMDBatteryLevel=BatteryStateChanged.value;
-			break;
+			FCoreDelegates::VRHeadsetRecenter.Broadcast();
 		}
-		case PXR_TYPE_EVENT_MOTION_TRACKER_KEY_EVENT:
-		{
-			const PxrEventDataMotionTrackerKey MotionTrackerKeyEvent = *reinterpret_cast<const PxrEventDataMotionTrackerKey*>(Event);
-			FPXREventDataMotionTrackerKey EventDataMotionTrackerKey={};
-			EventDataMotionTrackerKey.TrackerSN = FString(UTF8_TO_TCHAR(MotionTrackerKeyEvent.trackerSN));
-			EventDataMotionTrackerKey.Code =MotionTrackerKeyEvent.code;
-			EventDataMotionTrackerKey.Action =MotionTrackerKeyEvent.action;
-			EventDataMotionTrackerKey.Repeat=MotionTrackerKeyEvent.repeat;
-			EventDataMotionTrackerKey.bShortPress =MotionTrackerKeyEvent.shortPress;
+		break;
+	}
+	case PXR_TYPE_EVENT_DATA_MRC_STATUS:
+	{
+		const PxrEventDataMrcStatusChanged MRC = *reinterpret_cast<const PxrEventDataMrcStatusChanged*>(Event);
+		MRCEnabled = MRC.mrc_status == 0 ? true : false;
+		break;
+	}
+	case PXR_TYPE_EVENT_DATA_REFRESH_RATE_CHANGED:
+	{
+		const PxrEventDataRefreshRateChanged RateState = *reinterpret_cast<const PxrEventDataRefreshRateChanged*>(Event);
+		PXR_LOGD(PxrUnreal, "ProcessEvent PXR_TYPE_EVENT_DATA_REFRESH_RATE_CHANGED Rate:%f", RateState.refrashRate);
+		DisplayRefreshRate = RateState.refrashRate;
+		EventManager->RefreshRateChangedDelegate.Broadcast(RateState.refrashRate);
+		break;
+	}
+	case PXR_TYPE_EVENT_DATA_SESSION_STATE_CHANGED:
+	{
+		const PxrEventDataSessionStateChanged sessionStateChanged = *reinterpret_cast<const PxrEventDataSessionStateChanged*>(Event);
+		inputFocusState = sessionStateChanged.state == PXR_SESSION_STATE_FOCUSED;
+		break;
+	}
+	case PXR_TYPE_EVENT_HMD_BATTERY_CHANGED:
+	{
+		const PxrEventHmdBatteryChanged BatteryStateChanged = *reinterpret_cast<const PxrEventHmdBatteryChanged*>(Event);
+		PXR_LOGD(PxrUnreal, "ProcessEvent PXR_TYPE_EVENT_HMD_BATTERY_CHANGED BatteryState:%d", BatteryStateChanged.value);
+		EventManager->BatteryStateChangedDelegate.Broadcast(BatteryStateChanged.value);
+		CurrentHMDBatteryLevel=BatteryStateChanged.value;
+		break;
+	}
+	case PXR_TYPE_EVENT_MOTION_TRACKER_KEY_EVENT:
+	{
+		const PxrEventDataMotionTrackerKey MotionTrackerKeyEvent = *reinterpret_cast<const PxrEventDataMotionTrackerKey*>(Event);
+		FPXREventDataMotionTrackerKey EventDataMotionTrackerKey={};
+		EventDataMotionTrackerKey.TrackerSN = FString(UTF8_TO_TCHAR(MotionTrackerKeyEvent.trackerSN));
+		EventDataMotionTrackerKey.Code =MotionTrackerKeyEvent.code;
+		EventDataMotionTrackerKey.Action =MotionTrackerKeyEvent.action;
+		EventDataMotionTrackerKey.Repeat=MotionTrackerKeyEvent.repeat;
+		EventDataMotionTrackerKey.bShortPress =MotionTrackerKeyEvent.shortPress;
 
-			PXR_LOGD(PxrUnreal, "ProcessEvent PXR_TYPE_EVENT_MOTION_TRACKER_KEY_EVENT Code:%d,action:%d,repeat:%d,shortPress:%d"
-				,MotionTrackerKeyEvent.code
-				,MotionTrackerKeyEvent.action
-				,MotionTrackerKeyEvent.repeat
-				,MotionTrackerKeyEvent.shortPress);
+		PXR_LOGD(PxrUnreal, "ProcessEvent PXR_TYPE_EVENT_MOTION_TRACKER_KEY_EVENT Code:%d,action:%d,repeat:%d,shortPress:%d"
+			,MotionTrackerKeyEvent.code
+			,MotionTrackerKeyEvent.action
+			,MotionTrackerKeyEvent.repeat
+			,MotionTrackerKeyEvent.shortPress);
 
-			EventManager->DataMotionTrackerKeyDelegate.Broadcast(EventDataMotionTrackerKey);
-				
-			break;
-		}
-		case PXR_TYPE_EVENT_EXT_DEV_CONNECT_STATE_EVENT:
-		{
-			const PxrEventDataExtDevConnectEvent ExtDevConnectEvent = *reinterpret_cast<const PxrEventDataExtDevConnectEvent*>(Event);
-			FPXREventDataExtDevConnectEvent EventDataExtDevConnectEvent={};
-			EventDataExtDevConnectEvent.TrackerSN = FString(UTF8_TO_TCHAR(ExtDevConnectEvent.trackerSN));
-			EventDataExtDevConnectEvent.state =ExtDevConnectEvent.state;
-			PXR_LOGD(PxrUnreal, "ProcessEvent PXR_TYPE_EVENT_EXT_DEV_CONNECT_STATE_EVENT TrackerSN:%s,state:%d", *EventDataExtDevConnectEvent.TrackerSN
-				, EventDataExtDevConnectEvent.state);
-			EventManager->DataExtDevConnectEventDelegate.Broadcast(EventDataExtDevConnectEvent);
-			break;
-		}
-		case PXR_TYPE_EVENT_EXT_DEV_BATTERY_STATE_EVENT:
-		{
-			const PxrEventDataExtDevBatteryEvent ExtDevBatteryEvent = *reinterpret_cast<const PxrEventDataExtDevBatteryEvent*>(Event);
-			FPXREventDataExtDevBatteryEvent EventDataExtDevBatteryEvent={};
-			PXR_LOGD(PxrUnreal, "ProcessEvent PXR_TYPE_EVENT_EXT_DEV_BATTERY_STATE_EVENT TrackerSN:%s,battery:%d,charger:%d", *EventDataExtDevBatteryEvent.TrackerSN
-				, EventDataExtDevBatteryEvent.battery
-				, EventDataExtDevBatteryEvent.charger);
-			EventManager->DataExtDevBatteryEventDelegate.Broadcast(EventDataExtDevBatteryEvent);
-			break;
-		}
-		case PXR_TYPE_EVENT_MOTION_TRACKING_MODE_CHANGED_EVENT:
-		{
-			const PxrEventDataMotionTrackingModeChangedEvent DataMotionTrackingModeChangedEvent = *reinterpret_cast<const PxrEventDataMotionTrackingModeChangedEvent*>(Event);
-			PXR_LOGD(PxrUnreal, "ProcessEvent PXR_TYPE_EVENT_MOTION_TRACKING_MODE_CHANGED_EVENT Mode:%d", DataMotionTrackingModeChangedEvent.mode);
-			EventManager->DataMotionTrackingModeChangedEventDelegate.Broadcast(DataMotionTrackingModeChangedEvent.mode);
-			break;
-		}
-		case PXR_TYPE_EVENT_EXT_DEV_PASS_DATA_EVENT:
-		{
-			const PxrEventDataExtDevPassDataEvent DataExtDevPassDataEvent = *reinterpret_cast<const PxrEventDataExtDevPassDataEvent*>(Event);
-			PXR_LOGD(PxrUnreal, "ProcessEvent PXR_TYPE_EVENT_EXT_DEV_PASS_DATA_EVENT status:%d", DataExtDevPassDataEvent.status);
-			EventManager->DataExtDevPassDataEventDelegate.Broadcast(DataExtDevPassDataEvent.status);
-			break;
-		}
-		case PXR_TYPE_EVENT_VST_DISPLAY_STATUS_CHANGED:
-		{
-			const  PxrEventDataVstDisplayChanged DataVstDisplayChanged = *reinterpret_cast<const PxrEventDataVstDisplayChanged*>(Event);
-			PXR_LOGD(PxrUnreal, "ProcessEvent PXR_TYPE_EVENT_VST_DISPLAY_STATUS_CHANGED displayStatus:%d", DataVstDisplayChanged.displayStatus);
-			EventManager->VSTDisplayChangedDelegate.Broadcast(static_cast<EPICOVSTDisplayStatus>(DataVstDisplayChanged.displayStatus));
-			break;
-		}
-		default:
-		{
-			PollEventDelegate.Broadcast(Event);
-			break;
-		}
-		}
+		EventManager->DataMotionTrackerKeyDelegate.Broadcast(EventDataMotionTrackerKey);
+			
+		break;
+	}
+	case PXR_TYPE_EVENT_EXT_DEV_CONNECT_STATE_EVENT:
+	{
+		const PxrEventDataExtDevConnectEvent ExtDevConnectEvent = *reinterpret_cast<const PxrEventDataExtDevConnectEvent*>(Event);
+		FPXREventDataExtDevConnectEvent EventDataExtDevConnectEvent={};
+		EventDataExtDevConnectEvent.TrackerSN = FString(UTF8_TO_TCHAR(ExtDevConnectEvent.trackerSN));
+		EventDataExtDevConnectEvent.state =ExtDevConnectEvent.state;
+		PXR_LOGD(PxrUnreal, "ProcessEvent PXR_TYPE_EVENT_EXT_DEV_CONNECT_STATE_EVENT TrackerSN:%s,state:%d", *EventDataExtDevConnectEvent.TrackerSN
+			, EventDataExtDevConnectEvent.state);
+		EventManager->DataExtDevConnectEventDelegate.Broadcast(EventDataExtDevConnectEvent);
+		break;
+	}
+	case PXR_TYPE_EVENT_EXT_DEV_BATTERY_STATE_EVENT:
+	{
+		const PxrEventDataExtDevBatteryEvent ExtDevBatteryEvent = *reinterpret_cast<const PxrEventDataExtDevBatteryEvent*>(Event);
+		FPXREventDataExtDevBatteryEvent EventDataExtDevBatteryEvent={};
+		PXR_LOGD(PxrUnreal, "ProcessEvent PXR_TYPE_EVENT_EXT_DEV_BATTERY_STATE_EVENT TrackerSN:%s,battery:%d,charger:%d", *EventDataExtDevBatteryEvent.TrackerSN
+			, EventDataExtDevBatteryEvent.battery
+			, EventDataExtDevBatteryEvent.charger);
+		EventManager->DataExtDevBatteryEventDelegate.Broadcast(EventDataExtDevBatteryEvent);
+		break;
+	}
+	case PXR_TYPE_EVENT_MOTION_TRACKING_MODE_CHANGED_EVENT:
+	{
+		const PxrEventDataMotionTrackingModeChangedEvent DataMotionTrackingModeChangedEvent = *reinterpret_cast<const PxrEventDataMotionTrackingModeChangedEvent*>(Event);
+		PXR_LOGD(PxrUnreal, "ProcessEvent PXR_TYPE_EVENT_MOTION_TRACKING_MODE_CHANGED_EVENT Mode:%d", DataMotionTrackingModeChangedEvent.mode);
+		EventManager->DataMotionTrackingModeChangedEventDelegate.Broadcast(DataMotionTrackingModeChangedEvent.mode);
+		break;
+	}
+	case PXR_TYPE_EVENT_EXT_DEV_PASS_DATA_EVENT:
+	{
+		const PxrEventDataExtDevPassDataEvent DataExtDevPassDataEvent = *reinterpret_cast<const PxrEventDataExtDevPassDataEvent*>(Event);
+		PXR_LOGD(PxrUnreal, "ProcessEvent PXR_TYPE_EVENT_EXT_DEV_PASS_DATA_EVENT status:%d", DataExtDevPassDataEvent.status);
+		EventManager->DataExtDevPassDataEventDelegate.Broadcast(DataExtDevPassDataEvent.status);
+		break;
+	}
+	case PXR_TYPE_EVENT_VST_DISPLAY_STATUS_CHANGED:
+	{
+		const  PxrEventDataVstDisplayChanged DataVstDisplayChanged = *reinterpret_cast<const PxrEventDataVstDisplayChanged*>(Event);
+		PXR_LOGD(PxrUnreal, "ProcessEvent PXR_TYPE_EVENT_VST_DISPLAY_STATUS_CHANGED displayStatus:%d", DataVstDisplayChanged.displayStatus);
+		EventManager->VSTDisplayChangedDelegate.Broadcast(static_cast<EPICOVSTDisplayStatus>(DataVstDisplayChanged.displayStatus));
+		break;
+	}
+	default:
+	{
+		PollEventDelegate.Broadcast(Event);
+		break;
+	}
 	}
 }
 
@@ -2107,6 +2143,7 @@ void FPICOXRHMD::DoSessionShutdown()
 			GameFrame_GameThread.Reset();
 			PXRLayers_RenderThread.Reset();
 			PXREyeLayer_RenderThread.Reset();
+			bLayersNeedFullSync_RenderThread = true;
 
 			DelayDeletion.HandleLayerDeferredDeletionQueue_RenderThread(true);
 		});
@@ -3045,7 +3082,6 @@ void FPICOXRHMD::OnPreLoadMap(const FString& MapName)
 		PICOSplash->OnPreLoadMap(MapName);
 	}
 }
-DECLARE_STATS_GROUP(TEXT("PICOTiming"), STATGROUP_PICOTiming, STATCAT_Advanced);
 DECLARE_CYCLE_STAT(TEXT("WaitFrame"), STAT_WaitFrame, STATGROUP_PICOTiming);
 void FPICOXRHMD::WaitFrame()
 {
@@ -3059,7 +3095,9 @@ void FPICOXRHMD::WaitFrame()
 		{
 			if (bWaitFrameVersion)
 			{
+				FPXRFrameTiming::Get().Mark(GameFrame_GameThread->FrameNumber, EPXRFrameStage::WaitFrameBegin);
 				FPICOXRHMDModule::GetPluginWrapper().WaitFrame();
+				FPXRFrameTiming::Get().Mark(GameFrame_GameThread->FrameNumber, EPXRFrameStage::WaitFrameEnd);
 				FPICOXRHMDModule::GetPluginWrapper().GetPredictedDisplayTime(&CurrentFramePredictedTime);
 				GameFrame_GameThread->Flags.bHasWaited = true;
 				GameFrame_GameThread->predictedDisplayTimeMs = CurrentFramePredictedTime;
@@ -3090,6 +3128,7 @@ void FPICOXRHMD::LateUpdatePose()
 		if (!CurrentFrame->Flags.bLateUpdateOK)
 		{
 			UpdateSensorValue(GameSettings_RenderThread.Get(), CurrentFrame);
+			FPXRFrameTiming::Get().Mark(CurrentFrame->FrameNumber, EPXRFrameStage::LateUpdate);
 			CurrentFrame->Flags.bLateUpdateOK = true;
 			int32 SubmitViewNumber = CurrentFrame->ViewNumber;
 			ExecuteOnRHIThread_DoNotWait([this, SubmitViewNumber]()
@@ -3111,13 +3150,21 @@ void FPICOXRHMD::LateUpdatePose()
 #if PLATFORM_ANDROID
 	 if (!GameFrame_GameThread.IsValid() && FPICOXRHMDModule::GetPluginWrapper().IsRunning())
 	 {
+		 FPXRFrameTiming::Get().Update_GameThread(DisplayRefreshRate);
+
 		 static const auto WaitFrameAtGameFrameTailCVar = IConsoleManager::Get().FindTConsoleVariableDataInt(TEXT("PICO.WaitFrameAtGameFrameTail"));
 		 GameSettings->bWaitFrameAtGameFrameTail = WaitFrameAtGameFrameTailCVar && WaitFrameAtGameFrameTailCVar->GetValueOnAnyThread() != 0;
 
 		 PICOSplash->SwitchActiveSplash_GameThread();
+		 // Frames are not paced by the runtime while the splash shows or the session is out of focus
+		 if (PICOSplash->IsShown() || !inputFocusState || GameSettings->Flags.bPauseRendering)
+		 {
+			 FPXRFrameTiming::Get().RestartFrameInterval();
+		 }
 		 if (GameSettings->Flags.bHMDEnabled)
 		 {
 			 GameFrame_GameThread = MakeNewGameFrame();
+			 FPXRFrameTiming::Get().Mark(GameFrame_GameThread->FrameNumber, EPXRFrameStage::GameFrameBegin);
 			 NextGameFrameToRender_GameThread = GameFrame_GameThread;
 			 PXR_LOGV(PxrUnreal, "StartGameFrame %u", GameFrame_GameThread->FrameNumber);
 			 if (!PICOSplash->IsShown())
@@ -3128,6 +3175,7 @@ void FPICOXRHMD::LateUpdatePose()
 					 WaitFrame();
 				 }
 				 UpdateSensorValue(GameSettings.Get(), NextGameFrameToRender_GameThread.Get());
+				 FPXRFrameTiming::Get().Mark(GameFrame_GameThread->FrameNumber, EPXRFrameStage::PoseSampled);
 			 }
 		 }
 	 	
@@ -3168,89 +3216,184 @@ void FPICOXRHMD::LateUpdatePose()
 		 {
 			 NextGameFrameNumber++;
 		 }
-		 FSettingsPtr PXRSettings = GameSettings->Clone();
-		 FPXRGameFramePtr PXRFrame = NextGameFrameToRender_GameThread->CloneMyself();
+		 FPXRFrameTiming::Get().Mark(NextGameFrameToRender_GameThread->FrameNumber, EPXRFrameStage::RenderFrameBegin);
+		 FPXRFrameStatePtr FrameState = FrameStateRing.Acquire_GameThread(*GameSettings, *NextGameFrameToRender_GameThread, PXRLayerMap);
 		 PXR_LOGV(PxrUnreal, "OnRenderFrameBegin_GameThread %u has been eaten by render-thread!", NextGameFrameToRender_GameThread->FrameNumber);
-		 TArray<FPICOLayerPtr> PXRLayers;
 
-		 PXRLayers.Empty(PXRLayerMap.Num());
-
-		 for (auto Pair : PXRLayerMap)
-		 {
-			 PXRLayers.Emplace(Pair.Value->CloneMyself());
-
-			 if (Pair.Value->GetPXRLayerDesc().Flags & IStereoLayers::LAYER_FLAG_TEX_CONTINUOUS_UPDATE && Pair.Value->GetPXRLayerDesc().Texture.IsValid())
+		 ExecuteOnRenderThread_DoNotWait([this, FrameState](FRHICommandListImmediate& RHICmdList)
 			 {
-				 Pair.Value->MarkTextureForUpdate(true);
-			 }
-			 else
-			 {
-				 Pair.Value->MarkTextureForUpdate(false);
-			 }
-		 }
-		 PXRLayers.Sort(FPICOLayerPtr_SortById());
+				 GameSettings_RenderThread = FrameState->Settings;
+			 	
+				 GameFrame_RenderThread = FrameState->Frame;
 
-		 ExecuteOnRenderThread_DoNotWait([this, PXRSettings, PXRFrame, PXRLayers](FRHICommandListImmediate& RHICmdList)
-			 {
-				 if (PXRFrame.IsValid())
+				 if (bLayersNeedFullSync_RenderThread || !ApplyLayerChanges_RenderThread(FrameState->Changes, RHICmdList))
 				 {
-					 GameSettings_RenderThread = PXRSettings;
-				 	
-					 GameFrame_RenderThread = PXRFrame;
+					 SyncAllLayers_RenderThread(*FrameState, RHICmdList);
+				 }
 
-					 int32 PXRLayerIndex_Current = 0;
-					 int32 PXRLastLayerIndex_RenderThread = 0;
-					 TArray<FPICOLayerPtr> ValidXLayers;
+				 DelayDeletion.HandleLayerDeferredDeletionQueue_RenderThread();
+			 });
+	 }
+ }
 
-					 while (PXRLayerIndex_Current < PXRLayers.Num() && PXRLastLayerIndex_RenderThread < PXRLayers_RenderThread.Num())
-					 {
-						 uint32 LayerIdX = PXRLayers[PXRLayerIndex_Current]->GetID();
-						 uint32 LayerIdY = PXRLayers_RenderThread[PXRLastLayerIndex_RenderThread]->GetID();
+static int32 FindLayerIndexById(const TArray<FPICOLayerPtr>& Layers, uint32 LayerId)
+{
+	return Algo::BinarySearchBy(Layers, LayerId, [](const FPICOLayerPtr& Layer) { return Layer->GetID(); });
+}
 
-						 if (LayerIdX < LayerIdY)
-						 {
-							 if (PXRLayers[PXRLayerIndex_Current]->InitPXRLayer_RenderThread(GameSettings_RenderThread.Get(), RenderBridge, &DelayDeletion, RHICmdList))
-							 {
-								 ValidXLayers.Add(PXRLayers[PXRLayerIndex_Current]);
-							 }
-							 PXRLayerIndex_Current++;
-						 }
-						 else if (LayerIdX > LayerIdY)
-						 {
-							 DelayDeletion.AddLayerToDeferredDeletionQueue(PXRLayers_RenderThread[PXRLastLayerIndex_RenderThread++]);
-						 }
-						 else
-						 {
-							 if (PXRLayers[PXRLayerIndex_Current]->InitPXRLayer_RenderThread(GameSettings_RenderThread.Get(), RenderBridge, &DelayDeletion, RHICmdList, PXRLayers_RenderThread[PXRLastLayerIndex_RenderThread].Get()))
-							 {
-								 PXRLastLayerIndex_RenderThread++;
-								 ValidXLayers.Add(PXRLayers[PXRLayerIndex_Current]);
-							 }
-							 PXRLayerIndex_Current++;
-						 }
-					 }
+bool FPICOXRHMD::ApplyLayerChanges_RenderThread(const FPXRLayerChangeSet& Changes, FRHICommandListImmediate& RHICmdList)
+{
+	check(IsInRenderingThread());
 
-					 while (PXRLayerIndex_Current < PXRLayers.Num())
-					 {
-						 if (PXRLayers[PXRLayerIndex_Current]->InitPXRLayer_RenderThread(GameSettings_RenderThread.Get(), RenderBridge, &DelayDeletion, RHICmdList))
-						 {
-							 ValidXLayers.Add(PXRLayers[PXRLayerIndex_Current]);
-						 }
-						 PXRLayerIndex_Current++;
-					 }
+	for (uint32 LayerId : Changes.Removed)
+	{
+		const int32 Index = FindLayerIndexById(PXRLayers_RenderThread, LayerId);
+		if (Index != INDEX_NONE)
+		{
+			DelayDeletion.AddLayerToDeferredDeletionQueue(PXRLayers_RenderThread[Index]);
+			PXRLayers_RenderThread.RemoveAt(Index, 1, EAllowShrinking::No);
+		}
+	}
 
-					 while (PXRLastLayerIndex_RenderThread < PXRLayers_RenderThread.Num())
-					 {
-						 DelayDeletion.AddLayerToDeferredDeletionQueue(PXRLayers_RenderThread[PXRLastLayerIndex_RenderThread++]);
-					 }
+	for (const FPICOLayerPtr& Template : Changes.DescChanged)
+	{
+		const int32 Index = FindLayerIndexById(PXRLayers_RenderThread, Template->GetID());
+		if (Index == INDEX_NONE)
+		{
+			return false;
+		}
+
+		FPICOLayerPtr Layer = Template->CloneMyself();
+		if (Layer->InitPXRLayer_RenderThread(GameSettings_RenderThread.Get(), RenderBridge, &DelayDeletion, RHICmdList, PXRLayers_RenderThread[Index].Get()))
+		{
+			PXRLayers_RenderThread[Index] = Layer;
+		}
+		else
+		{
+			// Retried by rebuilding the list every frame until it succeeds
+			DelayDeletion.AddLayerToDeferredDeletionQueue(PXRLayers_RenderThread[Index]);
+			PXRLayers_RenderThread.RemoveAt(Index, 1, EAllowShrinking::No);
+			bLayersNeedFullSync_RenderThread = true;
+		}
+	}
 
-					 PXRLayers_RenderThread = ValidXLayers;
+	for (const FPICOLayerPtr& Template : Changes.Added)
+	{
+		const int32 Index = Algo::LowerBoundBy(PXRLayers_RenderThread, Template->GetID(), [](const FPICOLayerPtr& Layer) { return Layer->GetID(); });
+		if (Index < PXRLayers_RenderThread.Num() && PXRLayers_RenderThread[Index]->GetID() == Template->GetID())
+		{
+			return false;
+		}
 
-					 DelayDeletion.HandleLayerDeferredDeletionQueue_RenderThread();
-				 }
-			 });
-	 }
- }
+		FPICOLayerPtr Layer = Template->CloneMyself();
+		if (Layer->InitPXRLayer_RenderThread(GameSettings_RenderThread.Get(), RenderBridge, &DelayDeletion, RHICmdList))
+		{
+			PXRLayers_RenderThread.Insert(Layer, Index);
+		}
+		else
+		{
+			bLayersNeedFullSync_RenderThread = true;
+		}
+	}
+
+	for (uint32 LayerId : Changes.TextureChanged)
+	{
+		const int32 Index = FindLayerIndexById(PXRLayers_RenderThread, LayerId);
+		if (Index != INDEX_NONE)
+		{
+			PXRLayers_RenderThread[Index]->MarkTextureForUpdate();
+		}
+	}
+
+	return true;
+}
+
+void FPICOXRHMD::SyncAllLayers_RenderThread(const FPXRFrameState& FrameState, FRHICommandListImmediate& RHICmdList)
+{
+	check(IsInRenderingThread());
+
+	const TArray<FPICOLayerPtr>& PXRLayers = FrameState.Layers;
+	int32 PXRLayerIndex_Current = 0;
+	int32 PXRLastLayerIndex_RenderThread = 0;
+	TArray<FPICOLayerPtr>& ValidXLayers = PXRLayersScratch_RenderThread;
+	ValidXLayers.Reset();
+	bLayersNeedFullSync_RenderThread = false;
+
+	while (PXRLayerIndex_Current < PXRLayers.Num() && PXRLastLayerIndex_RenderThread < PXRLayers_RenderThread.Num())
+	{
+		uint32 LayerIdX = PXRLayers[PXRLayerIndex_Current]->GetID();
+		uint32 LayerIdY = PXRLayers_RenderThread[PXRLastLayerIndex_RenderThread]->GetID();
+
+		if (LayerIdX < LayerIdY)
+		{
+			FPICOLayerPtr Layer = PXRLayers[PXRLayerIndex_Current]->CloneMyself();
+			if (Layer->InitPXRLayer_RenderThread(GameSettings_RenderThread.Get(), RenderBridge, &DelayDeletion, RHICmdList))
+			{
+				ValidXLayers.Add(Layer);
+			}
+			else
+			{
+				bLayersNeedFullSync_RenderThread = true;
+			}
+			PXRLayerIndex_Current++;
+		}
+		else if (LayerIdX > LayerIdY)
+		{
+			DelayDeletion.AddLayerToDeferredDeletionQueue(PXRLayers_RenderThread[PXRLastLayerIndex_RenderThread++]);
+		}
+		else if (PXRLayers_RenderThread[PXRLastLayerIndex_RenderThread]->Generation == PXRLayers[PXRLayerIndex_Current]->Generation)
+		{
+			// Desc unchanged, the existing layer object and its swapchains are still valid
+			ValidXLayers.Add(PXRLayers_RenderThread[PXRLastLayerIndex_RenderThread++]);
+			PXRLayerIndex_Current++;
+		}
+		else
+		{
+			FPICOLayerPtr Layer = PXRLayers[PXRLayerIndex_Current]->CloneMyself();
+			if (Layer->InitPXRLayer_RenderThread(GameSettings_RenderThread.Get(), RenderBridge, &DelayDeletion, RHICmdList, PXRLayers_RenderThread[PXRLastLayerIndex_RenderThread].Get()))
+			{
+				PXRLastLayerIndex_RenderThread++;
+				ValidXLayers.Add(Layer);
+			}
+			else
+			{
+				bLayersNeedFullSync_RenderThread = true;
+			}
+			PXRLayerIndex_Current++;
+		}
+	}
+
+	while (PXRLayerIndex_Current < PXRLayers.Num())
+	{
+		FPICOLayerPtr Layer = PXRLayers[PXRLayerIndex_Current]->CloneMyself();
+		if (Layer->InitPXRLayer_RenderThread(GameSettings_RenderThread.Get(), RenderBridge, &DelayDeletion, RHICmdList))
+		{
+			ValidXLayers.Add(Layer);
+		}
+		else
+		{
+			bLayersNeedFullSync_RenderThread = true;
+		}
+		PXRLayerIndex_Current++;
+	}
+
+	while (PXRLastLayerIndex_RenderThread < PXRLayers_RenderThread.Num())
+	{
+		DelayDeletion.AddLayerToDeferredDeletionQueue(PXRLayers_RenderThread[PXRLastLayerIndex_RenderThread++]);
+	}
+
+	Swap(PXRLayers_RenderThread, ValidXLayers);
+	ValidXLayers.Reset();
+
+	for (uint32 LayerId : FrameState.Changes.TextureChanged)
+	{
+		const int32 Index = FindLayerIndexById(PXRLayers_RenderThread, LayerId);
+		if (Index != INDEX_NONE)
+		{
+			PXRLayers_RenderThread[Index]->MarkTextureForUpdate();
+		}
+	}
+}
 
 void FPICOXRHMD::OnRenderFrameEnd_RenderThread(FRDGBuilder& RDGBuilder)
 {
@@ -3308,6 +3451,7 @@ void FPICOXRHMD::OnRHIFrameBegin_RenderThread()
 					 {
 						 if (FPICOXRHMDModule::GetPluginWrapper().IsRunning())
 						 {
+							 FPXRFrameTiming::Get().Mark(GameFrame_RHIThread->FrameNumber, EPXRFrameStage::RHIBeginFrame);
 							 FPICOXRHMDModule::GetPluginWrapper().BeginFrame();
 							 if (!bWaitFrameVersion)
 							 {
@@ -3354,6 +3498,7 @@ void FPICOXRHMD::OnRHIFrameBegin_RenderThread()
 					 }
 				 }
 				 FPICOXRHMDModule::GetPluginWrapper().EndFrame();
+				 FPXRFrameTiming::Get().Mark(GameFrame_RHIThread->FrameNumber, EPXRFrameStage::RHIEndFrame);
 			 }
 			 else
 			 {
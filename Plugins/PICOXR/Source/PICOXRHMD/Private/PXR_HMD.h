@@ -18,12 +18,13 @@
 #include "HeadMountedDisplayBase.h"
 #include "SceneUtils.h"
 #include "PXR_GameFrame.h"
+#include "PXR_FrameState.h"
 #include "StereoLayerManager.h"
 #include "PXR_DelayDeleteLayer.h"
 #include "PXR_FoveatedRendering.h"
 #include "PXR_DynamicResolutionState.h"
+#include "PXR_EventBus.h"
 
-DECLARE_MULTICAST_DELEGATE_OneParam(FPICOPollEventDelegate, PxrEventDataBuffer* /*EventData*/);
 DECLARE_MULTICAST_DELEGATE(FPICOPollFutureFromHMDDelegate);
 
 class FPICOXRRenderBridge;
@@ -294,10 +295,16 @@ public:
 	FPXRGameFramePtr LastGameFrameToRender_GameThread;
 	TMap<uint32, FPICOLayerPtr> PXRLayerMap;
 	FPICOLayerPtr CurrentMRCLayer;
+	FPXRFrameStateRing FrameStateRing;
 	// Render thread
 	FSettingsPtr GameSettings_RenderThread;
 	FPXRGameFramePtr GameFrame_RenderThread;
 	TArray<FPICOLayerPtr> PXRLayers_RenderThread;
+	// Reused to build the next PXRLayers_RenderThread when rebuilding it
+	TArray<FPICOLayerPtr> PXRLayersScratch_RenderThread;
+	// Set when PXRLayers_RenderThread no longer matches the last frame state (first frame, eye layer re-creation,
+	// session shutdown, a layer that failed to initialize), so the next frame rebuilds it instead of applying changes
+	bool bLayersNeedFullSync_RenderThread = true;
 	FPICOLayerPtr PXREyeLayer_RenderThread;
 	// RHI thread
 	FSettingsPtr GameSettings_RHIThread;
@@ -347,6 +354,12 @@ public:
 		return PollEventDelegate;
 	}
 
+	// Per event type subscriptions; OnPollEventDelegate only receives the types the HMD does not handle itself
+	FPXREventBus& GetEventBus()
+	{
+		return EventBus;
+	}
+
 	PICOXRHMD_API FPICOPollFutureFromHMDDelegate& OnPollFutureDelegate()
 	{
 		return PollFutureDelegate;
@@ -365,6 +378,10 @@ public:
 protected:
 	void Recenter(PxrRecenterTypes RecenterType, float Yaw);
 	void InitEyeLayer_RenderThread(FRHICommandListImmediate& RHICmdList);
+	// Applies the layer change set to PXRLayers_RenderThread; returns false if the list has to be rebuilt instead
+	bool ApplyLayerChanges_RenderThread(const FPXRLayerChangeSet& Changes, FRHICommandListImmediate& RHICmdList);
+	// Rebuilds PXRLayers_RenderThread from all layer templates, keeping layer objects that are up to date
+	void SyncAllLayers_RenderThread(const FPXRFrameState& FrameState, FRHICommandListImmediate& RHICmdList);
 #ifdef PICO_CUSTOM_ENGINE
 	void UpdateFoveationOffsets_RenderThread();
 #endif
@@ -390,6 +407,7 @@ private:
 #endif
 
 	void ProcessEvent(int EventCount, PxrEventDataBuffer** EventData);
+	void HandleEvent(PxrEventDataBuffer* Event);
 	void ProcessControllerEvent( const PxrEventDataControllerChanged EventData);
 	void OnSeeThroughStateChange(int SeeThroughState);
 	void OnFoveationLevelChange(int32 FoveationLevel);
@@ -420,6 +438,7 @@ private:
 	bool bShutdownRequestQueued;
 
 	FPICOPollEventDelegate PollEventDelegate;
+	FPXREventBus EventBus;
 	FPICOPollFutureFromHMDDelegate PollFutureDelegate;
 };
 
@@ -9,6 +9,7 @@
 #include "PXR_HMDRuntimeSettings.h"
 #include "PXR_BoundarySystem.h"
 #include "PXR_Utils.h"
+#include "PXR_PoseCache.h"
 
 FPICOXRIPDChangedDelegate UPICOXRHMDFunctionLibrary::PICOXRIPDChangedCallback;
 FPICOXRHMD* UPICOXRHMDFunctionLibrary::PICOXRHMD = nullptr;
@@ -334,6 +335,15 @@ TArray<FVector> UPICOXRHMDFunctionLibrary::PXR_GetBoundaryGeometry(EPICOXRBounda
 	return TArray<FVector>();
 }
 
+bool UPICOXRHMDFunctionLibrary::PXR_BoundaryTestSpheres(const TArray<FVector>& Centers, float Radius, EPICOXRBoundaryType BoundaryType, TArray<FPICOXRBoundaryTestResult>& Results)
+{
+#if PLATFORM_ANDROID
+	return GetBoundarySystemInterface()->UPxr_TestSpheres(Centers, Radius, BoundaryType == EPICOXRBoundaryType::PlayArea, Results);
+#endif
+	Results.Reset();
+	return false;
+}
+
 FVector UPICOXRHMDFunctionLibrary::PXR_GetBoundaryDimensions(EPICOXRBoundaryType BoundaryType)
 {
 #if PLATFORM_ANDROID
@@ -498,9 +508,9 @@ void UPICOXRHMDFunctionLibrary::PXR_GetPredictedMainSensorState(FPxrSensorState&
 	if (FPICOXRVersionHelper::IsThisVersionOrGreater(0x2000201))
 	{
         double predictTimeMs = 0.0;
-        FPICOXRHMDModule::GetPluginWrapper().GetPredictedDisplayTime(&predictTimeMs);
+        FPXRPoseCache::Get().GetPredictedDisplayTime(&predictTimeMs);
         PxrSensorState2 sensorState2;
-        FPICOXRHMDModule::GetPluginWrapper().GetPredictedMainSensorState2(predictTimeMs, &sensorState2, &sensorFrameIndex);
+        FPXRPoseCache::Get().GetPredictedMainSensorState2(predictTimeMs, &sensorState2, &sensorFrameIndex);
         sensorState.status = sensorState2.status;
         sensorState.poseQuat.X = sensorState2.pose.orientation.x;
         sensorState.poseQuat.Y = sensorState2.pose.orientation.y;
@@ -675,7 +685,7 @@ float UPICOXRHMDFunctionLibrary::PXR_GetToDeltaSensorY()
 float UPICOXRHMDFunctionLibrary::PXR_GetPredictedDisplayTime()
 {
     double PredictTimeMs = 0.0f;
-    FPICOXRHMDModule::GetPluginWrapper().GetPredictedDisplayTime(&PredictTimeMs);
+    FPXRPoseCache::Get().GetPredictedDisplayTime(&PredictTimeMs);
     return PredictTimeMs;
 }
 
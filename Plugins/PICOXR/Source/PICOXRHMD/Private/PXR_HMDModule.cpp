@@ -11,6 +11,7 @@
 #include "Misc/Paths.h"
 #include "Engine/RendererSettings.h"
 #include "PXR_StereoLayersFlagsSupplier.h"
+#include "PXR_PluginTrace.h"
 
 #if WITH_EDITOR
 #include "PropertyEditorModule.h"
@@ -89,6 +90,7 @@ void FPICOXRHMDModule::ShutdownModule()
 #if PICO_HMD_SUPPORTED_PLATFORMS
 	if (PluginWrapper.Initialized)
 	{
+		FPXRPluginTrace::Stop(PluginWrapper);
 		DestroyPICOPluginWrapper(&PluginWrapper);
 	}
 
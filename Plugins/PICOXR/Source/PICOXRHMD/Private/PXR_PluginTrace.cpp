@@ -0,0 +1,694 @@
+// Copyright PICO Technology Co., Ltd. All rights reserved.
+// This plugin incorporates portions of the Unreal® Engine. Unreal® is a trademark or registered trademark of Epic Games, Inc. in the United States of America and elsewhere.
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "PXR_PluginTrace.h"
+
+#if PICO_HMD_SUPPORTED_PLATFORMS
+#include "PXR_HMDModule.h"
+#include "PXR_FrameTiming.h"
+#include "HAL/PlatformFileManager.h"
+#include "GenericPlatform/GenericPlatformFile.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/ScopeLock.h"
+#include "Misc/Crc.h"
+
+#define PICO_TRACED_ENTRY_POINTS(Op) \
+	Op(WaitFrame) \
+	Op(GetPredictedDisplayTime) \
+	Op(GetPredictedMainSensorState2) \
+	Op(PollEvent) \
+	Op(GetControllerConnectStatus) \
+	Op(GetControllerTrackingState) \
+	Op(GetControllerInputState) \
+	Op(GetHandTrackerJointLocations) \
+	Op(GetHandTrackerAimState) \
+	Op(GetEyeTrackingData1) \
+	Op(GetFaceTrackingData1) \
+	Op(GetBodyTrackingData) \
+	Op(GetMotionTrackerLocations)
+
+// Unity builds share this translation unit with the rest of the module, hence the named namespace
+namespace PXRPluginTrace
+{
+	// "PXRT"
+	constexpr uint32 TraceMagic = 0x54525850;
+	constexpr uint32 TraceVersion = 1;
+	// Recorded calls are written out from the WaitFrame shim, which already blocks, once this much is buffered
+	constexpr int32 FlushThresholdBytes = 256 * 1024;
+
+	enum class ECall : uint8
+	{
+#define PICO_TRACE_CALL_ID(Func) Func,
+		PICO_TRACED_ENTRY_POINTS(PICO_TRACE_CALL_ID)
+#undef PICO_TRACE_CALL_ID
+		Count
+	};
+
+	// Every record is a header followed by PayloadSize bytes of result and output structs
+	struct FRecordHeader
+	{
+		uint8 Call;
+		uint32 Key;
+		double Time;
+		uint32 PayloadSize;
+	};
+
+	enum class EMode : uint8
+	{
+		None,
+		Record,
+		Replay
+	};
+
+	EMode Mode = EMode::None;
+	// Runtime entry points, restored on Stop
+	PICOPluginWrapper Runtime;
+	FCriticalSection TraceLock;
+
+	// Recording
+	TUniquePtr<IFileHandle> RecordFile;
+	TArray<uint8> RecordBuffer;
+	double RecordStartTime = 0.0;
+
+	// Replay
+	struct FReplayStream
+	{
+		// Offsets of the record headers in ReplayData
+		TArray<int32> Records;
+		int32 Cursor = 0;
+	};
+	TArray<uint8> ReplayData;
+	TMap<uint64, FReplayStream> ReplayStreams;
+	float ReplaySpeed = 1.0f;
+	double ReplayLastFrameTime = 0.0;
+	double ReplayLastFrameWallTime = 0.0;
+	// Frame timing clock while replaying: trace time of the current frame, kept increasing across loops
+	std::atomic<double> ReplayClockFrameTime{ 0.0 };
+	std::atomic<double> ReplayClockFrameWallTime{ 0.0 };
+	// PollEvent hands out pointers that stay valid until the next poll
+	TArray<PxrEventDataBuffer> ReplayEvents;
+	uint64 ReplayCallCounts[(int32)ECall::Count] = {};
+
+	uint64 MakeStreamKey(ECall Call, uint32 Key)
+	{
+		return ((uint64)Call << 32) | Key;
+	}
+
+	uint32 MakeTrackerKey(const char* TrackerSN)
+	{
+		return TrackerSN ? FCrc::MemCrc32(TrackerSN, FCStringAnsi::Strlen(TrackerSN)) : 0;
+	}
+
+	void FlushRecording()
+	{
+		if (RecordFile && RecordBuffer.Num() > 0)
+		{
+			RecordFile->Write(RecordBuffer.GetData(), RecordBuffer.Num());
+			RecordBuffer.Reset();
+		}
+	}
+
+	// Builds one record on the stack and appends it to the trace buffer in Commit
+	class FRecordWriter
+	{
+	public:
+		FRecordWriter(ECall InCall, uint32 InKey)
+		{
+			// The header is written out raw, padding included
+			FMemory::Memzero(&Header, sizeof(Header));
+			Header.Call = (uint8)InCall;
+			Header.Key = InKey;
+			Header.Time = FPlatformTime::Seconds() - RecordStartTime;
+			Header.PayloadSize = 0;
+		}
+
+		template<typename T>
+		FRecordWriter& operator<<(const T& Value)
+		{
+			static_assert(TIsTriviallyCopyable<T>::Value, "Trace payloads are copied byte-wise");
+			return Write(&Value, sizeof(T));
+		}
+
+		FRecordWriter& Write(const void* Data, int32 Size)
+		{
+			Payload.Append((const uint8*)Data, Size);
+			return *this;
+		}
+
+		void Commit()
+		{
+			Header.PayloadSize = Payload.Num();
+			FScopeLock Lock(&TraceLock);
+			if (Mode != EMode::Record)
+			{
+				return;
+			}
+			RecordBuffer.Append((const uint8*)&Header, sizeof(Header));
+			RecordBuffer.Append(Payload);
+		}
+
+	private:
+		FRecordHeader Header;
+		TArray<uint8, TInlineAllocator<1024>> Payload;
+	};
+
+	// Reads the next recorded call of one stream; invalid when the trace has no record for it.
+	// The payload is copied out under the lock, as Stop may release the trace while a shim is still reading.
+	class FRecordReader
+	{
+	public:
+		FRecordReader(ECall InCall, uint32 InKey)
+		{
+			FScopeLock Lock(&TraceLock);
+			if (Mode != EMode::Replay)
+			{
+				return;
+			}
+			ReplayCallCounts[(int32)InCall]++;
+			FReplayStream* Stream = ReplayStreams.Find(MakeStreamKey(InCall, InKey));
+			if (Stream && Stream->Records.Num() > 0)
+			{
+				const int32 Offset = Stream->Records[Stream->Cursor];
+				Stream->Cursor = (Stream->Cursor + 1) % Stream->Records.Num();
+				FMemory::Memcpy(&Header, ReplayData.GetData() + Offset, sizeof(Header));
+				Payload.Append(ReplayData.GetData() + Offset + sizeof(Header), Header.PayloadSize);
+				bValid = true;
+			}
+		}
+
+		explicit operator bool() const
+		{
+			return bValid;
+		}
+
+		template<typename T>
+		FRecordReader& operator>>(T& Value)
+		{
+			static_assert(TIsTriviallyCopyable<T>::Value, "Trace payloads are copied byte-wise");
+			return Read(&Value, sizeof(T));
+		}
+
+		FRecordReader& Read(void* Out, int32 Size)
+		{
+			if (bValid && Pos + Size <= Payload.Num())
+			{
+				FMemory::Memcpy(Out, Payload.GetData() + Pos, Size);
+				Pos += Size;
+			}
+			return *this;
+		}
+
+		double GetTime() const
+		{
+			return Header.Time;
+		}
+
+	private:
+		FRecordHeader Header = {};
+		TArray<uint8, TInlineAllocator<1024>> Payload;
+		bool bValid = false;
+		int32 Pos = 0;
+	};
+
+	//----------------Record-------
+	int Record_WaitFrame()
+	{
+		const int Result = Runtime.WaitFrame();
+		FRecordWriter Record(ECall::WaitFrame, 0);
+		Record << Result;
+		Record.Commit();
+
+		FScopeLock Lock(&TraceLock);
+		if (RecordBuffer.Num() >= FlushThresholdBytes)
+		{
+			FlushRecording();
+		}
+		return Result;
+	}
+
+	int Record_GetPredictedDisplayTime(double* predictedDisplayTimeMs)
+	{
+		const int Result = Runtime.GetPredictedDisplayTime(predictedDisplayTimeMs);
+		FRecordWriter Record(ECall::GetPredictedDisplayTime, 0);
+		Record << Result << *predictedDisplayTimeMs;
+		Record.Commit();
+		return Result;
+	}
+
+	int Record_GetPredictedMainSensorState2(double predictTimeMs, PxrSensorState2* sensorState, int* sensorFrameIndex)
+	{
+		const int Result = Runtime.GetPredictedMainSensorState2(predictTimeMs, sensorState, sensorFrameIndex);
+		FRecordWriter Record(ECall::GetPredictedMainSensorState2, 0);
+		Record << Result << *sensorState << *sensorFrameIndex;
+		Record.Commit();
+		return Result;
+	}
+
+	bool Record_PollEvent(int eventCountMAX, int* eventDataCountOutput, PxrEventDataBuffer** eventDataPtr)
+	{
+		const bool Result = Runtime.PollEvent(eventCountMAX, eventDataCountOutput, eventDataPtr);
+		const int32 EventCount = Result ? FMath::Clamp(*eventDataCountOutput, 0, eventCountMAX) : 0;
+		FRecordWriter Record(ECall::PollEvent, 0);
+		Record << Result << EventCount;
+		for (int32 Index = 0; Index < EventCount; Index++)
+		{
+			Record << *eventDataPtr[Index];
+		}
+		Record.Commit();
+		return Result;
+	}
+
+	int Record_GetControllerConnectStatus(uint32_t deviceID)
+	{
+		const int Result = Runtime.GetControllerConnectStatus(deviceID);
+		FRecordWriter Record(ECall::GetControllerConnectStatus, deviceID);
+		Record << Result;
+		Record.Commit();
+		return Result;
+	}
+
+	int Record_GetControllerTrackingState(uint32_t deviceID, double predictTime, float headSensorData[], PxrControllerTracking* tracking)
+	{
+		const int Result = Runtime.GetControllerTrackingState(deviceID, predictTime, headSensorData, tracking);
+		FRecordWriter Record(ECall::GetControllerTrackingState, deviceID);
+		Record << Result << *tracking;
+		Record.Commit();
+		return Result;
+	}
+
+	int Record_GetControllerInputState(uint32_t deviceID, PxrControllerInputState* state)
+	{
+		const int Result = Runtime.GetControllerInputState(deviceID, state);
+		FRecordWriter Record(ECall::GetControllerInputState, deviceID);
+		Record << Result << *state;
+		Record.Commit();
+		return Result;
+	}
+
+	int Record_GetHandTrackerJointLocations(int hand, PxrHandJointsLocations* JointsLocations)
+	{
+		const int Result = Runtime.GetHandTrackerJointLocations(hand, JointsLocations);
+		FRecordWriter Record(ECall::GetHandTrackerJointLocations, hand);
+		Record << Result << *JointsLocations;
+		Record.Commit();
+		return Result;
+	}
+
+	int Record_GetHandTrackerAimState(int hand, PxrHandAimState* aimstate)
+	{
+		const int Result = Runtime.GetHandTrackerAimState(hand, aimstate);
+		FRecordWriter Record(ECall::GetHandTrackerAimState, hand);
+		Record << Result << *aimstate;
+		Record.Commit();
+		return Result;
+	}
+
+	int Record_GetEyeTrackingData1(const PxrEyeTrackingDataGetInfo* getInfo, PxrEyeTrackingData1* data)
+	{
+		const int Result = Runtime.GetEyeTrackingData1(getInfo, data);
+		FRecordWriter Record(ECall::GetEyeTrackingData1, 0);
+		Record << Result << *data;
+		Record.Commit();
+		return Result;
+	}
+
+	int Record_GetFaceTrackingData1(const PxrFaceTrackingDataGetInfo* getInfo, PxrFaceTrackingData* data)
+	{
+		const int Result = Runtime.GetFaceTrackingData1(getInfo, data);
+		// The blend shape weights live in a caller-owned buffer, the pointer itself is not recorded
+		FRecordWriter Record(ECall::GetFaceTrackingData1, 0);
+		Record << Result << data->timestamp << data->laughingProb << data->eyeValid << data->faceValid;
+		Record.Write(data->blendShapeWeight, BLEND_SHAPE_NUMS * sizeof(float));
+		Record.Commit();
+		return Result;
+	}
+
+	int Record_GetBodyTrackingData(const PxrBodyTrackingGetDataInfo* Info, PxrBodyTrackingData* Data)
+	{
+		const int Result = Runtime.GetBodyTrackingData(Info, Data);
+		FRecordWriter Record(ECall::GetBodyTrackingData, 0);
+		Record << Result << *Data;
+		Record.Commit();
+		return Result;
+	}
+
+	int Record_GetMotionTrackerLocations(double predictTime, char* trackerSN, PxrMotionTrackerLocations* locations)
+	{
+		const int Result = Runtime.GetMotionTrackerLocations(predictTime, trackerSN, locations);
+		FRecordWriter Record(ECall::GetMotionTrackerLocations, MakeTrackerKey(trackerSN));
+		Record << Result << *locations;
+		Record.Commit();
+		return Result;
+	}
+	//----------------Record-------
+
+	//----------------Replay-------
+	// Calls with no recorded data fail the same way the runtime does when it is not running
+	constexpr int ReplayMissing = -1;
+
+	int Replay_WaitFrame()
+	{
+		int Result = 0;
+		FRecordReader Record(ECall::WaitFrame, 0);
+		Record >> Result;
+		if (!Record)
+		{
+			return ReplayMissing;
+		}
+
+		// Keep the recorded frame intervals, scaled by the replay speed; looping back to the start resets the pacing
+		const double Now = FPlatformTime::Seconds();
+		const double RecordedDelta = Record.GetTime() - ReplayLastFrameTime;
+		if (ReplaySpeed > 0.0f && ReplayLastFrameWallTime > 0.0 && RecordedDelta > 0.0)
+		{
+			const double Remaining = RecordedDelta / ReplaySpeed - (Now - ReplayLastFrameWallTime);
+			if (Remaining > 0.0)
+			{
+				FPlatformProcess::Sleep((float)Remaining);
+			}
+		}
+		ReplayLastFrameTime = Record.GetTime();
+		ReplayLastFrameWallTime = FPlatformTime::Seconds();
+		ReplayClockFrameTime.store(ReplayClockFrameTime.load() + FMath::Max(RecordedDelta, 0.0));
+		ReplayClockFrameWallTime.store(ReplayLastFrameWallTime);
+		return Result;
+	}
+
+	// Within a frame the trace time advances with the wall clock scaled by the replay speed. Unpaced replay stays on
+	// the frame time, so the frame intervals seen by FPXRFrameTiming are exactly the recorded ones.
+	double ReplayClock()
+	{
+		const double FrameTime = ReplayClockFrameTime.load();
+		return ReplaySpeed > 0.0f ? FrameTime + (FPlatformTime::Seconds() - ReplayClockFrameWallTime.load()) * ReplaySpeed : FrameTime;
+	}
+
+	int Replay_GetPredictedDisplayTime(double* predictedDisplayTimeMs)
+	{
+		int Result = ReplayMissing;
+		FRecordReader(ECall::GetPredictedDisplayTime, 0) >> Result >> *predictedDisplayTimeMs;
+		return Result;
+	}
+
+	int Replay_GetPredictedMainSensorState2(double predictTimeMs, PxrSensorState2* sensorState, int* sensorFrameIndex)
+	{
+		int Result = ReplayMissing;
+		FRecordReader(ECall::GetPredictedMainSensorState2, 0) >> Result >> *sensorState >> *sensorFrameIndex;
+		return Result;
+	}
+
+	bool Replay_PollEvent(int eventCountMAX, int* eventDataCountOutput, PxrEventDataBuffer** eventDataPtr)
+	{
+		bool Result = false;
+		int32 EventCount = 0;
+		FRecordReader Record(ECall::PollEvent, 0);
+		Record >> Result >> EventCount;
+
+		EventCount = FMath::Min(EventCount, eventCountMAX);
+		ReplayEvents.SetNumUninitialized(EventCount, EAllowShrinking::No);
+		for (int32 Index = 0; Index < EventCount; Index++)
+		{
+			Record >> ReplayEvents[Index];
+			eventDataPtr[Index] = &ReplayEvents[Index];
+		}
+		*eventDataCountOutput = EventCount;
+		return Result;
+	}
+
+	int Replay_GetControllerConnectStatus(uint32_t deviceID)
+	{
+		int Result = 0;
+		FRecordReader(ECall::GetControllerConnectStatus, deviceID) >> Result;
+		return Result;
+	}
+
+	int Replay_GetControllerTrackingState(uint32_t deviceID, double predictTime, float headSensorData[], PxrControllerTracking* tracking)
+	{
+		int Result = ReplayMissing;
+		FRecordReader(ECall::GetControllerTrackingState, deviceID) >> Result >> *tracking;
+		return Result;
+	}
+
+	int Replay_GetControllerInputState(uint32_t deviceID, PxrControllerInputState* state)
+	{
+		int Result = ReplayMissing;
+		FRecordReader(ECall::GetControllerInputState, deviceID) >> Result >> *state;
+		return Result;
+	}
+
+	int Replay_GetHandTrackerJointLocations(int hand, PxrHandJointsLocations* JointsLocations)
+	{
+		int Result = ReplayMissing;
+		FRecordReader(ECall::GetHandTrackerJointLocations, hand) >> Result >> *JointsLocations;
+		return Result;
+	}
+
+	int Replay_GetHandTrackerAimState(int hand, PxrHandAimState* aimstate)
+	{
+		int Result = ReplayMissing;
+		FRecordReader(ECall::GetHandTrackerAimState, hand) >> Result >> *aimstate;
+		return Result;
+	}
+
+	int Replay_GetEyeTrackingData1(const PxrEyeTrackingDataGetInfo* getInfo, PxrEyeTrackingData1* data)
+	{
+		int Result = ReplayMissing;
+		FRecordReader(ECall::GetEyeTrackingData1, 0) >> Result >> *data;
+		return Result;
+	}
+
+	int Replay_GetFaceTrackingData1(const PxrFaceTrackingDataGetInfo* getInfo, PxrFaceTrackingData* data)
+	{
+		int Result = ReplayMissing;
+		FRecordReader Record(ECall::GetFaceTrackingData1, 0);
+		Record >> Result >> data->timestamp >> data->laughingProb >> data->eyeValid >> data->faceValid;
+		Record.Read(data->blendShapeWeight, BLEND_SHAPE_NUMS * sizeof(float));
+		return Result;
+	}
+
+	int Replay_GetBodyTrackingData(const PxrBodyTrackingGetDataInfo* Info, PxrBodyTrackingData* Data)
+	{
+		int Result = ReplayMissing;
+		FRecordReader(ECall::GetBodyTrackingData, 0) >> Result >> *Data;
+		return Result;
+	}
+
+	int Replay_GetMotionTrackerLocations(double predictTime, char* trackerSN, PxrMotionTrackerLocations* locations)
+	{
+		int Result = ReplayMissing;
+		FRecordReader(ECall::GetMotionTrackerLocations, MakeTrackerKey(trackerSN)) >> Result >> *locations;
+		return Result;
+	}
+	//----------------Replay-------
+
+	void RestoreRuntimeEntryPoints(PICOPluginWrapper& Wrapper)
+	{
+#define PICO_TRACE_RESTORE(Func) Wrapper.Func = Runtime.Func;
+		PICO_TRACED_ENTRY_POINTS(PICO_TRACE_RESTORE)
+#undef PICO_TRACE_RESTORE
+	}
+
+	// Indexes the records of a loaded trace by stream; false if the data is not a complete trace
+	bool IndexReplayData()
+	{
+		ReplayStreams.Reset();
+		if (ReplayData.Num() < (int32)(2 * sizeof(uint32)))
+		{
+			return false;
+		}
+
+		uint32 Magic = 0;
+		uint32 Version = 0;
+		FMemory::Memcpy(&Magic, ReplayData.GetData(), sizeof(uint32));
+		FMemory::Memcpy(&Version, ReplayData.GetData() + sizeof(uint32), sizeof(uint32));
+		if (Magic != TraceMagic || Version != TraceVersion)
+		{
+			return false;
+		}
+
+		int32 Offset = 2 * sizeof(uint32);
+		while (Offset + (int32)sizeof(FRecordHeader) <= ReplayData.Num())
+		{
+			FRecordHeader Header;
+			FMemory::Memcpy(&Header, ReplayData.GetData() + Offset, sizeof(Header));
+			const int64 End = (int64)Offset + sizeof(Header) + Header.PayloadSize;
+			if (Header.Call >= (uint8)ECall::Count || End > ReplayData.Num())
+			{
+				// A trace cut short by a crash still replays up to the last complete record
+				break;
+			}
+			ReplayStreams.FindOrAdd(MakeStreamKey((ECall)Header.Call, Header.Key)).Records.Add(Offset);
+			Offset = (int32)End;
+		}
+		return ReplayStreams.Num() > 0;
+	}
+}
+
+bool FPXRPluginTrace::StartRecording(PICOPluginWrapper& Wrapper, const FString& Path)
+{
+	using namespace PXRPluginTrace;
+
+	check(IsInGameThread());
+	if (!Wrapper.Initialized || Mode != EMode::None)
+	{
+		UE_LOG(LogPICOPluginWrapper, Warning, TEXT("Trace recording not started: %s"), Mode != EMode::None ? TEXT("a trace is already active") : TEXT("wrapper not initialized"));
+		return false;
+	}
+
+	RecordFile.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenWrite(*Path));
+	if (!RecordFile)
+	{
+		UE_LOG(LogPICOPluginWrapper, Error, TEXT("Unable to open trace file %s"), *Path);
+		return false;
+	}
+
+	const uint32 FileHeader[] = { TraceMagic, TraceVersion };
+	RecordFile->Write((const uint8*)FileHeader, sizeof(FileHeader));
+	RecordBuffer.Reset(FlushThresholdBytes * 2);
+	RecordStartTime = FPlatformTime::Seconds();
+
+	{
+		FScopeLock Lock(&TraceLock);
+		Mode = EMode::Record;
+	}
+	Runtime = Wrapper;
+#define PICO_TRACE_INSTALL_RECORD(Func) Wrapper.Func = &Record_##Func;
+	PICO_TRACED_ENTRY_POINTS(PICO_TRACE_INSTALL_RECORD)
+#undef PICO_TRACE_INSTALL_RECORD
+
+	UE_LOG(LogPICOPluginWrapper, Log, TEXT("Recording trace to %s"), *Path);
+	return true;
+}
+
+bool FPXRPluginTrace::StartReplay(PICOPluginWrapper& Wrapper, const FString& Path, float Speed)
+{
+	using namespace PXRPluginTrace;
+
+	check(IsInGameThread());
+	if (Mode != EMode::None)
+	{
+		UE_LOG(LogPICOPluginWrapper, Warning, TEXT("Trace replay not started: a trace is already active"));
+		return false;
+	}
+
+	if (!FFileHelper::LoadFileToArray(ReplayData, *Path) || !IndexReplayData())
+	{
+		UE_LOG(LogPICOPluginWrapper, Error, TEXT("Unable to load trace file %s"), *Path);
+		ReplayData.Empty();
+		ReplayStreams.Empty();
+		return false;
+	}
+
+	ReplaySpeed = FMath::Max(Speed, 0.0f);
+	ReplayLastFrameTime = 0.0;
+	ReplayLastFrameWallTime = 0.0;
+	ReplayClockFrameTime.store(0.0);
+	ReplayClockFrameWallTime.store(FPlatformTime::Seconds());
+
+	{
+		FScopeLock Lock(&TraceLock);
+		FMemory::Memzero(ReplayCallCounts);
+		Mode = EMode::Replay;
+	}
+	Runtime = Wrapper;
+#define PICO_TRACE_INSTALL_REPLAY(Func) Wrapper.Func = &Replay_##Func;
+	PICO_TRACED_ENTRY_POINTS(PICO_TRACE_INSTALL_REPLAY)
+#undef PICO_TRACE_INSTALL_REPLAY
+	FPXRFrameTiming::Get().SetClock(&ReplayClock);
+
+	UE_LOG(LogPICOPluginWrapper, Log, TEXT("Replaying trace %s (%d streams) at speed %.2f"), *Path, ReplayStreams.Num(), ReplaySpeed);
+	return true;
+}
+
+void FPXRPluginTrace::Stop(PICOPluginWrapper& Wrapper)
+{
+	using namespace PXRPluginTrace;
+
+	check(IsInGameThread());
+	if (Mode == EMode::None)
+	{
+		return;
+	}
+
+	RestoreRuntimeEntryPoints(Wrapper);
+	// Shims already running on another thread only touch the trace under the lock (readers copy their record out),
+	// so it can be released here; they see Mode None afterwards
+	FScopeLock Lock(&TraceLock);
+	if (Mode == EMode::Record)
+	{
+		FlushRecording();
+		RecordFile.Reset();
+		RecordBuffer.Empty();
+		UE_LOG(LogPICOPluginWrapper, Log, TEXT("Trace recording stopped"));
+	}
+	else
+	{
+		FPXRFrameTiming::Get().SetClock(nullptr);
+		ReplayStreams.Empty();
+		ReplayData.Empty();
+		UE_LOG(LogPICOPluginWrapper, Log, TEXT("Trace replay stopped"));
+	}
+	Mode = EMode::None;
+}
+
+bool FPXRPluginTrace::IsRecording()
+{
+	return PXRPluginTrace::Mode == PXRPluginTrace::EMode::Record;
+}
+
+bool FPXRPluginTrace::IsReplaying()
+{
+	return PXRPluginTrace::Mode == PXRPluginTrace::EMode::Replay;
+}
+
+void FPXRPluginTrace::GetReplayCallCounts(TArray<TPair<FString, uint64>>& OutCounts)
+{
+	using namespace PXRPluginTrace;
+
+	static const TCHAR* const CallNames[] =
+	{
+#define PICO_TRACE_CALL_NAME(Func) TEXT(#Func),
+		PICO_TRACED_ENTRY_POINTS(PICO_TRACE_CALL_NAME)
+#undef PICO_TRACE_CALL_NAME
+	};
+
+	FScopeLock Lock(&TraceLock);
+	OutCounts.Reset((int32)ECall::Count);
+	for (int32 Index = 0; Index < (int32)ECall::Count; Index++)
+	{
+		OutCounts.Emplace(CallNames[Index], ReplayCallCounts[Index]);
+	}
+}
+
+static FAutoConsoleCommand CPICOTraceRecord(
+	TEXT("pico.Trace.Record"),
+	TEXT("Records the PICO runtime queries to a binary trace.\n")
+	TEXT("Usage: pico.Trace.Record <File>"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+		{
+			const FString Path = Args.Num() > 0 ? Args[0] : FPaths::ProjectSavedDir() / TEXT("PICOTrace.pxrt");
+			FPXRPluginTrace::StartRecording(FPICOXRHMDModule::GetPluginWrapper(), Path);
+		}));
+
+static FAutoConsoleCommand CPICOTraceReplay(
+	TEXT("pico.Trace.Replay"),
+	TEXT("Replays a trace recorded with pico.Trace.Record in place of the PICO runtime queries.\n")
+	TEXT("Usage: pico.Trace.Replay <File> [Speed], Speed 0 replays without frame pacing (default 1)"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+		{
+			const FString Path = Args.Num() > 0 ? Args[0] : FPaths::ProjectSavedDir() / TEXT("PICOTrace.pxrt");
+			const float Speed = Args.Num() > 1 ? FCString::Atof(*Args[1]) : 1.0f;
+			FPXRPluginTrace::StartReplay(FPICOXRHMDModule::GetPluginWrapper(), Path, Speed);
+		}));
+
+static FAutoConsoleCommand CPICOTraceStop(
+	TEXT("pico.Trace.Stop"),
+	TEXT("Stops trace recording or replay and restores the PICO runtime entry points."),
+	FConsoleCommandDelegate::CreateLambda([]()
+		{
+			FPXRPluginTrace::Stop(FPICOXRHMDModule::GetPluginWrapper());
+		}));
+
+#undef PICO_TRACED_ENTRY_POINTS
+#endif //PICO_HMD_SUPPORTED_PLATFORMS
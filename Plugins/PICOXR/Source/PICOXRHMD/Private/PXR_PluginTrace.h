@@ -0,0 +1,40 @@
+// Copyright PICO Technology Co., Ltd. All rights reserved.
+// This plugin incorporates portions of the Unreal® Engine. Unreal® is a trademark or registered trademark of Epic Games, Inc. in the United States of America and elsewhere.
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+#include "CoreMinimal.h"
+#include "IPXR_HMDModule.h"
+
+#if PICO_HMD_SUPPORTED_PLATFORMS
+#include "PXR_PluginWrapper.h"
+
+// Record/replay of the per-frame runtime queries in PICOPluginWrapper.
+//
+// Recording swaps the traced entry points for shims that forward to the runtime and append the call key, result and
+// output structs to a binary trace. Replay swaps them for shims that return the recorded results in order, one
+// stream per entry point and key (controller, hand, tracker), looping at the end of the trace. WaitFrame is paced by
+// the recorded frame intervals divided by the replay speed; a speed of 0 replays as fast as the caller runs.
+// Entry points that are not traced stay bound to the runtime. While replaying, FPXRFrameTiming runs on the trace time.
+//
+// Traced: WaitFrame, GetPredictedDisplayTime, GetPredictedMainSensorState2, PollEvent, GetControllerConnectStatus,
+// GetControllerTrackingState, GetControllerInputState, GetHandTrackerJointLocations, GetHandTrackerAimState,
+// GetEyeTrackingData1, GetFaceTrackingData1, GetBodyTrackingData, GetMotionTrackerLocations.
+//
+// Console: pico.Trace.Record <File>, pico.Trace.Replay <File> [Speed], pico.Trace.Stop
+// Commandlet: -run=PXRTraceBenchmark, see UPXRTraceBenchmarkCommandlet
+class FPXRPluginTrace
+{
+public:
+	static bool StartRecording(PICOPluginWrapper& Wrapper, const FString& Path);
+	static bool StartReplay(PICOPluginWrapper& Wrapper, const FString& Path, float Speed);
+	// Restores the runtime entry points and, when recording, writes out the rest of the trace
+	static void Stop(PICOPluginWrapper& Wrapper);
+
+	static bool IsRecording();
+	static bool IsReplaying();
+
+	// Calls served by the replay shims since StartReplay, by traced entry point name
+	static void GetReplayCallCounts(TArray<TPair<FString, uint64>>& OutCounts);
+};
+#endif //PICO_HMD_SUPPORTED_PLATFORMS
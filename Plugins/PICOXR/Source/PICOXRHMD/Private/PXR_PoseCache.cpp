@@ -0,0 +1,64 @@
+// Copyright PICO Technology Co., Ltd. All rights reserved.
+// This plugin incorporates portions of the Unreal® Engine. Unreal® is a trademark or registered trademark of Epic Games, Inc. in the United States of America and elsewhere.
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "PXR_PoseCache.h"
+#include "PXR_HMDModule.h"
+
+FPXRPoseCache& FPXRPoseCache::Get()
+{
+	static FPXRPoseCache Instance;
+	return Instance;
+}
+
+int FPXRPoseCache::GetPredictedDisplayTime(double* OutPredictedDisplayTimeMs)
+{
+#if PICO_HMD_SUPPORTED_PLATFORMS
+	if (!IsInGameThread())
+	{
+		return FPICOXRHMDModule::GetPluginWrapper().GetPredictedDisplayTime(OutPredictedDisplayTimeMs);
+	}
+
+	if (DisplayTimeFrame != GFrameCounter)
+	{
+		DisplayTimeFrame = GFrameCounter;
+		double TimeMs = 0.0;
+		DisplayTimeResult = FPICOXRHMDModule::GetPluginWrapper().GetPredictedDisplayTime(&TimeMs);
+		if (DisplayTimeResult == 0 && TimeMs != DisplayTimeMs)
+		{
+			DisplayTimeMs = TimeMs;
+			Epoch++;
+		}
+	}
+
+	*OutPredictedDisplayTimeMs = DisplayTimeMs;
+	return DisplayTimeResult;
+#else
+	return -1;
+#endif
+}
+
+int FPXRPoseCache::GetPredictedMainSensorState2(double PredictTimeMs, PxrSensorState2* OutSensorState, int* OutSensorFrameIndex)
+{
+#if PICO_HMD_SUPPORTED_PLATFORMS
+	if (!IsInGameThread())
+	{
+		return FPICOXRHMDModule::GetPluginWrapper().GetPredictedMainSensorState2(PredictTimeMs, OutSensorState, OutSensorFrameIndex);
+	}
+
+	// The same prediction time can come back across frames while the runtime is paused, so the frame is part of the key
+	if (!bSensorStateValid || SensorStateTimeMs != PredictTimeMs || SensorStateFrame != GFrameCounter)
+	{
+		SensorStateResult = FPICOXRHMDModule::GetPluginWrapper().GetPredictedMainSensorState2(PredictTimeMs, &SensorState, &SensorFrameIndex);
+		SensorStateTimeMs = PredictTimeMs;
+		SensorStateFrame = GFrameCounter;
+		bSensorStateValid = true;
+	}
+
+	*OutSensorState = SensorState;
+	*OutSensorFrameIndex = SensorFrameIndex;
+	return SensorStateResult;
+#else
+	return -1;
+#endif
+}
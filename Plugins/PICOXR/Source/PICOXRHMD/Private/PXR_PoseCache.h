@@ -0,0 +1,41 @@
+// Copyright PICO Technology Co., Ltd. All rights reserved.
+// This plugin incorporates portions of the Unreal® Engine. Unreal® is a trademark or registered trademark of Epic Games, Inc. in the United States of America and elsewhere.
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+#include "CoreMinimal.h"
+#include "PXR_Plugin_Types.h"
+
+// Per frame cache of the runtime prediction queries, for the game thread readers in the HMD, input, motion tracking
+// and MR modules.
+// The predicted display time is fetched from the runtime once per game frame, and the sensor state once per predicted
+// display time, so every reader in a frame sees the same prediction and only the first one crosses into the runtime.
+// The methods mirror the PICOPluginWrapper entry points and return the runtime result code; called off the game
+// thread they go straight to the runtime. Readers that keep their own converted results can compare GetEpoch, which
+// changes whenever the predicted display time does.
+class PICOXRHMD_API FPXRPoseCache
+{
+public:
+	static FPXRPoseCache& Get();
+
+	int GetPredictedDisplayTime(double* OutPredictedDisplayTimeMs);
+	int GetPredictedMainSensorState2(double PredictTimeMs, PxrSensorState2* OutSensorState, int* OutSensorFrameIndex);
+
+	uint64 GetEpoch() const
+	{
+		return Epoch;
+	}
+
+private:
+	uint64 DisplayTimeFrame = MAX_uint64;
+	double DisplayTimeMs = 0.0;
+	int DisplayTimeResult = -1;
+	uint64 Epoch = 0;
+
+	bool bSensorStateValid = false;
+	double SensorStateTimeMs = 0.0;
+	uint64 SensorStateFrame = MAX_uint64;
+	PxrSensorState2 SensorState = {};
+	int SensorFrameIndex = 0;
+	int SensorStateResult = -1;
+};
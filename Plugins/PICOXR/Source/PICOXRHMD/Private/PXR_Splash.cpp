@@ -20,10 +20,8 @@ FPXRSplash::FPXRSplash(FPICOXRHMD* InPICOXRHMD)
 	, bIsShown(false)
 	, bSplashNeedUpdateActiveState(false)
 	, bSplashShouldToShow(false)
-	, FramesOutstanding(0)
 {
 	AddedPXRSplashLayers.Reset();
-	PXRLayers_RenderThread_Entry.Reset();
 	PXRLayers_RenderThread.Reset();
 	PXRLayers_RHIThread.Reset();
 
@@ -82,6 +80,7 @@ bool FPXRSplash::IsPlayingLoadingMovie() const
 void FPXRSplash::ClearSplashes()
 {
 	check(IsInGameThread());
+	CancelTextureLoads();
 	FScopeLock ScopeLock(&RenderThreadLock);
 	AddedPXRSplashLayers.Reset();
 }
@@ -106,6 +105,7 @@ void FPXRSplash::InitSplash()
 	{
 		Settings = PICOXRHMD->CreateNewSettings();
 		PXRFrame = PICOXRHMD->MakeNewGameFrame();
+		SplashFrames.Init(*PXRFrame);
 		AddSplashFromPXRSettings();
 		PICOXRHMD->InitDevice();
 		bInitialized = true;
@@ -118,6 +118,7 @@ void FPXRSplash::ShutDownSplash()
 
 	if (bInitialized)
 	{
+		CancelTextureLoads();
 		ExecuteOnRenderThread([this]()
 			{
 				if (SplashTicker)
@@ -129,7 +130,10 @@ void FPXRSplash::ShutDownSplash()
 				ExecuteOnRHIThread([this]()
 					{
 						AddedPXRSplashLayers.Reset();
-						PXRLayers_RenderThread_Entry.Reset();
+						EntryLayersSnapshot.Reset();
+						AppliedLayersSnapshot_RenderThread.Reset();
+						LayersSnapshot_RenderThread.Reset();
+						LayersSnapshot_RHIThread.Reset();
 						PXRLayers_RenderThread.Reset();
 						PXRLayers_RHIThread.Reset();
 					});
@@ -159,6 +163,10 @@ void FPXRSplash::ReleaseResources_RHIThread()
 
 	PXRLayers_RenderThread.Reset();
 	PXRLayers_RHIThread.Reset();
+	// Recreated from the current entry layers on the next splash tick
+	AppliedLayersSnapshot_RenderThread.Reset();
+	LayersSnapshot_RenderThread.Reset();
+	LayersSnapshot_RHIThread.Reset();
 }
 
 void FPXRSplash::SplashTick_RenderThread(float DeltaTime)
@@ -171,7 +179,7 @@ void FPXRSplash::SplashTick_RenderThread(float DeltaTime)
 		return;
 	}
 
-	if (FramesOutstanding > 0)
+	if (SplashFrames.HasOutstanding())
 	{
 		PXR_LOGV(PxrUnreal, "Splash skipping frame; too many frames outstanding");
 		return;
@@ -257,66 +265,9 @@ void FPXRSplash::EndTicker()
 void FPXRSplash::ToShow()
 {
 	check(IsInGameThread());
-	ReleaseAllTextures();
+	UpdateTextureStates_GameThread();
 
-	for (int32 i = 0; i < AddedPXRSplashLayers.Num(); ++i)
-	{
-		FPXRSplashLayer& SplashLayer = AddedPXRSplashLayers[i];
-		if (SplashLayer.Desc.SplashTexturePath.IsValid())
-		{
-			LoadTexture(SplashLayer);
-		}
-		if (SplashLayer.Desc.LoadingTextureFromPath && SplashLayer.Desc.LoadingTextureFromPath->IsValidLowLevel())
-		{
-			SplashLayer.Desc.LoadingTextureFromPath->UpdateResource();
-		}
-	}
-	FlushRenderingCommands();
-
-	for (int32 i = 0; i < AddedPXRSplashLayers.Num(); ++i)
-	{
-		FPXRSplashLayer& SplashLayer = AddedPXRSplashLayers[i];
-		if (SplashLayer.Desc.LoadingTextureFromPath && SplashLayer.Desc.LoadingTextureFromPath->IsValidLowLevel())
-		{
-            if (SplashLayer.Desc.LoadingTextureFromPath->GetResource() && SplashLayer.Desc.LoadingTextureFromPath->GetResource()->TextureRHI)
-			{
-				SplashLayer.Desc.LoadedTextureRef = SplashLayer.Desc.LoadingTextureFromPath->GetResource()->TextureRHI;
-			}
-			else
-			{
-				PXR_LOGI(PxrUnreal, "Splash %s - no Resource!", PLATFORM_CHAR(*SplashLayer.Desc.LoadingTextureFromPath->GetDesc()));
-			}
-		}
-
-		if (SplashLayer.Desc.LoadedTextureRef)
-		{
-			const int32 PXRLayerID = PICOXRHMD->NextLayerId++;
-			SplashLayer.Layer = MakeShareable(new FPICOXRStereoLayer(PICOXRHMD, PXRLayerID, CreateStereoLayerDescFromPXRSplashDesc(SplashLayer.Desc)));
-			SplashLayer.Layer->bSplashLayer = true;
-		}
-	}
-
-	{
-		FScopeLock ScopeLock(&RenderThreadLock);
-		PXRLayers_RenderThread_Entry.Reset();
-		for (int32 i = 0; i < AddedPXRSplashLayers.Num(); i++)
-		{
-			const FPXRSplashLayer& SplashLayer = AddedPXRSplashLayers[i];
-
-			if (SplashLayer.Layer.IsValid())
-			{
-				FPICOLayerPtr ClonedLayer = SplashLayer.Layer->CloneMyself();
-				PXRLayers_RenderThread_Entry.Add(ClonedLayer);
-			}
-		}
-		if (PXRLayers_RenderThread_Entry.Num() > 0)
-		{
-			PXRLayers_RenderThread_Entry.Add(BlackLayer->CloneMyself());
-		}
-		PXRLayers_RenderThread_Entry.Sort(FPICOLayerPtr_SortById());
-	}
-
-	if (PXRLayers_RenderThread_Entry.Num() > 0)
+	if (UpdateEntryLayers_GameThread() > 0)
 	{
 		BeginTicker();
 		bIsShown = true;
@@ -333,7 +284,7 @@ void FPXRSplash::ToHide()
 	PXR_LOGI(PxrUnreal, "Splash Hide!");
 	bIsShown = false;
 	EndTicker();
-	ReleaseAllTextures();
+	ReleaseAllLayers();
 }
 
 void FPXRSplash::AutoShow(bool AutoShowSplash)
@@ -346,12 +297,26 @@ void FPXRSplash::AddPXRSplashLayers(const FPXRSplashDesc& Desc)
 {
 	check(IsInGameThread());
 	PXR_LOGI(PxrUnreal, "Splash AddSplash!");
-	FScopeLock ScopeLock(&RenderThreadLock);
-	AddedPXRSplashLayers.Add(FPXRSplashLayer(Desc));
+	int32 LayerIndex;
+	{
+		FScopeLock ScopeLock(&RenderThreadLock);
+		LayerIndex = AddedPXRSplashLayers.Add(FPXRSplashLayer(Desc));
+	}
+	// Preloaded from here, so that showing the splash later never waits for the texture
+	if (Desc.SplashTexturePath.IsValid())
+	{
+		RequestTexture(AddedPXRSplashLayers[LayerIndex]);
+	}
 }
 
 void FPXRSplash::SwitchActiveSplash_GameThread()
 {
+	// Textures that finish loading while the splash is up are added to it
+	if (UpdateTextureStates_GameThread() && bIsShown)
+	{
+		UpdateEntryLayers_GameThread();
+	}
+
 	if (bSplashNeedUpdateActiveState)
 	{
 		if (bSplashShouldToShow)
@@ -372,48 +337,210 @@ void FPXRSplash::SwitchActiveSplash_GameThread()
 	}
 }
 
-void FPXRSplash::ReleaseAllTextures()
+void FPXRSplash::ReleaseAllLayers()
 {
+	check(IsInGameThread());
 	FScopeLock ScopeLock(&RenderThreadLock);
 	for (int32 i = 0; i < AddedPXRSplashLayers.Num(); ++i)
 	{
-		if (AddedPXRSplashLayers[i].Desc.SplashTexturePath.IsValid())
+		AddedPXRSplashLayers[i].Layer.Reset();
+	}
+}
+
+void FPXRSplashTextureLoader::Request(FPXRSplashLayer& SplashLayer, FStreamableDelegate OnLoaded)
+{
+	check(IsInGameThread());
+	SplashLayer.Desc.LoadingTextureFromPath = nullptr;
+	SplashLayer.Desc.LoadedTextureRef = nullptr;
+	SplashLayer.TextureState = EPXRSplashTextureState::Loading;
+	// The delegate may run before RequestAsyncLoad returns, so the handle is only checked when updating the states
+	SplashLayer.LoadHandle = StreamableManager.RequestAsyncLoad(SplashLayer.Desc.SplashTexturePath, MoveTemp(OnLoaded), FStreamableManager::AsyncLoadHighPriority);
+}
+
+void FPXRSplashTextureLoader::Cancel(FPXRSplashLayer& SplashLayer)
+{
+	check(IsInGameThread());
+	if (SplashLayer.LoadHandle.IsValid())
+	{
+		SplashLayer.LoadHandle->CancelHandle();
+		SplashLayer.LoadHandle.Reset();
+	}
+}
+
+bool FPXRSplashTextureLoader::UpdateStates(TArray<FPXRSplashLayer>& SplashLayers)
+{
+	check(IsInGameThread());
+	// Resources of textures that were waiting before this update have been created once the fence has passed
+	const bool bResourcesCreated = TextureResourceFence.IsFenceComplete();
+	bool bNewlyLoaded = false;
+	bool bNewlyReady = false;
+
+	for (int32 i = 0; i < SplashLayers.Num(); ++i)
+	{
+		FPXRSplashLayer& SplashLayer = SplashLayers[i];
+		if (SplashLayer.TextureState == EPXRSplashTextureState::WaitingForResource && bResourcesCreated)
 		{
-			ReleaseTexture(AddedPXRSplashLayers[i]);
+			UTexture* Texture = SplashLayer.Desc.LoadingTextureFromPath;
+			if (Texture && Texture->GetResource() && Texture->GetResource()->TextureRHI)
+			{
+				SplashLayer.Desc.LoadedTextureRef = Texture->GetResource()->TextureRHI;
+				SplashLayer.TextureState = EPXRSplashTextureState::Ready;
+				bNewlyReady = true;
+			}
+			else
+			{
+				PXR_LOGI(PxrUnreal, "Splash %s - no Resource!", PLATFORM_CHAR(*SplashLayer.Desc.SplashTexturePath.ToString()));
+				SplashLayer.TextureState = EPXRSplashTextureState::Failed;
+			}
 		}
+		else if (SplashLayer.TextureState == EPXRSplashTextureState::Loading && (!SplashLayer.LoadHandle.IsValid() || !SplashLayer.LoadHandle->IsLoadingInProgress()))
+		{
+			UTexture* Texture = Cast<UTexture>(SplashLayer.Desc.SplashTexturePath.ResolveObject());
+			if (Texture)
+			{
+				// Loaded textures normally have their resource already; either way its creation is only waited for by the fence
+				if (!Texture->GetResource())
+				{
+					Texture->UpdateResource();
+				}
+				SplashLayer.Desc.LoadingTextureFromPath = Texture;
+				SplashLayer.TextureState = EPXRSplashTextureState::WaitingForResource;
+				bNewlyLoaded = true;
+			}
+			else
+			{
+				PXR_LOGI(PxrUnreal, "Splash failed to load %s!", PLATFORM_CHAR(*SplashLayer.Desc.SplashTexturePath.ToString()));
+				SplashLayer.TextureState = EPXRSplashTextureState::Failed;
+			}
+		}
+	}
+
+	if (bNewlyLoaded)
+	{
+		TextureResourceFence.BeginFence();
+	}
+	return bNewlyReady;
+}
+
+void FPXRSplashFrames::Init(const FPXRGameFrame& Template)
+{
+	for (FPXRGameFramePtr& Frame : Frames)
+	{
+		Frame = Template.CloneMyself();
 	}
+	NextFrame = 0;
+	FramesOutstanding = 0;
 }
 
-void FPXRSplash::ReleaseTexture(FPXRSplashLayer& InSplashLayer)
+FPXRGameFrame* FPXRSplashFrames::Acquire_RenderThread(const FPXRGameFrame& Template)
+{
+	check(!HasOutstanding());
+	FPXRGameFrame* Frame = Frames[NextFrame].Get();
+	NextFrame = (NextFrame + 1) % NumFrames;
+	*Frame = Template;
+	FPlatformAtomics::InterlockedIncrement(&FramesOutstanding);
+	return Frame;
+}
+
+void FPXRSplashFrames::Release_RHIThread()
+{
+	FPlatformAtomics::InterlockedDecrement(&FramesOutstanding);
+}
+
+void FPXRSplash::CancelTextureLoads()
 {
 	check(IsInGameThread());
-	InSplashLayer.Desc.LoadingTextureFromPath = nullptr;
-	InSplashLayer.Desc.LoadedTextureRef = nullptr;
-	InSplashLayer.Layer.Reset();
+	for (int32 i = 0; i < AddedPXRSplashLayers.Num(); ++i)
+	{
+		TextureLoader.Cancel(AddedPXRSplashLayers[i]);
+	}
 }
 
-void FPXRSplash::LoadTexture(FPXRSplashLayer& InSplashLayer)
+void FPXRSplash::RequestTexture(FPXRSplashLayer& InSplashLayer)
 {
 	check(IsInGameThread());
-	ReleaseTexture(InSplashLayer);
-	InSplashLayer.Desc.LoadingTextureFromPath = Cast<UTexture>(InSplashLayer.Desc.SplashTexturePath.TryLoad());
-	InSplashLayer.Desc.LoadedTextureRef = nullptr;
 	InSplashLayer.Layer.Reset();
+	TextureLoader.Request(InSplashLayer, FStreamableDelegate::CreateSP(this, &FPXRSplash::OnSplashTextureLoaded));
+}
+
+void FPXRSplash::OnSplashTextureLoaded()
+{
+	if (UpdateTextureStates_GameThread() && bIsShown)
+	{
+		UpdateEntryLayers_GameThread();
+	}
+}
+
+bool FPXRSplash::UpdateTextureStates_GameThread()
+{
+	check(IsInGameThread());
+	FScopeLock ScopeLock(&RenderThreadLock);
+	return TextureLoader.UpdateStates(AddedPXRSplashLayers);
+}
+
+int32 FPXRSplash::UpdateEntryLayers_GameThread()
+{
+	check(IsInGameThread());
+	bool bTexturesPending = false;
+	for (int32 i = 0; i < AddedPXRSplashLayers.Num(); ++i)
+	{
+		FPXRSplashLayer& SplashLayer = AddedPXRSplashLayers[i];
+		bTexturesPending |= SplashLayer.TextureState == EPXRSplashTextureState::Loading || SplashLayer.TextureState == EPXRSplashTextureState::WaitingForResource;
+		if (!SplashLayer.Layer.IsValid() && SplashLayer.Desc.LoadedTextureRef)
+		{
+			const int32 PXRLayerID = PICOXRHMD->NextLayerId++;
+			SplashLayer.Layer = MakeShareable(new FPICOXRStereoLayer(PICOXRHMD, PXRLayerID, CreateStereoLayerDescFromPXRSplashDesc(SplashLayer.Desc)));
+			SplashLayer.Layer->bSplashLayer = true;
+		}
+	}
+
+	TArray<FPICOLayerPtr> EntryLayers;
+	for (int32 i = 0; i < AddedPXRSplashLayers.Num(); i++)
+	{
+		const FPXRSplashLayer& SplashLayer = AddedPXRSplashLayers[i];
+
+		if (SplashLayer.Layer.IsValid())
+		{
+			FPICOLayerPtr ClonedLayer = SplashLayer.Layer->CloneMyself();
+			EntryLayers.Add(ClonedLayer);
+		}
+	}
+	// Until the textures are ready the splash is only the black layer, which still covers the transition
+	if (EntryLayers.Num() > 0 || bTexturesPending)
+	{
+		EntryLayers.Add(BlackLayer->CloneMyself());
+	}
+	EntryLayers.Sort(FPICOLayerPtr_SortById());
+
+	const int32 NumEntryLayers = EntryLayers.Num();
+	FLayerSnapshotPtr Snapshot = MakeShared<TArray<FPICOLayerPtr>, ESPMode::ThreadSafe>(MoveTemp(EntryLayers));
+	FScopeLock ScopeLock(&RenderThreadLock);
+	EntryLayersSnapshot = Snapshot;
+	return NumEntryLayers;
 }
 
 void FPXRSplash::RenderSplashFrame_RenderThread(FRHICommandListImmediate& RHICmdList)
 {
 	CheckInRenderThread();
 
-	FScopeLock ScopeLock(&RenderThreadLock);
+	FLayerSnapshotPtr EntryLayers;
+	{
+		FScopeLock ScopeLock(&RenderThreadLock);
+		EntryLayers = EntryLayersSnapshot;
+	}
+	if (!EntryLayers.IsValid())
+	{
+		return;
+	}
+
+	// Settings are never modified once created, so the render and RHI threads share them
+	const FGameSettings* PXRSettings = Settings.Get();
 
-	FSettingsPtr PXRSettings = Settings->Clone();
-	FPXRGameFramePtr SplashFrame = PXRFrame->CloneMyself();
+	FPXRGameFrame* SplashFrame = SplashFrames.Acquire_RenderThread(*PXRFrame);
 	SplashFrame->FrameNumber = PICOXRHMD->NextGameFrameNumber;
 	SplashFrame->predictedDisplayTimeMs = PICOXRHMD->CurrentFramePredictedTime + 1000.0f / PICOXRHMD->DisplayRefreshRate;
 	SplashFrame->ShowFlags.Rendering = true;
 	SplashFrame->Flags.bHasWaited = PICOXRHMD->WaitedFrameNumber == SplashFrame->FrameNumber ? true : false;
-	TArray<FPICOLayerPtr> SplashEntryLayers = PXRLayers_RenderThread_Entry;
 
 	if (FPICOXRHMDModule::GetPluginWrapper().IsRunning())
 	{
@@ -445,14 +572,16 @@ void FPXRSplash::RenderSplashFrame_RenderThread(FRHICommandListImmediate& RHICmd
 		SplashFrame->ShowFlags.Rendering = false;
 	}
 
-	FPlatformAtomics::InterlockedIncrement(&FramesOutstanding);
-
 	if (SplashFrame->ShowFlags.Rendering)
 	{
-		PICOXRHMD->UpdateSensorValue(PXRSettings.Get(), SplashFrame.Get());
+		PICOXRHMD->UpdateSensorValue(PXRSettings, SplashFrame);
 	}
 
+	// The layers only need to be created and handed to the RHI thread when the game thread publishes a new set
+	if (EntryLayers != AppliedLayersSnapshot_RenderThread)
 	{
+		const TArray<FPICOLayerPtr>& SplashEntryLayers = *EntryLayers;
+		bool bAllLayersCreated = true;
 		int32 EntryLayer_i = 0;
 		int32 Layer_j_RenderThread = 0;
 
@@ -463,7 +592,7 @@ void FPXRSplash::RenderSplashFrame_RenderThread(FRHICommandListImmediate& RHICmd
 
 			if (LayerIdX < LayerIdY)
 			{
-				SplashEntryLayers[EntryLayer_i++]->InitPXRLayer_RenderThread(PXRSettings.Get(), CustomRenderBridge, &PICOXRHMD->DelayDeletion, RHICmdList);
+				bAllLayersCreated &= SplashEntryLayers[EntryLayer_i++]->InitPXRLayer_RenderThread(PXRSettings, CustomRenderBridge, &PICOXRHMD->DelayDeletion, RHICmdList);
 			}
 			else if (LayerIdX > LayerIdY)
 			{
@@ -471,24 +600,36 @@ void FPXRSplash::RenderSplashFrame_RenderThread(FRHICommandListImmediate& RHICmd
 			}
 			else
 			{
-				SplashEntryLayers[EntryLayer_i++]->InitPXRLayer_RenderThread(PXRSettings.Get(), CustomRenderBridge, &PICOXRHMD->DelayDeletion, RHICmdList, PXRLayers_RenderThread[Layer_j_RenderThread++].Get());
+				bAllLayersCreated &= SplashEntryLayers[EntryLayer_i++]->InitPXRLayer_RenderThread(PXRSettings, CustomRenderBridge, &PICOXRHMD->DelayDeletion, RHICmdList, PXRLayers_RenderThread[Layer_j_RenderThread++].Get());
 			}
 		}
 
 		while (EntryLayer_i < SplashEntryLayers.Num())
 		{
-			SplashEntryLayers[EntryLayer_i++]->InitPXRLayer_RenderThread(PXRSettings.Get(), CustomRenderBridge, &PICOXRHMD->DelayDeletion, RHICmdList);
+			bAllLayersCreated &= SplashEntryLayers[EntryLayer_i++]->InitPXRLayer_RenderThread(PXRSettings, CustomRenderBridge, &PICOXRHMD->DelayDeletion, RHICmdList);
 		}
 
 		while (Layer_j_RenderThread < PXRLayers_RenderThread.Num())
 		{
 			PICOXRHMD->DelayDeletion.AddLayerToDeferredDeletionQueue(PXRLayers_RenderThread[Layer_j_RenderThread++]);
 		}
-	}
 
-	PXRLayers_RenderThread = SplashEntryLayers;
+		PXRLayers_RenderThread = SplashEntryLayers;
 
-	for (auto Splash : PXRLayers_RenderThread)
+		TArray<FPICOLayerPtr> RHILayers;
+		RHILayers.Reserve(SplashEntryLayers.Num());
+		for (const FPICOLayerPtr& Layer : SplashEntryLayers)
+		{
+			RHILayers.Add(Layer->CloneMyself());
+		}
+		RHILayers.Sort(FPICOLayerPtr_SortByPriority());
+		LayersSnapshot_RenderThread = MakeShared<TArray<FPICOLayerPtr>, ESPMode::ThreadSafe>(MoveTemp(RHILayers));
+
+		// A layer whose creation failed, e.g. before the session is up, is retried on the next tick
+		AppliedLayersSnapshot_RenderThread = bAllLayersCreated ? EntryLayers : nullptr;
+	}
+
+	for (const FPICOLayerPtr& Splash : PXRLayers_RenderThread)
 	{
 		if (!Splash->bSplashBlackProjectionLayer)
 		{
@@ -498,14 +639,13 @@ void FPXRSplash::RenderSplashFrame_RenderThread(FRHICommandListImmediate& RHICmd
 
 	CustomRenderBridge->SubmitGPUCommands_RenderThread(RHICmdList);
 
-	for (int32 i = 0; i < SplashEntryLayers.Num(); i++)
-	{
-		SplashEntryLayers[i] = SplashEntryLayers[i]->CloneMyself();
-	}
-
-	ExecuteOnRHIThread_DoNotWait([this, PXRSettings, SplashFrame, SplashEntryLayers]()
+	ExecuteOnRHIThread_DoNotWait([this, PXRSettings, SplashFrame, RHILayers = LayersSnapshot_RenderThread]()
 		{
-			PXRLayers_RHIThread = SplashEntryLayers;
+			if (RHILayers != LayersSnapshot_RHIThread)
+			{
+				LayersSnapshot_RHIThread = RHILayers;
+				PXRLayers_RHIThread = *RHILayers;
+			}
 			if (SplashFrame->ShowFlags.Rendering && FPICOXRHMDModule::GetPluginWrapper().IsRunning())
 			{
 				PXR_LOGV(PxrUnreal, "Splash BeginFrame %u", SplashFrame->FrameNumber);
@@ -521,16 +661,14 @@ void FPXRSplash::RenderSplashFrame_RenderThread(FRHICommandListImmediate& RHICmd
 				}
 			}
 
-			FPlatformAtomics::InterlockedDecrement(&FramesOutstanding);
-
-			PXRLayers_RHIThread.Sort(FPICOLayerPtr_SortByPriority());
+			SplashFrames.Release_RHIThread();
 
 			if (SplashFrame->ShowFlags.Rendering && FPICOXRHMDModule::GetPluginWrapper().IsRunning())
 			{
 				PXR_LOGV(PxrUnreal, "Splash EndFrame %u", SplashFrame->FrameNumber);
 				for (int32 LayerIndex = 0; LayerIndex < PXRLayers_RHIThread.Num(); LayerIndex++)
 				{
-					PXRLayers_RHIThread[LayerIndex]->SubmitLayer_RHIThread(PXRSettings.Get(), SplashFrame.Get());
+					PXRLayers_RHIThread[LayerIndex]->SubmitLayer_RHIThread(PXRSettings, SplashFrame);
 				}
 				FPICOXRHMDModule::GetPluginWrapper().EndFrame();
 			}
@@ -9,15 +9,67 @@
 #include "PXR_HMDTypes.h"
 #include "PXR_HMDRuntimeSettings.h"
 #include "PXR_GameFrame.h"
+#include "Engine/StreamableManager.h"
+#include "RenderCommandFence.h"
+
+enum class EPXRSplashTextureState : uint8
+{
+	// Texture given as LoadedTextureRef, nothing to load
+	None,
+	Loading,
+	// Loaded, the render thread has not created the texture resource yet
+	WaitingForResource,
+	Ready,
+	Failed
+};
 
 struct FPXRSplashLayer
 {
 	FPXRSplashDesc Desc;
 	FPICOLayerPtr Layer;
+	EPXRSplashTextureState TextureState;
+	TSharedPtr<FStreamableHandle> LoadHandle;
+
+public:
+	FPXRSplashLayer(const FPXRSplashDesc& InSplashDesc) : Desc(InSplashDesc), TextureState(EPXRSplashTextureState::None) {}
+	FPXRSplashLayer(const FPXRSplashLayer& InSplashLayer) : Desc(InSplashLayer.Desc), Layer(InSplashLayer.Layer), TextureState(InSplashLayer.TextureState), LoadHandle(InSplashLayer.LoadHandle) {}
+};
 
+// Asynchronous loading of the splash textures through the streamable manager; their texture resources are created by
+// the render thread and waited for with a fence. Nothing here waits for the load or for the render thread.
+class FPXRSplashTextureLoader
+{
 public:
-	FPXRSplashLayer(const FPXRSplashDesc& InSplashDesc) : Desc(InSplashDesc) {}
-	FPXRSplashLayer(const FPXRSplashLayer& InSplashLayer) : Desc(InSplashLayer.Desc), Layer(InSplashLayer.Layer) {}
+	// Starts loading the texture of the splash layer. OnLoaded runs before this returns when the texture is already loaded.
+	void Request(FPXRSplashLayer& SplashLayer, FStreamableDelegate OnLoaded);
+	void Cancel(FPXRSplashLayer& SplashLayer);
+	// Advances the texture state of the splash layers; returns true if a texture became ready
+	bool UpdateStates(TArray<FPXRSplashLayer>& SplashLayers);
+
+private:
+	FStreamableManager StreamableManager;
+	FRenderCommandFence TextureResourceFence;
+};
+
+// The game frames of the splash ticks, allocated once and used in turn. The RHI thread releases a frame before it
+// submits the layers, so while it still reads one frame the next tick takes the other; a tick is skipped while a frame
+// is outstanding, so the RHI thread is done with a frame before it comes round again.
+class FPXRSplashFrames
+{
+public:
+	static constexpr int32 NumFrames = 2;
+
+	void Init(const FPXRGameFrame& Template);
+	bool HasOutstanding() const { return FramesOutstanding > 0; }
+	// Render thread. Returns the next frame reset from Template and counts it as outstanding.
+	FPXRGameFrame* Acquire_RenderThread(const FPXRGameFrame& Template);
+	// RHI thread. The released frame may still be read until the RHI thread releases the next one.
+	void Release_RHIThread();
+
+private:
+	FPXRGameFramePtr Frames[NumFrames];
+	int32 NextFrame = 0;
+	int32 FramesOutstanding = 0;
 };
 
 class FPXRSplash : public IXRLoadingScreen, public TSharedFromThis<FPXRSplash>
@@ -68,9 +120,14 @@ protected:
 	void EndTicker();
 	void ToShow();
 	void ToHide();
-	void ReleaseAllTextures();
-	void ReleaseTexture(FPXRSplashLayer& InSplashLayer);
-	void LoadTexture(FPXRSplashLayer& InSplashLayer);
+	void ReleaseAllLayers();
+	void CancelTextureLoads();
+	void RequestTexture(FPXRSplashLayer& InSplashLayer);
+	void OnSplashTextureLoaded();
+	// Advances the texture state of the splash layers without blocking; returns true if a texture became ready
+	bool UpdateTextureStates_GameThread();
+	// Creates the layers of the ready textures and hands them to the render thread; returns the number of layers
+	int32 UpdateEntryLayers_GameThread();
 	void RenderSplashFrame_RenderThread(FRHICommandListImmediate& RHICmdList);
 	IStereoLayers::FLayerDesc CreateStereoLayerDescFromPXRSplashDesc(FPXRSplashDesc PXRSplashDesc);
 
@@ -88,9 +145,19 @@ protected:
 	bool bSplashShouldToShow;
 
 	TArray<FPXRSplashLayer> AddedPXRSplashLayers;
-	TArray<FPICOLayerPtr> PXRLayers_RenderThread_Entry;
+	// Splash textures are loaded asynchronously when added and kept until cleared, so showing never loads
+	FPXRSplashTextureLoader TextureLoader;
 	TArray<FPICOLayerPtr> PXRLayers_RenderThread;
 
-	int32 FramesOutstanding;
+	// Layer sets are immutable once published, so the render and RHI threads only redo work when the pointer changes
+	typedef TSharedPtr<const TArray<FPICOLayerPtr>, ESPMode::ThreadSafe> FLayerSnapshotPtr;
+	// Set by the game thread under RenderThreadLock
+	FLayerSnapshotPtr EntryLayersSnapshot;
+	FLayerSnapshotPtr AppliedLayersSnapshot_RenderThread;
+	// RHI thread copies of the applied layers, sorted by priority
+	FLayerSnapshotPtr LayersSnapshot_RenderThread;
+	FLayerSnapshotPtr LayersSnapshot_RHIThread;
+
+	FPXRSplashFrames SplashFrames;
 };
 typedef TSharedPtr<FPXRSplash> FPICOXRSplashPtr;
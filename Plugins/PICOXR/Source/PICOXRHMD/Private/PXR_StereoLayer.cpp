@@ -73,6 +73,7 @@ FPICOXRStereoLayer::FPICOXRStereoLayer(FPICOXRHMD* InHMDDevice, uint32 InPXRLaye
 	, bSplashBlackProjectionLayer(false)
 	, bMRCLayer(false)
 	, bNeedsTexSrgbCreate(false)
+	, Generation(0)
 #ifdef PICO_CUSTOM_ENGINE
 	, bEnableEyeTrackingFoveationRendering(false)
 #endif
@@ -99,6 +100,7 @@ FPICOXRStereoLayer::FPICOXRStereoLayer(const FPICOXRStereoLayer& InPXRLayer)
 	, bSplashBlackProjectionLayer(InPXRLayer.bSplashBlackProjectionLayer)
     , bMRCLayer(InPXRLayer.bMRCLayer)
 	, bNeedsTexSrgbCreate(InPXRLayer.bNeedsTexSrgbCreate)
+	, Generation(InPXRLayer.Generation)
 #ifdef PICO_CUSTOM_ENGINE
 	, bEnableEyeTrackingFoveationRendering(InPXRLayer.bEnableEyeTrackingFoveationRendering)
 #endif
@@ -359,7 +361,9 @@ void FPICOXRStereoLayer::PXRLayersCopy_RenderThread(FPICOXRRenderBridge* RenderB
 
 	PXR_LOGV(PxrUnreal, "ID=%d, bTextureNeedUpdate=%d, IsVisible:%d, SwapChain.IsValid=%d, LayerDesc.Texture.IsValid=%d", ID, bTextureNeedUpdate, IsVisible(), SwapChain.IsValid(), LayerDesc.Texture.IsValid());
 
-	if (bTextureNeedUpdate && IsVisible())
+	// Continuous-update layers are copied every frame without being re-marked
+	const bool bContinuousUpdate = (LayerDesc.Flags & IStereoLayers::LAYER_FLAG_TEX_CONTINUOUS_UPDATE) && LayerDesc.Texture.IsValid();
+	if ((bTextureNeedUpdate || bContinuousUpdate) && IsVisible())
 	{
 		// Copy textures
 		if (LayerDesc.Texture.IsValid() && SwapChain.IsValid())
@@ -520,6 +524,17 @@ bool FPICOXRStereoLayer::InitPXRLayer_RenderThread(const FGameSettings* Settings
 #endif
 	}
 
+	// Native layer of a destroyed layer with the same create parameters, when there is nothing to reuse from InLayer
+	FPICOLayerPtr PooledLayer;
+	if (ID != 0 && DelayDeletion && !IfCanReuseLayers(InLayer))
+	{
+		PooledLayer = DelayDeletion->AcquirePooledLayer_RenderThread(this);
+		if (PooledLayer.IsValid())
+		{
+			InLayer = PooledLayer.Get();
+		}
+	}
+
 	if (IfCanReuseLayers(InLayer))
 	{
 		//GameThread = RenderThread
@@ -532,7 +547,7 @@ bool FPICOXRStereoLayer::InitPXRLayer_RenderThread(const FGameSettings* Settings
 		MotionVectorSwapChain=InLayer->MotionVectorSwapChain;
 		MotionVectorDepthSwapChain=InLayer->MotionVectorDepthSwapChain;
 #endif
-		bTextureNeedUpdate |= InLayer->bTextureNeedUpdate;
+		bTextureNeedUpdate |= InLayer->bTextureNeedUpdate || PooledLayer.IsValid();
 		bNeedsTexSrgbCreate = InLayer->bNeedsTexSrgbCreate;
 	}
     else
@@ -1222,37 +1237,53 @@ int32 FPICOXRStereoLayer::GetShapeType()
 	return ShapeType;
 }
 
-void FPICOXRStereoLayer::SetEyeLayerDesc(uint32 SizeX, uint32 SizeY, uint32 ArraySize, uint32 NumMips, uint32 NumSamples, FString RHIString,bool EnableSubSampled)
+PxrLayerParam FPICOXRStereoLayer::MakeEyeLayerCreateParam(uint32 SizeX, uint32 SizeY, uint32 ArraySize, uint32 NumMips, uint32 NumSamples, const FString& RHIString, bool EnableSubSampled) const
 {
-	PxrLayerCreateParam.layerShape = PXR_LAYER_PROJECTION;
-	PxrLayerCreateParam.width = SizeX;
-	PxrLayerCreateParam.height = SizeY;
-	PxrLayerCreateParam.faceCount = 1;
-	PxrLayerCreateParam.mipmapCount = NumMips;
-	PxrLayerCreateParam.sampleCount = NumSamples;
-	PxrLayerCreateParam.arraySize = ArraySize;
-	PxrLayerCreateParam.layerLayout = ArraySize == 2 ? PXR_LAYER_LAYOUT_ARRAY : PXR_LAYER_LAYOUT_DOUBLE_WIDE;
+	PxrLayerParam Param = PxrLayerCreateParam;
+	Param.layerShape = PXR_LAYER_PROJECTION;
+	Param.width = SizeX;
+	Param.height = SizeY;
+	Param.faceCount = 1;
+	Param.mipmapCount = NumMips;
+	Param.sampleCount = NumSamples;
+	Param.arraySize = ArraySize;
+	Param.layerLayout = ArraySize == 2 ? PXR_LAYER_LAYOUT_ARRAY : PXR_LAYER_LAYOUT_DOUBLE_WIDE;
 #if PLATFORM_ANDROID
 	 if (RHIString == TEXT("Vulkan"))
 	{
-		PxrLayerCreateParam.format = IsMobileColorsRGB() ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8A8_UNORM;
+		Param.format = IsMobileColorsRGB() ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8A8_UNORM;
 	}
 	if (EnableSubSampled)
 	{
-		PxrLayerCreateParam.layerFlags |= PXR_LAYER_FLAG_ENABLE_SUBSAMPLED;
+		Param.layerFlags |= PXR_LAYER_FLAG_ENABLE_SUBSAMPLED;
 	}
 	else
 	{
-		PxrLayerCreateParam.layerFlags &= ~PXR_LAYER_FLAG_ENABLE_SUBSAMPLED;
+		Param.layerFlags &= ~PXR_LAYER_FLAG_ENABLE_SUBSAMPLED;
 	}
 #ifdef PICO_CUSTOM_ENGINE
 	if (HMDDevice->IsSupportsSpaceWarp())
 	{
-		PxrLayerCreateParam.layerFlags |= PXR_LAYER_FLAG_ENABLE_FRAME_EXTRAPOLATION ;
+		Param.layerFlags |= PXR_LAYER_FLAG_ENABLE_FRAME_EXTRAPOLATION ;
 	}
 #endif
 #endif
-	
+	return Param;
+}
+
+bool FPICOXRStereoLayer::HasSameCreateParam(const PxrLayerParam& InParam) const
+{
+	return PxrLayerCreateParam.layerShape == InParam.layerShape
+		&& PxrLayerCreateParam.layerType == InParam.layerType
+		&& PxrLayerCreateParam.layerLayout == InParam.layerLayout
+		&& PxrLayerCreateParam.format == InParam.format
+		&& PxrLayerCreateParam.width == InParam.width
+		&& PxrLayerCreateParam.height == InParam.height
+		&& PxrLayerCreateParam.sampleCount == InParam.sampleCount
+		&& PxrLayerCreateParam.faceCount == InParam.faceCount
+		&& PxrLayerCreateParam.arraySize == InParam.arraySize
+		&& PxrLayerCreateParam.mipmapCount == InParam.mipmapCount
+		&& PxrLayerCreateParam.layerFlags == InParam.layerFlags;
 }
 
 const FName FEACLayer::ShapeName = FName("EACLayer");
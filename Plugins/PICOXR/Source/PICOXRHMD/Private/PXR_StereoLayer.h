@@ -57,11 +57,18 @@ public:
 	void IncrementSwapChainIndex_RHIThread(FPICOXRRenderBridge* RenderBridge);
 	const void SubmitLayer_RHIThread(const FGameSettings* Settings, const FPXRGameFrame* Frame);
 	int32 GetShapeType();
-	void SetEyeLayerDesc(uint32 SizeX, uint32 SizeY, uint32 ArraySize, uint32 NumMips, uint32 NumSamples, FString RHIString,bool EnableSubSampled);
+	// Create params of the eye layer for the given render target, starting from this layer's params
+	PxrLayerParam MakeEyeLayerCreateParam(uint32 SizeX, uint32 SizeY, uint32 ArraySize, uint32 NumMips, uint32 NumSamples, const FString& RHIString, bool EnableSubSampled) const;
+	void SetEyeLayerCreateParam(const PxrLayerParam& InParam) { PxrLayerCreateParam = InParam; }
+	// Whether InParam would create the same native layer as this layer's params
+	bool HasSameCreateParam(const PxrLayerParam& InParam) const;
     void PXRLayersCopy_RenderThread(FPICOXRRenderBridge* RenderBridge, FRHICommandListImmediate& RHICmdList);
 	void MarkTextureForUpdate(bool bUpdate = true) { bTextureNeedUpdate = bUpdate; }
+	bool IsTextureMarkedForUpdate() const { return bTextureNeedUpdate; }
 	bool InitPXRLayer_RenderThread(const FGameSettings* Settings, FPICOXRRenderBridge* CustomPresent, FDelayDeleteLayerManager* DelayDeletion, FRHICommandListImmediate& RHICmdList, const FPICOXRStereoLayer* InLayer = nullptr);
 	bool IfCanReuseLayers(const FPICOXRStereoLayer* InLayer) const;
+	// Only owner of a native layer that a new layer with the same create parameters could take over
+	bool CanBePooled() const { return ID != 0 && !bMRCLayer && PxrLayer.IsValid() && PxrLayer.GetSharedReferenceCount() == 1; }
 	void ReleaseResources_RHIThread();
 	bool IsVisible() { return (LayerDesc.Flags & IStereoLayers::LAYER_FLAG_HIDDEN) == 0; }
 	void DestroyUnderlayMesh();
@@ -69,6 +76,8 @@ public:
 	bool bSplashBlackProjectionLayer;
 	bool bMRCLayer;
 	bool bNeedsTexSrgbCreate;
+	// Generation of the frame state template this layer was copied from (0 if it was not), see FPXRFrameState
+	uint32 Generation;
 	void SetTrackingMode(PxrTrackingModeFlags mode) { TrackingMode = mode; }
 
 #ifdef PICO_CUSTOM_ENGINE
@@ -0,0 +1,233 @@
+// Copyright PICO Technology Co., Ltd. All rights reserved.
+// This plugin incorporates portions of the Unreal® Engine. Unreal® is a trademark or registered trademark of Epic Games, Inc. in the United States of America and elsewhere.
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "PXR_TraceBenchmarkCommandlet.h"
+#include "IPXR_HMDModule.h"
+#include "Misc/Parse.h"
+#include "Misc/ScopeExit.h"
+
+#if PICO_HMD_SUPPORTED_PLATFORMS
+#include "PXR_HMDModule.h"
+#include "PXR_PluginTrace.h"
+#include "PXR_PoseCache.h"
+#include "PXR_FrameTiming.h"
+
+namespace PXRTraceBenchmark
+{
+	enum class EStage : uint8
+	{
+		// Game thread work per frame, the replay pacing in WaitFrame excluded
+		Frame,
+		Prediction,
+		Events,
+		Input,
+		Tracking,
+		Count
+	};
+
+	static const TCHAR* const StageNames[] = { TEXT("Frame"), TEXT("Prediction"), TEXT("Events"), TEXT("Input"), TEXT("Tracking") };
+	static_assert(UE_ARRAY_COUNT(StageNames) == (int32)EStage::Count, "Stage names out of date");
+
+	// Percentile (0-1) of Values in microseconds; sorts Values
+	static double GetPercentileUs(TArray<double>& Values, double Percentile)
+	{
+		if (Values.Num() == 0)
+		{
+			return 0.0;
+		}
+		Values.Sort();
+		const int32 Index = FMath::Clamp(FMath::CeilToInt(Percentile * Values.Num()) - 1, 0, Values.Num() - 1);
+		return Values[Index] * 1e6;
+	}
+}
+#endif //PICO_HMD_SUPPORTED_PLATFORMS
+
+UPXRTraceBenchmarkCommandlet::UPXRTraceBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+int32 UPXRTraceBenchmarkCommandlet::Main(const FString& Params)
+{
+#if PICO_HMD_SUPPORTED_PLATFORMS
+	using namespace PXRTraceBenchmark;
+
+	FString TracePath;
+	if (!FParse::Value(*Params, TEXT("Trace="), TracePath))
+	{
+		UE_LOG(LogPICOPluginWrapper, Error, TEXT("Usage: -run=PXRTraceBenchmark -Trace=<File> [-Frames=1000] [-Speed=0] [-RefreshRate=72] [-Readers=4] [-TrackerSN=<SN>,<SN>] [-NoPoseCache] [-CSV=<File>]"));
+		return 1;
+	}
+
+	int32 NumFrames = 1000;
+	float Speed = 0.0f;
+	float RefreshRate = 72.0f;
+	// HMD, input, motion tracking and MR each read the prediction once per frame
+	int32 NumReaders = 4;
+	FParse::Value(*Params, TEXT("Frames="), NumFrames);
+	FParse::Value(*Params, TEXT("Speed="), Speed);
+	FParse::Value(*Params, TEXT("RefreshRate="), RefreshRate);
+	FParse::Value(*Params, TEXT("Readers="), NumReaders);
+	const bool bUsePoseCache = !FParse::Param(*Params, TEXT("NoPoseCache"));
+	NumFrames = FMath::Max(NumFrames, 1);
+
+	FString TrackerSNList;
+	FParse::Value(*Params, TEXT("TrackerSN="), TrackerSNList, false);
+	TArray<FString> TrackerSNStrings;
+	TrackerSNList.ParseIntoArray(TrackerSNStrings, TEXT(","));
+	TArray<TArray<ANSICHAR>> TrackerSNs;
+	for (const FString& SN : TrackerSNStrings)
+	{
+		const auto Converted = StringCast<ANSICHAR>(*SN);
+		TrackerSNs.Emplace(Converted.Get(), Converted.Length() + 1);
+	}
+
+	PICOPluginWrapper& Wrapper = FPICOXRHMDModule::GetPluginWrapper();
+	if (!FPXRPluginTrace::StartReplay(Wrapper, TracePath, Speed))
+	{
+		return 1;
+	}
+	ON_SCOPE_EXIT
+	{
+		FPXRPluginTrace::Stop(Wrapper);
+	};
+
+	FPXRFrameTiming& Timing = FPXRFrameTiming::Get();
+	FPXRPoseCache& PoseCache = FPXRPoseCache::Get();
+
+	TArray<double> StageSeconds[(int32)EStage::Count];
+	for (TArray<double>& Seconds : StageSeconds)
+	{
+		Seconds.Reserve(NumFrames);
+	}
+
+	PxrEventDataBuffer* EventData[PXR_MAX_EVENT_COUNT];
+	float HeadSensorData[7] = {};
+	float BlendShapeWeights[BLEND_SHAPE_NUMS] = {};
+
+	for (int32 FrameIndex = 0; FrameIndex < NumFrames; FrameIndex++)
+	{
+		// The pose cache is keyed on the engine frame, which only the engine loop advances otherwise
+		GFrameCounter++;
+		const uint32 FrameNumber = (uint32)GFrameCounter;
+		double StageStart[(int32)EStage::Count];
+
+		Timing.Mark(FrameNumber, EPXRFrameStage::GameFrameBegin);
+		Timing.Mark(FrameNumber, EPXRFrameStage::WaitFrameBegin);
+		Wrapper.WaitFrame();
+		Timing.Mark(FrameNumber, EPXRFrameStage::WaitFrameEnd);
+		StageStart[(int32)EStage::Frame] = FPlatformTime::Seconds();
+
+		StageStart[(int32)EStage::Prediction] = FPlatformTime::Seconds();
+		double DisplayTimeMs = 0.0;
+		for (int32 Reader = 0; Reader < NumReaders; Reader++)
+		{
+			PxrSensorState2 SensorState = {};
+			int SensorFrameIndex = 0;
+			if (bUsePoseCache)
+			{
+				PoseCache.GetPredictedDisplayTime(&DisplayTimeMs);
+				PoseCache.GetPredictedMainSensorState2(DisplayTimeMs, &SensorState, &SensorFrameIndex);
+			}
+			else
+			{
+				Wrapper.GetPredictedDisplayTime(&DisplayTimeMs);
+				Wrapper.GetPredictedMainSensorState2(DisplayTimeMs, &SensorState, &SensorFrameIndex);
+			}
+		}
+		Timing.Mark(FrameNumber, EPXRFrameStage::PoseSampled);
+		StageSeconds[(int32)EStage::Prediction].Add(FPlatformTime::Seconds() - StageStart[(int32)EStage::Prediction]);
+
+		StageStart[(int32)EStage::Events] = FPlatformTime::Seconds();
+		int EventCount = 0;
+		Wrapper.PollEvent(PXR_MAX_EVENT_COUNT, &EventCount, EventData);
+		StageSeconds[(int32)EStage::Events].Add(FPlatformTime::Seconds() - StageStart[(int32)EStage::Events]);
+
+		StageStart[(int32)EStage::Input] = FPlatformTime::Seconds();
+		for (uint32 Device = 0; Device < 2; Device++)
+		{
+			if (Wrapper.GetControllerConnectStatus(Device) != 0)
+			{
+				PxrControllerTracking Tracking = {};
+				PxrControllerInputState InputState = {};
+				Wrapper.GetControllerTrackingState(Device, DisplayTimeMs, HeadSensorData, &Tracking);
+				Wrapper.GetControllerInputState(Device, &InputState);
+			}
+			PxrHandJointsLocations JointLocations = {};
+			PxrHandAimState AimState = {};
+			Wrapper.GetHandTrackerJointLocations(Device, &JointLocations);
+			Wrapper.GetHandTrackerAimState(Device, &AimState);
+		}
+		StageSeconds[(int32)EStage::Input].Add(FPlatformTime::Seconds() - StageStart[(int32)EStage::Input]);
+
+		StageStart[(int32)EStage::Tracking] = FPlatformTime::Seconds();
+		{
+			PxrEyeTrackingDataGetInfo EyeInfo = {};
+			PxrEyeTrackingData1 EyeData = {};
+			Wrapper.GetEyeTrackingData1(&EyeInfo, &EyeData);
+
+			PxrFaceTrackingDataGetInfo FaceInfo = {};
+			PxrFaceTrackingData FaceData = {};
+			FaceData.blendShapeWeight = BlendShapeWeights;
+			Wrapper.GetFaceTrackingData1(&FaceInfo, &FaceData);
+
+			PxrBodyTrackingGetDataInfo BodyInfo = {};
+			PxrBodyTrackingData BodyData = {};
+			Wrapper.GetBodyTrackingData(&BodyInfo, &BodyData);
+
+			for (TArray<ANSICHAR>& SN : TrackerSNs)
+			{
+				PxrMotionTrackerLocations Locations = {};
+				Wrapper.GetMotionTrackerLocations(DisplayTimeMs, SN.GetData(), &Locations);
+			}
+		}
+		StageSeconds[(int32)EStage::Tracking].Add(FPlatformTime::Seconds() - StageStart[(int32)EStage::Tracking]);
+		StageSeconds[(int32)EStage::Frame].Add(FPlatformTime::Seconds() - StageStart[(int32)EStage::Frame]);
+
+		// No renderer runs headless; the remaining stages close the frame so that frame intervals and missed frames
+		// follow the trace time
+		Timing.Mark(FrameNumber, EPXRFrameStage::RenderFrameBegin);
+		Timing.Mark(FrameNumber, EPXRFrameStage::BeginRendering);
+		Timing.Mark(FrameNumber, EPXRFrameStage::RHIBeginFrame);
+		Timing.Mark(FrameNumber, EPXRFrameStage::RHIEndFrame);
+		Timing.Update_GameThread(RefreshRate);
+	}
+
+	UE_LOG(LogPICOPluginWrapper, Display, TEXT("Replayed %d frames of %s (speed %.2f, %d prediction readers, pose cache %s)"),
+		NumFrames, *TracePath, Speed, NumReaders, bUsePoseCache ? TEXT("on") : TEXT("off"));
+	for (int32 Stage = 0; Stage < (int32)EStage::Count; Stage++)
+	{
+		TArray<double>& Seconds = StageSeconds[Stage];
+		UE_LOG(LogPICOPluginWrapper, Display, TEXT("  %-10s p50 %8.2f us  p95 %8.2f us  p99 %8.2f us  max %8.2f us"), StageNames[Stage],
+			GetPercentileUs(Seconds, 0.5), GetPercentileUs(Seconds, 0.95), GetPercentileUs(Seconds, 0.99), GetPercentileUs(Seconds, 1.0));
+	}
+
+	TArray<TPair<FString, uint64>> CallCounts;
+	FPXRPluginTrace::GetReplayCallCounts(CallCounts);
+	uint64 TotalCalls = 0;
+	for (const TPair<FString, uint64>& Count : CallCounts)
+	{
+		if (Count.Value > 0)
+		{
+			UE_LOG(LogPICOPluginWrapper, Display, TEXT("  %-30s %6.2f calls/frame"), *Count.Key, (double)Count.Value / NumFrames);
+			TotalCalls += Count.Value;
+		}
+	}
+	UE_LOG(LogPICOPluginWrapper, Display, TEXT("  %-30s %6.2f calls/frame"), TEXT("Total"), (double)TotalCalls / NumFrames);
+
+	Timing.LogSummary();
+	FString CSVPath;
+	if (FParse::Value(*Params, TEXT("CSV="), CSVPath) && !Timing.ExportCSV(CSVPath))
+	{
+		return 1;
+	}
+	return 0;
+#else
+	UE_LOG(LogTemp, Error, TEXT("PXRTraceBenchmark: the PICO runtime is not supported on this platform"));
+	return 1;
+#endif //PICO_HMD_SUPPORTED_PLATFORMS
+}
@@ -0,0 +1,30 @@
+// Copyright PICO Technology Co., Ltd. All rights reserved.
+// This plugin incorporates portions of the Unreal® Engine. Unreal® is a trademark or registered trademark of Epic Games, Inc. in the United States of America and elsewhere.
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "PXR_TraceBenchmarkCommandlet.generated.h"
+
+/**
+ * Replays a trace recorded with pico.Trace.Record headless and times the per-frame runtime queries of the HMD, input
+ * and tracking update loops against it: WaitFrame, the prediction readers, PollEvent, controllers and hands, then
+ * eye, face, body and motion trackers. Reports per-stage percentiles, runtime calls per frame and the frame timing
+ * summary.
+ *
+ * Usage: UnrealEditor-Cmd <Project> -run=PXRTraceBenchmark -Trace=<File> [-Frames=1000] [-Speed=0] [-RefreshRate=72]
+ *        [-Readers=4] [-TrackerSN=<SN>,<SN>] [-NoPoseCache] [-CSV=<File>]
+ * -Readers is the number of prediction readers per frame; -NoPoseCache sends them to the runtime directly instead of
+ * through FPXRPoseCache, for a before/after comparison of the calls per frame. Motion trackers are keyed by serial
+ * number in the trace, so they are only queried for the serial numbers given in -TrackerSN.
+ */
+UCLASS()
+class UPXRTraceBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+public:
+	UPXRTraceBenchmarkCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,90 @@
+// Copyright PICO Technology Co., Ltd. All rights reserved.
+// This plugin incorporates portions of the Unreal® Engine. Unreal® is a trademark or registered trademark of Epic Games, Inc. in the United States of America and elsewhere.
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+#include "CoreMinimal.h"
+#include "HAL/MemoryBase.h"
+#include "HAL/PlatformTLS.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+// Counts heap allocations made on the calling thread while in scope, for the "no allocation in steady state" checks.
+// GMalloc is replaced by a proxy that forwards every call to the allocator it replaced, so memory may be freed on
+// either side of the scope. Allocations from other threads are forwarded without being counted.
+class FPXRScopedAllocationCounter : public FMalloc
+{
+public:
+	FPXRScopedAllocationCounter()
+		: Inner(GMalloc)
+		, ThreadId(FPlatformTLS::GetCurrentThreadId())
+		, NumAllocations(0)
+	{
+		GMalloc = this;
+	}
+
+	virtual ~FPXRScopedAllocationCounter()
+	{
+		GMalloc = Inner;
+	}
+
+	int64 GetNumAllocations() const { return NumAllocations; }
+
+	virtual void* Malloc(SIZE_T Count, uint32 Alignment) override
+	{
+		CountAllocation();
+		return Inner->Malloc(Count, Alignment);
+	}
+
+	virtual void* TryMalloc(SIZE_T Count, uint32 Alignment) override
+	{
+		CountAllocation();
+		return Inner->TryMalloc(Count, Alignment);
+	}
+
+	virtual void* Realloc(void* Original, SIZE_T Count, uint32 Alignment) override
+	{
+		if (Count > 0)
+		{
+			CountAllocation();
+		}
+		return Inner->Realloc(Original, Count, Alignment);
+	}
+
+	virtual void* TryRealloc(void* Original, SIZE_T Count, uint32 Alignment) override
+	{
+		if (Count > 0)
+		{
+			CountAllocation();
+		}
+		return Inner->TryRealloc(Original, Count, Alignment);
+	}
+
+	virtual void Free(void* Original) override { Inner->Free(Original); }
+	virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override { return Inner->QuantizeSize(Count, Alignment); }
+	virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override { return Inner->GetAllocationSize(Original, SizeOut); }
+	virtual void Trim(bool bTrimThreadCaches) override { Inner->Trim(bTrimThreadCaches); }
+	virtual void SetupTLSCachesOnCurrentThread() override { Inner->SetupTLSCachesOnCurrentThread(); }
+	virtual void ClearAndDisableTLSCachesOnCurrentThread() override { Inner->ClearAndDisableTLSCachesOnCurrentThread(); }
+	virtual void UpdateStats() override { Inner->UpdateStats(); }
+	virtual void GetAllocatorStats(FGenericMemoryStats& OutStats) override { Inner->GetAllocatorStats(OutStats); }
+	virtual void DumpAllocatorStats(FOutputDevice& Ar) override { Inner->DumpAllocatorStats(Ar); }
+	virtual bool IsInternallyThreadSafe() const override { return Inner->IsInternallyThreadSafe(); }
+	virtual bool ValidateHeap() override { return Inner->ValidateHeap(); }
+	virtual const TCHAR* GetDescriptiveName() override { return Inner->GetDescriptiveName(); }
+
+private:
+	void CountAllocation()
+	{
+		if (FPlatformTLS::GetCurrentThreadId() == ThreadId)
+		{
+			NumAllocations++;
+		}
+	}
+
+	FMalloc* Inner;
+	uint32 ThreadId;
+	int64 NumAllocations;
+};
+
+#endif
@@ -0,0 +1,151 @@
+// Copyright PICO Technology Co., Ltd. All rights reserved.
+// This plugin incorporates portions of the Unreal® Engine. Unreal® is a trademark or registered trademark of Epic Games, Inc. in the United States of America and elsewhere.
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Misc/AutomationTest.h"
+#include "Algo/Reverse.h"
+#include "Math/RandomStream.h"
+#include "PXR_BoundaryGeometry.h"
+#include "PXR_HMDFunctionLibrary.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace PXRBoundaryGeometryTest
+{
+	// Star shaped polygon around Center, enough edges for a tree several levels deep
+	static TArray<FVector> MakeStarPolygon(FRandomStream& Random, const FVector& Center, int32 NumPoints)
+	{
+		TArray<FVector> Points;
+		for (int32 I = 0; I < NumPoints; I++)
+		{
+			const double Angle = 2.0 * UE_DOUBLE_PI * I / NumPoints;
+			const double Radius = Random.FRandRange(150.0f, 250.0f);
+			Points.Add(Center + FVector(FMath::Cos(Angle) * Radius, FMath::Sin(Angle) * Radius, 0.0));
+		}
+		return Points;
+	}
+
+	// Reference answers, testing every edge
+	static double GetBruteForceDistance(const TArray<FVector>& Points, const FVector& Point)
+	{
+		double BestDistance = MAX_dbl;
+		for (int32 I = 0; I < Points.Num(); I++)
+		{
+			const FVector2D A(Points[I]);
+			const FVector2D B(Points[(I + 1) % Points.Num()]);
+			const FVector2D P(Point);
+			const FVector2D AB = B - A;
+			const double T = FMath::Clamp(FVector2D::DotProduct(P - A, AB) / AB.SizeSquared(), 0.0, 1.0);
+			BestDistance = FMath::Min(BestDistance, FVector2D::Distance(A + AB * T, P));
+		}
+		return BestDistance;
+	}
+
+	static bool IsInsideBruteForce(const TArray<FVector>& Points, const FVector& Point)
+	{
+		bool bInside = false;
+		for (int32 I = 0; I < Points.Num(); I++)
+		{
+			const FVector& A = Points[I];
+			const FVector& B = Points[(I + 1) % Points.Num()];
+			if ((A.Y > Point.Y) != (B.Y > Point.Y) && Point.X < A.X + (Point.Y - A.Y) * (B.X - A.X) / (B.Y - A.Y))
+			{
+				bInside = !bInside;
+			}
+		}
+		return bInside;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPXRBoundaryGeometrySquareTest, "PICOXR.BoundaryGeometry.Square",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FPXRBoundaryGeometrySquareTest::RunTest(const FString& Parameters)
+{
+	// Same square in both windings, the normal must point inwards either way
+	const TArray<FVector> CounterClockwise = { FVector(-100, -100, 0), FVector(100, -100, 0), FVector(100, 100, 0), FVector(-100, 100, 0) };
+	TArray<FVector> Clockwise = CounterClockwise;
+	Algo::Reverse(Clockwise);
+
+	for (const TArray<FVector>& Points : { CounterClockwise, Clockwise })
+	{
+		FPXRBoundaryGeometry Geometry;
+		Geometry.Build(TArray<FVector>(Points));
+		TestTrue(TEXT("Valid"), Geometry.IsValid());
+		TestTrue(TEXT("Center inside"), Geometry.IsInside(FVector(0, 0, 50)));
+		TestFalse(TEXT("Outside"), Geometry.IsInside(FVector(150, 0, 0)));
+
+		FVector ClosestPoint;
+		FVector Normal;
+		TestEqual(TEXT("Distance"), Geometry.GetClosestPoint(FVector(90, 10, 30), ClosestPoint, Normal), 10.0f, 1e-3f);
+		TestEqual(TEXT("Closest point"), ClosestPoint, FVector(100, 10, 0), 1e-3f);
+		TestEqual(TEXT("Normal"), Normal, FVector(-1, 0, 0), 1e-4f);
+
+		TestEqual(TEXT("Distance outside"), Geometry.GetClosestPoint(FVector(-130, 0, 0), ClosestPoint, Normal), 30.0f, 1e-3f);
+		TestEqual(TEXT("Normal outside"), Normal, FVector(1, 0, 0), 1e-4f);
+	}
+
+	// Fewer than three points is no boundary
+	FPXRBoundaryGeometry Geometry;
+	Geometry.Build({ FVector(0, 0, 0), FVector(100, 0, 0) });
+	TestFalse(TEXT("Two points"), Geometry.IsValid());
+	TestFalse(TEXT("Two points inside"), Geometry.IsInside(FVector::ZeroVector));
+	TArray<FPICOXRBoundaryTestResult> Results;
+	Results.SetNum(1);
+	const FVector Center = FVector::ZeroVector;
+	TestFalse(TEXT("Two points spheres"), Geometry.TestSpheres(MakeArrayView(&Center, 1), 10.0f, Results));
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPXRBoundaryGeometryBruteForceTest, "PICOXR.BoundaryGeometry.BruteForce",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FPXRBoundaryGeometryBruteForceTest::RunTest(const FString& Parameters)
+{
+	using namespace PXRBoundaryGeometryTest;
+
+	FRandomStream Random(0x50494330);
+	const TArray<FVector> Points = MakeStarPolygon(Random, FVector(30, -40, 0), 257);
+	FPXRBoundaryGeometry Geometry;
+	Geometry.Build(TArray<FVector>(Points));
+
+	TArray<FVector> Centers;
+	for (int32 I = 0; I < 2000; I++)
+	{
+		Centers.Add(FVector(Random.FRandRange(-350.0f, 350.0f), Random.FRandRange(-350.0f, 350.0f), Random.FRandRange(0.0f, 200.0f)));
+	}
+
+	const float Radius = 25.0f;
+	TArray<FPICOXRBoundaryTestResult> Results;
+	Results.SetNum(Centers.Num());
+	if (!TestTrue(TEXT("TestSpheres"), Geometry.TestSpheres(Centers, Radius, Results)))
+	{
+		return false;
+	}
+
+	for (int32 I = 0; I < Centers.Num(); I++)
+	{
+		const FVector& Center = Centers[I];
+		const FPICOXRBoundaryTestResult& Result = Results[I];
+		const double Distance = GetBruteForceDistance(Points, Center);
+
+		bool bMatches = TestEqual(TEXT("Closest distance"), (double)Result.ClosestDistance, Distance, 1e-2);
+		bMatches &= TestEqual(TEXT("Closest point distance"), FVector::Dist2D(Result.ClosestPoint, Center), Distance, 1e-2);
+		bMatches &= TestEqual(TEXT("Normal length"), Result.ClosestPointNormal.Size(), 1.0, 1e-4);
+		// Points on an edge, or a radius away from it, can go either way in float
+		if (Distance > 1e-2 && FMath::Abs(Distance - Radius) > 1e-2)
+		{
+			const bool bInside = IsInsideBruteForce(Points, Center);
+			bMatches &= TestEqual(TEXT("Inside"), Result.IsInside, bInside);
+			bMatches &= TestEqual(TEXT("Triggering"), Result.IsTriggering, !bInside || Distance <= Radius);
+		}
+		if (!bMatches)
+		{
+			AddInfo(FString::Printf(TEXT("Center %s"), *Center.ToString()));
+			return false;
+		}
+	}
+	return true;
+}
+
+#endif
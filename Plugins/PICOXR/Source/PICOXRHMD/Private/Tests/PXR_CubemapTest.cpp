@@ -0,0 +1,305 @@
+// Copyright PICO Technology Co., Ltd. All rights reserved.
+// This plugin incorporates portions of the Unreal® Engine. Unreal® is a trademark or registered trademark of Epic Games, Inc. in the United States of America and elsewhere.
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Misc/AutomationTest.h"
+#include "Tests/AutomationCommon.h"
+#include "PXR_Cubemap.h"
+#include "PXR_CubemapCapture.h"
+#include "IImageWrapper.h"
+#include "IImageWrapperModule.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeExit.h"
+#include "Modules/ModuleManager.h"
+#include "RenderingThread.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace PXRCubemapTest
+{
+	constexpr int32 Resolution = 4;
+	// Longest game thread call of a capture allowed: one frame at 72 Hz
+	constexpr double StallBudgetSeconds = 1.0 / 72.0;
+	constexpr double TimeoutSeconds = 30.0;
+
+	// Synthetic render target contents: red is the face, green the column and blue the row, with a translucent alpha
+	// that the stitching has to make opaque. All values are exact in 8 bit, 16 bit and half float.
+	static FLinearColor GetFaceColor(int32 Face, int32 X, int32 Y)
+	{
+		return FLinearColor((Face + 1) / 8.0f, (X + 1) / 8.0f, (Y + 1) / 8.0f, 0.25f);
+	}
+
+	static void WritePixel(EPixelFormat Format, const FLinearColor& Color, uint8* Pixel)
+	{
+		switch (Format)
+		{
+		case PF_B8G8R8A8:
+			*(FColor*)Pixel = Color.QuantizeRound();
+			break;
+		case PF_R8G8B8A8:
+		{
+			const FColor Quantized = Color.QuantizeRound();
+			Pixel[0] = Quantized.R;
+			Pixel[1] = Quantized.G;
+			Pixel[2] = Quantized.B;
+			Pixel[3] = Quantized.A;
+			break;
+		}
+		case PF_A16B16G16R16:
+		{
+			uint16* Value = (uint16*)Pixel;
+			Value[0] = (uint16)FMath::RoundToInt(Color.R * 65535.0f);
+			Value[1] = (uint16)FMath::RoundToInt(Color.G * 65535.0f);
+			Value[2] = (uint16)FMath::RoundToInt(Color.B * 65535.0f);
+			Value[3] = (uint16)FMath::RoundToInt(Color.A * 65535.0f);
+			break;
+		}
+		default:
+			*(FFloat16Color*)Pixel = FFloat16Color(Color);
+			break;
+		}
+	}
+
+	static void FillFaces(FPXRCubemapCapture& Capture)
+	{
+		const int32 BytesPerPixel = GPixelFormats[Capture.Format].BlockBytes;
+		for (int32 Face = 0; Face < CubemapFaceCount; Face++)
+		{
+			Capture.Faces[Face].SetNumZeroed(Resolution * Resolution * BytesPerPixel);
+			for (int32 Y = 0; Y < Resolution; Y++)
+			{
+				for (int32 X = 0; X < Resolution; X++)
+				{
+					WritePixel(Capture.Format, GetFaceColor(Face, X, Y), Capture.Faces[Face].GetData() + (Y * Resolution + X) * BytesPerPixel);
+				}
+			}
+		}
+	}
+
+	static bool GetImageSize(const FString& Filename, EImageFormat ImageFormat, int64& OutWidth, int64& OutHeight)
+	{
+		IImageWrapperModule& ImageWrapperModule = FModuleManager::LoadModuleChecked<IImageWrapperModule>(FName("ImageWrapper"));
+		TSharedPtr<IImageWrapper> ImageWrapper = ImageWrapperModule.CreateImageWrapper(ImageFormat);
+		TArray64<uint8> Compressed;
+		if (!ImageWrapper.IsValid() || !FFileHelper::LoadFileToArray(Compressed, *Filename) || !ImageWrapper->SetCompressed(Compressed.GetData(), Compressed.Num()))
+		{
+			return false;
+		}
+		OutWidth = ImageWrapper->GetWidth();
+		OutHeight = ImageWrapper->GetHeight();
+		return true;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPXRCubemapLayoutTest, "PICOXR.Cubemap.Layout",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FPXRCubemapLayoutTest::RunTest(const FString& Parameters)
+{
+	using namespace PXRCubemapTest;
+
+	const EPixelFormat Formats[] = { PF_B8G8R8A8, PF_R8G8B8A8, PF_A16B16G16R16, PF_FloatRGBA };
+	const int32 Stride = Resolution * CubemapFaceCount;
+	for (EPixelFormat Format : Formats)
+	{
+		const FString FormatName = GetPixelFormatString(Format);
+		TestTrue(*FString::Printf(TEXT("%s supported"), *FormatName), IsSupportedCubemapFormat(Format));
+
+		FPXRCubemapCapture Capture;
+		Capture.Resolution = Resolution;
+		Capture.Format = Format;
+		FillFaces(Capture);
+
+		// The EXR strip holds the same linear values whatever the capture format
+		TArray64<FFloat16Color> LinearStrip;
+		StitchCubemapFaces(Capture, LinearStrip);
+		int32 NumWrong = 0;
+		if (TestEqual(*FString::Printf(TEXT("%s EXR strip size"), *FormatName), LinearStrip.Num(), (int64)Stride * Resolution))
+		{
+			for (int32 Face = 0; Face < CubemapFaceCount; Face++)
+			{
+				for (int32 Y = 0; Y < Resolution; Y++)
+				{
+					for (int32 X = 0; X < Resolution; X++)
+					{
+						FLinearColor Expected = GetFaceColor(Face, X, Y);
+						Expected.A = 1.0f;
+						const FLinearColor Actual(LinearStrip[(int64)Y * Stride + Face * Resolution + X]);
+						NumWrong += Actual.Equals(Expected, 1.0f / 255.0f) ? 0 : 1;
+					}
+				}
+			}
+		}
+		TestEqual(*FString::Printf(TEXT("%s EXR pixels out of place"), *FormatName), NumWrong, 0);
+
+		// The PNG strip of an 8 bit capture holds the bytes read back
+		if (GPixelFormats[Format].BlockBytes == 4)
+		{
+			TArray64<FColor> ColorStrip;
+			StitchCubemapFaces(Capture, ColorStrip);
+			NumWrong = 0;
+			for (int32 Face = 0; Face < CubemapFaceCount; Face++)
+			{
+				for (int32 Y = 0; Y < Resolution; Y++)
+				{
+					for (int32 X = 0; X < Resolution; X++)
+					{
+						FColor Expected = GetFaceColor(Face, X, Y).QuantizeRound();
+						Expected.A = 255;
+						NumWrong += ColorStrip[(int64)Y * Stride + Face * Resolution + X] == Expected ? 0 : 1;
+					}
+				}
+			}
+			TestEqual(*FString::Printf(TEXT("%s PNG pixels out of place"), *FormatName), NumWrong, 0);
+		}
+	}
+	TestFalse(TEXT("depth format not supported"), IsSupportedCubemapFormat(PF_DepthStencil));
+
+	// Encoded files are one 6N x N image
+	IImageWrapperModule& ImageWrapperModule = FModuleManager::LoadModuleChecked<IImageWrapperModule>(FName("ImageWrapper"));
+	for (bool bEXR : { false, true })
+	{
+		const EImageFormat ImageFormat = bEXR ? EImageFormat::EXR : EImageFormat::PNG;
+		if (!ImageWrapperModule.CreateImageWrapper(ImageFormat).IsValid())
+		{
+			AddInfo(FString::Printf(TEXT("No %s encoder on this platform"), bEXR ? TEXT("EXR") : TEXT("PNG")));
+			continue;
+		}
+
+		FPXRCubemapCapture Capture;
+		Capture.Filename = FPaths::CreateTempFilename(*FPaths::ProjectSavedDir(), TEXT("PICOCubemapTest"), bEXR ? TEXT(".exr") : TEXT(".png"));
+		Capture.Resolution = Resolution;
+		Capture.Format = PF_FloatRGBA;
+		Capture.bEXR = bEXR;
+		Capture.ImageWrapperModule = &ImageWrapperModule;
+		FillFaces(Capture);
+		ON_SCOPE_EXIT
+		{
+			IFileManager::Get().Delete(*Capture.Filename);
+		};
+
+		int64 Width = 0;
+		int64 Height = 0;
+		if (TestTrue(TEXT("encoded"), EncodeCubemap(Capture)) && TestTrue(TEXT("decoded"), GetImageSize(Capture.Filename, ImageFormat, Width, Height)))
+		{
+			TestEqual(TEXT("width"), Width, (int64)Stride);
+			TestEqual(TEXT("height"), Height, (int64)Resolution);
+		}
+		TestEqual(TEXT("faces freed"), Capture.Faces[0].Num(), 0);
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPXRCubemapCaptureTest, "PICOXR.Cubemap.Capture",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FPXRCubemapCaptureTest::RunTest(const FString& Parameters)
+{
+	using namespace PXRCubemapTest;
+
+	// A transient world ticked by the test, so that it also runs headless with -nullrhi, where the readbacks return
+	// blank faces. The first capture creates the capture components and targets, the second one reuses them.
+	struct FState
+	{
+		UWorld* World = nullptr;
+		APXR_Cubemap* Cubemap = nullptr;
+		TArray<double> CaptureSeconds;
+		double MaxTickSeconds = 0.0;
+		double Deadline = 0.0;
+		TSet<FString> ExistingFiles;
+	};
+	TSharedRef<FState> State = MakeShared<FState>();
+
+	State->World = UWorld::CreateWorld(EWorldType::Game, false);
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(State->World);
+	State->World->InitializeActorsForPlay(FURL());
+	State->World->BeginPlay();
+
+	State->Cubemap = State->World->SpawnActor<APXR_Cubemap>();
+	if (!TestNotNull(TEXT("cubemap actor"), State->Cubemap))
+	{
+		GEngine->DestroyWorldContext(State->World);
+		State->World->DestroyWorld(false);
+		return false;
+	}
+	State->Cubemap->CaptureBoxSideRes = 64;
+	State->Cubemap->CaptureFormat = PF_B8G8R8A8;
+
+	TArray<FString> Files;
+	IFileManager::Get().FindFiles(Files, *(FPaths::ProjectSavedDir() / TEXT("Cubemaps")), TEXT("png"));
+	State->ExistingFiles.Append(Files);
+
+	auto StartCapture = [this, State]()
+	{
+		const double Start = FPlatformTime::Seconds();
+		TestTrue(TEXT("capture started"), State->Cubemap->SaveCubeMap_PICO());
+		State->CaptureSeconds.Add(FPlatformTime::Seconds() - Start);
+		State->Deadline = FPlatformTime::Seconds() + TimeoutSeconds;
+	};
+	StartCapture();
+
+	ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([this, State, StartCapture]()
+		{
+			const double Start = FPlatformTime::Seconds();
+			State->World->Tick(LEVELTICK_All, StallBudgetSeconds);
+			State->MaxTickSeconds = FMath::Max(State->MaxTickSeconds, FPlatformTime::Seconds() - Start);
+			FlushRenderingCommands();
+
+			if (State->Cubemap->IsCapturing())
+			{
+				if (FPlatformTime::Seconds() < State->Deadline)
+				{
+					return false;
+				}
+				AddError(TEXT("Capture timed out"));
+			}
+			else
+			{
+				TestTrue(TEXT("saved"), State->Cubemap->isCatchImageWP);
+				if (State->CaptureSeconds.Num() < 2)
+				{
+					StartCapture();
+					return false;
+				}
+			}
+
+			// The captures were saved within the same second, so they may share a file name
+			TArray<FString> Files;
+			const FString OutputDir = FPaths::ProjectSavedDir() / TEXT("Cubemaps");
+			IFileManager::Get().FindFiles(Files, *OutputDir, TEXT("png"));
+			int32 NumNewFiles = 0;
+			for (const FString& File : Files)
+			{
+				if (State->ExistingFiles.Contains(File))
+				{
+					continue;
+				}
+				NumNewFiles++;
+				int64 Width = 0;
+				int64 Height = 0;
+				if (TestTrue(TEXT("decoded"), GetImageSize(OutputDir / File, EImageFormat::PNG, Width, Height)))
+				{
+					TestEqual(TEXT("width"), Width, (int64)State->Cubemap->CaptureBoxSideRes * CubemapFaceCount);
+					TestEqual(TEXT("height"), Height, (int64)State->Cubemap->CaptureBoxSideRes);
+				}
+				IFileManager::Get().Delete(*(OutputDir / File));
+			}
+			TestTrue(TEXT("files saved"), NumNewFiles > 0);
+
+			AddInfo(FString::Printf(TEXT("Game thread: first capture %.3f ms, reused capture %.3f ms, longest world tick %.3f ms"),
+				State->CaptureSeconds[0] * 1000.0, State->CaptureSeconds.Last() * 1000.0, State->MaxTickSeconds * 1000.0));
+			TestTrue(TEXT("reused capture within a frame"), State->CaptureSeconds.Last() < StallBudgetSeconds);
+
+			GEngine->DestroyWorldContext(State->World);
+			State->World->DestroyWorld(false);
+			return true;
+		}));
+	return true;
+}
+
+#endif
@@ -0,0 +1,431 @@
+// Copyright PICO Technology Co., Ltd. All rights reserved.
+// This plugin incorporates portions of the Unreal® Engine. Unreal® is a trademark or registered trademark of Epic Games, Inc. in the United States of America and elsewhere.
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Misc/AutomationTest.h"
+#include "PXR_DelayDeleteLayer.h"
+#include "PXR_AllocationCounter.h"
+#include "HAL/IConsoleManager.h"
+#include "RenderingThread.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace PXRDelayDeleteLayerTest
+{
+	constexpr int32 LayerWait = 3;
+	constexpr int32 PxrLayerWait = 7;
+	constexpr int32 PooledLayerFrames = 90;
+
+	// Game thread layer with a native layer that is not backed by the runtime; destroying the native layer queues its
+	// deletion like a created one does
+	class FTestLayer : public FPICOXRStereoLayer
+	{
+	public:
+		FTestLayer(uint32 InID)
+			: FPICOXRStereoLayer(nullptr, InID, MakeDesc(InID))
+		{
+		}
+
+		void CreateNativeLayer(FDelayDeleteLayerManager& Manager, uint32 InPxrLayerId)
+		{
+			PxrLayer = MakeShareable(new FPxrLayer(GetID(), InPxrLayerId, &Manager));
+		}
+
+		// What InitPXRLayer_RenderThread does with a pooled layer
+		void TakeNativeLayer(FTestLayer& From)
+		{
+			PxrLayer = MoveTemp(From.PxrLayer);
+		}
+
+		TWeakPtr<FPxrLayer, ESPMode::ThreadSafe> GetNativeLayer() const { return PxrLayer; }
+
+	private:
+		static IStereoLayers::FLayerDesc MakeDesc(uint32 InID)
+		{
+			IStereoLayers::FLayerDesc Desc;
+			Desc.Id = InID;
+			return Desc;
+		}
+	};
+
+	typedef TSharedPtr<FTestLayer, ESPMode::ThreadSafe> FTestLayerPtr;
+	typedef TWeakPtr<FPICOXRStereoLayer, ESPMode::ThreadSafe> FWeakLayerPtr;
+
+	static FTestLayerPtr MakeLayer(uint32 ID, FDelayDeleteLayerManager* Manager = nullptr)
+	{
+		FTestLayerPtr Layer = MakeShareable(new FTestLayer(ID));
+		if (Manager)
+		{
+			Layer->CreateNativeLayer(*Manager, 1000 + ID);
+		}
+		return Layer;
+	}
+
+	// The manager is only used on the render thread; the game thread waits until Function has run
+	static void RunOnRenderThread(TUniqueFunction<void()> Function)
+	{
+		ENQUEUE_RENDER_COMMAND(PXRDelayDeleteLayerTest)([Function = MoveTemp(Function)](FRHICommandListImmediate&)
+			{
+				Function();
+			});
+		FlushRenderingCommands();
+	}
+
+	// Sets the render thread value of an integer console variable until the end of the scope
+	class FScopedCVar
+	{
+	public:
+		FScopedCVar(const TCHAR* Name, int32 Value)
+			: CVar(IConsoleManager::Get().FindConsoleVariable(Name))
+			, OldValue(CVar ? CVar->GetInt() : 0)
+		{
+			Set(Value);
+		}
+
+		~FScopedCVar()
+		{
+			Set(OldValue);
+		}
+
+		void Set(int32 Value)
+		{
+			if (CVar)
+			{
+				CVar->Set(Value, ECVF_SetByCode);
+				// The render thread copy is updated by a render command
+				FlushRenderingCommands();
+			}
+		}
+
+	private:
+		IConsoleVariable* CVar;
+		int32 OldValue;
+	};
+
+	// Handle call index at which each layer was destroyed, INDEX_NONE while alive
+	static void RecordDestroyed(const TArray<FWeakLayerPtr>& Layers, TArray<int32>& DestroyedAt, int32 Frame)
+	{
+		while (DestroyedAt.Num() < Layers.Num())
+		{
+			DestroyedAt.Add(INDEX_NONE);
+		}
+		for (int32 Index = 0; Index < Layers.Num(); Index++)
+		{
+			if (DestroyedAt[Index] == INDEX_NONE && !Layers[Index].IsValid())
+			{
+				DestroyedAt[Index] = Frame;
+			}
+		}
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPXRDelayDeleteLayerWaitTest, "PICOXR.DelayDeleteLayer.Wait",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FPXRDelayDeleteLayerWaitTest::RunTest(const FString& Parameters)
+{
+	using namespace PXRDelayDeleteLayerTest;
+
+	FScopedCVar MaxDestroys(TEXT("pico.Layers.MaxDestroysPerFrame"), 0);
+	FScopedCVar PoolSize(TEXT("pico.Layers.PoolSize"), 0);
+
+	// A stereo layer and a native layer are queued before each frame, for longer than the ring of buckets
+	RunOnRenderThread([this]()
+		{
+			FDelayDeleteLayerManager Manager;
+			const int32 NumFrames = 40;
+			TArray<FWeakLayerPtr> Layers;
+			TArray<int32> DestroyedAt;
+			for (int32 Frame = 0; Frame < NumFrames; Frame++)
+			{
+				FTestLayerPtr Layer = MakeLayer(Frame + 1);
+				Layers.Add(Layer);
+				Manager.AddLayerToDeferredDeletionQueue(Layer);
+				Manager.AddPxrLayerToDeferredDeletionQueue(Frame + 1, 1000 + Frame);
+				Layer.Reset();
+
+				Manager.HandleLayerDeferredDeletionQueue_RenderThread();
+				RecordDestroyed(Layers, DestroyedAt, Frame);
+
+				// Entries are handled once more than their wait has passed
+				const int32 Expected = FMath::Min(Frame + 1, LayerWait + 1) + FMath::Min(Frame + 1, PxrLayerWait + 1);
+				if (Manager.GetNumQueuedEntries() != Expected)
+				{
+					AddError(FString::Printf(TEXT("Frame %d: %d entries queued, expected %d"), Frame, Manager.GetNumQueuedEntries(), Expected));
+				}
+			}
+
+			for (int32 Index = 0; Index < NumFrames - LayerWait - 1; Index++)
+			{
+				if (DestroyedAt[Index] != Index + LayerWait + 1)
+				{
+					AddError(FString::Printf(TEXT("Layer queued at frame %d destroyed at frame %d"), Index, DestroyedAt[Index]));
+				}
+			}
+			Manager.HandleLayerDeferredDeletionQueue_RenderThread(true);
+			TestEqual(TEXT("drained"), Manager.GetNumQueuedEntries(), 0);
+		});
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPXRDelayDeleteLayerBudgetTest, "PICOXR.DelayDeleteLayer.Budget",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FPXRDelayDeleteLayerBudgetTest::RunTest(const FString& Parameters)
+{
+	using namespace PXRDelayDeleteLayerTest;
+
+	FScopedCVar MaxDestroys(TEXT("pico.Layers.MaxDestroysPerFrame"), 2);
+	FScopedCVar PoolSize(TEXT("pico.Layers.PoolSize"), 0);
+
+	RunOnRenderThread([this]()
+		{
+			FDelayDeleteLayerManager Manager;
+			TArray<FWeakLayerPtr> Layers;
+			TArray<int32> DestroyedAt;
+			auto QueueLayer = [&Manager, &Layers]()
+			{
+				FTestLayerPtr Layer = MakeLayer(Layers.Num() + 1);
+				Layers.Add(Layer);
+				Manager.AddLayerToDeferredDeletionQueue(Layer);
+			};
+
+			// Three layers expire at frame 4 and two at frame 5, two are destroyed per frame
+			QueueLayer();
+			QueueLayer();
+			QueueLayer();
+			for (int32 Frame = 0; Frame < 10; Frame++)
+			{
+				if (Frame == 1)
+				{
+					QueueLayer();
+					QueueLayer();
+				}
+				Manager.HandleLayerDeferredDeletionQueue_RenderThread();
+				RecordDestroyed(Layers, DestroyedAt, Frame);
+			}
+
+			// The leftover of frame 4 goes before the layers expiring at frame 5
+			TestTrue(TEXT("destroyed frames"), DestroyedAt == TArray<int32>({ 4, 4, 5, 5, 6 }));
+			TestEqual(TEXT("drained"), Manager.GetNumQueuedEntries(), 0);
+		});
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPXRDelayDeleteLayerImmediateTest, "PICOXR.DelayDeleteLayer.DeleteImmediately",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FPXRDelayDeleteLayerImmediateTest::RunTest(const FString& Parameters)
+{
+	using namespace PXRDelayDeleteLayerTest;
+
+	FScopedCVar MaxDestroys(TEXT("pico.Layers.MaxDestroysPerFrame"), 1);
+	FScopedCVar PoolSize(TEXT("pico.Layers.PoolSize"), 4);
+
+	RunOnRenderThread([this]()
+		{
+			FDelayDeleteLayerManager Manager;
+			TArray<FWeakLayerPtr> Layers;
+			TArray<TWeakPtr<FPxrLayer, ESPMode::ThreadSafe>> NativeLayers;
+			auto QueueLayer = [&Manager, &Layers, &NativeLayers]()
+			{
+				FTestLayerPtr Layer = MakeLayer(Layers.Num() + 1, &Manager);
+				Layers.Add(Layer);
+				NativeLayers.Add(Layer->GetNativeLayer());
+				Manager.AddLayerToDeferredDeletionQueue(Layer);
+			};
+
+			// One layer in the pool, two waiting behind the budget of one per frame, one waiting for its frame
+			QueueLayer();
+			QueueLayer();
+			QueueLayer();
+			for (int32 Frame = 0; Frame < LayerWait + 2; Frame++)
+			{
+				Manager.HandleLayerDeferredDeletionQueue_RenderThread();
+			}
+			QueueLayer();
+			Manager.AddPxrLayerToDeferredDeletionQueue(100, 1100);
+			TestEqual(TEXT("pooled"), Manager.GetNumPooledLayers(), 1);
+			TestEqual(TEXT("queued"), Manager.GetNumQueuedEntries(), 4);
+
+			// Releasing the stereo layers queues their native layers, which are drained as well
+			Manager.HandleLayerDeferredDeletionQueue_RenderThread(true);
+			TestEqual(TEXT("queued after"), Manager.GetNumQueuedEntries(), 0);
+			TestEqual(TEXT("pooled after"), Manager.GetNumPooledLayers(), 0);
+			for (int32 Index = 0; Index < Layers.Num(); Index++)
+			{
+				TestFalse(*FString::Printf(TEXT("layer %d released"), Index), Layers[Index].IsValid());
+				TestFalse(*FString::Printf(TEXT("native layer %d released"), Index), NativeLayers[Index].IsValid());
+			}
+		});
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPXRDelayDeleteLayerPoolTest, "PICOXR.DelayDeleteLayer.Pool",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FPXRDelayDeleteLayerPoolTest::RunTest(const FString& Parameters)
+{
+	using namespace PXRDelayDeleteLayerTest;
+
+	FScopedCVar MaxDestroys(TEXT("pico.Layers.MaxDestroysPerFrame"), 0);
+	FScopedCVar PoolSize(TEXT("pico.Layers.PoolSize"), 2);
+
+	// Shared by the render commands below, each run while the game thread waits
+	FDelayDeleteLayerManager Manager;
+	TArray<FWeakLayerPtr> Layers;
+	TArray<TWeakPtr<FPxrLayer, ESPMode::ThreadSafe>> NativeLayers;
+	auto QueueLayer = [&Manager, &Layers, &NativeLayers]()
+	{
+		FTestLayerPtr Layer = MakeLayer(Layers.Num() + 1, &Manager);
+		Layers.Add(Layer);
+		NativeLayers.Add(Layer->GetNativeLayer());
+		Manager.AddLayerToDeferredDeletionQueue(Layer);
+	};
+
+	RunOnRenderThread([&]()
+		{
+			// Three layers expire together into a pool of two: the oldest one is released with its native layer
+			QueueLayer();
+			QueueLayer();
+			QueueLayer();
+			for (int32 Frame = 0; Frame < LayerWait + 2; Frame++)
+			{
+				Manager.HandleLayerDeferredDeletionQueue_RenderThread();
+			}
+			TestEqual(TEXT("pool size"), Manager.GetNumPooledLayers(), 2);
+			TestFalse(TEXT("oldest evicted"), Layers[0].IsValid() || NativeLayers[0].IsValid());
+			TestEqual(TEXT("evicted native layer queued"), Manager.GetNumQueuedEntries(), 1);
+
+			// The most recently pooled layer is taken first, its native layer survives the stereo layer
+			FTestLayerPtr NewLayer = MakeLayer(10);
+			FPICOLayerPtr Pooled = Manager.AcquirePooledLayer_RenderThread(NewLayer.Get());
+			if (TestTrue(TEXT("acquired"), Pooled.IsValid()))
+			{
+				TestEqual(TEXT("most recent"), Pooled->GetID(), Layers[2].Pin()->GetID());
+				NewLayer->TakeNativeLayer(*StaticCastSharedPtr<FTestLayer>(Pooled));
+			}
+			Pooled.Reset();
+			TestEqual(TEXT("pool size after acquire"), Manager.GetNumPooledLayers(), 1);
+			TestTrue(TEXT("native layer taken over"), NativeLayers[2].IsValid() && !Layers[2].IsValid());
+			NewLayer.Reset();
+
+			// The remaining layer is released once it has been pooled for more than its frames
+			for (int32 Frame = 0; Frame < PooledLayerFrames; Frame++)
+			{
+				Manager.HandleLayerDeferredDeletionQueue_RenderThread();
+			}
+			TestEqual(TEXT("pooled until its last frame"), Manager.GetNumPooledLayers(), 1);
+			Manager.HandleLayerDeferredDeletionQueue_RenderThread();
+			TestEqual(TEXT("aged out"), Manager.GetNumPooledLayers(), 0);
+			TestFalse(TEXT("aged out layer released"), Layers[1].IsValid() || NativeLayers[1].IsValid());
+			TestTrue(TEXT("nothing left to acquire"), !Manager.AcquirePooledLayer_RenderThread(MakeLayer(11).Get()).IsValid());
+
+			// Refill the pool
+			QueueLayer();
+			QueueLayer();
+			for (int32 Frame = 0; Frame < LayerWait + 2; Frame++)
+			{
+				Manager.HandleLayerDeferredDeletionQueue_RenderThread();
+			}
+			TestEqual(TEXT("refilled"), Manager.GetNumPooledLayers(), 2);
+		});
+
+	// A smaller pool evicts the oldest layers on the next frame
+	PoolSize.Set(1);
+	RunOnRenderThread([&]()
+		{
+			Manager.HandleLayerDeferredDeletionQueue_RenderThread();
+			TestEqual(TEXT("shrunk"), Manager.GetNumPooledLayers(), 1);
+			TestFalse(TEXT("oldest of the refill evicted"), Layers[3].IsValid());
+			TestTrue(TEXT("newest of the refill kept"), Layers[4].IsValid());
+
+			Manager.HandleLayerDeferredDeletionQueue_RenderThread(true);
+			TestEqual(TEXT("drained"), Manager.GetNumQueuedEntries(), 0);
+		});
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPXRDelayDeleteLayerChurnTest, "PICOXR.DelayDeleteLayer.Churn",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FPXRDelayDeleteLayerChurnTest::RunTest(const FString& Parameters)
+{
+	using namespace PXRDelayDeleteLayerTest;
+
+	FScopedCVar MaxDestroys(TEXT("pico.Layers.MaxDestroysPerFrame"), 8);
+	FScopedCVar PoolSize(TEXT("pico.Layers.PoolSize"), 4);
+
+	// Every frame replaces all layers with new ones of the same create parameters, as a widget rebuilt each frame does
+	RunOnRenderThread([this]()
+		{
+			constexpr int32 NumFrames = 10000;
+			constexpr int32 LayersPerFrame = 4;
+			FDelayDeleteLayerManager Manager;
+			TArray<FTestLayerPtr> LiveLayers;
+			TArray<FTestLayerPtr> NewLayers;
+			TArray<double> FrameSeconds;
+			FrameSeconds.Reserve(NumFrames);
+			uint32 NextID = 1;
+			int32 NumCreated = 0;
+			int32 NumReused = 0;
+			int32 MaxQueued = 0;
+			int32 MaxPooled = 0;
+			int64 NumAllocations = 0;
+
+			// Only the allocations made while handling the queue are counted
+			FPXRScopedAllocationCounter AllocationCounter;
+			for (int32 Frame = 0; Frame < NumFrames; Frame++)
+			{
+				for (int32 Index = 0; Index < LayersPerFrame; Index++)
+				{
+					FTestLayerPtr Layer = MakeLayer(NextID++);
+					FPICOLayerPtr Pooled = Manager.AcquirePooledLayer_RenderThread(Layer.Get());
+					if (Pooled.IsValid())
+					{
+						Layer->TakeNativeLayer(*StaticCastSharedPtr<FTestLayer>(Pooled));
+						NumReused++;
+					}
+					else
+					{
+						Layer->CreateNativeLayer(Manager, NextID);
+						NumCreated++;
+					}
+					NewLayers.Add(MoveTemp(Layer));
+				}
+				for (const FTestLayerPtr& Layer : LiveLayers)
+				{
+					Manager.AddLayerToDeferredDeletionQueue(Layer);
+				}
+				Swap(LiveLayers, NewLayers);
+				NewLayers.Reset();
+
+				const int64 AllocationsBefore = AllocationCounter.GetNumAllocations();
+				const double Start = FPlatformTime::Seconds();
+				Manager.HandleLayerDeferredDeletionQueue_RenderThread();
+				FrameSeconds.Add(FPlatformTime::Seconds() - Start);
+				NumAllocations += AllocationCounter.GetNumAllocations() - AllocationsBefore;
+				MaxQueued = FMath::Max(MaxQueued, Manager.GetNumQueuedEntries());
+				MaxPooled = FMath::Max(MaxPooled, Manager.GetNumPooledLayers());
+			}
+
+			FrameSeconds.Sort();
+			AddInfo(FString::Printf(TEXT("%d frames of %d layers: %d native layers created, %d reused, at most %d entries queued and %d layers pooled"),
+				NumFrames, LayersPerFrame, NumCreated, NumReused, MaxQueued, MaxPooled));
+			AddInfo(FString::Printf(TEXT("Deletion per frame: p50 %.2f us, p99 %.2f us, max %.2f us, %.3f allocations"),
+				FrameSeconds[NumFrames / 2] * 1e6, FrameSeconds[NumFrames * 99 / 100] * 1e6, FrameSeconds.Last() * 1e6, (double)NumAllocations / NumFrames));
+
+			// A layer released at frame F is pooled at frame F + LayerWait + 1 and reused on the next one, so only the
+			// first frames create native layers
+			TestTrue(TEXT("native layers reused"), NumCreated <= LayersPerFrame * (LayerWait + 3));
+			TestTrue(TEXT("pool bounded"), MaxPooled <= 4);
+			TestTrue(TEXT("queue bounded"), MaxQueued <= LayersPerFrame * (LayerWait + 1) + LayersPerFrame * (PxrLayerWait + 1));
+
+			LiveLayers.Reset();
+			Manager.HandleLayerDeferredDeletionQueue_RenderThread(true);
+			TestEqual(TEXT("drained"), Manager.GetNumQueuedEntries(), 0);
+		});
+	return true;
+}
+
+#endif
@@ -0,0 +1,166 @@
+// Copyright PICO Technology Co., Ltd. All rights reserved.
+// This plugin incorporates portions of the Unreal® Engine. Unreal® is a trademark or registered trademark of Epic Games, Inc. in the United States of America and elsewhere.
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Misc/AutomationTest.h"
+#include "PXR_EventBus.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace PXREventBusTest
+{
+	// Tail byte of the buffer used to tell events apart, it is copied along with deferred events
+	static constexpr int32 SerialOffset = 400;
+
+	static PxrEventDataBuffer MakeEvent(PxrStructureType Type, uint8 Serial, uint64 Provider = 0)
+	{
+		PxrEventDataBuffer Event;
+		FMemory::Memzero(Event);
+		Event.type = Type;
+		if (Type == PXR_TYPE_EVENT_DATA_SENSE_DATA_UPDATED)
+		{
+			reinterpret_cast<PxrEventDataSenseDataUpdated&>(Event).provider = Provider;
+		}
+		Event.varying[SerialOffset] = Serial;
+		return Event;
+	}
+
+	static uint8 GetSerial(const PxrEventDataBuffer* Event)
+	{
+		return Event->varying[SerialOffset];
+	}
+
+	// Dispatches one poll and returns the serials in the order the handler saw them
+	static TArray<uint8> DispatchPoll(FPXREventBus& Bus, TArray<PxrEventDataBuffer>& Poll, double BudgetSeconds, float HandlerSleepSeconds = 0.0f)
+	{
+		TArray<PxrEventDataBuffer*> Events;
+		for (PxrEventDataBuffer& Event : Poll)
+		{
+			Events.Add(&Event);
+		}
+
+		TArray<uint8> Serials;
+		Bus.Dispatch(Events.Num(), Events.GetData(), BudgetSeconds, [&Serials, HandlerSleepSeconds](PxrEventDataBuffer* Event)
+			{
+				Serials.Add(GetSerial(Event));
+				if (HandlerSleepSeconds > 0.0f)
+				{
+					FPlatformProcess::Sleep(HandlerSleepSeconds);
+				}
+			});
+		return Serials;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPXREventBusCoalesceTest, "PICOXR.EventBus.Coalesce",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FPXREventBusCoalesceTest::RunTest(const FString& Parameters)
+{
+	using namespace PXREventBusTest;
+	FPXREventBus Bus;
+
+	// Only the last foveation change of the poll is dispatched, in its place; other types are kept as they are
+	TArray<PxrEventDataBuffer> Poll = {
+		MakeEvent(PXR_TYPE_EVENT_FOVEATION_LEVEL_CHANGED, 1),
+		MakeEvent(PXR_TYPE_EVENT_DATA_SESSION_STATE_CHANGED, 2),
+		MakeEvent(PXR_TYPE_EVENT_FOVEATION_LEVEL_CHANGED, 3),
+		MakeEvent(PXR_TYPE_EVENT_DATA_SESSION_STATE_CHANGED, 4),
+	};
+	TestEqual(TEXT("Coalesced by type"), DispatchPoll(Bus, Poll, 0.0), TArray<uint8>({ 2, 3, 4 }));
+
+	// Sense data updates are coalesced per provider
+	Poll = {
+		MakeEvent(PXR_TYPE_EVENT_DATA_SENSE_DATA_UPDATED, 1, 100),
+		MakeEvent(PXR_TYPE_EVENT_DATA_SENSE_DATA_UPDATED, 2, 200),
+		MakeEvent(PXR_TYPE_EVENT_DATA_SENSE_DATA_UPDATED, 3, 100),
+	};
+	TestEqual(TEXT("Coalesced by key"), DispatchPoll(Bus, Poll, 0.0), TArray<uint8>({ 2, 3 }));
+
+	// Types registered by the caller
+	Bus.SetCoalesced(PXR_TYPE_EVENT_DATA_SESSION_STATE_CHANGED);
+	Poll = {
+		MakeEvent(PXR_TYPE_EVENT_DATA_SESSION_STATE_CHANGED, 1),
+		MakeEvent(PXR_TYPE_EVENT_DATA_SESSION_STATE_CHANGED, 2),
+	};
+	TestEqual(TEXT("Coalesced after SetCoalesced"), DispatchPoll(Bus, Poll, 0.0), TArray<uint8>({ 2 }));
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPXREventBusDeferredTest, "PICOXR.EventBus.Deferred",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FPXREventBusDeferredTest::RunTest(const FString& Parameters)
+{
+	using namespace PXREventBusTest;
+	FPXREventBus Bus;
+
+	// The handler takes longer than the budget, so exactly one deferred event is dispatched per poll
+	const double Budget = 1e-6;
+	const float HandlerSleep = 0.002f;
+
+	TArray<PxrEventDataBuffer> Poll = {
+		MakeEvent(PXR_TYPE_EVENT_DATA_SENSE_DATA_UPDATED, 1, 100),
+		MakeEvent(PXR_TYPE_EVENT_DATA_SESSION_STATE_CHANGED, 2),
+		MakeEvent(PXR_TYPE_EVENT_DATA_SENSE_DATA_UPDATED, 3, 200),
+	};
+	TestEqual(TEXT("Immediate events first, then the oldest deferred one"), DispatchPoll(Bus, Poll, Budget, HandlerSleep), TArray<uint8>({ 2, 1 }));
+
+	// A newer update of provider 200 replaces the one still waiting, provider 300 queues behind it
+	Poll = {
+		MakeEvent(PXR_TYPE_EVENT_DATA_SENSE_DATA_UPDATED, 4, 200),
+		MakeEvent(PXR_TYPE_EVENT_DATA_SENSE_DATA_UPDATED, 5, 300),
+	};
+	TestEqual(TEXT("Pending event replaced by a newer one"), DispatchPoll(Bus, Poll, Budget, HandlerSleep), TArray<uint8>({ 4 }));
+
+	Poll.Reset();
+	TestEqual(TEXT("Carried over to an empty poll"), DispatchPoll(Bus, Poll, Budget, HandlerSleep), TArray<uint8>({ 5 }));
+	TestEqual(TEXT("Drained"), DispatchPoll(Bus, Poll, Budget, HandlerSleep), TArray<uint8>());
+
+	// Without a budget deferrable events are dispatched in poll order
+	Poll = {
+		MakeEvent(PXR_TYPE_EVENT_DATA_SENSE_DATA_UPDATED, 6, 100),
+		MakeEvent(PXR_TYPE_EVENT_DATA_SESSION_STATE_CHANGED, 7),
+	};
+	TestEqual(TEXT("No budget"), DispatchPoll(Bus, Poll, 0.0), TArray<uint8>({ 6, 7 }));
+
+	// ResetDeferred drops what is waiting
+	Poll = {
+		MakeEvent(PXR_TYPE_EVENT_DATA_SENSE_DATA_UPDATED, 8, 100),
+		MakeEvent(PXR_TYPE_EVENT_DATA_SENSE_DATA_UPDATED, 9, 200),
+	};
+	TestEqual(TEXT("Before reset"), DispatchPoll(Bus, Poll, Budget, HandlerSleep), TArray<uint8>({ 8 }));
+	Bus.ResetDeferred();
+	Poll.Reset();
+	TestEqual(TEXT("After reset"), DispatchPoll(Bus, Poll, Budget, HandlerSleep), TArray<uint8>());
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPXREventBusSubscribeTest, "PICOXR.EventBus.Subscribe",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FPXREventBusSubscribeTest::RunTest(const FString& Parameters)
+{
+	using namespace PXREventBusTest;
+	FPXREventBus Bus;
+
+	TArray<uint8> Received;
+	const FDelegateHandle Handle = Bus.Subscribe(PXR_TYPE_EVENT_DATA_SESSION_STATE_CHANGED, FPICOPollEventDelegate::FDelegate::CreateLambda([&Received](PxrEventDataBuffer* Event)
+		{
+			Received.Add(GetSerial(Event));
+		}));
+
+	TArray<PxrEventDataBuffer> Poll = {
+		MakeEvent(PXR_TYPE_EVENT_DATA_SESSION_STATE_CHANGED, 1),
+		MakeEvent(PXR_TYPE_EVENT_FOVEATION_LEVEL_CHANGED, 2),
+	};
+	TestEqual(TEXT("Handler sees every event"), DispatchPoll(Bus, Poll, 0.0), TArray<uint8>({ 1, 2 }));
+	TestEqual(TEXT("Subscriber sees its type"), Received, TArray<uint8>({ 1 }));
+
+	Bus.Unsubscribe(PXR_TYPE_EVENT_DATA_SESSION_STATE_CHANGED, Handle);
+	DispatchPoll(Bus, Poll, 0.0);
+	TestEqual(TEXT("Nothing after Unsubscribe"), Received, TArray<uint8>({ 1 }));
+	return true;
+}
+
+#endif
@@ -0,0 +1,170 @@
+// Copyright PICO Technology Co., Ltd. All rights reserved.
+// This plugin incorporates portions of the Unreal® Engine. Unreal® is a trademark or registered trademark of Epic Games, Inc. in the United States of America and elsewhere.
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Misc/AutomationTest.h"
+#include "PXR_FrameState.h"
+#include "PXR_AllocationCounter.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace PXRFrameStateTest
+{
+	// Game thread layers have no native resources, so they can be created without an HMD
+	static FPICOLayerPtr MakeLayer(uint32 ID, int32 Priority = 0)
+	{
+		IStereoLayers::FLayerDesc Desc;
+		Desc.Id = ID;
+		Desc.Priority = Priority;
+		return MakeShareable(new FPICOXRStereoLayer(nullptr, ID, Desc));
+	}
+
+	static TArray<uint32> GetIDs(const TArray<FPICOLayerPtr>& Layers)
+	{
+		TArray<uint32> IDs;
+		for (const FPICOLayerPtr& Layer : Layers)
+		{
+			IDs.Add(Layer->GetID());
+		}
+		return IDs;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPXRFrameStateChangeSetTest, "PICOXR.FrameState.ChangeSet",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FPXRFrameStateChangeSetTest::RunTest(const FString& Parameters)
+{
+	using namespace PXRFrameStateTest;
+
+	FGameSettings Settings;
+	FPXRGameFrame Frame;
+	TMap<uint32, FPICOLayerPtr> LayerMap;
+	LayerMap.Add(2, MakeLayer(2));
+	LayerMap.Add(0, MakeLayer(0));
+	LayerMap.Add(1, MakeLayer(1));
+
+	FPXRFrameStateRing Ring;
+
+	// First frame: every layer is added, sorted by ID
+	FPXRFrameStatePtr State = Ring.Acquire_GameThread(Settings, Frame, LayerMap);
+	TestTrue(TEXT("added"), GetIDs(State->Changes.Added) == TArray<uint32>({ 0, 1, 2 }));
+	TestTrue(TEXT("layers"), GetIDs(State->Layers) == TArray<uint32>({ 0, 1, 2 }));
+	TestTrue(TEXT("templates are copies"), State->Layers[0] != LayerMap[0]);
+	const TArray<FPICOLayerPtr> FirstTemplates = State->Layers;
+	State.Reset();
+
+	// Nothing changed: empty change set and the same templates
+	State = Ring.Acquire_GameThread(Settings, Frame, LayerMap);
+	TestTrue(TEXT("no changes"), State->Changes.IsEmpty());
+	TestTrue(TEXT("stable templates"), State->Layers == FirstTemplates);
+	State.Reset();
+
+	// Removing and adding layers in the same frame
+	LayerMap.Remove(1);
+	LayerMap.Add(5, MakeLayer(5));
+	State = Ring.Acquire_GameThread(Settings, Frame, LayerMap);
+	TestTrue(TEXT("removed"), State->Changes.Removed == TArray<uint32>({ 1 }));
+	TestTrue(TEXT("added after remove"), GetIDs(State->Changes.Added) == TArray<uint32>({ 5 }));
+	TestEqual(TEXT("no desc change on add"), State->Changes.DescChanged.Num(), 0);
+	TestTrue(TEXT("layers after remove"), GetIDs(State->Layers) == TArray<uint32>({ 0, 2, 5 }));
+	TestTrue(TEXT("kept template"), State->Layers[0] == FirstTemplates[0] && State->Layers[1] == FirstTemplates[2]);
+	State.Reset();
+
+	// Replacing the game thread object (SetLayerDesc) re-copies only that layer, with a newer generation
+	LayerMap[2] = MakeLayer(2, 1);
+	State = Ring.Acquire_GameThread(Settings, Frame, LayerMap);
+	if (TestTrue(TEXT("desc changed"), GetIDs(State->Changes.DescChanged) == TArray<uint32>({ 2 })))
+	{
+		TestTrue(TEXT("new template"), State->Changes.DescChanged[0] == State->Layers[1] && State->Layers[1] != FirstTemplates[2]);
+		TestTrue(TEXT("newer generation"), State->Layers[1]->Generation > FirstTemplates[2]->Generation);
+		TestEqual(TEXT("new desc"), State->Layers[1]->GetPXRLayerDesc().Priority, 1);
+	}
+	TestEqual(TEXT("nothing added on desc change"), State->Changes.Added.Num(), 0);
+	TestTrue(TEXT("other templates kept"), State->Layers[0] == FirstTemplates[0]);
+	State.Reset();
+
+	// A one-off texture update is forwarded once, without copying the layer
+	LayerMap[0]->MarkTextureForUpdate();
+	State = Ring.Acquire_GameThread(Settings, Frame, LayerMap);
+	TestTrue(TEXT("texture changed"), State->Changes.TextureChanged == TArray<uint32>({ 0 }));
+	TestEqual(TEXT("no desc change on texture update"), State->Changes.DescChanged.Num(), 0);
+	TestTrue(TEXT("template kept on texture update"), State->Layers[0] == FirstTemplates[0]);
+	TestFalse(TEXT("texture update consumed"), LayerMap[0]->IsTextureMarkedForUpdate());
+	State.Reset();
+
+	State = Ring.Acquire_GameThread(Settings, Frame, LayerMap);
+	TestTrue(TEXT("no changes after texture update"), State->Changes.IsEmpty());
+	State.Reset();
+
+	// A frame state still held by the render thread is not overwritten when its slot comes round again
+	Frame.FrameNumber = 100;
+	FPXRFrameStatePtr Held = Ring.Acquire_GameThread(Settings, Frame, LayerMap);
+	for (int32 Index = 1; Index <= FPXRFrameStateRing::NumSlots; Index++)
+	{
+		Frame.FrameNumber = 100 + Index;
+		State = Ring.Acquire_GameThread(Settings, Frame, LayerMap);
+		TestTrue(TEXT("held state not reused"), State != Held);
+		State.Reset();
+	}
+	TestEqual(TEXT("held frame untouched"), Held->Frame->FrameNumber, (uint32)100);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPXRFrameStateAllocationTest, "PICOXR.FrameState.Allocation",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FPXRFrameStateAllocationTest::RunTest(const FString& Parameters)
+{
+	using namespace PXRFrameStateTest;
+
+	FGameSettings Settings;
+	FPXRGameFrame Frame;
+	TMap<uint32, FPICOLayerPtr> LayerMap;
+	for (uint32 ID = 0; ID < 8; ID++)
+	{
+		LayerMap.Add(ID, MakeLayer(ID));
+	}
+
+	// Fill every slot once; afterwards each state is released by the "render thread" before its slot comes round again
+	FPXRFrameStateRing Ring;
+	for (int32 Index = 0; Index < FPXRFrameStateRing::NumSlots * 2; Index++)
+	{
+		Ring.Acquire_GameThread(Settings, Frame, LayerMap);
+	}
+
+	const int32 NumFrames = 10000;
+	int64 NumAllocations = 0;
+	{
+		FPXRScopedAllocationCounter Counter;
+		for (int32 Index = 0; Index < NumFrames; Index++)
+		{
+			Frame.FrameNumber = Index;
+			FPXRFrameStatePtr State = Ring.Acquire_GameThread(Settings, Frame, LayerMap);
+			State.Reset();
+		}
+		NumAllocations = Counter.GetNumAllocations();
+	}
+	TestEqual(TEXT("steady state allocations"), NumAllocations, (int64)0);
+
+	// A texture update each frame still does not copy anything, once each slot's change list has grown
+	for (int32 Index = 0; Index < FPXRFrameStateRing::NumSlots; Index++)
+	{
+		LayerMap[3]->MarkTextureForUpdate();
+		Ring.Acquire_GameThread(Settings, Frame, LayerMap);
+	}
+	{
+		FPXRScopedAllocationCounter Counter;
+		for (int32 Index = 0; Index < NumFrames; Index++)
+		{
+			LayerMap[3]->MarkTextureForUpdate();
+			FPXRFrameStatePtr State = Ring.Acquire_GameThread(Settings, Frame, LayerMap);
+			State.Reset();
+		}
+		NumAllocations = Counter.GetNumAllocations();
+	}
+	TestEqual(TEXT("texture update allocations"), NumAllocations, (int64)0);
+	return true;
+}
+
+#endif
@@ -0,0 +1,123 @@
+// Copyright PICO Technology Co., Ltd. All rights reserved.
+// This plugin incorporates portions of the Unreal® Engine. Unreal® is a trademark or registered trademark of Epic Games, Inc. in the United States of America and elsewhere.
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Misc/AutomationTest.h"
+#include "PXR_FrameTiming.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeExit.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace PXRFrameTimingTest
+{
+	// Replayed time, read by FPXRFrameTiming through SetClock
+	static double ClockTime = 0.0;
+
+	static double Clock()
+	{
+		return ClockTime;
+	}
+
+	constexpr float RefreshRate = 72.0f;
+	constexpr double Period = 1.0 / RefreshRate;
+
+	// Replays the hooks of one frame the way FPICOXRHMD calls them, all stages within the first half of the period,
+	// with RHIEndFrame at Start + Period / 2; then folds it in as the next game frame would
+	static void ReplayFrame(FPXRFrameTiming& Timing, uint32 FrameNumber, double Start)
+	{
+		const EPXRFrameStage Stages[] =
+		{
+			EPXRFrameStage::GameFrameBegin,
+			EPXRFrameStage::WaitFrameBegin,
+			EPXRFrameStage::WaitFrameEnd,
+			EPXRFrameStage::PoseSampled,
+			EPXRFrameStage::RenderFrameBegin,
+			EPXRFrameStage::BeginRendering,
+			EPXRFrameStage::LateUpdate,
+			EPXRFrameStage::RHIBeginFrame,
+			EPXRFrameStage::RHIEndFrame,
+		};
+		const int32 NumStages = UE_ARRAY_COUNT(Stages);
+		for (int32 Index = 0; Index < NumStages; Index++)
+		{
+			ClockTime = Start + Period * 0.5 * Index / (NumStages - 1);
+			Timing.Mark(FrameNumber, Stages[Index]);
+		}
+		Timing.Update_GameThread(RefreshRate);
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPXRFrameTimingReplayTest, "PICOXR.FrameTiming.Replay",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FPXRFrameTimingReplayTest::RunTest(const FString& Parameters)
+{
+	using namespace PXRFrameTimingTest;
+
+	FPXRFrameTiming& Timing = FPXRFrameTiming::Get();
+	ClockTime = 1000.0;
+	Timing.SetClock(&Clock);
+	ON_SCOPE_EXIT
+	{
+		Timing.SetClock(nullptr);
+	};
+
+	uint32 FrameNumber = 1;
+	double Time = ClockTime;
+	auto ReplayFrames = [&](int32 NumFrames, double Interval)
+	{
+		for (int32 Index = 0; Index < NumFrames; Index++)
+		{
+			Time += Interval;
+			ReplayFrame(Timing, FrameNumber++, Time);
+		}
+	};
+
+	// Paced frames
+	ReplayFrames(100, Period);
+	TestEqual(TEXT("paced"), (int32)Timing.GetMissedFrames(), 0);
+
+	// One frame late by two refreshes, then one by a single refresh
+	ReplayFrames(1, Period * 3);
+	TestEqual(TEXT("two refreshes missed"), (int32)Timing.GetMissedFrames(), 2);
+	ReplayFrames(1, Period * 2);
+	ReplayFrames(10, Period);
+	TestEqual(TEXT("one more refresh missed"), (int32)Timing.GetMissedFrames(), 3);
+
+	// Backgrounded for 30 seconds: a gap, not 2000 missed frames
+	ReplayFrames(1, 30.0);
+	ReplayFrames(10, Period);
+	TestEqual(TEXT("long gap"), (int32)Timing.GetMissedFrames(), 3);
+
+	// Splash for 0.3 seconds, under the gap threshold: the HMD restarts the interval each splash frame
+	Timing.RestartFrameInterval();
+	ReplayFrames(1, 0.3);
+	ReplayFrames(10, Period);
+	TestEqual(TEXT("restarted interval"), (int32)Timing.GetMissedFrames(), 3);
+
+	// Without the restart the same 0.3 seconds are missed refreshes
+	ReplayFrames(1, 0.3);
+	TestEqual(TEXT("short stall"), (int32)Timing.GetMissedFrames(), 3 + FMath::RoundToInt(0.3 / Period) - 1);
+
+	// The export holds every replayed frame with its stages relative to GameFrameBegin
+	const FString Path = FPaths::CreateTempFilename(*FPaths::ProjectSavedDir(), TEXT("PICOFrameTimingTest"), TEXT(".csv"));
+	ON_SCOPE_EXIT
+	{
+		IFileManager::Get().Delete(*Path);
+	};
+	FString Csv;
+	if (TestTrue(TEXT("export"), Timing.ExportCSV(Path)) && TestTrue(TEXT("load export"), FFileHelper::LoadFileToString(Csv, *Path)))
+	{
+		TArray<FString> Lines;
+		Csv.ParseIntoArrayLines(Lines);
+		TestEqual(TEXT("exported frames"), Lines.Num() - 1, (int32)FrameNumber - 1);
+		TestTrue(TEXT("header"), Lines.Num() > 0 && Lines[0].StartsWith(TEXT("Frame,GameFrameBeginMs")));
+		TestTrue(TEXT("first frame"), Lines.Num() > 1 && Lines[1].StartsWith(TEXT("1,0.000,")));
+	}
+	return true;
+}
+
+#endif
@@ -0,0 +1,297 @@
+// Copyright PICO Technology Co., Ltd. All rights reserved.
+// This plugin incorporates portions of the Unreal® Engine. Unreal® is a trademark or registered trademark of Epic Games, Inc. in the United States of America and elsewhere.
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Misc/AutomationTest.h"
+#include "Tests/AutomationCommon.h"
+#include "PXR_Splash.h"
+#include "PXR_AllocationCounter.h"
+#include "Engine/Texture2D.h"
+#include "GlobalRenderResources.h"
+#include "Misc/PackageName.h"
+#include "Math/RandomStream.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace PXRSplashTest
+{
+	// Longest game thread call of the texture loader allowed: one frame at 72 Hz
+	constexpr double StallBudgetSeconds = 1.0 / 72.0;
+	constexpr double TimeoutSeconds = 10.0;
+
+	// Loaded by the engine at startup, so the streamable manager completes its request inside RequestAsyncLoad
+	static const TCHAR* const LoadedTexturePath = TEXT("/Engine/EngineResources/DefaultTexture.DefaultTexture");
+	static const TCHAR* const MissingTexturePath = TEXT("/Game/PICOXRSplashTest/Missing.Missing");
+	// Engine textures that are usually not loaded in a test run; the first one found on disk and not in memory is used
+	static const TCHAR* const UnloadedTextureCandidates[] =
+	{
+		TEXT("/Engine/EngineResources/Black.Black"),
+		TEXT("/Engine/EngineMaterials/DefaultDiffuse.DefaultDiffuse"),
+		TEXT("/Engine/EngineMaterials/DefaultNormal.DefaultNormal"),
+		TEXT("/Engine/EngineMaterials/DefaultBokeh.DefaultBokeh"),
+	};
+
+	// The splash side of the loader: layers, the states each one went through, and how long the game thread was held
+	struct FState : public TSharedFromThis<FState>
+	{
+		FPXRSplashTextureLoader Loader;
+		TArray<FPXRSplashLayer> Layers;
+		TArray<TArray<EPXRSplashTextureState>> SeenStates;
+		bool bInRequest = false;
+		int32 DelegateCallsInRequest = 0;
+		double MaxStallSeconds = 0.0;
+		double Deadline = 0.0;
+
+		void RecordStates()
+		{
+			for (int32 Index = 0; Index < Layers.Num(); Index++)
+			{
+				if (SeenStates[Index].Num() == 0 || SeenStates[Index].Last() != Layers[Index].TextureState)
+				{
+					SeenStates[Index].Add(Layers[Index].TextureState);
+				}
+			}
+		}
+
+		// What FPXRSplash does when a texture finishes loading and on each game frame
+		void Update()
+		{
+			const double Start = FPlatformTime::Seconds();
+			Loader.UpdateStates(Layers);
+			MaxStallSeconds = FMath::Max(MaxStallSeconds, FPlatformTime::Seconds() - Start);
+			RecordStates();
+		}
+
+		void Request(int32 Index)
+		{
+			TWeakPtr<FState> WeakState = AsShared();
+			const double Start = FPlatformTime::Seconds();
+			bInRequest = true;
+			Loader.Request(Layers[Index], FStreamableDelegate::CreateLambda([WeakState]()
+				{
+					if (TSharedPtr<FState> State = WeakState.Pin())
+					{
+						State->DelegateCallsInRequest += State->bInRequest ? 1 : 0;
+						State->Update();
+					}
+				}));
+			bInRequest = false;
+			MaxStallSeconds = FMath::Max(MaxStallSeconds, FPlatformTime::Seconds() - Start);
+			RecordStates();
+		}
+
+		bool IsSettled() const
+		{
+			for (const FPXRSplashLayer& Layer : Layers)
+			{
+				if (Layer.TextureState == EPXRSplashTextureState::Loading || Layer.TextureState == EPXRSplashTextureState::WaitingForResource)
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+	};
+
+	static FPXRSplashLayer MakeLayer(const TCHAR* TexturePath)
+	{
+		FPXRSplashDesc Desc;
+		Desc.SplashTexturePath = FSoftObjectPath(TexturePath);
+		return FPXRSplashLayer(Desc);
+	}
+
+	static FString StatesToString(const TArray<EPXRSplashTextureState>& States)
+	{
+		static const TCHAR* const Names[] = { TEXT("None"), TEXT("Loading"), TEXT("WaitingForResource"), TEXT("Ready"), TEXT("Failed") };
+		FString Result;
+		for (EPXRSplashTextureState State : States)
+		{
+			Result += Result.IsEmpty() ? Names[(int32)State] : FString(TEXT(" > ")) + Names[(int32)State];
+		}
+		return Result;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPXRSplashTextureStatesTest, "PICOXR.Splash.TextureStates",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FPXRSplashTextureStatesTest::RunTest(const FString& Parameters)
+{
+	using namespace PXRSplashTest;
+
+	if (!TestNotNull(TEXT("loaded texture"), LoadObject<UTexture2D>(nullptr, LoadedTexturePath)))
+	{
+		return false;
+	}
+	const TCHAR* UnloadedTexturePath = nullptr;
+	for (const TCHAR* Candidate : UnloadedTextureCandidates)
+	{
+		if (!FSoftObjectPath(Candidate).ResolveObject() && FPackageName::DoesPackageExist(FSoftObjectPath(Candidate).GetLongPackageName()))
+		{
+			UnloadedTexturePath = Candidate;
+			break;
+		}
+	}
+
+	// Indices of the layers below
+	enum { Given, Loaded, Missing, Unloaded };
+
+	TSharedRef<FState> State = MakeShared<FState>();
+	FPXRSplashDesc GivenDesc;
+	GivenDesc.LoadedTextureRef = GBlackTexture->TextureRHI;
+	State->Layers.Add(FPXRSplashLayer(GivenDesc));
+	State->Layers.Add(MakeLayer(LoadedTexturePath));
+	State->Layers.Add(MakeLayer(MissingTexturePath));
+	if (UnloadedTexturePath)
+	{
+		State->Layers.Add(MakeLayer(UnloadedTexturePath));
+	}
+	else
+	{
+		AddInfo(TEXT("No unloaded engine texture found, the asynchronous load path is only covered by the missing texture"));
+	}
+	State->SeenStates.SetNum(State->Layers.Num());
+	State->RecordStates();
+
+	for (int32 Index = Loaded; Index < State->Layers.Num(); Index++)
+	{
+		State->Request(Index);
+	}
+
+	// A texture already in memory completes inside RequestAsyncLoad, before its handle is stored
+	TestTrue(TEXT("delegate ran inside the request"), State->DelegateCallsInRequest > 0);
+	TestEqual(TEXT("loaded texture waits only for its resource"), (int32)State->Layers[Loaded].TextureState, (int32)EPXRSplashTextureState::WaitingForResource);
+
+	State->Deadline = FPlatformTime::Seconds() + TimeoutSeconds;
+	ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([this, State, UnloadedTexturePath]()
+		{
+			// Polled once per game frame, as SwitchActiveSplash_GameThread does
+			State->Update();
+			if (!State->IsSettled() && FPlatformTime::Seconds() < State->Deadline)
+			{
+				return false;
+			}
+
+			for (int32 Index = 0; Index < State->Layers.Num(); Index++)
+			{
+				AddInfo(FString::Printf(TEXT("Layer %d: %s"), Index, *StatesToString(State->SeenStates[Index])));
+			}
+			TestTrue(TEXT("settled"), State->IsSettled());
+
+			typedef TArray<EPXRSplashTextureState> FStates;
+			TestTrue(TEXT("given texture"), State->SeenStates[Given] == FStates({ EPXRSplashTextureState::None }));
+			TestTrue(TEXT("loaded texture"), State->SeenStates[Loaded] == FStates({ EPXRSplashTextureState::None, EPXRSplashTextureState::WaitingForResource, EPXRSplashTextureState::Ready }));
+			// Whether a missing package fails inside the request or on a later frame is up to the package loader
+			TestTrue(TEXT("missing texture"), State->SeenStates[Missing].Last() == EPXRSplashTextureState::Failed && !State->SeenStates[Missing].Contains(EPXRSplashTextureState::WaitingForResource));
+			if (UnloadedTexturePath)
+			{
+				TestTrue(TEXT("unloaded texture"), State->SeenStates[Unloaded] == FStates({ EPXRSplashTextureState::None, EPXRSplashTextureState::Loading, EPXRSplashTextureState::WaitingForResource, EPXRSplashTextureState::Ready }));
+			}
+			TestTrue(TEXT("ready texture has its RHI texture"), State->Layers[Loaded].Desc.LoadedTextureRef.IsValid());
+
+			AddInfo(FString::Printf(TEXT("Longest game thread stall: %.3f ms"), State->MaxStallSeconds * 1000.0));
+			TestTrue(TEXT("no stall longer than a frame"), State->MaxStallSeconds < StallBudgetSeconds);
+			return true;
+		}));
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPXRSplashFrameAllocationTest, "PICOXR.Splash.FrameAllocation",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FPXRSplashFrameAllocationTest::RunTest(const FString& Parameters)
+{
+	using namespace PXRSplashTest;
+
+	constexpr int32 NumTicks = 10000;
+	FPXRGameFrame Template;
+	Template.FrameNumber = 7;
+	FPXRSplashFrames SplashFrames;
+	SplashFrames.Init(Template);
+
+	// What a render tick reads besides its frame: the entry layers published by the game thread, unchanged here
+	FCriticalSection RenderThreadLock;
+	typedef TSharedPtr<const TArray<FPICOLayerPtr>, ESPMode::ThreadSafe> FLayerSnapshotPtr;
+	const FLayerSnapshotPtr EntryLayersSnapshot = MakeShared<TArray<FPICOLayerPtr>, ESPMode::ThreadSafe>();
+	FLayerSnapshotPtr AppliedLayersSnapshot = EntryLayersSnapshot;
+
+	// The RHI thread runs the splash commands in order; each one releases its frame, then keeps reading it to submit
+	// the layers. Frames of commands not yet done, oldest first: at most the one being submitted and the one queued.
+	FPXRGameFrame* RHIFrames[FPXRSplashFrames::NumFrames] = {};
+	int32 NumRHIFrames = 0;
+	bool bHeadReleased = false;
+
+	FRandomStream Random(22);
+	int32 NumRendered = 0;
+	int32 NumSkipped = 0;
+	int32 NumReused = 0;
+	int32 NumAllocations = 0;
+	{
+		FPXRScopedAllocationCounter AllocationCounter;
+		for (int32 Tick = 0; Tick < NumTicks; Tick++)
+		{
+			// The RHI thread gets through zero to three steps of its queue between two render ticks
+			for (int32 Step = Random.RandRange(0, 3); Step > 0 && NumRHIFrames > 0; Step--)
+			{
+				if (!bHeadReleased)
+				{
+					SplashFrames.Release_RHIThread();
+					bHeadReleased = true;
+				}
+				else
+				{
+					RHIFrames[0] = RHIFrames[1];
+					RHIFrames[1] = nullptr;
+					NumRHIFrames--;
+					bHeadReleased = false;
+				}
+			}
+
+			if (SplashFrames.HasOutstanding())
+			{
+				NumSkipped++;
+				continue;
+			}
+
+			FLayerSnapshotPtr EntryLayers;
+			{
+				FScopeLock ScopeLock(&RenderThreadLock);
+				EntryLayers = EntryLayersSnapshot;
+			}
+			NumReused += EntryLayers == AppliedLayersSnapshot ? 1 : 0;
+
+			FPXRGameFrame* Frame = SplashFrames.Acquire_RenderThread(Template);
+			for (int32 Index = 0; Index < NumRHIFrames; Index++)
+			{
+				if (RHIFrames[Index] == Frame)
+				{
+					AddError(FString::Printf(TEXT("Tick %d took the frame the RHI thread is still reading"), Tick));
+				}
+			}
+			if (Frame->FrameNumber != Template.FrameNumber || Frame->ShowFlags.Rendering != Template.ShowFlags.Rendering)
+			{
+				AddError(FString::Printf(TEXT("Tick %d got a frame not reset from the template"), Tick));
+			}
+			Frame->FrameNumber = Tick;
+			Frame->ShowFlags.Rendering = !Template.ShowFlags.Rendering;
+
+			if (NumRHIFrames == FPXRSplashFrames::NumFrames)
+			{
+				AddError(FString::Printf(TEXT("Tick %d queued more frames than are allocated"), Tick));
+				break;
+			}
+			RHIFrames[NumRHIFrames++] = Frame;
+			NumRendered++;
+		}
+		NumAllocations = (int32)AllocationCounter.GetNumAllocations();
+	}
+
+	AddInfo(FString::Printf(TEXT("%d ticks: %d rendered, %d skipped with a frame outstanding, %d allocations"), NumTicks, NumRendered, NumSkipped, NumAllocations));
+	TestTrue(TEXT("ticks rendered"), NumRendered > NumTicks / 4);
+	TestTrue(TEXT("ticks skipped"), NumSkipped > 0);
+	TestEqual(TEXT("layer snapshot reused"), NumReused, NumRendered);
+	TestEqual(TEXT("allocations"), NumAllocations, 0);
+	return true;
+}
+
+#endif
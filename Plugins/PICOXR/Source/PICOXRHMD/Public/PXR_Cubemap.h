@@ -7,9 +7,18 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
 #include "PixelFormat.h"
+#include "Engine/TimerHandle.h"
 #include "PXR_Cubemap.generated.h"
 
 class USceneCaptureComponent2D;
+struct FPXRCubemapCapture;
+
+// Captures the scene around a point into a 6N x N strip of cube faces (right, left, top, bottom, front, back),
+// saved as PNG or EXR under Saved/Cubemaps.
+// The capture components and render targets are created once and reused. Faces are read back from the GPU
+// asynchronously, and the stitching and encoding run on a background thread, so a capture never blocks the game thread.
+// In sequence mode several probe points are captured in one batch, one probe per frame, with at most
+// MaxProbesInFlight of them waiting for readback or encoding at once.
 UCLASS()
 class PICOXRHMD_API APXR_Cubemap : public AActor
 {
@@ -22,6 +31,7 @@ public:
 protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 public:
 	// Called every frame
@@ -33,13 +43,35 @@ public:
 	FQuat Orientation = FQuat::Identity;
 	FVector Location = FVector::ZeroVector;
 	EPixelFormat CaptureFormat = PF_A16B16G16R16;
+	// Saves the linear scene color as half float EXR instead of the final color as 8 bit PNG; only PF_FloatRGBA keeps
+	// values above 1
+	bool bSaveAsEXR = false;
+	int32 MaxProbesInFlight = 2;
 
+	// Starts capturing at the actor transform; isCatchImageWP is set once the file is saved.
+	// Returns false if the capture could not be started.
 	bool SaveCubeMap_PICO();
+	// Captures one cubemap per probe transform, numbered in the file names
+	bool SaveCubeMapSequence_PICO(const TArray<FTransform>& ProbeTransforms);
+	bool IsCapturing() const;
 
 private:
+	bool StartCaptures(TArray<FTransform>&& ProbeTransforms, bool bNumbered);
+	void InitCaptureComponents();
+	void CaptureProbe(const FTransform& ProbeTransform, const FString& Filename);
+	void PollCaptures();
+	void ReleaseCaptureComponents();
+
 	UPROPERTY()
 		TArray<USceneCaptureComponent2D*> CaptureComponents;
 
+	TArray<TSharedPtr<FPXRCubemapCapture, ESPMode::ThreadSafe>> Captures;
+	TArray<FTransform> PendingProbes;
+	TArray<FString> PendingFilenames;
+	int32 NextProbe = 0;
+	bool bBatchSaved = true;
+	FTimerHandle PollTimerHandle;
+
 	UFUNCTION(BlueprintCallable, CallInEditor, Category = "PXR|PXRHMD")
 		void PXR_CubemapHandler();
 
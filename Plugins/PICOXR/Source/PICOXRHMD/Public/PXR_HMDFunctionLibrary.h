@@ -41,6 +41,27 @@ enum class EPICOXRBoundaryState :uint8
 	LostNoDialog = 112
 };
 
+USTRUCT(BlueprintType)
+struct FPICOXRBoundaryTestResult
+{
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "PXR|PXRHMD")
+	bool IsTriggering = false;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "PXR|PXRHMD")
+	bool IsInside = false;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "PXR|PXRHMD")
+	float ClosestDistance = 0.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "PXR|PXRHMD")
+	FVector ClosestPoint = FVector::ZeroVector;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "PXR|PXRHMD")
+	FVector ClosestPointNormal = FVector::ZeroVector;
+};
+
 UENUM(BlueprintType)
 enum class EPICOXRTrackedDeviceType : uint8
 {
@@ -605,6 +626,27 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "PXR|PXRHMD")
 	static TArray<FVector> PXR_GetBoundaryGeometry(EPICOXRBoundaryType BoundaryType);
 
+	/// <summary>Checks many spheres against the boundary at once, e.g. one per actor. Answered locally from the cached boundary
+	/// geometry, which is refreshed when the runtime reports a session, tracking or recenter change.</summary>
+	/// <param name ="Centers">(In) TArray, the sphere centers in the Unreal coordinate system </param>
+	/// <param name ="Radius">(In) float, the sphere radius; 0 tests points </param>
+	/// <param name ="BoundaryType">(In) Enum, boundary type:
+	/// <ul>
+	/// <li>`Outer`: boundary (i.e., the on-site quick setting boundary or the customized boundary)</li>
+	/// <li>`PlayArea`: the biggest internal rectangle of the customized boundary（no such a bounary for on-site quick setting boundary）</li>
+	/// </ul>
+	/// </param>
+	/// <param name ="Results">(Out) TArray, one result per center. A sphere triggers when it reaches the boundary or its center is outside.
+	/// Distances are measured on the floor plane and the normal points into the boundary. </param>
+	/// <returns>Bool:
+	/// <ul>
+	/// <li>`true`: results got</li>
+	/// <li>`false`: no boundary</li>
+	/// </ul>
+	/// </returns>
+	UFUNCTION(BlueprintCallable, Category = "PXR|PXRHMD")
+	static bool PXR_BoundaryTestSpheres(const TArray<FVector>& Centers, float Radius, EPICOXRBoundaryType BoundaryType, TArray<FPICOXRBoundaryTestResult>& Results);
+
 	/**
 	* Returns the dimensions in UE world space of the requested Boundary Type.
 	* @param BoundaryType			(in) An enum representing the boundary type requested, either Outer Boundary (exact Boundary bounds) or PlayArea (rectangle inside the Outer Boundary)
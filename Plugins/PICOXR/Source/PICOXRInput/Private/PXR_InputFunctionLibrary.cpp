@@ -7,6 +7,7 @@
 #include "PXR_Utils.h"
 #include "PXR_Input.h"
 #include "PXR_Log.h"
+#include "PXR_PoseCache.h"
 #include "UObject/ConstructorHelpers.h"
 #include "Misc/Paths.h"
 #include "Misc/FileHelper.h"
@@ -961,7 +962,7 @@ bool UPICOXRInputFunctionLibrary::PXR_GetBodyTrackingPose(TArray<FPxrBodyTrackin
     {
 #if PLATFORM_ANDROID
         double dPredictTime=0;
-        if (FPICOXRHMDModule::GetPluginWrapper().GetPredictedDisplayTime(&dPredictTime))
+        if (FPXRPoseCache::Get().GetPredictedDisplayTime(&dPredictTime))
         {
             return false;
         }
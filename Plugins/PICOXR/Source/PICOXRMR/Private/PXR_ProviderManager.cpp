@@ -12,7 +12,7 @@
 #include "Algo/Transform.h"
 
 TSharedPtr<FPICOXRHMD> FPICOProviderManager::PICOXRHMDPtr = nullptr;
-FDelegateHandle FPICOProviderManager::HandleOfPollEvent;
+TArray<TPair<PxrStructureType, FDelegateHandle>> FPICOProviderManager::HandlesOfPollEvent;
 FDelegateHandle FPICOProviderManager::HandleOfPollFuture;
 
 
@@ -519,7 +519,21 @@ bool FPICOProviderManager::Initialize(FPICOXRHMD* InPICOXRHMD)
 	if (PICOXRHMDPtr)
 	{
 		PXR_LOGI(PxrMR, "FPICOProviderManager::Initialize Bind PollEvent");
-		HandleOfPollEvent = PICOXRHMDPtr->OnPollEventDelegate().AddStatic(FPICOProviderManager::PollEvent);
+		const PxrStructureType EventTypes[] =
+		{
+			PXR_TYPE_EVENT_DATA_SENSE_DATA_UPDATED,
+			PXR_TYPE_EVENT_DATA_SENSE_DATA_PROVIDER_STATE_CHANGED,
+			PXR_TYPE_EVENT_DATA_ANCHOR_ENTITY_CREATED,
+			PXR_TYPE_EVENT_DATA_ANCHOR_ENTITY_PERSISTED,
+			PXR_TYPE_EVENT_DATA_ANCHOR_ENTITY_UNPERSISTED,
+			PXR_TYPE_EVENT_DATA_ANCHOR_ENTITY_CLEARED,
+			PXR_TYPE_EVENT_DATA_ANCHOR_ENTITY_LOADED,
+			PXR_TYPE_EVENT_DATA_SPATIAL_SCENE_CAPTURED,
+		};
+		for (const PxrStructureType EventType : EventTypes)
+		{
+			HandlesOfPollEvent.Emplace(EventType, PICOXRHMDPtr->GetEventBus().Subscribe(EventType, FPICOPollEventDelegate::FDelegate::CreateStatic(FPICOProviderManager::PollEvent)));
+		}
 		HandleOfPollFuture = PICOXRHMDPtr->OnPollFutureDelegate().AddStatic(FPICOProviderManager::PXR_PollFutureForProviders);
 		if (ShouldUseLegacyMR()&&Settings->bEnableSceneCapture)
 		{
@@ -734,10 +748,14 @@ bool FPICOProviderManager::Finalize()
 		}
 	}
 
-	if (HandleOfPollEvent.IsValid() && GetPICOXRHMDPtr().IsValid())
+	if (GetPICOXRHMDPtr().IsValid())
 	{
-		GetPICOXRHMDPtr()->OnPollEventDelegate().Remove(HandleOfPollEvent);
+		for (const TPair<PxrStructureType, FDelegateHandle>& Handle : HandlesOfPollEvent)
+		{
+			GetPICOXRHMDPtr()->GetEventBus().Unsubscribe(Handle.Key, Handle.Value);
+		}
 	}
+	HandlesOfPollEvent.Reset();
 
 	if (HandleOfPollFuture.IsValid() && GetPICOXRHMDPtr().IsValid())
 	{
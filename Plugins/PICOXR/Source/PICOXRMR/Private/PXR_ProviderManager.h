@@ -156,7 +156,7 @@ private:
 	
 	static TSharedPtr<FPICOXRHMD> PICOXRHMDPtr;
 
-	static FDelegateHandle HandleOfPollEvent;
+	static TArray<TPair<PxrStructureType, FDelegateHandle>> HandlesOfPollEvent;
 	static FDelegateHandle HandleOfPollFuture;
 	static uint64 GlobalUUIDCount;
 	
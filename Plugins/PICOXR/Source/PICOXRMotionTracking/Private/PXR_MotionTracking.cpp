@@ -12,6 +12,7 @@
 #include "PXR_MotionTrackingUtility.h"
 #include "PXR_Utils.h"
 #include "PXR_Log.h"
+#include "PXR_PoseCache.h"
 #include "Async/Async.h"
 
 
@@ -455,13 +456,37 @@ bool PICOXRMotionTracking::GetMotionTrackerMode(EPXRMotionTrackerMode& trackerMo
 
 bool PICOXRMotionTracking::GetMotionTrackerLocations(float WorldToMetersScale, const FString& trackerSN, FPXRMotionTrackerLocations& locations,EPXRMotionTrackerConfidence& Confidence)
 {
+	// Converted locations per tracker, served to every game thread reader within a frame. The runtime can report the
+	// same predicted display time across frames (splash, pause), so the frame is part of the key as well as the epoch.
+	struct FCachedLocations
+	{
+		uint64 Frame;
+		uint64 Epoch;
+		float WorldToMetersScale;
+		FPXRMotionTrackerLocations Locations;
+		EPXRMotionTrackerConfidence Confidence;
+	};
+	static TMap<FString, FCachedLocations> CachedLocations;
+
 	bool bResult = false;
 	double dPredictTime = 0;
-	if (FPICOXRHMDModule::GetPluginWrapper().GetPredictedDisplayTime(&dPredictTime))
+	if (FPXRPoseCache::Get().GetPredictedDisplayTime(&dPredictTime))
 	{
 		return bResult;
 	}
 
+	const bool bUseCache = IsInGameThread();
+	if (bUseCache)
+	{
+		const FCachedLocations* Cached = CachedLocations.Find(trackerSN);
+		if (Cached && Cached->Frame == GFrameCounter && Cached->Epoch == FPXRPoseCache::Get().GetEpoch() && Cached->WorldToMetersScale == WorldToMetersScale)
+		{
+			locations = Cached->Locations;
+			Confidence = Cached->Confidence;
+			return true;
+		}
+	}
+
 	PxrMotionTrackerLocations MotionTrackerLocations = {};
 	int32 ConfidenceInt = 0;
 	bResult = PXRP_SUCCESS(FPICOXRHMDModule::GetPluginWrapper().GetMotionTrackerLocationsWithConfidence(dPredictTime,TCHAR_TO_ANSI(*trackerSN),&MotionTrackerLocations,&ConfidenceInt));
@@ -496,7 +521,11 @@ bool PICOXRMotionTracking::GetMotionTrackerLocations(float WorldToMetersScale, c
 		locations.GlobalPose.AngularVelocity = FVector(-static_cast<float>(MotionTrackerLocations.globalPose.angularVelocity[2]), static_cast<float>(MotionTrackerLocations.globalPose.angularVelocity[0]), static_cast<float>(MotionTrackerLocations.globalPose.angularVelocity[1]));
 		locations.GlobalPose.LinearAcceleration = FVector(-static_cast<float>(MotionTrackerLocations.globalPose.linearAcceleration[2]), static_cast<float>(MotionTrackerLocations.globalPose.linearAcceleration[0]), static_cast<float>(MotionTrackerLocations.globalPose.linearAcceleration[1]));
 		locations.GlobalPose.LinearVelocity = FVector(-static_cast<float>(MotionTrackerLocations.globalPose.linearVelocity[2]), static_cast<float>(MotionTrackerLocations.globalPose.linearVelocity[0]), static_cast<float>(MotionTrackerLocations.globalPose.linearVelocity[1]));
-		
+
+		if (bUseCache)
+		{
+			CachedLocations.Add(trackerSN, FCachedLocations{ GFrameCounter, FPXRPoseCache::Get().GetEpoch(), WorldToMetersScale, locations, Confidence });
+		}
 	}
 
 	return bResult;
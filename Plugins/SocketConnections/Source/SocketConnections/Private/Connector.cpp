@@ -1,30 +1,68 @@
-// Connector.cpp: 多线程 Socket 连接实现，提供蓝图接口与委托广播
+// Connector.cpp: 基于共享 I/O 反应器的 Socket 连接实现，提供蓝图接口与委托广播
 
 #include "Connector.h"
+#include "SocketReactor.h"
+#include "FrameAssembler.h"
+#include "SendQueue.h"
+#include "Reconnect.h"
 #include "Sockets.h"
 #include "SocketSubsystem.h"
-#include "HAL/Runnable.h"
-#include "HAL/RunnableThread.h"
 #include "Misc/ScopeLock.h"
-#include "Async/Async.h"
+#include "HAL/ThreadSafeCounter.h"
+#include "Containers/Queue.h"
 #include "Logging/LogMacros.h"
 
 // 本文件内使用的日志分类
 DEFINE_LOG_CATEGORY_STATIC(LogSocketConnections, Log, All);
 
-// 工作线程：负责创建 Socket、维护连接与接收循环
-class FSocketWorker : public FRunnable
+// 接收缓冲区大小，每个连接复用一份
+static const int32 RECV_BUFFER_SIZE = 64 * 1024;
+
+// I/O 线程投递给游戏线程的事件，按产生顺序在 AConnector::Tick 中统一广播
+enum class EConnectorEventType : uint8
+{
+    Message,
+    State,
+    Error,
+    // 自动重连成功，会话恢复消息已排在发送队列最前
+    Resumed
+};
+
+struct FConnectorEvent
+{
+    EConnectorEventType type;
+    ESocketState state;
+    FString text;
+};
+
+// 工作者：负责创建 Socket、维护连接与收发；所有 ISocketReactorHandler 回调均在反应器 I/O 线程执行
+class FSocketWorker : public ISocketReactorHandler
 {
 public:
     FSocketWorker(AConnector* inOwner, const FString& inAddress, int32 inPort, bool inUseUdp)
-        : owner(inOwner)
-        , address(inAddress)
+        : address(inAddress)
         , port(inPort)
         , useUdp(inUseUdp)
         , socket(nullptr)
+        , sendQueue(FMath::Max(inOwner->maxSendQueueBytes, 1), inOwner->sendOverflow)
+        , wakeupPending(false)
         , shouldStop(false)
         , connected(false)
+        , connecting(false)
+        , connectDeadline(0.0)
+        , autoReconnect(inOwner->autoReconnect && !inUseUdp)
+        , keepSpareConnection(inOwner->keepSpareConnection)
+        , backoff(inOwner->reconnectInitialDelay, inOwner->reconnectMaxDelay, inOwner->reconnectJitter)
+        , reconnectAt(0.0)
+        , hasConnected(false)
+        , framingMode(inOwner->framingMode)
+        , deliverFramesAsString(inOwner->deliverFramesAsString)
+        , onFrame(inOwner->onFrameReceivedNative)
+        , frameAssembler(RECV_BUFFER_SIZE, FMath::Max(inOwner->maxFrameSize, 1))
     {
+        // 分帧模式下 TCP 直接写入 frameAssembler 的环形缓冲区，recvBuffer 仅供字符串模式与 UDP 使用
+        if (useUdp || framingMode == EConnectorFraming::String)
+            recvBuffer.SetNumUninitialized(RECV_BUFFER_SIZE);
     }
 
     virtual ~FSocketWorker()
@@ -32,27 +70,17 @@ public:
         CloseSocket();
     }
 
-    virtual bool Init() override
+    // 注册到反应器，连接在 I/O 线程中发起
+    void Start()
     {
-        shouldStop = false;
-        connected = false;
-        return true;
+        FSocketReactor::Get().Register(AsShared());
     }
 
-    virtual uint32 Run() override
-    {
-        // 根据协议初始化并进入接收循环
-        if (useUdp)
-            UdpRecvLoop();
-        else
-            TcpRecvLoop();
-
-        return 0;
-    }
-
-    virtual void Stop() override
+    // 请求停止：由 AConnector 在游戏线程调用，不等待 I/O 线程，Socket 在注销回调中关闭
+    void RequestStop()
     {
         shouldStop = true;
+        FSocketReactor::Get().Unregister(AsShared());
     }
 
     bool IsConnected() const
@@ -60,45 +88,107 @@ public:
         return connected;
     }
 
-    bool SendString(const FString& message)
+    // 游戏线程每帧调用一次：取出队列中的全部事件并广播
+    // LatestOnly 策略下，相邻的消息只保留最后一条；状态与错误事件始终按顺序逐条广播
+    void DrainEvents(AConnector* connector, EConnectorDelivery delivery)
+    {
+        FConnectorEvent event;
+        FString latest;
+        bool hasLatest = false;
+        while (!shouldStop && events.Dequeue(event))
+        {
+            if (event.type == EConnectorEventType::Message)
+            {
+                if (delivery == EConnectorDelivery::AllMessages)
+                {
+                    connector->onMessageReceived.Broadcast(event.text);
+                }
+                else
+                {
+                    latest = MoveTemp(event.text);
+                    hasLatest = true;
+                }
+                continue;
+            }
+
+            // 先交付被合并的最新消息，保证其仍排在之后的状态变化之前
+            if (hasLatest)
+            {
+                hasLatest = false;
+                connector->onMessageReceived.Broadcast(latest);
+            }
+
+            if (event.type == EConnectorEventType::State)
+                connector->onConnectorStateChanged.Broadcast(event.state);
+            else if (event.type == EConnectorEventType::Error)
+                connector->onConnectorError.Broadcast(event.text);
+            else
+                connector->onSessionResumed.Broadcast();
+        }
+
+        if (hasLatest && !shouldStop)
+            connector->onMessageReceived.Broadcast(latest);
+    }
+
+    bool SendString(const FString& message, bool replaceable)
     {
         if (message.IsEmpty())
             return false;
 
-        FScopeLock scopeLock(&socketMutex);
-        if (!socket || !connected) 
+        FTCHARToUTF8 converter(*message);
+        return SendBytes((const uint8*)converter.Get(), converter.Length(), replaceable);
+    }
+
+    // 发送原始字节：只入队并唤醒 I/O 线程，不在调用线程做系统调用；TCP 分帧模式下在前面加上长度前缀
+    bool SendBytes(const uint8* data, int32 length, bool replaceable)
+    {
+        if (!connected)
         {
             UE_LOG(LogSocketConnections, Warning, TEXT("TCP Send 失败: Socket未连接"));
             BroadcastError(TEXT("发送失败：Socket 未连接"));
             return false;
         }
 
-        FTCHARToUTF8 converter(*message);
-        int32 bytesSent = 0;
-        if (useUdp)
-        {
-            if (!remoteAddr.IsValid())
-            {
-                BroadcastError(TEXT("发送失败：UDP 远端地址无效"));
-                return false;
-            }
-            const bool ok = socket->SendTo((uint8*)converter.Get(), converter.Length(), bytesSent, *remoteAddr) && bytesSent > 0;
-            if (!ok) 
-                BroadcastError(TEXT("UDP 发送失败"));
-
-            return ok;
-        }
-        else
+        if (!EnqueueBytes(data, length, replaceable))
         {
-            const bool ok = socket->Send((uint8*)converter.Get(), converter.Length(), bytesSent) && bytesSent > 0;
-            if (!ok) BroadcastError(TEXT("TCP 发送失败"));
-            return ok;
+            UE_LOG(LogSocketConnections, Warning, TEXT("Send 失败: 发送队列已满(%lld 字节)"), sendQueue.GetStats().queuedBytes);
+            BroadcastError(TEXT("发送失败：发送队列已满"));
+            return false;
         }
+
+        // 已有未处理的唤醒时不再重复投递，I/O 线程会一次写出队列中的全部消息
+        if (!wakeupPending.AtomicSet(true))
+            FSocketReactor::Get().Wakeup(AsShared());
+        return true;
+    }
+
+    FConnectorSendStats GetSendStats() const
+    {
+        return sendQueue.GetStats();
+    }
+
+    // 数据流中断的累计次数：发送队列丢弃、拒绝、覆盖的消息与重连（对端状态已丢失）之和
+    int64 GetLossCount() const
+    {
+        const FConnectorSendStats stats = sendQueue.GetStats();
+        return (int64)stats.droppedMessages + stats.rejectedMessages + stats.overwrittenMessages + sessionResumes.GetValue();
+    }
+
+    // UDP 数据报与长度前缀帧都能在对端还原消息边界，String 模式的 TCP 字节流不能
+    bool PreservesFrameBoundaries() const
+    {
+        return useUdp || framingMode == EConnectorFraming::LengthPrefixed;
+    }
+
+    // 设置会话恢复消息：自动重连成功后先于其它消息发出（如 GlobalConfigCommand 生成的配置指令）
+    void SetResumeMessage(const FString& message)
+    {
+        FScopeLock lock(&resumeMutex);
+        resumeMessage = message;
     }
 
     void CloseSocket()
     {
-        FScopeLock scopeLock(&socketMutex);
         if (socket)
         {
             socket->Close();
@@ -106,191 +196,353 @@ public:
             socket = nullptr;
         }
         connected = false;
+        connecting = false;
+        sendQueue.Reset();
     }
 
-private:
-    // TCP 接收循环：非阻塞连接 + 轮询状态，随后非阻塞接收
-    void TcpRecvLoop()
+    // ===================== ISocketReactorHandler =====================
+    virtual FSocket* GetSocket() const override
     {
-        ISocketSubsystem* s = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM);
-        if (!s)
+        return socket;
+    }
+
+    virtual bool WantsWrite() const override
+    {
+        // 非阻塞握手期间通过可写事件判断连接完成；连接后仅在发送队列有积压时关注可写
+        return connecting || (connected && sendQueue.HasPending());
+    }
+
+    virtual double GetDeadline() const override
+    {
+        return connecting ? connectDeadline : reconnectAt;
+    }
+
+    virtual void OnRegistered() override
+    {
+        if (shouldStop)
+            return;
+
+        if (useUdp)
+            OpenUdp();
+        else
+            OpenTcp();
+    }
+
+    virtual void OnReadable() override
+    {
+        if (useUdp)
+            ReadUdp();
+        else if (framingMode == EConnectorFraming::LengthPrefixed)
+            ReadTcpFramed();
+        else
+            ReadTcp();
+    }
+
+    virtual void OnWritable() override
+    {
+        if (connecting)
+            CheckTcpConnect();
+        else
+            FlushSendQueue();
+    }
+
+    virtual void OnWakeup() override
+    {
+        // 先清标记再发送，保证发送期间新入队的消息能再次唤醒
+        wakeupPending = false;
+        FlushSendQueue();
+    }
+
+    virtual void OnDeadline(double now) override
+    {
+        if (!connecting)
         {
-            BroadcastError(TEXT("当前平台的 SocketSubsystem 不可用"));
-            BroadcastState(ESocketState::Unconnect);
+            // 退避等待结束，发起重连
+            if (reconnectAt > 0.0 && now >= reconnectAt)
+            {
+                reconnectAt = 0.0;
+                Reconnect();
+            }
             return;
         }
 
-        TSharedRef<FInternetAddr> addr = s->CreateInternetAddr();
-        bool ipOk = false;
-        addr->SetIp(*address, ipOk);
-        addr->SetPort(port);
-        if (!ipOk)
+        // 超时未连接（通常为远端不可达或被防火墙拒绝）
+        const ESocketErrors lastError = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->GetLastErrorCode();
+        UE_LOG(LogSocketConnections, Warning, TEXT("TCP 连接超时(%.2fs)，lastError=%d，断开：%s:%d"), CONNECT_TIMEOUT_SEC, (int32)lastError, *address, port);
+        Disconnect(FString::Printf(TEXT("TCP 连接超时(%.2fs)"), CONNECT_TIMEOUT_SEC));
+    }
+
+    virtual void OnUnregistered() override
+    {
+        // 由 AConnector::Stop 触发，状态广播已在游戏线程完成
+        CloseSocket();
+        reconnectAt = 0.0;
+        if (spare.IsValid())
         {
-            BroadcastError(FString::Printf(TEXT("非法 IP 地址: %s:%d"), *address, port));
-            BroadcastState(ESocketState::Unconnect);
-            return;
+            FSocketReactor::Get().Unregister(spare.ToSharedRef());
+            spare.Reset();
         }
+    }
 
-        // 创建 Socket：连接阶段使用非阻塞，接收阶段切换为阻塞
-        socket = s->CreateSocket(NAME_Stream, TEXT("SocketConnectionsTCP"), false);
+private:
+    // TCP 连接：非阻塞 connect，握手结果由反应器的可写事件与超时回调驱动
+    void OpenTcp()
+    {
+        FString error;
+        socket = CreateConnectingTcpSocket(address, port, error);
         if (!socket)
         {
-            BroadcastError(TEXT("CreateSocket 失败"));
+            // 地址或平台问题，重试也无法恢复
+            BroadcastError(error);
             BroadcastState(ESocketState::Unconnect);
             return;
         }
-        socket->SetNonBlocking(true);
-        socket->SetReuseAddr(true);
-        socket->SetNoDelay(true);
-
-        // 发起连接并在更长的时间窗口内轮询状态（避免误判慢网络为失败）
-        // 注意：非阻塞 connect 返回 false 并不一定是错误，常见为“正在握手”(EWOULDBLOCK/EINPROGRESS)
-        const bool connectInitiated = socket->Connect(*addr);
-        if (!connectInitiated)
+
+        // TCP 握手可能较慢，给足超时时间，避免误判慢网络为失败
+        connecting = true;
+        connectDeadline = FPlatformTime::Seconds() + CONNECT_TIMEOUT_SEC;
+    }
+
+    // 握手阶段收到可写事件：确认连接结果
+    void CheckTcpConnect()
+    {
+        const ESocketConnectionState state = socket->GetConnectionState();
+        if (state == SCS_Connected)
         {
-            const ESocketErrors lastError = s->GetLastErrorCode();
-            UE_LOG(LogSocketConnections, Verbose, TEXT("TCP 非阻塞 connect 返回 false，lastError=%d (可能为握手进行中) -> %s:%d"), (int32)lastError, *address, port);
+            connecting = false;
+            UE_LOG(LogSocketConnections, Log, TEXT("TCP 握手成功：%s:%d"), *address, port);
+            OnSessionEstablished();
         }
-        const double start = FPlatformTime::Seconds();
-        const double connectTimeoutSec = 5.0; // TCP 握手可能较慢，适当延长超时
-        while (!shouldStop)
+        else if (state == SCS_ConnectionError)
         {
-            // 在非阻塞握手阶段，使用写就绪等待更可靠地判断握手完成（Windows/Linux/Mac）
-            bool writeReady = true;
-#if PLATFORM_WINDOWS || PLATFORM_LINUX || PLATFORM_MAC || PLATFORM_ANDROID
-            writeReady = socket->Wait(ESocketWaitConditions::WaitForWrite, FTimespan::FromMilliseconds(100));
-#endif
+            const ESocketErrors lastError = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->GetLastErrorCode();
+            UE_LOG(LogSocketConnections, Warning, TEXT("TCP 握手错误(lastError=%d)，断开：%s:%d"), (int32)lastError, *address, port);
+            Disconnect(FString::Printf(TEXT("TCP 握手错误，错误码=%d"), (int32)lastError));
+        }
+        // 其它状态（如 NotConnected）继续等待，直到超时回调
+    }
 
-            if (writeReady)
+    // 重连：备用连接已就绪时直接接管其 Socket，否则重新发起握手
+    void Reconnect()
+    {
+        if (spare.IsValid() && spare->IsReady())
+        {
+            socket = spare->Release();
+            if (socket)
             {
-                const ESocketConnectionState state = socket->GetConnectionState();
-                if (state == SCS_Connected)
-                {
-                    connected = true;
-                    BroadcastState(ESocketState::Connected);
-                    // 切换到阻塞式接收：让 Recv 在无数据时阻塞，以可靠检测远端关闭
-                    socket->SetNonBlocking(false);
-                    UE_LOG(LogSocketConnections, Log, TEXT("TCP 握手成功：%s:%d"), *address, port);
-                    break;
-                }
-                else if (state == SCS_ConnectionError)
-                {
-                    const ESocketErrors lastError = s->GetLastErrorCode();
-                    UE_LOG(LogSocketConnections, Warning, TEXT("TCP 握手错误(lastError=%d)，断开：%s:%d"), (int32)lastError, *address, port);
-                    BroadcastError(FString::Printf(TEXT("TCP 握手错误，错误码=%d"), (int32)lastError));
-                    BroadcastState(ESocketState::Unconnect);
-                    CloseSocket();
-                    return;
-                }
-                // 其它状态（如 NotConnected）继续等待，避免误判慢网络
+                UE_LOG(LogSocketConnections, Log, TEXT("TCP 接管备用连接：%s:%d"), *address, port);
+                OnSessionEstablished();
+                return;
             }
+            UE_LOG(LogSocketConnections, Log, TEXT("TCP 备用连接已失效，改为重新握手：%s:%d"), *address, port);
+        }
+
+        UE_LOG(LogSocketConnections, Log, TEXT("TCP 第 %d 次重连：%s:%d"), backoff.GetAttempts(), *address, port);
+        OpenTcp();
+    }
+
+    // 连接建立（首次握手、重连或接管备用连接）；重连时先把会话恢复消息放入队列，再通知游戏线程
+    void OnSessionEstablished()
+    {
+        const bool resumed = hasConnected;
+        hasConnected = true;
+        backoff.Reset();
+
+        if (resumed)
+        {
+            sessionResumes.Increment();
+            EnqueueResumeMessage();
+        }
+
+        connected = true;
+        BroadcastState(ESocketState::Connected);
+        if (resumed)
+        {
+            events.Enqueue({ EConnectorEventType::Resumed, ESocketState::Connected, FString() });
+            FlushSendQueue();
+        }
+
+        // 首次连上后开始预热备用连接
+        if (autoReconnect && keepSpareConnection && !spare.IsValid())
+        {
+            spare = MakeShared<FSpareConnection, ESPMode::ThreadSafe>(address, port, backoff);
+            FSocketReactor::Get().Register(spare.ToSharedRef());
+        }
+    }
+
+    // TCP 连接断开或握手失败：开启自动重连时按退避时间安排重连（备用连接就绪则立即接管），否则通知未连接
+    void Disconnect(const FString& reason)
+    {
+        CloseSocket();
+        frameAssembler.Reset();
+        BroadcastError(reason);
+
+        if (!autoReconnect || shouldStop)
+        {
+            BroadcastState(ESocketState::Unconnect);
+            return;
+        }
+
+        BroadcastState(ESocketState::Connecting);
+        if (spare.IsValid() && spare->IsReady())
+        {
+            Reconnect();
+            return;
+        }
+
+        const double delay = backoff.NextDelay();
+        reconnectAt = FPlatformTime::Seconds() + delay;
+        UE_LOG(LogSocketConnections, Log, TEXT("TCP 将在 %.2fs 后重连：%s:%d"), delay, *address, port);
+    }
 
-            if (FPlatformTime::Seconds() - start >= connectTimeoutSec)
+    // 入队原始字节，TCP 分帧模式下在前面加上长度前缀
+    bool EnqueueBytes(const uint8* data, int32 length, bool replaceable)
+    {
+        uint8 header[FRAME_HEADER_SIZE];
+        int32 headerSize = 0;
+        if (!useUdp && framingMode == EConnectorFraming::LengthPrefixed)
+        {
+            FFrameAssembler::WriteHeader(header, (uint32)length);
+            headerSize = FRAME_HEADER_SIZE;
+        }
+
+        return sendQueue.Enqueue(header, headerSize, data, length, replaceable);
+    }
+
+    void EnqueueResumeMessage()
+    {
+        FString message;
+        {
+            FScopeLock lock(&resumeMutex);
+            message = resumeMessage;
+        }
+
+        if (message.IsEmpty())
+            return;
+
+        FTCHARToUTF8 converter(*message);
+        if (!EnqueueBytes((const uint8*)converter.Get(), converter.Length(), false))
+            UE_LOG(LogSocketConnections, Warning, TEXT("会话恢复消息入队失败：%s:%d"), *address, port);
+    }
+
+    // 在 I/O 线程写出发送队列；写不完时由反应器在可写后再次回调
+    void FlushSendQueue()
+    {
+        if (!socket || !connected)
+            return;
+
+        const ESendFlushResult result = useUdp ? sendQueue.FlushDatagrams(socket, *remoteAddr) : sendQueue.FlushStream(socket);
+        if (result != ESendFlushResult::Error)
+            return;
+
+        const ESocketErrors lastError = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->GetLastErrorCode();
+        if (useUdp)
+        {
+            UE_LOG(LogSocketConnections, Warning, TEXT("UDP 发送失败(lastError=%d)：%s:%d"), (int32)lastError, *address, port);
+            BroadcastError(TEXT("UDP 发送失败"));
+            return;
+        }
+
+        UE_LOG(LogSocketConnections, Warning, TEXT("TCP 发送失败(lastError=%d)，断开：%s:%d"), (int32)lastError, *address, port);
+        Disconnect(FString::Printf(TEXT("TCP 发送失败，错误码=%d"), (int32)lastError));
+    }
+
+    // 可读事件：读空内核缓冲后返回，等待下一次就绪通知
+    void ReadTcp()
+    {
+        while (socket && connected && !shouldStop)
+        {
+            int32 bytesRead = 0;
+            if (!socket->Recv(recvBuffer.GetData(), recvBuffer.Num(), bytesRead))
             {
-                // 超时未连接（通常为远端不可达或被防火墙拒绝）
-                const ESocketErrors lastError = s->GetLastErrorCode();
-                UE_LOG(LogSocketConnections, Warning, TEXT("TCP 连接超时(%.2fs)，lastError=%d，断开：%s:%d"), connectTimeoutSec, (int32)lastError, *address, port);
-                BroadcastError(FString::Printf(TEXT("TCP 连接超时(%.2fs)"), connectTimeoutSec, (int32)lastError));
-                BroadcastState(ESocketState::Unconnect);
-                CloseSocket();
+                HandleRecvFailure();
                 return;
             }
 
-            FPlatformProcess::Sleep(0.01f);
+            // 无更多数据
+            if (bytesRead <= 0)
+                return;
+
+            BroadcastMessage(UTF8ToFString(recvBuffer.GetData(), bytesRead));
+
+            // 未读满说明内核缓冲已空，省去一次必然返回 EWOULDBLOCK 的系统调用
+            if (bytesRead < recvBuffer.Num())
+                return;
         }
+    }
 
-        // 已连接，进入接收循环（阻塞式 Recv，配合有限等待保证可中断）
-        while (!shouldStop && socket && connected)
+    // 分帧模式的可读事件：Recv 直接写入环形缓冲区，收齐的帧以视图交付，不做逐包分配
+    void ReadTcpFramed()
+    {
+        while (socket && connected && !shouldStop)
         {
-            // 检查连接状态，若服务器关闭或异常，立刻断开并广播
-            ESocketConnectionState current = socket->GetConnectionState();
-            if (current == SCS_ConnectionError)
+            const TArrayView<uint8> region = frameAssembler.GetWritableRegion();
+            int32 bytesRead = 0;
+            if (!socket->Recv(region.GetData(), region.Num(), bytesRead))
             {
-                UE_LOG(LogSocketConnections, Warning, TEXT("TCP 接收循环检测到连接错误，断开：%s:%d"), *address, port);
-                CloseSocket();
-                BroadcastError(TEXT("接收循环检测到连接错误"));
-                BroadcastState(ESocketState::Unconnect);
+                HandleRecvFailure();
                 return;
             }
-            else if (current == SCS_NotConnected)
-            {
-                // 已建立连接后出现 NotConnected，通常表示远端优雅断开或连接丢失
-                UE_LOG(LogSocketConnections, Warning, TEXT("TCP 连接丢失(SCS_NotConnected)，断开：%s:%d"), *address, port);
-                CloseSocket();
-                BroadcastError(TEXT("Tcp服务器断开"));
-                BroadcastState(ESocketState::Unconnect);
+
+            if (bytesRead <= 0)
                 return;
-            }
-            // 使用有限时长等待：兼顾阻塞接收与线程可中断退出
-            // 注意：许多平台在远端关闭时，读取事件也会变为就绪，随后 Recv 返回 0
-            bool readyForRead = true;
-#if PLATFORM_WINDOWS || PLATFORM_LINUX || PLATFORM_MAC || PLATFORM_ANDROID
-            readyForRead = socket->Wait(ESocketWaitConditions::WaitForRead, FTimespan::FromMilliseconds(100));
-#endif
-            if (!readyForRead)
-            {
-                // 超时，无数据到达；继续下一轮以便响应 shouldStop
-                continue;
-            }
 
-            // 执行阻塞接收（在阻塞模式下，若无数据将阻塞，若远端关闭将返回 0）
-            TArray<uint8> buffer;
-            buffer.SetNumUninitialized(64 * 1024);
-            int32 bytesRead = 0;
-            if (socket->Recv(buffer.GetData(), buffer.Num(), bytesRead))
+            frameAssembler.CommitWrite(bytesRead);
+            if (!DispatchFrames())
+                return;
+
+            if (bytesRead < region.Num())
+                return;
+        }
+    }
+
+    // 交付 frameAssembler 中所有完整的帧；帧长度非法时断开并返回 false
+    bool DispatchFrames()
+    {
+        TArrayView<const uint8> payload;
+        while (true)
+        {
+            const EFrameResult result = frameAssembler.NextFrame(payload);
+            if (result == EFrameResult::NeedMore)
+                return true;
+
+            if (result == EFrameResult::Oversize)
             {
-                // 如果 bytesRead == 0，表示远端优雅断开
-                if (bytesRead == 0)
-                {
-                    UE_LOG(LogSocketConnections, Warning, TEXT("TCP 接收到长度为 0 的数据(优雅断开)，断开：%s:%d"), *address, port);
-                    CloseSocket();
-                    BroadcastError(TEXT("Tcp服务器断开"));
-                    BroadcastState(ESocketState::Unconnect);
-                    return;
-                }
-                FString msg = UTF8ToFString(buffer.GetData(), bytesRead);
-                BroadcastMessage(msg);
+                UE_LOG(LogSocketConnections, Warning, TEXT("TCP 帧长度超出上限(%d 字节)，断开：%s:%d"), frameAssembler.GetMaxFrameSize(), *address, port);
+                Disconnect(FString::Printf(TEXT("帧长度超出上限(%d 字节)"), frameAssembler.GetMaxFrameSize()));
+                return false;
             }
-            else
-            {
-                // Recv 失败：优先判断 bytesRead==0（常见于远端优雅断开，Windows/Android 均会出现）
-                if (bytesRead == 0)
-                {
-                    UE_LOG(LogSocketConnections, Warning, TEXT("TCP Recv 返回 false 且 bytesRead==0，判定为远端优雅断开：%s:%d"), *address, port);
-                    CloseSocket();
-                    BroadcastError(TEXT("Tcp服务器断开"));
-                    BroadcastState(ESocketState::Unconnect);
-                    return;
-                }
 
-                // 若非优雅断开，则检查连接状态与错误码，处理网络错误/异常断开
-                const ESocketConnectionState afterRecv = socket->GetConnectionState();
-                if (afterRecv == SCS_ConnectionError)
-                {
-                    const ESocketErrors lastError = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->GetLastErrorCode();
-                    UE_LOG(LogSocketConnections, Warning, TEXT("TCP Recv 失败后检测到 ConnectionError(lastError=%d)，断开：%s:%d"), (int32)lastError, *address, port);
-                    CloseSocket();
-                    BroadcastError(FString::Printf(TEXT("TCP 接收失败，错误码=%d"), (int32)lastError));
-                    BroadcastState(ESocketState::Unconnect);
-                    return;
-                }
-                else if (afterRecv == SCS_NotConnected)
-                {
-                    UE_LOG(LogSocketConnections, Warning, TEXT("TCP Recv 失败后检测到 NotConnected，断开：%s:%d"), *address, port);
-                    CloseSocket();
-                    BroadcastError(TEXT("接收失败后检测到 NotConnected"));
-                    BroadcastState(ESocketState::Unconnect);
-                    return;
-                }
-            }
+            DeliverFrame(payload);
         }
+    }
 
-        CloseSocket();
-        BroadcastState(ESocketState::Unconnect);
+    // 交付一帧：先同步回调原生委托，再按需转为字符串送往游戏线程
+    void DeliverFrame(TArrayView<const uint8> payload)
+    {
+        onFrame.Broadcast(payload);
+        if (deliverFramesAsString)
+            BroadcastMessage(UTF8ToFString(payload.GetData(), payload.Num()));
+    }
+
+    // 非阻塞 Recv 返回 false：远端优雅断开（recv 返回 0）或连接错误；EWOULDBLOCK 不会走到这里
+    void HandleRecvFailure()
+    {
+        const ESocketConnectionState afterRecv = socket->GetConnectionState();
+        if (afterRecv == SCS_ConnectionError)
+        {
+            const ESocketErrors lastError = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->GetLastErrorCode();
+            UE_LOG(LogSocketConnections, Warning, TEXT("TCP Recv 失败后检测到 ConnectionError(lastError=%d)，断开：%s:%d"), (int32)lastError, *address, port);
+            Disconnect(FString::Printf(TEXT("TCP 接收失败，错误码=%d"), (int32)lastError));
+            return;
+        }
+
+        UE_LOG(LogSocketConnections, Warning, TEXT("TCP 连接被远端关闭，断开：%s:%d"), *address, port);
+        Disconnect(TEXT("Tcp服务器断开"));
     }
 
-    // UDP 接收循环：绑定到本地端口，使用 RecvFrom 读取并广播
-    void UdpRecvLoop()
+    // UDP：绑定到本地端口，使用 RecvFrom 读取并广播
+    void OpenUdp()
     {
         ISocketSubsystem* s = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM);
         if (!s)
@@ -313,15 +565,17 @@ private:
         }
 
         // 创建 UDP socket 并绑定本地端口
-        socket = s->CreateSocket(NAME_DGram, TEXT("SocketConnectionsUDP"), false);
-        if (!socket)
+        FSocket* newSocket = s->CreateSocket(NAME_DGram, TEXT("SocketConnectionsUDP"), false);
+        if (!newSocket)
         {
             BroadcastError(TEXT("CreateSocket 失败(UDP)"));
             BroadcastState(ESocketState::Unconnect);
             return;
         }
-        socket->SetNonBlocking(true);
-        socket->SetReuseAddr(true);
+        newSocket->SetNonBlocking(true);
+        newSocket->SetReuseAddr(true);
+
+        socket = newSocket;
 
         // 绑定到任意本地地址:port（若端口被占用，绑定失败）
         TSharedRef<FInternetAddr> local = s->CreateInternetAddr();
@@ -335,32 +589,26 @@ private:
             return;
         }
 
+        sender = s->CreateInternetAddr();
         connected = true; // UDP 无连接态，绑定成功即视为可通信
         BroadcastState(ESocketState::Connected);
+    }
 
-        TSharedRef<FInternetAddr> sender = s->CreateInternetAddr();
-        while (!shouldStop && socket)
+    // 可读事件：逐个读取数据报直到队列为空
+    void ReadUdp()
+    {
+        while (socket && !shouldStop)
         {
-            uint32 pendingSize = 0;
-            if (socket->HasPendingData(pendingSize) && pendingSize > 0)
-            {
-                TArray<uint8> buffer;
-                buffer.SetNumUninitialized(FMath::Min<int32>(pendingSize, 64 * 1024));
-                int32 bytesRead = 0;
-                if (socket->RecvFrom(buffer.GetData(), buffer.Num(), bytesRead, *sender))
-                {
-                    FString msg = UTF8ToFString(buffer.GetData(), bytesRead);
-                    BroadcastMessage(msg);
-                }
-            }
+            int32 bytesRead = 0;
+            if (!socket->RecvFrom(recvBuffer.GetData(), recvBuffer.Num(), bytesRead, *sender) || bytesRead <= 0)
+                return;
+
+            // 数据报天然有边界，分帧模式下直接作为一帧交付
+            if (framingMode == EConnectorFraming::LengthPrefixed)
+                DeliverFrame(TArrayView<const uint8>(recvBuffer.GetData(), bytesRead));
             else
-            {
-                FPlatformProcess::Sleep(0.01f);
-            }
+                BroadcastMessage(UTF8ToFString(recvBuffer.GetData(), bytesRead));
         }
-
-        CloseSocket();
-        BroadcastState(ESocketState::Unconnect);
     }
 
     // 将字节数组按 UTF-8 转为 FString
@@ -374,64 +622,78 @@ private:
         return FString(conv.Get(), conv.Length());
     }
 
-    // 在游戏线程广播消息
-    void BroadcastMessage(const FString& msg)
+    // 投递消息，下一次 Tick 时在游戏线程广播
+    void BroadcastMessage(FString&& msg)
     {
-        if (!owner)
-            return;
-
-        AsyncTask(ENamedThreads::GameThread, [o = owner, msg]
-        {
-            o->onMessageReceived.Broadcast(msg);
-        });
+        events.Enqueue({ EConnectorEventType::Message, ESocketState::Unconnect, MoveTemp(msg) });
     }
 
-    // 在游戏线程广播状态变化
+    // 投递状态变化，下一次 Tick 时在游戏线程广播
     void BroadcastState(ESocketState state)
     {
-        if (!owner)
-        {
-            return;
-        }
-        AsyncTask(ENamedThreads::GameThread, [o = owner, state]
-        {
-            o->onConnectorStateChanged.Broadcast(state);
-        });
+        events.Enqueue({ EConnectorEventType::State, state, FString() });
     }
 
-    // 在游戏线程广播错误原因
+    // 投递错误原因，下一次 Tick 时在游戏线程广播
     void BroadcastError(const FString& reason)
     {
-        if (!owner)
-            return;
-        AsyncTask(ENamedThreads::GameThread, [o = owner, reason]
-        {
-            o->onConnectorError.Broadcast(reason);
-        });
+        events.Enqueue({ EConnectorEventType::Error, ESocketState::Unconnect, reason });
     }
 
 private:
-    AConnector* owner;
+    static constexpr double CONNECT_TIMEOUT_SEC = 5.0;
+
+    // 多生产者（I/O 线程与发送线程）、单消费者（游戏线程）的无锁队列
+    TQueue<FConnectorEvent, EQueueMode::Mpsc> events;
+
     FString address;
     int32 port;
     bool useUdp;
 
     FSocket* socket;
     TSharedPtr<FInternetAddr> remoteAddr;
+    TSharedPtr<FInternetAddr> sender;
+    TArray<uint8> recvBuffer;
 
-    FCriticalSection socketMutex;
+    FSendQueue sendQueue;
+    FThreadSafeBool wakeupPending;
     FThreadSafeBool shouldStop;
     FThreadSafeBool connected;
+
+    // 仅 I/O 线程访问
+    bool connecting;
+    double connectDeadline;
+
+    // 自动重连（仅 TCP），设置创建时从 AConnector 拷贝；以下状态仅 I/O 线程访问
+    bool autoReconnect;
+    bool keepSpareConnection;
+    FReconnectBackoff backoff;
+    // 下一次重连的时间点，<= 0 表示未安排重连
+    double reconnectAt;
+    // 是否曾连上过，用于区分首次连接与重连
+    bool hasConnected;
+    TSharedPtr<FSpareConnection, ESPMode::ThreadSafe> spare;
+
+    FCriticalSection resumeMutex;
+    FString resumeMessage;
+    FThreadSafeCounter sessionResumes;
+
+    // 分帧设置，创建时从 AConnector 拷贝，连接期间不变
+    EConnectorFraming framingMode;
+    bool deliverFramesAsString;
+    FOnConnectorFrameNative onFrame;
+    FFrameAssembler frameAssembler;
 };
 
 // ===================== AConnector =====================
 AConnector::AConnector()
-    : worker(nullptr)
-    , thread(nullptr)
-    , connectPort(0)
+    : connectPort(0)
     , useUdp(false)
 {
-    PrimaryActorTick.bCanEverTick = false; // 默认关闭 Tick；采用后台线程接收
+    // 收发由共享 I/O 反应器线程驱动；Tick 仅在连接期间开启，用于批量广播收到的事件
+    PrimaryActorTick.bCanEverTick = true;
+    PrimaryActorTick.bStartWithTickEnabled = false;
+    PrimaryActorTick.bTickEvenWhenPaused = true;
 }
 
 void AConnector::BeginPlay()
@@ -439,14 +701,24 @@ void AConnector::BeginPlay()
     Super::BeginPlay();
 }
 
+void AConnector::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    Stop();
+    Super::EndPlay(EndPlayReason);
+}
+
 void AConnector::Tick(float DeltaTime)
 {
     Super::Tick(DeltaTime);
+
+    // 持有局部引用：委托回调中可能调用 Stop/TryConnectServer 替换 worker
+    if (TSharedPtr<FSocketWorker, ESPMode::ThreadSafe> current = worker)
+        current->DrainEvents(this, deliveryPolicy);
 }
 
 void AConnector::TryConnectServer(const FString& address, int32 port, bool inUseUdp)
 {
-    // 用法：蓝图调用，设置地址/端口/协议并启动接收线程
+    // 用法：蓝图调用，设置地址/端口/协议并注册到共享 I/O 反应器
     Stop();
 
     connectAddress = address;
@@ -456,8 +728,10 @@ void AConnector::TryConnectServer(const FString& address, int32 port, bool inUse
     // 在主线程通知“连接中”
     onConnectorStateChanged.Broadcast(ESocketState::Connecting);
 
-    worker = new FSocketWorker(this, connectAddress, connectPort, useUdp);
-    thread = FRunnableThread::Create(worker, TEXT("SocketConnectionsWorker"));
+    worker = MakeShared<FSocketWorker, ESPMode::ThreadSafe>(this, connectAddress, connectPort, useUdp);
+    worker->SetResumeMessage(resumeMessage);
+    worker->Start();
+    SetActorTickEnabled(true);
 }
 
 bool AConnector::SendString(const FString& message)
@@ -465,30 +739,68 @@ bool AConnector::SendString(const FString& message)
     FScopeLock scopeLock(&sendMutex);
     if (!worker)
     {
-        UE_LOG(LogSocketConnections, Warning, TEXT("TCP Send 失败: 未启动工作线程"));
+        UE_LOG(LogSocketConnections, Warning, TEXT("TCP Send 失败: 未启动连接"));
         onConnectorError.Broadcast(TEXT("发送失败：未连接服务端"));
         return false;
     }
 
-    return worker->SendString(message);
+    return worker->SendString(message, false);
 }
 
-void AConnector::Stop()
+bool AConnector::SendStringLatest(const FString& message)
+{
+    FScopeLock scopeLock(&sendMutex);
+    if (!worker)
+    {
+        UE_LOG(LogSocketConnections, Warning, TEXT("TCP Send 失败: 未启动连接"));
+        onConnectorError.Broadcast(TEXT("发送失败：未连接服务端"));
+        return false;
+    }
+
+    return worker->SendString(message, true);
+}
+
+void AConnector::SetResumeMessage(const FString& message)
 {
-    // 用法：蓝图调用，停止并释放连接资源
+    FScopeLock scopeLock(&sendMutex);
+    resumeMessage = message;
     if (worker)
-        worker->Stop();
+        worker->SetResumeMessage(message);
+}
 
-    if (thread)
+FConnectorSendStats AConnector::GetSendStats() const
+{
+    return worker ? worker->GetSendStats() : FConnectorSendStats();
+}
+
+bool AConnector::SendFrame(TArrayView<const uint8> payload)
+{
+    FScopeLock scopeLock(&sendMutex);
+    if (!worker)
     {
-        thread->WaitForCompletion();
-        delete thread;
-        thread = nullptr;
+        UE_LOG(LogSocketConnections, Warning, TEXT("TCP Send 失败: 未启动连接"));
+        onConnectorError.Broadcast(TEXT("发送失败：未连接服务端"));
+        return false;
     }
+
+    return worker->SendBytes(payload.GetData(), payload.Num(), false);
+}
+
+FConnectorSender AConnector::GetSender() const
+{
+    FConnectorSender sender;
+    sender.worker = worker;
+    return sender;
+}
+
+void AConnector::Stop()
+{
+    // 用法：蓝图调用，停止并释放连接资源；Socket 由 I/O 线程异步关闭，不阻塞游戏线程
     if (worker)
     {
-        delete worker;
-        worker = nullptr;
+        worker->RequestStop();
+        worker.Reset();
+        SetActorTickEnabled(false);
     }
 
     onConnectorStateChanged.Broadcast(ESocketState::Unconnect);
@@ -499,3 +811,27 @@ bool AConnector::IsConnected() const
     return worker && worker->IsConnected();
 }
 
+// ===================== FConnectorSender =====================
+bool FConnectorSender::SendFrame(TArrayView<const uint8> payload, bool replaceable) const
+{
+    TSharedPtr<FSocketWorker, ESPMode::ThreadSafe> pinned = worker.Pin();
+    return pinned && pinned->SendBytes(payload.GetData(), payload.Num(), replaceable);
+}
+
+bool FConnectorSender::IsConnected() const
+{
+    TSharedPtr<FSocketWorker, ESPMode::ThreadSafe> pinned = worker.Pin();
+    return pinned && pinned->IsConnected();
+}
+
+int64 FConnectorSender::GetLossCount() const
+{
+    TSharedPtr<FSocketWorker, ESPMode::ThreadSafe> pinned = worker.Pin();
+    return pinned ? pinned->GetLossCount() : 0;
+}
+
+bool FConnectorSender::PreservesFrameBoundaries() const
+{
+    TSharedPtr<FSocketWorker, ESPMode::ThreadSafe> pinned = worker.Pin();
+    return pinned && pinned->PreservesFrameBoundaries();
+}
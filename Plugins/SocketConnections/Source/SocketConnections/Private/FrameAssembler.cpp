@@ -0,0 +1,108 @@
+// FrameAssembler.cpp: 长度前缀分帧实现
+
+#include "FrameAssembler.h"
+
+FFrameAssembler::FFrameAssembler(int32 inInitialCapacity, int32 inMaxFrameSize)
+    : head(0)
+    , tail(0)
+    , maxFrameSize(inMaxFrameSize)
+{
+    const int32 capacity = (int32)FMath::RoundUpToPowerOfTwo((uint32)FMath::Max(inInitialCapacity, FRAME_HEADER_SIZE * 2));
+    ring.SetNumUninitialized(capacity);
+    mask = (uint32)capacity - 1;
+}
+
+TArrayView<uint8> FFrameAssembler::GetWritableRegion()
+{
+    // 环已满时只可能是一帧尚未收全且超过当前容量，NextFrame 会先扩容，这里兜底再扩一倍
+    if (Num() == Capacity())
+        Grow(Capacity() * 2);
+
+    const uint32 start = tail & mask;
+    const int32 freeBytes = Capacity() - Num();
+    const int32 contiguous = FMath::Min(freeBytes, Capacity() - (int32)start);
+    return TArrayView<uint8>(ring.GetData() + start, contiguous);
+}
+
+void FFrameAssembler::CommitWrite(int32 bytes)
+{
+    check(bytes >= 0 && bytes <= Capacity() - Num());
+    tail += (uint32)bytes;
+}
+
+EFrameResult FFrameAssembler::NextFrame(TArrayView<const uint8>& outPayload)
+{
+    if (Num() < FRAME_HEADER_SIZE)
+        return EFrameResult::NeedMore;
+
+    uint8 header[FRAME_HEADER_SIZE];
+    CopyOut(head, header, FRAME_HEADER_SIZE);
+    const uint32 payloadSize = ((uint32)header[0] << 24) | ((uint32)header[1] << 16) | ((uint32)header[2] << 8) | (uint32)header[3];
+    if (payloadSize > (uint32)maxFrameSize)
+        return EFrameResult::Oversize;
+
+    const int32 frameSize = FRAME_HEADER_SIZE + (int32)payloadSize;
+    if (Num() < frameSize)
+    {
+        // 整帧放不进当前环：提前扩容，后续 Recv 才有空间
+        if (frameSize > Capacity())
+            Grow(frameSize);
+        return EFrameResult::NeedMore;
+    }
+
+    const uint32 start = (head + FRAME_HEADER_SIZE) & mask;
+    if (start + payloadSize <= (uint32)Capacity())
+    {
+        // 常见路径：payload 在环内连续，直接交付视图
+        outPayload = TArrayView<const uint8>(ring.GetData() + start, (int32)payloadSize);
+    }
+    else
+    {
+        scratch.SetNumUninitialized((int32)payloadSize, EAllowShrinking::No);
+        CopyOut(head + FRAME_HEADER_SIZE, scratch.GetData(), (int32)payloadSize);
+        outPayload = TArrayView<const uint8>(scratch.GetData(), (int32)payloadSize);
+    }
+
+    head += (uint32)frameSize;
+    return EFrameResult::Frame;
+}
+
+void FFrameAssembler::Reset()
+{
+    head = 0;
+    tail = 0;
+}
+
+void FFrameAssembler::WriteHeader(uint8* out, uint32 payloadSize)
+{
+    out[0] = (uint8)(payloadSize >> 24);
+    out[1] = (uint8)(payloadSize >> 16);
+    out[2] = (uint8)(payloadSize >> 8);
+    out[3] = (uint8)payloadSize;
+}
+
+void FFrameAssembler::CopyOut(uint32 offset, uint8* out, int32 count) const
+{
+    const uint32 start = offset & mask;
+    const int32 first = FMath::Min(count, Capacity() - (int32)start);
+    FMemory::Memcpy(out, ring.GetData() + start, first);
+    if (count > first)
+        FMemory::Memcpy(out + first, ring.GetData(), count - first);
+}
+
+void FFrameAssembler::Grow(int32 minCapacity)
+{
+    const int32 newCapacity = (int32)FMath::RoundUpToPowerOfTwo((uint32)minCapacity);
+    if (newCapacity <= Capacity())
+        return;
+
+    TArray<uint8> newRing;
+    newRing.SetNumUninitialized(newCapacity);
+    const int32 count = Num();
+    CopyOut(head, newRing.GetData(), count);
+
+    ring = MoveTemp(newRing);
+    mask = (uint32)newCapacity - 1;
+    head = 0;
+    tail = (uint32)count;
+}
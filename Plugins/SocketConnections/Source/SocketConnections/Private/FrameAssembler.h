@@ -0,0 +1,71 @@
+// FrameAssembler.h: 长度前缀分帧的环形缓冲区，Recv 直接写入环内空闲区，整帧以视图形式交付
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// 帧头：4 字节大端无符号长度，后接 payload
+static constexpr int32 FRAME_HEADER_SIZE = 4;
+
+enum class EFrameResult : uint8
+{
+    // 已取出一帧
+    Frame,
+    // 数据不足，等待后续 Recv
+    NeedMore,
+    // 帧长度超出上限，连接数据已不可信
+    Oversize
+};
+
+class FFrameAssembler
+{
+public:
+    FFrameAssembler(int32 inInitialCapacity, int32 inMaxFrameSize);
+
+    // 可直接写入的连续空闲区域（供 Recv 零拷贝写入）；返回视图在 CommitWrite 前有效
+    TArrayView<uint8> GetWritableRegion();
+
+    // 提交实际写入的字节数
+    void CommitWrite(int32 bytes);
+
+    // 取出下一帧并消费；payload 视图指向环内或复用的拼接缓冲区，在下一次写入前有效
+    EFrameResult NextFrame(TArrayView<const uint8>& outPayload);
+
+    // 丢弃全部未处理数据（断线重连时调用）
+    void Reset();
+
+    int32 Num() const
+    {
+        return (int32)(tail - head);
+    }
+
+    int32 GetMaxFrameSize() const
+    {
+        return maxFrameSize;
+    }
+
+    // 将帧头写入 out（至少 FRAME_HEADER_SIZE 字节）
+    static void WriteHeader(uint8* out, uint32 payloadSize);
+
+private:
+    int32 Capacity() const
+    {
+        return ring.Num();
+    }
+
+    // 从环内偏移 offset 处拷贝 count 字节（处理环绕）
+    void CopyOut(uint32 offset, uint8* out, int32 count) const;
+
+    // 扩容到不小于 minCapacity 的 2 的幂，并将现有数据线性化
+    void Grow(int32 minCapacity);
+
+    TArray<uint8> ring;
+    // 跨越环尾的帧拷贝到此处，容量只增不减
+    TArray<uint8> scratch;
+
+    // 单调递增的读写位置，取模由 mask 完成
+    uint32 head;
+    uint32 tail;
+    uint32 mask;
+    int32 maxFrameSize;
+};
@@ -0,0 +1,228 @@
+// Reconnect.cpp: 指数退避与备用连接实现
+
+#include "Reconnect.h"
+#include "Sockets.h"
+#include "SocketSubsystem.h"
+#include "HAL/PlatformTime.h"
+#include "Logging/LogMacros.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogSocketReconnect, Log, All);
+
+// 备用连接的握手超时，与主连接保持一致
+static constexpr double SPARE_CONNECT_TIMEOUT_SEC = 5.0;
+
+FSocket* CreateConnectingTcpSocket(const FString& address, int32 port, FString& outError)
+{
+    ISocketSubsystem* s = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM);
+    if (!s)
+    {
+        outError = TEXT("当前平台的 SocketSubsystem 不可用");
+        return nullptr;
+    }
+
+    TSharedRef<FInternetAddr> addr = s->CreateInternetAddr();
+    bool ipOk = false;
+    addr->SetIp(*address, ipOk);
+    addr->SetPort(port);
+    if (!ipOk)
+    {
+        outError = FString::Printf(TEXT("非法 IP 地址: %s:%d"), *address, port);
+        return nullptr;
+    }
+
+    // 创建 Socket：全程保持非阻塞，由反应器等待就绪
+    FSocket* socket = s->CreateSocket(NAME_Stream, TEXT("SocketConnectionsTCP"), false);
+    if (!socket)
+    {
+        outError = TEXT("CreateSocket 失败");
+        return nullptr;
+    }
+    socket->SetNonBlocking(true);
+    socket->SetReuseAddr(true);
+    socket->SetNoDelay(true);
+
+    // 注意：非阻塞 connect 返回 false 并不一定是错误，常见为“正在握手”(EWOULDBLOCK/EINPROGRESS)
+    if (!socket->Connect(*addr))
+    {
+        const ESocketErrors lastError = s->GetLastErrorCode();
+        UE_LOG(LogSocketReconnect, Verbose, TEXT("TCP 非阻塞 connect 返回 false，lastError=%d (可能为握手进行中) -> %s:%d"), (int32)lastError, *address, port);
+    }
+    return socket;
+}
+
+// ===================== FReconnectBackoff =====================
+FReconnectBackoff::FReconnectBackoff(float inInitialDelay, float inMaxDelay, float inJitter)
+    : initialDelay(FMath::Max(inInitialDelay, 0.0f))
+    , maxDelay(FMath::Max(inMaxDelay, inInitialDelay))
+    , jitter(FMath::Clamp(inJitter, 0.0f, 1.0f))
+    , attempts(0)
+    , random((int32)FPlatformTime::Cycles())
+{
+}
+
+double FReconnectBackoff::NextDelay()
+{
+    // 指数上限 30，避免 2^n 溢出
+    const double base = FMath::Min(maxDelay, initialDelay * FMath::Pow(2.0, (double)FMath::Min(attempts, 30)));
+    attempts++;
+    return base * (1.0 + jitter * (random.FRand() * 2.0 - 1.0));
+}
+
+// ===================== FSpareConnection =====================
+FSpareConnection::FSpareConnection(const FString& inAddress, int32 inPort, const FReconnectBackoff& inBackoff)
+    : address(inAddress)
+    , port(inPort)
+    , socket(nullptr)
+    , connecting(false)
+    , ready(false)
+    , hasUnreadData(false)
+    , connectDeadline(0.0)
+    , retryAt(0.0)
+    , backoff(inBackoff)
+{
+    backoff.Reset();
+}
+
+FSpareConnection::~FSpareConnection()
+{
+    Close();
+}
+
+FSocket* FSpareConnection::Release()
+{
+    check(ready);
+    int32 pendingBytes = 0;
+    FSocket* released = nullptr;
+    if (Probe(pendingBytes))
+    {
+        released = socket;
+        socket = nullptr;
+        ready = false;
+        hasUnreadData = false;
+        retryAt = FPlatformTime::Seconds();
+    }
+    else
+    {
+        // 远端已关闭但挂断通知尚未分发
+        UE_LOG(LogSocketReconnect, Log, TEXT("备用连接接管前探测失败，稍后重新预热：%s:%d"), *address, port);
+        Close();
+        ScheduleRetry();
+    }
+
+    // 立即把 Socket 从本 handler 的监听中移除，接管方回调返回后才能注册同一个句柄
+    FSocketReactor::Get().Refresh(this);
+    return released;
+}
+
+void FSpareConnection::OnRegistered()
+{
+    Open();
+}
+
+void FSpareConnection::OnReadable()
+{
+    if (connecting)
+    {
+        CheckConnect();
+        return;
+    }
+
+    // 空闲连接可读：EOF 或错误说明已失效；远端提前发来的数据不读取，留给接管方
+    int32 pendingBytes = 0;
+    if (Probe(pendingBytes))
+    {
+        hasUnreadData = pendingBytes > 0;
+        return;
+    }
+
+    UE_LOG(LogSocketReconnect, Log, TEXT("备用连接失效，稍后重新预热：%s:%d"), *address, port);
+    Close();
+    ScheduleRetry();
+}
+
+void FSpareConnection::OnWritable()
+{
+    if (connecting)
+        CheckConnect();
+}
+
+void FSpareConnection::OnDeadline(double now)
+{
+    if (connecting)
+    {
+        UE_LOG(LogSocketReconnect, Verbose, TEXT("备用连接握手超时(%.2fs)：%s:%d"), SPARE_CONNECT_TIMEOUT_SEC, *address, port);
+        Close();
+        ScheduleRetry();
+        return;
+    }
+
+    if (retryAt > 0.0 && now >= retryAt)
+    {
+        retryAt = 0.0;
+        Open();
+    }
+}
+
+void FSpareConnection::OnUnregistered()
+{
+    Close();
+    retryAt = 0.0;
+}
+
+void FSpareConnection::Open()
+{
+    FString error;
+    socket = CreateConnectingTcpSocket(address, port, error);
+    if (!socket)
+    {
+        UE_LOG(LogSocketReconnect, Warning, TEXT("备用连接创建失败：%s"), *error);
+        ScheduleRetry();
+        return;
+    }
+
+    connecting = true;
+    connectDeadline = FPlatformTime::Seconds() + SPARE_CONNECT_TIMEOUT_SEC;
+}
+
+void FSpareConnection::CheckConnect()
+{
+    const ESocketConnectionState state = socket->GetConnectionState();
+    if (state == SCS_Connected)
+    {
+        connecting = false;
+        ready = true;
+        backoff.Reset();
+        UE_LOG(LogSocketReconnect, Verbose, TEXT("备用连接已就绪：%s:%d"), *address, port);
+    }
+    else if (state == SCS_ConnectionError)
+    {
+        Close();
+        ScheduleRetry();
+    }
+}
+
+void FSpareConnection::Close()
+{
+    if (socket)
+    {
+        socket->Close();
+        ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(socket);
+        socket = nullptr;
+    }
+    connecting = false;
+    ready = false;
+    hasUnreadData = false;
+}
+
+bool FSpareConnection::Probe(int32& outPendingBytes) const
+{
+    // 流式 Socket 的 Recv 在 EOF 与出错时返回 false，无数据可读(EWOULDBLOCK)时返回 true 且读取 0 字节
+    uint8 byte = 0;
+    outPendingBytes = 0;
+    return socket && socket->Recv(&byte, 1, outPendingBytes, ESocketReceiveFlags::Peek);
+}
+
+void FSpareConnection::ScheduleRetry()
+{
+    retryAt = FPlatformTime::Seconds() + backoff.NextDelay();
+}
@@ -0,0 +1,108 @@
+// Reconnect.h: 自动重连支持：带随机抖动的指数退避，以及预热好的备用 TCP 连接
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Math/RandomStream.h"
+#include "SocketReactor.h"
+
+class FSocket;
+
+// 创建非阻塞 TCP Socket 并发起 connect；失败时返回 nullptr 并写出错误原因
+FSocket* CreateConnectingTcpSocket(const FString& address, int32 port, FString& outError);
+
+// 指数退避：第 n 次重试等待 min(maxDelay, initialDelay * 2^n)，再乘以 [1 - jitter, 1 + jitter] 的随机系数，避免多台设备同时重连
+class FReconnectBackoff
+{
+public:
+    FReconnectBackoff(float inInitialDelay, float inMaxDelay, float inJitter);
+
+    // 返回下一次重试前的等待时间（秒），并累加重试次数
+    double NextDelay();
+
+    // 连接成功后调用，下次断线从初始间隔重新开始
+    void Reset()
+    {
+        attempts = 0;
+    }
+
+    int32 GetAttempts() const
+    {
+        return attempts;
+    }
+
+private:
+    double initialDelay;
+    double maxDelay;
+    double jitter;
+    int32 attempts;
+    FRandomStream random;
+};
+
+// 备用连接：提前完成握手并保持空闲，主连接断开时由 FSocketWorker 直接接管 Socket，省去重连握手
+// 空闲期间关注可读以便及时发现远端关闭/重置，失效后按退避时间重新预热。所有回调均在反应器 I/O 线程执行
+class FSpareConnection : public ISocketReactorHandler
+{
+public:
+    FSpareConnection(const FString& inAddress, int32 inPort, const FReconnectBackoff& inBackoff);
+    virtual ~FSpareConnection();
+
+    // 是否已握手完成、可以接管
+    bool IsReady() const
+    {
+        return ready;
+    }
+
+    // 交出已连接的 Socket（仅 I/O 线程调用），并立即开始预热下一条
+    // 交出前再探测一次连接是否存活，已失效时返回 nullptr，由调用方改为重新握手
+    FSocket* Release();
+
+    // ===================== ISocketReactorHandler =====================
+    virtual FSocket* GetSocket() const override
+    {
+        return socket;
+    }
+
+    // 远端提前发来的数据留给接管方读取，此后不再关注可读，否则会反复触发
+    virtual bool WantsRead() const override
+    {
+        return ready && !hasUnreadData;
+    }
+
+    virtual bool WantsWrite() const override
+    {
+        return connecting;
+    }
+
+    virtual double GetDeadline() const override
+    {
+        return connecting ? connectDeadline : retryAt;
+    }
+
+    virtual void OnRegistered() override;
+    virtual void OnReadable() override;
+    virtual void OnWritable() override;
+    virtual void OnDeadline(double now) override;
+    virtual void OnUnregistered() override;
+
+private:
+    void Open();
+    void CheckConnect();
+    void Close();
+    void ScheduleRetry();
+
+    // 非阻塞 MSG_PEEK 探测：远端关闭或出错时返回 false，不消费任何数据
+    bool Probe(int32& outPendingBytes) const;
+
+    FString address;
+    int32 port;
+
+    FSocket* socket;
+    bool connecting;
+    bool ready;
+    bool hasUnreadData;
+    double connectDeadline;
+    // 下一次预热的时间点，<= 0 表示无需预热
+    double retryAt;
+    FReconnectBackoff backoff;
+};
@@ -0,0 +1,278 @@
+// SendQueue.cpp: 有界发送队列实现
+
+#include "SendQueue.h"
+#include "SocketReactor.h"
+#include "Sockets.h"
+#include "SocketSubsystem.h"
+#include "Misc/ScopeLock.h"
+
+// 聚集写需要原生句柄；Windows 与无法取得原生句柄的平台逐条发送
+#define SEND_QUEUE_USE_SENDMSG (SOCKET_REACTOR_NATIVE_HANDLES && !PLATFORM_WINDOWS)
+
+#if SEND_QUEUE_USE_SENDMSG
+#include <errno.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#endif
+
+// 单次聚集写最多携带的消息数
+static const int32 MAX_GATHER_MESSAGES = 32;
+
+// 回收缓冲区的数量上限，超出后直接释放
+static const int32 MAX_FREE_BUFFERS = 64;
+
+// 已出队的槽位达到此数量且不少于一半时整体前移一次，均摊到每条消息为 O(1)
+static const int32 MIN_COMPACT_SLOTS = 32;
+
+FSendQueue::FSendQueue(int64 inMaxQueuedBytes, EConnectorSendOverflow inOverflow)
+    : maxQueuedBytes(inMaxQueuedBytes)
+    , overflow(inOverflow)
+    , headIndex(0)
+    , headOffset(0)
+{
+}
+
+bool FSendQueue::Enqueue(const uint8* header, int32 headerSize, const uint8* data, int32 size, bool replaceable)
+{
+    const int32 total = headerSize + size;
+    if (total <= 0)
+        return false;
+
+    FScopeLock lock(&mutex);
+
+    // 覆盖：找到尚未开始发送的同类消息，原位替换内容，保持其队列位置
+    if (replaceable)
+    {
+        for (int32 i = NumMessagesLocked() - 1; i >= 0; i--)
+        {
+            if (!MessageLocked(i).replaceable || (i == 0 && headOffset > 0))
+                continue;
+
+            TArray<uint8>& bytes = MessageLocked(i).bytes;
+            if (pendingBytes.GetValue() - bytes.Num() + total > maxQueuedBytes)
+                break;
+
+            pendingBytes.Add(total - bytes.Num());
+            bytes.SetNumUninitialized(total, EAllowShrinking::No);
+            if (headerSize > 0)
+                FMemory::Memcpy(bytes.GetData(), header, headerSize);
+            FMemory::Memcpy(bytes.GetData() + headerSize, data, size);
+            stats.overwrittenMessages++;
+            UpdateQueuedLocked();
+            return true;
+        }
+    }
+
+    if (pendingBytes.GetValue() + total > maxQueuedBytes)
+    {
+        if (overflow == EConnectorSendOverflow::DropOldest)
+        {
+            // 正在发送的首条消息必须写完，从它之后开始丢弃
+            const int32 firstDroppable = headOffset > 0 ? 1 : 0;
+            while (NumMessagesLocked() > firstDroppable && pendingBytes.GetValue() + total > maxQueuedBytes)
+            {
+                if (firstDroppable == 0)
+                    PopFrontLocked();
+                else
+                    DropSecondLocked();
+                stats.droppedMessages++;
+            }
+        }
+
+        if (pendingBytes.GetValue() + total > maxQueuedBytes)
+        {
+            stats.rejectedMessages++;
+            UpdateQueuedLocked();
+            return false;
+        }
+    }
+
+    FOutgoingMessage& message = messages.AddDefaulted_GetRef();
+    if (freeBuffers.Num() > 0)
+        message.bytes = freeBuffers.Pop(EAllowShrinking::No);
+    message.bytes.SetNumUninitialized(total, EAllowShrinking::No);
+    if (headerSize > 0)
+        FMemory::Memcpy(message.bytes.GetData(), header, headerSize);
+    FMemory::Memcpy(message.bytes.GetData() + headerSize, data, size);
+    message.replaceable = replaceable;
+
+    pendingBytes.Add(total);
+    UpdateQueuedLocked();
+    return true;
+}
+
+ESendFlushResult FSendQueue::FlushStream(FSocket* socket)
+{
+    FScopeLock lock(&mutex);
+    while (NumMessagesLocked() > 0)
+    {
+        int64 requested = 0;
+        int64 written = 0;
+
+#if !SEND_QUEUE_USE_SENDMSG
+        // Windows 编辑器下逐条发送；移动端与 Linux 走下面的聚集写
+        const FOutgoingMessage& head = MessageLocked(0);
+        requested = head.bytes.Num() - headOffset;
+        int32 bytesSent = 0;
+        if (!socket->Send(head.bytes.GetData() + headOffset, (int32)requested, bytesSent))
+        {
+            const ESocketErrors lastError = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->GetLastErrorCode();
+            return lastError == SE_EWOULDBLOCK ? ESendFlushResult::WouldBlock : ESendFlushResult::Error;
+        }
+        written = bytesSent;
+#else
+        iovec iov[MAX_GATHER_MESSAGES];
+        const int32 count = FMath::Min(NumMessagesLocked(), MAX_GATHER_MESSAGES);
+        for (int32 i = 0; i < count; i++)
+        {
+            const int32 offset = i == 0 ? headOffset : 0;
+            iov[i].iov_base = MessageLocked(i).bytes.GetData() + offset;
+            iov[i].iov_len = (size_t)(MessageLocked(i).bytes.Num() - offset);
+            requested += (int64)iov[i].iov_len;
+        }
+
+        msghdr msg = {};
+        msg.msg_iov = iov;
+        msg.msg_iovlen = count;
+
+        // 与 FSocketBSD::Send 一致，屏蔽远端关闭时的 SIGPIPE
+#ifdef MSG_NOSIGNAL
+        const ssize_t result = sendmsg((int)FSocketReactor::GetNativeHandle(socket), &msg, MSG_NOSIGNAL);
+#else
+        const ssize_t result = sendmsg((int)FSocketReactor::GetNativeHandle(socket), &msg, 0);
+#endif
+        if (result < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            return (errno == EAGAIN || errno == EWOULDBLOCK) ? ESendFlushResult::WouldBlock : ESendFlushResult::Error;
+        }
+        written = result;
+#endif
+
+        ConsumeLocked(written);
+        if (written < requested)
+        {
+            // 内核缓冲区已满：剩余部分等下一次可写事件
+            stats.partialWrites++;
+            UpdateQueuedLocked();
+            return ESendFlushResult::WouldBlock;
+        }
+    }
+
+    UpdateQueuedLocked();
+    return ESendFlushResult::Drained;
+}
+
+ESendFlushResult FSendQueue::FlushDatagrams(FSocket* socket, const FInternetAddr& remote)
+{
+    FScopeLock lock(&mutex);
+    while (NumMessagesLocked() > 0)
+    {
+        const FOutgoingMessage& head = MessageLocked(0);
+        int32 bytesSent = 0;
+        if (!socket->SendTo(head.bytes.GetData(), head.bytes.Num(), bytesSent, remote))
+        {
+            const ESocketErrors lastError = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->GetLastErrorCode();
+            if (lastError == SE_EWOULDBLOCK)
+            {
+                UpdateQueuedLocked();
+                return ESendFlushResult::WouldBlock;
+            }
+
+            // 数据报发送失败不可重试，丢弃该条后交由调用方报告
+            stats.droppedMessages++;
+            PopFrontLocked();
+            UpdateQueuedLocked();
+            return ESendFlushResult::Error;
+        }
+
+        stats.sentBytes += head.bytes.Num();
+        stats.sentMessages++;
+        PopFrontLocked();
+    }
+
+    UpdateQueuedLocked();
+    return ESendFlushResult::Drained;
+}
+
+void FSendQueue::Reset()
+{
+    FScopeLock lock(&mutex);
+    while (NumMessagesLocked() > 0)
+        PopFrontLocked();
+    headOffset = 0;
+    UpdateQueuedLocked();
+}
+
+FConnectorSendStats FSendQueue::GetStats() const
+{
+    FScopeLock lock(&mutex);
+    return stats;
+}
+
+void FSendQueue::ConsumeLocked(int64 bytes)
+{
+    stats.sentBytes += bytes;
+    while (bytes > 0 && NumMessagesLocked() > 0)
+    {
+        const int32 remaining = MessageLocked(0).bytes.Num() - headOffset;
+        if (bytes < remaining)
+        {
+            headOffset += (int32)bytes;
+            pendingBytes.Subtract(bytes);
+            return;
+        }
+
+        bytes -= remaining;
+        stats.sentMessages++;
+        PopFrontLocked();
+    }
+}
+
+void FSendQueue::PopFrontLocked()
+{
+    FOutgoingMessage& head = MessageLocked(0);
+    pendingBytes.Subtract(head.bytes.Num() - headOffset);
+    RecycleLocked(MoveTemp(head.bytes));
+    head.replaceable = false;
+    headIndex++;
+    headOffset = 0;
+
+    if (headIndex == messages.Num())
+    {
+        messages.Reset();
+        headIndex = 0;
+    }
+    else if (headIndex >= MIN_COMPACT_SLOTS && headIndex * 2 >= messages.Num())
+    {
+        messages.RemoveAt(0, headIndex, EAllowShrinking::No);
+        headIndex = 0;
+    }
+}
+
+void FSendQueue::DropSecondLocked()
+{
+    // 丢弃的槽位由队首消息占据，队首整体后移一格，不移动其余消息
+    FOutgoingMessage& dropped = MessageLocked(1);
+    pendingBytes.Subtract(dropped.bytes.Num());
+    RecycleLocked(MoveTemp(dropped.bytes));
+    dropped = MoveTemp(MessageLocked(0));
+    headIndex++;
+}
+
+void FSendQueue::RecycleLocked(TArray<uint8>&& buffer)
+{
+    if (freeBuffers.Num() < MAX_FREE_BUFFERS)
+    {
+        buffer.Reset();
+        freeBuffers.Add(MoveTemp(buffer));
+    }
+}
+
+void FSendQueue::UpdateQueuedLocked()
+{
+    stats.queuedBytes = pendingBytes.GetValue();
+    stats.queuedMessages = NumMessagesLocked();
+    stats.peakQueuedBytes = FMath::Max(stats.peakQueuedBytes, stats.queuedBytes);
+}
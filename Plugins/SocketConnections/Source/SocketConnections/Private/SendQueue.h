@@ -0,0 +1,87 @@
+// SendQueue.h: 有界发送队列，任意线程入队、I/O 线程写出，正确处理部分写并支持聚集写
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+#include "HAL/ThreadSafeCounter64.h"
+#include "Connector.h"
+
+class FSocket;
+class FInternetAddr;
+
+enum class ESendFlushResult : uint8
+{
+    // 队列已全部写出
+    Drained,
+    // 内核发送缓冲区已满，等待可写事件后继续
+    WouldBlock,
+    // 发送出错，错误码可通过 SocketSubsystem 的 GetLastErrorCode 获取
+    Error
+};
+
+class FSendQueue
+{
+public:
+    FSendQueue(int64 inMaxQueuedBytes, EConnectorSendOverflow inOverflow);
+
+    // 入队一条消息（header 可为空，与 data 拼接为一条线上消息）
+    // replaceable 为 true 时替换队列中尚未开始发送的同类消息；返回 false 表示队列已满被拒绝
+    bool Enqueue(const uint8* header, int32 headerSize, const uint8* data, int32 size, bool replaceable);
+
+    // 以下两个接口只在 I/O 线程调用
+    // 流式 Socket：一次系统调用聚集写出多条消息，部分写时记录偏移
+    ESendFlushResult FlushStream(FSocket* socket);
+    // 数据报 Socket：每条消息一个数据报
+    ESendFlushResult FlushDatagrams(FSocket* socket, const FInternetAddr& remote);
+
+    bool HasPending() const
+    {
+        return pendingBytes.GetValue() > 0;
+    }
+
+    // 丢弃全部待发送消息（断线时调用），统计保留
+    void Reset();
+
+    FConnectorSendStats GetStats() const;
+
+private:
+    struct FOutgoingMessage
+    {
+        TArray<uint8> bytes;
+        bool replaceable = false;
+    };
+
+    // 以下函数需持有 mutex
+    int32 NumMessagesLocked() const
+    {
+        return messages.Num() - headIndex;
+    }
+
+    FOutgoingMessage& MessageLocked(int32 index)
+    {
+        return messages[headIndex + index];
+    }
+
+    void ConsumeLocked(int64 bytes);
+    void PopFrontLocked();
+    // 丢弃队首之后的第一条消息（队首已部分写出时使用）
+    void DropSecondLocked();
+    void RecycleLocked(TArray<uint8>&& buffer);
+    void UpdateQueuedLocked();
+
+    const int64 maxQueuedBytes;
+    const EConnectorSendOverflow overflow;
+
+    mutable FCriticalSection mutex;
+    // messages[headIndex] 起为待发送消息；出队只前移 headIndex，积累到一定数量再整体前移，避免每条消息一次 O(n) 的 RemoveAt(0)
+    TArray<FOutgoingMessage> messages;
+    int32 headIndex;
+    // 队首消息已写出的字节数；大于 0 时该消息不可再被丢弃或覆盖，否则会破坏流上的消息边界
+    int32 headOffset;
+    // 已发送消息的缓冲区，入队时复用，避免逐条分配
+    TArray<TArray<uint8>> freeBuffers;
+
+    FThreadSafeCounter64 pendingBytes;
+    FConnectorSendStats stats;
+};
@@ -1,6 +1,7 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "SocketConnections.h"
+#include "SocketReactor.h"
 
 #define LOCTEXT_NAMESPACE "FSocketConnectionsModule"
 
@@ -13,6 +14,7 @@ void FSocketConnectionsModule::ShutdownModule()
 {
 	// This function may be called during shutdown to clean up your module.  For modules that support dynamic reloading,
 	// we call this function before unloading the module.
+	FSocketReactor::Shutdown();
 }
 
 #undef LOCTEXT_NAMESPACE
@@ -0,0 +1,487 @@
+// SocketReactor.cpp: 共享 I/O 反应器实现（epoll / poll 两种后端）
+
+#include "SocketReactor.h"
+#include "Sockets.h"
+#include "SocketSubsystem.h"
+#if SOCKET_REACTOR_NATIVE_HANDLES
+#include "BSDSockets/SocketsBSD.h"
+#endif
+#include "HAL/Event.h"
+#include "HAL/RunnableThread.h"
+#include "Misc/ScopeLock.h"
+#include "Logging/LogMacros.h"
+
+#if SOCKET_REACTOR_USE_EPOLL
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#elif SOCKET_REACTOR_USE_POLL && PLATFORM_WINDOWS
+#define SocketReactorPoll WSAPoll
+#elif SOCKET_REACTOR_USE_POLL
+#include <poll.h>
+#define SocketReactorPoll poll
+#endif
+
+DEFINE_LOG_CATEGORY_STATIC(LogSocketReactor, Log, All);
+
+static FSocketReactor* gReactor = nullptr;
+static FCriticalSection gReactorMutex;
+
+// 单次等待的上限：即便没有超时任务也定期醒来检查 shouldStop
+static const int32 MAX_WAIT_MS = 1000;
+
+#if !SOCKET_REACTOR_NATIVE_HANDLES
+// 轮询后端无法在 Socket 就绪时被唤醒，等待时长取该值与超时的较小者
+static const int32 FALLBACK_POLL_INTERVAL_MS = 5;
+#endif
+
+FSocketReactor& FSocketReactor::Get()
+{
+    FScopeLock lock(&gReactorMutex);
+    if (!gReactor)
+    {
+        gReactor = new FSocketReactor();
+        gReactor->thread = FRunnableThread::Create(gReactor, TEXT("SocketConnectionsReactor"), 0, TPri_AboveNormal);
+    }
+    return *gReactor;
+}
+
+// Build.cs 仅在平台 Socket 子系统基于 BSD Socket 时启用原生句柄，此时 PLATFORM_SOCKETSUBSYSTEM 创建的 FSocket 均为 FSocketBSD
+uint64 FSocketReactor::GetNativeHandle(FSocket* socket)
+{
+#if SOCKET_REACTOR_NATIVE_HANDLES
+    return (uint64)static_cast<FSocketBSD*>(socket)->GetNativeSocket();
+#else
+    return 0;
+#endif
+}
+
+void FSocketReactor::Shutdown()
+{
+    FSocketReactor* reactor = nullptr;
+    {
+        FScopeLock lock(&gReactorMutex);
+        reactor = gReactor;
+    }
+    if (!reactor)
+        return;
+
+    // 等待 I/O 线程时不能持锁：退出前的 OnUnregistered 回调会经 Get() 投递命令（例如注销备用连接）
+    // gReactor 保持不变直到线程结束，避免回调中的 Get() 另建一个反应器；这些命令不再处理，由析构释放
+    reactor->Stop();
+    if (reactor->thread)
+    {
+        reactor->thread->WaitForCompletion();
+        delete reactor->thread;
+        reactor->thread = nullptr;
+    }
+
+    {
+        FScopeLock lock(&gReactorMutex);
+        gReactor = nullptr;
+    }
+    delete reactor;
+}
+
+FSocketReactor::FSocketReactor()
+    : thread(nullptr)
+    , shouldStop(false)
+#if SOCKET_REACTOR_USE_EPOLL
+    , epollFd(-1)
+    , wakeFd(-1)
+#elif SOCKET_REACTOR_USE_POLL
+    , wakeSocket(nullptr)
+    , wakePending(false)
+#else
+    , wakeEvent(nullptr)
+#endif
+{
+    if (!InitBackend())
+        UE_LOG(LogSocketReactor, Error, TEXT("I/O 反应器后端初始化失败，所有连接将无法收发"));
+}
+
+FSocketReactor::~FSocketReactor()
+{
+    // 释放尚未处理的命令持有的 handler 引用
+    FCommand command;
+    while (commands.Dequeue(command))
+    {
+    }
+    ShutdownBackend();
+}
+
+bool FSocketReactor::InitBackend()
+{
+#if SOCKET_REACTOR_USE_EPOLL
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (epollFd < 0 || wakeFd < 0)
+        return false;
+
+    // data.ptr 为空表示唤醒事件
+    epoll_event ev = {};
+    ev.events = EPOLLIN;
+    ev.data.ptr = nullptr;
+    return epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &ev) == 0;
+#elif SOCKET_REACTOR_USE_POLL
+    // 绑定到 127.0.0.1 的 UDP Socket，向自己发送 1 字节即可打断 poll
+    ISocketSubsystem* s = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM);
+    if (!s)
+        return false;
+
+    wakeSocket = s->CreateSocket(NAME_DGram, TEXT("SocketConnectionsReactorWake"), false);
+    if (!wakeSocket)
+        return false;
+    wakeSocket->SetNonBlocking(true);
+
+    wakeAddr = s->CreateInternetAddr();
+    bool ipOk = false;
+    wakeAddr->SetIp(TEXT("127.0.0.1"), ipOk);
+    wakeAddr->SetPort(0);
+    if (!ipOk || !wakeSocket->Bind(*wakeAddr))
+        return false;
+
+    wakeAddr->SetPort(wakeSocket->GetPortNo());
+    return true;
+#else
+    wakeEvent = FPlatformProcess::GetSynchEventFromPool(false);
+    return wakeEvent != nullptr;
+#endif
+}
+
+void FSocketReactor::ShutdownBackend()
+{
+#if SOCKET_REACTOR_USE_EPOLL
+    if (wakeFd >= 0)
+        close(wakeFd);
+    if (epollFd >= 0)
+        close(epollFd);
+    wakeFd = -1;
+    epollFd = -1;
+#elif SOCKET_REACTOR_USE_POLL
+    if (wakeSocket)
+    {
+        wakeSocket->Close();
+        ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(wakeSocket);
+        wakeSocket = nullptr;
+    }
+#else
+    if (wakeEvent)
+    {
+        FPlatformProcess::ReturnSynchEventToPool(wakeEvent);
+        wakeEvent = nullptr;
+    }
+#endif
+}
+
+void FSocketReactor::Signal()
+{
+#if SOCKET_REACTOR_USE_EPOLL
+    const uint64 one = 1;
+    const ssize_t written = write(wakeFd, &one, sizeof(one));
+    (void)written;
+#elif SOCKET_REACTOR_USE_POLL
+    // 合并连续的唤醒请求，避免回环 Socket 积压
+    if (wakeSocket && !wakePending.AtomicSet(true))
+    {
+        uint8 byte = 0;
+        int32 bytesSent = 0;
+        wakeSocket->SendTo(&byte, 1, bytesSent, *wakeAddr);
+    }
+#else
+    if (wakeEvent)
+        wakeEvent->Trigger();
+#endif
+}
+
+void FSocketReactor::Register(const FSocketReactorHandlerRef& handler)
+{
+    commands.Enqueue({ ECommandType::Register, handler });
+    Signal();
+}
+
+void FSocketReactor::Unregister(const FSocketReactorHandlerRef& handler)
+{
+    commands.Enqueue({ ECommandType::Unregister, handler });
+    Signal();
+}
+
+void FSocketReactor::Wakeup(const FSocketReactorHandlerRef& handler)
+{
+    commands.Enqueue({ ECommandType::Wakeup, handler });
+    Signal();
+}
+
+void FSocketReactor::Refresh(ISocketReactorHandler* handler)
+{
+    check(thread && FPlatformTLS::GetCurrentThreadId() == thread->GetThreadID());
+    if (FHandlerRecord* record = handlers.Find(handler))
+        SyncHandler(*record);
+}
+
+void FSocketReactor::Stop()
+{
+    shouldStop = true;
+    Signal();
+}
+
+uint32 FSocketReactor::Run()
+{
+    while (!shouldStop)
+    {
+        ProcessCommands();
+        WaitAndDispatch(ComputeTimeoutMs());
+        DispatchDeadlines();
+    }
+
+    // 退出前注销全部 handler，保证 Socket 被关闭
+    ProcessCommands();
+    for (TPair<ISocketReactorHandler*, FHandlerRecord>& pair : handlers)
+    {
+        RemoveFromBackend(pair.Value);
+        pair.Value.handler->OnUnregistered();
+    }
+    handlers.Empty();
+    return 0;
+}
+
+void FSocketReactor::ProcessCommands()
+{
+    FCommand command;
+    while (commands.Dequeue(command))
+    {
+        ISocketReactorHandler* key = command.handler.Get();
+        switch (command.type)
+        {
+        case ECommandType::Register:
+        {
+            if (handlers.Contains(key))
+                break;
+
+            FHandlerRecord& record = handlers.Add(key);
+            record.handler = command.handler;
+            record.handler->OnRegistered();
+            SyncHandler(record);
+            break;
+        }
+        case ECommandType::Unregister:
+        {
+            FHandlerRecord* record = handlers.Find(key);
+            if (!record)
+                break;
+
+            RemoveFromBackend(*record);
+            handlers.Remove(key);
+            command.handler->OnUnregistered();
+            break;
+        }
+        case ECommandType::Wakeup:
+        {
+            FHandlerRecord* record = handlers.Find(key);
+            if (!record)
+                break;
+
+            record->handler->OnWakeup();
+            SyncHandler(*record);
+            break;
+        }
+        }
+    }
+}
+
+int32 FSocketReactor::ComputeTimeoutMs() const
+{
+    if (!commands.IsEmpty())
+        return 0;
+
+    const double now = FPlatformTime::Seconds();
+    double nearest = now + MAX_WAIT_MS / 1000.0;
+    for (const TPair<ISocketReactorHandler*, FHandlerRecord>& pair : handlers)
+    {
+        const double deadline = pair.Value.handler->GetDeadline();
+        if (deadline > 0.0 && deadline < nearest)
+            nearest = deadline;
+    }
+    return FMath::Clamp(FMath::CeilToInt32((nearest - now) * 1000.0), 0, MAX_WAIT_MS);
+}
+
+void FSocketReactor::DispatchDeadlines()
+{
+    const double now = FPlatformTime::Seconds();
+    for (TPair<ISocketReactorHandler*, FHandlerRecord>& pair : handlers)
+    {
+        const double deadline = pair.Value.handler->GetDeadline();
+        if (deadline > 0.0 && deadline <= now)
+        {
+            pair.Value.handler->OnDeadline(now);
+            SyncHandler(pair.Value);
+        }
+    }
+}
+
+void FSocketReactor::DispatchEvents(FHandlerRecord& record, bool readable, bool writable)
+{
+    // 先处理可写：非阻塞握手完成后再读取，避免在 Connected 之前消费数据
+    if (writable && record.handler->GetSocket() == record.socket)
+        record.handler->OnWritable();
+    if (readable && record.handler->GetSocket() == record.socket)
+        record.handler->OnReadable();
+    SyncHandler(record);
+}
+
+void FSocketReactor::SyncHandler(FHandlerRecord& record)
+{
+    FSocket* socket = record.handler->GetSocket();
+    const uint64 nativeHandle = socket ? GetNativeHandle(socket) : 0;
+    const bool wantRead = socket && record.handler->WantsRead();
+    const bool wantWrite = socket && record.handler->WantsWrite();
+    const bool sameSocket = socket == record.socket && nativeHandle == record.nativeHandle;
+    if (sameSocket && wantRead == record.watchingRead && wantWrite == record.watchingWrite)
+        return;
+
+#if SOCKET_REACTOR_USE_EPOLL
+    // 旧 Socket 若已关闭，内核已自动移除，此处 DEL 失败可忽略
+    if (record.socket && !sameSocket)
+        epoll_ctl(epollFd, EPOLL_CTL_DEL, (int32)record.nativeHandle, nullptr);
+
+    if (socket)
+    {
+        epoll_event ev = {};
+        ev.events = (wantRead ? (EPOLLIN | EPOLLRDHUP) : 0) | (wantWrite ? EPOLLOUT : 0);
+        ev.data.ptr = record.handler.Get();
+        if (epoll_ctl(epollFd, sameSocket ? EPOLL_CTL_MOD : EPOLL_CTL_ADD, (int32)nativeHandle, &ev) != 0)
+            UE_LOG(LogSocketReactor, Warning, TEXT("epoll_ctl 失败，errno=%d"), errno);
+    }
+#endif
+    // poll 后端每轮根据 record 重新构造 pollfd 数组，只需记录状态
+
+    record.socket = socket;
+    record.nativeHandle = nativeHandle;
+    record.watchingRead = wantRead;
+    record.watchingWrite = wantWrite;
+}
+
+void FSocketReactor::RemoveFromBackend(FHandlerRecord& record)
+{
+#if SOCKET_REACTOR_USE_EPOLL
+    if (record.socket)
+        epoll_ctl(epollFd, EPOLL_CTL_DEL, (int32)record.nativeHandle, nullptr);
+#endif
+    record.socket = nullptr;
+    record.nativeHandle = 0;
+    record.watchingRead = false;
+    record.watchingWrite = false;
+}
+
+void FSocketReactor::WaitAndDispatch(int32 timeoutMs)
+{
+#if SOCKET_REACTOR_USE_EPOLL
+    static const int32 MAX_EVENTS = 64;
+    epoll_event events[MAX_EVENTS];
+    const int32 count = epoll_wait(epollFd, events, MAX_EVENTS, timeoutMs);
+    for (int32 i = 0; i < count; i++)
+    {
+        ISocketReactorHandler* key = static_cast<ISocketReactorHandler*>(events[i].data.ptr);
+        if (!key)
+        {
+            uint64 value = 0;
+            const ssize_t bytesRead = read(wakeFd, &value, sizeof(value));
+            (void)bytesRead;
+            continue;
+        }
+
+        // 同一批事件中 handler 可能已在前面的回调中被注销
+        FHandlerRecord* record = handlers.Find(key);
+        if (!record || !record->socket)
+            continue;
+
+        const uint32 flags = events[i].events;
+        DispatchEvents(*record, (flags & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) != 0, (flags & (EPOLLOUT | EPOLLERR)) != 0);
+    }
+#elif SOCKET_REACTOR_USE_POLL
+    TArray<pollfd, TInlineAllocator<64>> pollFds;
+    TArray<ISocketReactorHandler*, TInlineAllocator<64>> pollOwners;
+
+    pollfd wake = {};
+    wake.fd = (SOCKET)GetNativeHandle(wakeSocket);
+    wake.events = POLLIN;
+    pollFds.Add(wake);
+    pollOwners.Add(nullptr);
+
+    for (const TPair<ISocketReactorHandler*, FHandlerRecord>& pair : handlers)
+    {
+        if (!pair.Value.socket)
+            continue;
+
+        pollfd entry = {};
+        entry.fd = (SOCKET)pair.Value.nativeHandle;
+        entry.events = (pair.Value.watchingRead ? POLLIN : 0) | (pair.Value.watchingWrite ? POLLOUT : 0);
+        pollFds.Add(entry);
+        pollOwners.Add(pair.Key);
+    }
+
+    const int32 count = SocketReactorPoll(pollFds.GetData(), pollFds.Num(), timeoutMs);
+    if (count <= 0)
+        return;
+
+    for (int32 i = 0; i < pollFds.Num(); i++)
+    {
+        const int32 flags = pollFds[i].revents;
+        if (flags == 0)
+            continue;
+
+        if (!pollOwners[i])
+        {
+            // 先清除标记再读空，保证读空期间的新唤醒不会丢失
+            wakePending = false;
+            uint8 drain[64];
+            int32 bytesRead = 0;
+            while (wakeSocket->Recv(drain, sizeof(drain), bytesRead) && bytesRead > 0)
+            {
+            }
+            continue;
+        }
+
+        FHandlerRecord* record = handlers.Find(pollOwners[i]);
+        if (!record || !record->socket)
+            continue;
+
+        DispatchEvents(*record, (flags & (POLLIN | POLLHUP | POLLERR)) != 0, (flags & (POLLOUT | POLLERR)) != 0);
+    }
+#else
+    // 先收集就绪状态再分发，回调期间 handlers 可能变化
+    struct FReadyHandler
+    {
+        ISocketReactorHandler* key;
+        bool readable;
+        bool writable;
+    };
+    TArray<FReadyHandler, TInlineAllocator<64>> ready;
+    for (const TPair<ISocketReactorHandler*, FHandlerRecord>& pair : handlers)
+    {
+        FSocket* socket = pair.Value.socket;
+        if (!socket)
+            continue;
+
+        const bool readable = pair.Value.watchingRead && socket->Wait(ESocketWaitConditions::WaitForRead, FTimespan::Zero());
+        const bool writable = pair.Value.watchingWrite && socket->Wait(ESocketWaitConditions::WaitForWrite, FTimespan::Zero());
+        if (readable || writable)
+            ready.Add({ pair.Key, readable, writable });
+    }
+
+    if (ready.Num() == 0)
+    {
+        wakeEvent->Wait(FMath::Min(timeoutMs, FALLBACK_POLL_INTERVAL_MS));
+        return;
+    }
+
+    for (const FReadyHandler& entry : ready)
+    {
+        FHandlerRecord* record = handlers.Find(entry.key);
+        if (!record || !record->socket)
+            continue;
+
+        DispatchEvents(*record, entry.readable, entry.writable);
+    }
+#endif
+}
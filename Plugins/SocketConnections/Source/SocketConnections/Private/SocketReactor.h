@@ -0,0 +1,151 @@
+// SocketReactor.h: 共享 I/O 反应器，单个线程通过就绪通知复用所有 AConnector 的 Socket
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/Runnable.h"
+#include "HAL/ThreadSafeBool.h"
+#include "Containers/Queue.h"
+#include "Templates/SharedPointer.h"
+
+// SOCKET_REACTOR_NATIVE_HANDLES 由 Build.cs 定义：平台 Socket 为 FSocketBSD 时才能取得原生句柄
+#ifndef SOCKET_REACTOR_NATIVE_HANDLES
+#define SOCKET_REACTOR_NATIVE_HANDLES 0
+#endif
+
+// Linux/Android 使用 epoll + eventfd；其它平台退化为 poll + 本地回环唤醒 Socket
+// 无法取得原生句柄时使用 FSocket::Wait 逐个查询 + 唤醒事件的轮询后端
+#define SOCKET_REACTOR_USE_EPOLL (SOCKET_REACTOR_NATIVE_HANDLES && (PLATFORM_LINUX || PLATFORM_ANDROID))
+#define SOCKET_REACTOR_USE_POLL (SOCKET_REACTOR_NATIVE_HANDLES && !SOCKET_REACTOR_USE_EPOLL)
+
+class FSocket;
+class FInternetAddr;
+class FRunnableThread;
+class FEvent;
+
+// 反应器回调接口：除 Get*/Wants* 查询外，所有回调均在 I/O 线程触发
+// 注意：Socket 的创建与关闭只应在回调内完成，反应器会在每次回调后同步监听集合
+class ISocketReactorHandler : public TSharedFromThis<ISocketReactorHandler, ESPMode::ThreadSafe>
+{
+public:
+    virtual ~ISocketReactorHandler() {}
+
+    // 当前需要监听的 Socket，可为空（例如连接失败后）
+    virtual FSocket* GetSocket() const = 0;
+
+    // 是否需要监听可读事件；返回 false 时仍会收到错误/挂断通知（经 OnReadable 回调）
+    virtual bool WantsRead() const { return true; }
+
+    // 是否需要监听可写事件（握手中或有待发送数据时）
+    virtual bool WantsWrite() const = 0;
+
+    // 下一次超时时间点（FPlatformTime::Seconds），<= 0 表示无超时
+    virtual double GetDeadline() const { return 0.0; }
+
+    // 注册到反应器后回调，通常在此创建 Socket 并发起连接
+    virtual void OnRegistered() = 0;
+
+    // Socket 可读（含远端关闭/错误）
+    virtual void OnReadable() = 0;
+
+    // Socket 可写（含非阻塞握手完成）
+    virtual void OnWritable() = 0;
+
+    // 其它线程调用 FSocketReactor::Wakeup 后回调（发送、停止等）
+    virtual void OnWakeup() {}
+
+    // 到达 GetDeadline 返回的时间点
+    virtual void OnDeadline(double now) {}
+
+    // 从反应器注销后回调，需在此关闭 Socket
+    virtual void OnUnregistered() = 0;
+};
+
+typedef TSharedRef<ISocketReactorHandler, ESPMode::ThreadSafe> FSocketReactorHandlerRef;
+typedef TSharedPtr<ISocketReactorHandler, ESPMode::ThreadSafe> FSocketReactorHandlerPtr;
+
+// 单例 I/O 线程：替代每个连接一个线程 + Wait/Sleep 轮询的方式，收到数据或唤醒请求后立即处理
+class FSocketReactor : public FRunnable
+{
+public:
+    // 获取（必要时创建）全局反应器，可在任意线程调用
+    static FSocketReactor& Get();
+
+    // 停止 I/O 线程并注销所有 handler，在模块卸载时调用
+    static void Shutdown();
+
+    // 取得 FSocket 的原生句柄，仅 SOCKET_REACTOR_NATIVE_HANDLES 时有效，否则返回 0
+    static uint64 GetNativeHandle(FSocket* socket);
+
+    // 以下接口线程安全，实际操作会投递到 I/O 线程执行
+    void Register(const FSocketReactorHandlerRef& handler);
+    void Unregister(const FSocketReactorHandlerRef& handler);
+    void Wakeup(const FSocketReactorHandlerRef& handler);
+
+    // 立即同步 handler 的监听状态，仅可在 I/O 线程的回调中调用
+    // 用于在 handler 之间转移 Socket：先刷新让出方，再由接收方的回调返回后自动同步
+    void Refresh(ISocketReactorHandler* handler);
+
+    virtual uint32 Run() override;
+    virtual void Stop() override;
+
+private:
+    FSocketReactor();
+    virtual ~FSocketReactor();
+
+    bool InitBackend();
+    void ShutdownBackend();
+
+    // 通知后端立即从等待中返回
+    void Signal();
+
+    enum class ECommandType : uint8
+    {
+        Register,
+        Unregister,
+        Wakeup
+    };
+
+    struct FCommand
+    {
+        ECommandType type;
+        FSocketReactorHandlerPtr handler;
+    };
+
+    // 每个 handler 在后端中的注册状态，仅 I/O 线程访问
+    struct FHandlerRecord
+    {
+        FSocketReactorHandlerPtr handler;
+        FSocket* socket = nullptr;
+        uint64 nativeHandle = 0;
+        bool watchingRead = false;
+        bool watchingWrite = false;
+    };
+
+    void ProcessCommands();
+    void WaitAndDispatch(int32 timeoutMs);
+    void DispatchDeadlines();
+    int32 ComputeTimeoutMs() const;
+
+    // 将 handler 当前的 Socket 与读写关注同步到后端
+    void SyncHandler(FHandlerRecord& record);
+    void RemoveFromBackend(FHandlerRecord& record);
+    void DispatchEvents(FHandlerRecord& record, bool readable, bool writable);
+
+    FRunnableThread* thread;
+    FThreadSafeBool shouldStop;
+
+    TQueue<FCommand, EQueueMode::Mpsc> commands;
+    TMap<ISocketReactorHandler*, FHandlerRecord> handlers;
+
+#if SOCKET_REACTOR_USE_EPOLL
+    int32 epollFd;
+    int32 wakeFd;
+#elif SOCKET_REACTOR_USE_POLL
+    FSocket* wakeSocket;
+    TSharedPtr<FInternetAddr> wakeAddr;
+    FThreadSafeBool wakePending;
+#else
+    FEvent* wakeEvent;
+#endif
+};
@@ -0,0 +1,185 @@
+// FrameAssemblerTest.cpp: 长度前缀分帧的自动化测试
+
+#include "Misc/AutomationTest.h"
+#include "FrameAssembler.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+// 模拟 Recv：按 GetWritableRegion 给出的空闲区分段写入，每次最多 chunkSize 字节
+static void FeedBytes(FFrameAssembler& assembler, TArrayView<const uint8> bytes, int32 chunkSize = MAX_int32)
+{
+    int32 pos = 0;
+    while (pos < bytes.Num())
+    {
+        const TArrayView<uint8> region = assembler.GetWritableRegion();
+        const int32 count = FMath::Min3(region.Num(), chunkSize, bytes.Num() - pos);
+        FMemory::Memcpy(region.GetData(), bytes.GetData() + pos, count);
+        assembler.CommitWrite(count);
+        pos += count;
+    }
+}
+
+// 帧头 + 内容为 seed, seed+1, ... 的 payload
+static TArray<uint8> MakeFrame(int32 payloadSize, uint8 seed)
+{
+    TArray<uint8> frame;
+    frame.SetNumUninitialized(FRAME_HEADER_SIZE + payloadSize);
+    FFrameAssembler::WriteHeader(frame.GetData(), (uint32)payloadSize);
+    for (int32 i = 0; i < payloadSize; i++)
+        frame[FRAME_HEADER_SIZE + i] = (uint8)(seed + i);
+    return frame;
+}
+
+static bool PayloadMatches(TArrayView<const uint8> payload, int32 payloadSize, uint8 seed)
+{
+    if (payload.Num() != payloadSize)
+        return false;
+    for (int32 i = 0; i < payloadSize; i++)
+    {
+        if (payload[i] != (uint8)(seed + i))
+            return false;
+    }
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFrameAssemblerSplitHeaderTest, "SocketConnections.FrameAssembler.SplitHeader",
+    EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FFrameAssemblerSplitHeaderTest::RunTest(const FString& Parameters)
+{
+    FFrameAssembler assembler(64, 1024);
+    const TArray<uint8> frame = MakeFrame(10, 7);
+    TArrayView<const uint8> payload;
+
+    // 帧头只到达一半
+    FeedBytes(assembler, MakeArrayView(frame.GetData(), 2));
+    TestEqual(TEXT("half header"), (int32)assembler.NextFrame(payload), (int32)EFrameResult::NeedMore);
+
+    // 帧头完整但 payload 未收全
+    FeedBytes(assembler, MakeArrayView(frame.GetData() + 2, 5));
+    TestEqual(TEXT("partial payload"), (int32)assembler.NextFrame(payload), (int32)EFrameResult::NeedMore);
+
+    // 逐字节补齐剩余部分
+    FeedBytes(assembler, MakeArrayView(frame.GetData() + 7, frame.Num() - 7), 1);
+    TestEqual(TEXT("complete"), (int32)assembler.NextFrame(payload), (int32)EFrameResult::Frame);
+    TestTrue(TEXT("payload"), PayloadMatches(payload, 10, 7));
+    TestEqual(TEXT("consumed"), assembler.Num(), 0);
+    TestEqual(TEXT("nothing left"), (int32)assembler.NextFrame(payload), (int32)EFrameResult::NeedMore);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFrameAssemblerMultipleFramesTest, "SocketConnections.FrameAssembler.MultipleFrames",
+    EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FFrameAssemblerMultipleFramesTest::RunTest(const FString& Parameters)
+{
+    // 容量 32 的小环：多次读取后帧会跨越环尾，走拼接缓冲区的路径；空帧也是合法的一帧
+    FFrameAssembler assembler(32, 1024);
+    const int32 sizes[] = { 5, 0, 9, 13, 3, 11 };
+    const int32 numFrames = UE_ARRAY_COUNT(sizes);
+
+    for (int32 round = 0; round < 20; round++)
+    {
+        // 一次读取中到达多帧，最后一帧只到达一部分
+        TArray<uint8> bytes;
+        for (int32 i = 0; i < numFrames; i++)
+            bytes.Append(MakeFrame(sizes[i], (uint8)(round * 16 + i)));
+        const int32 splitAt = bytes.Num() - 4;
+
+        int32 next = 0;
+        TArrayView<const uint8> payload;
+        auto drain = [&]()
+        {
+            while (assembler.NextFrame(payload) == EFrameResult::Frame)
+            {
+                if (!TestTrue(TEXT("payload"), next < numFrames && PayloadMatches(payload, sizes[next], (uint8)(round * 16 + next))))
+                    return false;
+                next++;
+            }
+            return true;
+        };
+
+        // 环容量有限，边写边取
+        int32 pos = 0;
+        while (pos < splitAt)
+        {
+            const int32 count = FMath::Min(FMath::Min(assembler.GetWritableRegion().Num(), 24), splitAt - pos);
+            FeedBytes(assembler, MakeArrayView(bytes.GetData() + pos, count));
+            pos += count;
+            if (!drain())
+                return false;
+        }
+        TestEqual(TEXT("frames before the last one"), next, numFrames - 1);
+
+        FeedBytes(assembler, MakeArrayView(bytes.GetData() + splitAt, bytes.Num() - splitAt));
+        if (!drain())
+            return false;
+        if (!TestEqual(TEXT("all frames"), next, numFrames))
+            return false;
+    }
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFrameAssemblerGrowTest, "SocketConnections.FrameAssembler.Grow",
+    EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FFrameAssemblerGrowTest::RunTest(const FString& Parameters)
+{
+    // 帧比初始容量大：NextFrame 提前扩容，数据在扩容前后保持完整
+    FFrameAssembler assembler(16, 4096);
+    TArrayView<const uint8> payload;
+
+    const TArray<uint8> small = MakeFrame(6, 1);
+    FeedBytes(assembler, small);
+    TestEqual(TEXT("small frame"), (int32)assembler.NextFrame(payload), (int32)EFrameResult::Frame);
+
+    const TArray<uint8> large = MakeFrame(1000, 3);
+    int32 pos = 0;
+    while (pos < large.Num())
+    {
+        const int32 count = FMath::Min(assembler.GetWritableRegion().Num(), large.Num() - pos);
+        FeedBytes(assembler, MakeArrayView(large.GetData() + pos, count));
+        pos += count;
+        if (pos < large.Num())
+            TestEqual(TEXT("large frame incomplete"), (int32)assembler.NextFrame(payload), (int32)EFrameResult::NeedMore);
+    }
+    TestEqual(TEXT("large frame"), (int32)assembler.NextFrame(payload), (int32)EFrameResult::Frame);
+    TestTrue(TEXT("large payload"), PayloadMatches(payload, 1000, 3));
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFrameAssemblerOversizeTest, "SocketConnections.FrameAssembler.Oversize",
+    EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FFrameAssemblerOversizeTest::RunTest(const FString& Parameters)
+{
+    FFrameAssembler assembler(64, 100);
+    TArrayView<const uint8> payload;
+
+    // 恰好等于上限的帧可以取出
+    FeedBytes(assembler, MakeFrame(100, 0));
+    TestEqual(TEXT("max size"), (int32)assembler.NextFrame(payload), (int32)EFrameResult::Frame);
+    TestTrue(TEXT("max size payload"), PayloadMatches(payload, 100, 0));
+
+    // 帧头一到就判定超限，不等待 payload，也不消费数据
+    uint8 header[FRAME_HEADER_SIZE];
+    FFrameAssembler::WriteHeader(header, 101);
+    FeedBytes(assembler, header);
+    TestEqual(TEXT("oversize"), (int32)assembler.NextFrame(payload), (int32)EFrameResult::Oversize);
+    TestEqual(TEXT("oversize again"), (int32)assembler.NextFrame(payload), (int32)EFrameResult::Oversize);
+
+    // 高位字节被当作长度的一部分，不会回绕成小值
+    assembler.Reset();
+    FFrameAssembler::WriteHeader(header, 0x80000004u);
+    FeedBytes(assembler, header);
+    TestEqual(TEXT("huge length"), (int32)assembler.NextFrame(payload), (int32)EFrameResult::Oversize);
+
+    // Reset 后恢复正常
+    assembler.Reset();
+    FeedBytes(assembler, MakeFrame(4, 9));
+    TestEqual(TEXT("after reset"), (int32)assembler.NextFrame(payload), (int32)EFrameResult::Frame);
+    TestTrue(TEXT("after reset payload"), PayloadMatches(payload, 4, 9));
+    return true;
+}
+
+#endif
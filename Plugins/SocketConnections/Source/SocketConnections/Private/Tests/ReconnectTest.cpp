@@ -0,0 +1,227 @@
+// ReconnectTest.cpp: 重连退避与备用连接的自动化测试
+
+#include "Misc/AutomationTest.h"
+#include "Reconnect.h"
+#include "Sockets.h"
+#include "SocketSubsystem.h"
+#include "IPAddress.h"
+#include "HAL/ThreadSafeBool.h"
+#include "Misc/ScopeExit.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+// 在 I/O 线程上接管备用连接，模拟 FSocketWorker 的重连回调
+class FSpareAdopter : public ISocketReactorHandler
+{
+public:
+    TSharedPtr<FSpareConnection, ESPMode::ThreadSafe> spare;
+    // 接管前在 I/O 线程关闭的服务端 Socket，用于制造挂断通知尚未分发的死连接
+    FSocket* closeBeforeRelease = nullptr;
+    FSocket* adopted = nullptr;
+    FThreadSafeBool done;
+
+    virtual FSocket* GetSocket() const override { return nullptr; }
+    virtual bool WantsWrite() const override { return false; }
+    virtual void OnRegistered() override {}
+    virtual void OnReadable() override {}
+    virtual void OnWritable() override {}
+    virtual void OnUnregistered() override {}
+
+    virtual void OnWakeup() override
+    {
+        if (closeBeforeRelease)
+            closeBeforeRelease->Close();
+        if (spare->IsReady())
+            adopted = spare->Release();
+        done = true;
+    }
+};
+
+// 本机回环监听 Socket，备用连接连向它
+struct FSpareTestServer
+{
+    ISocketSubsystem* subsystem = nullptr;
+    FSocket* listener = nullptr;
+    FSocket* accepted = nullptr;
+    int32 port = 0;
+
+    bool Open()
+    {
+        subsystem = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM);
+        if (!subsystem)
+            return false;
+
+        TSharedRef<FInternetAddr> address = subsystem->CreateInternetAddr(FNetworkProtocolTypes::IPv4);
+        address->SetLoopbackAddress();
+        address->SetPort(0);
+        listener = subsystem->CreateSocket(NAME_Stream, TEXT("ReconnectTestListener"), FNetworkProtocolTypes::IPv4);
+        if (!listener || !listener->Bind(*address) || !listener->Listen(4))
+            return false;
+        port = listener->GetPortNo();
+        return true;
+    }
+
+    bool Accept()
+    {
+        bool pending = false;
+        if (!listener->WaitForPendingConnection(pending, FTimespan::FromSeconds(5.0)) || !pending)
+            return false;
+        accepted = listener->Accept(TEXT("ReconnectTestServer"));
+        return accepted != nullptr;
+    }
+
+    void Destroy(FSocket*& socket)
+    {
+        if (socket)
+        {
+            socket->Close();
+            subsystem->DestroySocket(socket);
+            socket = nullptr;
+        }
+    }
+
+    ~FSpareTestServer()
+    {
+        Destroy(accepted);
+        Destroy(listener);
+    }
+};
+
+// 轮询等待条件成立，超时返回 false
+template <typename PredicateType>
+static bool WaitUntil(PredicateType predicate, double timeoutSec = 5.0)
+{
+    const double deadline = FPlatformTime::Seconds() + timeoutSec;
+    while (!predicate())
+    {
+        if (FPlatformTime::Seconds() >= deadline)
+            return false;
+        FPlatformProcess::Sleep(0.005f);
+    }
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FReconnectBackoffTest, "SocketConnections.Reconnect.Backoff",
+    EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FReconnectBackoffTest::RunTest(const FString& Parameters)
+{
+    // 无抖动：逐次翻倍直到上限，Reset 后从初始间隔重新开始
+    FReconnectBackoff backoff(0.5f, 8.0f, 0.0f);
+    const double expected[] = { 0.5, 1.0, 2.0, 4.0, 8.0, 8.0, 8.0 };
+    for (const double delay : expected)
+        TestEqual(TEXT("exponential"), backoff.NextDelay(), delay, 1e-9);
+    TestEqual(TEXT("attempts"), backoff.GetAttempts(), 7);
+    backoff.Reset();
+    TestEqual(TEXT("attempts after reset"), backoff.GetAttempts(), 0);
+    TestEqual(TEXT("initial delay after reset"), backoff.NextDelay(), 0.5, 1e-9);
+
+    // 抖动：落在 [1 - jitter, 1 + jitter] 倍之内且确有变化；大量重试后指数不溢出
+    FReconnectBackoff jittered(0.25f, 4.0f, 0.2f);
+    double minDelay = MAX_dbl;
+    double maxDelay = 0.0;
+    for (int32 i = 0; i < 1000; i++)
+    {
+        const double base = FMath::Min(4.0, 0.25 * FMath::Pow(2.0, (double)FMath::Min(i, 30)));
+        const double delay = jittered.NextDelay();
+        if (!TestTrue(TEXT("jitter range"), delay >= base * 0.8 - 1e-9 && delay <= base * 1.2 + 1e-9))
+        {
+            AddInfo(FString::Printf(TEXT("attempt %d: %f"), i, delay));
+            return false;
+        }
+        if (i >= 4)
+        {
+            minDelay = FMath::Min(minDelay, delay);
+            maxDelay = FMath::Max(maxDelay, delay);
+        }
+    }
+    TestTrue(TEXT("jitter spreads the delays"), maxDelay - minDelay > 0.1);
+
+    // 参数钳制：上限不低于初始间隔，抖动不超过 1
+    FReconnectBackoff clamped(2.0f, 1.0f, 5.0f);
+    for (int32 i = 0; i < 100; i++)
+    {
+        const double delay = clamped.NextDelay();
+        TestTrue(TEXT("clamped"), delay >= 0.0 && delay <= 4.0);
+    }
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FReconnectSpareTest, "SocketConnections.Reconnect.Spare",
+    EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FReconnectSpareTest::RunTest(const FString& Parameters)
+{
+    FSpareTestServer server;
+    if (!TestTrue(TEXT("listener"), server.Open()))
+        return false;
+
+    FSocketReactor& reactor = FSocketReactor::Get();
+    TSharedRef<FSpareConnection, ESPMode::ThreadSafe> spare = MakeShared<FSpareConnection, ESPMode::ThreadSafe>(TEXT("127.0.0.1"), server.port, FReconnectBackoff(0.05f, 0.2f, 0.0f));
+    reactor.Register(spare);
+    ON_SCOPE_EXIT
+    {
+        reactor.Unregister(spare);
+    };
+
+    // 存活的备用连接：接管得到已连接的 Socket，数据可直达服务端
+    if (!TestTrue(TEXT("accept"), server.Accept()) || !TestTrue(TEXT("ready"), WaitUntil([&]() { return spare->IsReady(); })))
+        return false;
+
+    TSharedRef<FSpareAdopter, ESPMode::ThreadSafe> adopter = MakeShared<FSpareAdopter, ESPMode::ThreadSafe>();
+    adopter->spare = spare;
+    reactor.Register(adopter);
+    ON_SCOPE_EXIT
+    {
+        reactor.Unregister(adopter);
+    };
+    reactor.Wakeup(adopter);
+    if (!TestTrue(TEXT("adopted"), WaitUntil([&]() { return (bool)adopter->done; })) || !TestNotNull(TEXT("live spare"), adopter->adopted))
+        return false;
+
+    uint8 byte = 42;
+    int32 bytesSent = 0;
+    TestTrue(TEXT("send on adopted socket"), adopter->adopted->Send(&byte, 1, bytesSent));
+    uint8 received = 0;
+    int32 bytesRead = 0;
+    server.accepted->SetNonBlocking(false);
+    TestTrue(TEXT("server receives"), server.accepted->Recv(&received, 1, bytesRead) && received == 42);
+    adopter->adopted->Close();
+    server.subsystem->DestroySocket(adopter->adopted);
+    adopter->adopted = nullptr;
+    server.Destroy(server.accepted);
+
+    // 接管后立即预热下一条；服务端关闭这条空闲连接后应被丢弃，而不是一直显示就绪
+    if (!TestTrue(TEXT("accept next"), server.Accept()) || !TestTrue(TEXT("next ready"), WaitUntil([&]() { return spare->IsReady(); })))
+        return false;
+    server.Destroy(server.listener);
+    server.Destroy(server.accepted);
+    TestTrue(TEXT("dead spare dropped"), WaitUntil([&]() { return !spare->IsReady(); }));
+
+    // 挂断通知尚未分发时接管：探测失败，返回 nullptr，调用方改为重新握手
+    FSpareTestServer secondServer;
+    if (!TestTrue(TEXT("second listener"), secondServer.Open()))
+        return false;
+    TSharedRef<FSpareConnection, ESPMode::ThreadSafe> dying = MakeShared<FSpareConnection, ESPMode::ThreadSafe>(TEXT("127.0.0.1"), secondServer.port, FReconnectBackoff(0.05f, 0.2f, 0.0f));
+    reactor.Register(dying);
+    ON_SCOPE_EXIT
+    {
+        reactor.Unregister(dying);
+    };
+    if (!TestTrue(TEXT("accept dying"), secondServer.Accept()) || !TestTrue(TEXT("dying ready"), WaitUntil([&]() { return dying->IsReady(); })))
+        return false;
+    secondServer.Destroy(secondServer.listener);
+
+    adopter->spare = dying;
+    adopter->closeBeforeRelease = secondServer.accepted;
+    adopter->done = false;
+    reactor.Wakeup(adopter);
+    if (TestTrue(TEXT("probed"), WaitUntil([&]() { return (bool)adopter->done; })))
+    {
+        TestNull(TEXT("dead spare not adopted"), adopter->adopted);
+        TestFalse(TEXT("dead spare no longer ready"), dying->IsReady());
+    }
+    return true;
+}
+
+#endif
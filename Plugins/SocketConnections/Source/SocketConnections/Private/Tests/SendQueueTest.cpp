@@ -0,0 +1,257 @@
+// SendQueueTest.cpp: 发送队列的自动化测试（覆盖、溢出策略，以及回环连接上的部分写）
+
+#include "Misc/AutomationTest.h"
+#include "SendQueue.h"
+#include "FrameAssembler.h"
+#include "Sockets.h"
+#include "SocketSubsystem.h"
+#include "IPAddress.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+// 以长度前缀帧入队，payload 内容为 seed, seed+1, ...
+static bool EnqueueFrame(FSendQueue& queue, int32 payloadSize, uint8 seed, bool replaceable)
+{
+    TArray<uint8> payload;
+    payload.SetNumUninitialized(payloadSize);
+    for (int32 i = 0; i < payloadSize; i++)
+        payload[i] = (uint8)(seed + i);
+
+    uint8 header[FRAME_HEADER_SIZE];
+    FFrameAssembler::WriteHeader(header, (uint32)payloadSize);
+    return queue.Enqueue(header, FRAME_HEADER_SIZE, payload.GetData(), payloadSize, replaceable);
+}
+
+// 本机回环 TCP 连接：client 端非阻塞并缩小发送缓冲区，server 端缩小接收缓冲区，使大消息必然部分写
+struct FLoopbackConnection
+{
+    ISocketSubsystem* subsystem = nullptr;
+    FSocket* listener = nullptr;
+    FSocket* client = nullptr;
+    FSocket* server = nullptr;
+    FFrameAssembler received = FFrameAssembler(64 * 1024, 16 * 1024 * 1024);
+
+    bool Open()
+    {
+        subsystem = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM);
+        if (!subsystem)
+            return false;
+
+        TSharedRef<FInternetAddr> address = subsystem->CreateInternetAddr(FNetworkProtocolTypes::IPv4);
+        address->SetLoopbackAddress();
+        address->SetPort(0);
+
+        listener = subsystem->CreateSocket(NAME_Stream, TEXT("SendQueueTestListener"), FNetworkProtocolTypes::IPv4);
+        if (!listener || !listener->Bind(*address) || !listener->Listen(1))
+            return false;
+        listener->GetAddress(*address);
+
+        client = subsystem->CreateSocket(NAME_Stream, TEXT("SendQueueTestClient"), FNetworkProtocolTypes::IPv4);
+        if (!client || !client->Connect(*address))
+            return false;
+        server = listener->Accept(TEXT("SendQueueTestServer"));
+        if (!server)
+            return false;
+
+        int32 newSize = 0;
+        client->SetSendBufferSize(4096, newSize);
+        server->SetReceiveBufferSize(4096, newSize);
+        client->SetNoDelay(true);
+        return client->SetNonBlocking(true) && server->SetNonBlocking(true);
+    }
+
+    ~FLoopbackConnection()
+    {
+        for (FSocket* socket : { server, client, listener })
+        {
+            if (socket)
+            {
+                socket->Close();
+                subsystem->DestroySocket(socket);
+            }
+        }
+    }
+
+    // 读出 server 端当前可读的全部数据
+    void Receive()
+    {
+        for (;;)
+        {
+            const TArrayView<uint8> region = received.GetWritableRegion();
+            int32 bytesRead = 0;
+            if (!server->Recv(region.GetData(), region.Num(), bytesRead) || bytesRead <= 0)
+                return;
+            received.CommitWrite(bytesRead);
+        }
+    }
+
+    // 交替写出与读取，直到队列写空；返回最后一次 Flush 的结果
+    ESendFlushResult Pump(FSendQueue& queue)
+    {
+        const double deadline = FPlatformTime::Seconds() + 10.0;
+        ESendFlushResult result = ESendFlushResult::WouldBlock;
+        while (FPlatformTime::Seconds() < deadline)
+        {
+            result = queue.FlushStream(client);
+            Receive();
+            if (result != ESendFlushResult::WouldBlock)
+                break;
+        }
+        // 最后一批数据可能仍在回环的内核缓冲区中
+        while (FPlatformTime::Seconds() < deadline && client && server)
+        {
+            const int32 before = received.Num();
+            FPlatformProcess::Sleep(0.01f);
+            Receive();
+            if (received.Num() == before)
+                break;
+        }
+        return result;
+    }
+
+    // 按序取出一帧并校验长度与内容
+    bool ExpectFrame(FAutomationTestBase& test, const TCHAR* what, int32 payloadSize, uint8 seed)
+    {
+        TArrayView<const uint8> payload;
+        if (!test.TestEqual(what, (int32)received.NextFrame(payload), (int32)EFrameResult::Frame)
+            || !test.TestEqual(what, payload.Num(), payloadSize))
+        {
+            return false;
+        }
+        for (int32 i = 0; i < payloadSize; i++)
+        {
+            if (payload[i] != (uint8)(seed + i))
+            {
+                test.AddError(FString::Printf(TEXT("%s: byte %d differs"), what, i));
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSendQueueOverflowTest, "SocketConnections.SendQueue.Overflow",
+    EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSendQueueOverflowTest::RunTest(const FString& Parameters)
+{
+    // 覆盖：同类消息原位替换，字节数按新内容计算
+    FSendQueue queue(1000, EConnectorSendOverflow::Reject);
+    EnqueueFrame(queue, 96, 1, false);
+    EnqueueFrame(queue, 96, 2, true);
+    EnqueueFrame(queue, 96, 3, false);
+    TestTrue(TEXT("replace"), EnqueueFrame(queue, 196, 4, true));
+    FConnectorSendStats stats = queue.GetStats();
+    TestEqual(TEXT("overwritten"), stats.overwrittenMessages, 1);
+    TestEqual(TEXT("queued messages after replace"), stats.queuedMessages, 3);
+    TestEqual(TEXT("queued bytes after replace"), stats.queuedBytes, (int64)400);
+
+    // Reject：超出上限的消息被拒绝，队列不变
+    TestFalse(TEXT("reject"), EnqueueFrame(queue, 696, 5, false));
+    stats = queue.GetStats();
+    TestEqual(TEXT("rejected"), stats.rejectedMessages, 1);
+    TestEqual(TEXT("queued messages after reject"), stats.queuedMessages, 3);
+
+    queue.Reset();
+    stats = queue.GetStats();
+    TestEqual(TEXT("reset bytes"), stats.queuedBytes, (int64)0);
+    TestEqual(TEXT("reset messages"), stats.queuedMessages, 0);
+
+    // DropOldest：丢弃最早的消息为新消息腾出空间；大量入队出队后计数保持一致
+    FSendQueue dropQueue(1000, EConnectorSendOverflow::DropOldest);
+    for (int32 i = 0; i < 200; i++)
+        TestTrue(TEXT("drop oldest"), EnqueueFrame(dropQueue, 296, (uint8)i, false));
+    stats = dropQueue.GetStats();
+    TestEqual(TEXT("dropped"), stats.droppedMessages, 197);
+    TestEqual(TEXT("queued messages after drop"), stats.queuedMessages, 3);
+    TestEqual(TEXT("queued bytes after drop"), stats.queuedBytes, (int64)900);
+    TestFalse(TEXT("larger than the queue"), EnqueueFrame(dropQueue, 1000, 0, false));
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSendQueueStreamTest, "SocketConnections.SendQueue.Stream",
+    EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSendQueueStreamTest::RunTest(const FString& Parameters)
+{
+    FLoopbackConnection connection;
+    if (!TestTrue(TEXT("loopback connection"), connection.Open()))
+        return false;
+
+    // 覆盖保持原消息的队列位置
+    FSendQueue queue(64 * 1024 * 1024, EConnectorSendOverflow::Reject);
+    EnqueueFrame(queue, 10, 1, false);
+    EnqueueFrame(queue, 20, 2, true);
+    EnqueueFrame(queue, 30, 3, false);
+    EnqueueFrame(queue, 40, 4, true);
+    TestEqual(TEXT("small frames"), (int32)connection.Pump(queue), (int32)ESendFlushResult::Drained);
+    connection.ExpectFrame(*this, TEXT("first"), 10, 1);
+    connection.ExpectFrame(*this, TEXT("replaced"), 40, 4);
+    connection.ExpectFrame(*this, TEXT("third"), 30, 3);
+
+    // 大量大小不一的消息：多次部分写后流上的消息边界与内容完整
+    int64 totalBytes = 0;
+    for (int32 i = 0; i < 300; i++)
+    {
+        const int32 size = 1 + (i * 7919) % 20000;
+        EnqueueFrame(queue, size, (uint8)i, false);
+        totalBytes += FRAME_HEADER_SIZE + size;
+    }
+    TestEqual(TEXT("many frames"), (int32)connection.Pump(queue), (int32)ESendFlushResult::Drained);
+    for (int32 i = 0; i < 300; i++)
+    {
+        if (!connection.ExpectFrame(*this, TEXT("many frames"), 1 + (i * 7919) % 20000, (uint8)i))
+            return false;
+    }
+    FConnectorSendStats stats = queue.GetStats();
+    TestTrue(TEXT("partial writes"), stats.partialWrites > 0);
+    TestEqual(TEXT("sent messages"), stats.sentMessages, 304);
+    TestEqual(TEXT("sent bytes"), stats.sentBytes, totalBytes + 4 * FRAME_HEADER_SIZE + 10 + 40 + 30);
+    TestEqual(TEXT("queued bytes when drained"), stats.queuedBytes, (int64)0);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSendQueuePartialHeadTest, "SocketConnections.SendQueue.PartialHead",
+    EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSendQueuePartialHeadTest::RunTest(const FString& Parameters)
+{
+    FLoopbackConnection connection;
+    if (!TestTrue(TEXT("loopback connection"), connection.Open()))
+        return false;
+
+    const int32 largeSize = 4 * 1024 * 1024;
+    const int64 maxQueued = 6 * 1024 * 1024;
+    FSendQueue queue(maxQueued, EConnectorSendOverflow::DropOldest);
+
+    // 可覆盖的大消息只写出一部分
+    EnqueueFrame(queue, largeSize, 1, true);
+    if (!TestEqual(TEXT("large frame blocks"), (int32)queue.FlushStream(connection.client), (int32)ESendFlushResult::WouldBlock))
+        return false;
+    TestEqual(TEXT("partial write"), queue.GetStats().partialWrites, 1);
+
+    // 已部分写出的队首不能被覆盖，否则流上的消息边界被破坏
+    EnqueueFrame(queue, 100, 2, true);
+    TestEqual(TEXT("head not overwritten"), queue.GetStats().overwrittenMessages, 0);
+    EnqueueFrame(queue, 200, 3, true);
+    TestEqual(TEXT("second replaceable overwritten"), queue.GetStats().overwrittenMessages, 1);
+
+    // 也不能被 DropOldest 丢弃：超出上限时从队首之后开始丢
+    EnqueueFrame(queue, 50 * 1024, 4, false);
+    const int64 queued = queue.GetStats().queuedBytes;
+    const int32 overflowSize = (int32)(maxQueued - queued) - FRAME_HEADER_SIZE + 1;
+    TestTrue(TEXT("overflow"), EnqueueFrame(queue, overflowSize, 5, false));
+    FConnectorSendStats stats = queue.GetStats();
+    TestEqual(TEXT("dropped after the head"), stats.droppedMessages, 1);
+    TestEqual(TEXT("queued messages"), stats.queuedMessages, 3);
+
+    TestEqual(TEXT("drained"), (int32)connection.Pump(queue), (int32)ESendFlushResult::Drained);
+    connection.ExpectFrame(*this, TEXT("partially written head"), largeSize, 1);
+    connection.ExpectFrame(*this, TEXT("kept"), 50 * 1024, 4);
+    connection.ExpectFrame(*this, TEXT("overflowing"), overflowSize, 5);
+    TArrayView<const uint8> payload;
+    TestEqual(TEXT("nothing else"), (int32)connection.received.NextFrame(payload), (int32)EFrameResult::NeedMore);
+    return true;
+}
+
+#endif
@@ -15,6 +15,73 @@ enum class ESocketState : uint8
 	Connected
 };
 
+// TCP 分帧模式：String 为原始字节流（保持旧行为），LengthPrefixed 为 4 字节大端长度前缀 + payload
+UENUM(BlueprintType)
+enum class EConnectorFraming : uint8
+{
+	String,
+	LengthPrefixed
+};
+
+// 收到的消息向游戏线程交付的策略（每帧统一交付一次）
+UENUM(BlueprintType)
+enum class EConnectorDelivery : uint8
+{
+	// 每条消息都广播一次
+	AllMessages,
+	// 一帧内只广播最新一条，适合高频且只关心最新值的数据（如追踪器位姿）
+	LatestOnly
+};
+
+// 发送队列已满时的处理策略
+UENUM(BlueprintType)
+enum class EConnectorSendOverflow : uint8
+{
+	// 拒绝新消息，SendString 返回 false
+	Reject,
+	// 丢弃最早的未开始发送的消息，为新消息腾出空间
+	DropOldest
+};
+
+// 发送队列统计，用于观察背压（字节数均为含帧头的线上字节）
+USTRUCT(BlueprintType)
+struct FConnectorSendStats
+{
+	GENERATED_BODY()
+
+	// 当前排队等待发送的字节数与消息数
+	UPROPERTY(BlueprintReadOnly, Category="SocketConnections")
+	int64 queuedBytes = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category="SocketConnections")
+	int32 queuedMessages = 0;
+
+	// 历史最高排队字节数
+	UPROPERTY(BlueprintReadOnly, Category="SocketConnections")
+	int64 peakQueuedBytes = 0;
+
+	// 累计已写入内核的字节数与完整发出的消息数
+	UPROPERTY(BlueprintReadOnly, Category="SocketConnections")
+	int64 sentBytes = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category="SocketConnections")
+	int32 sentMessages = 0;
+
+	// 因队列已满被拒绝、被 DropOldest 丢弃、被 SendStringLatest 覆盖的消息数
+	UPROPERTY(BlueprintReadOnly, Category="SocketConnections")
+	int32 rejectedMessages = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category="SocketConnections")
+	int32 droppedMessages = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category="SocketConnections")
+	int32 overwrittenMessages = 0;
+
+	// 内核发送缓冲区写满、只写出一部分的次数
+	UPROPERTY(BlueprintReadOnly, Category="SocketConnections")
+	int32 partialWrites = 0;
+};
+
 // 当收到服务端消息时广播（已在游戏线程触发，安全可用于 UI）
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnMessageReceived, const FString&, message);
 
@@ -24,6 +91,39 @@ DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnConnectorStateChanged, ESocketSta
 // 当遇到错误时广播错误原因（已在游戏线程触发）
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnConnectorError, const FString&, reason);
 
+// 自动重连成功后广播（已在游戏线程触发），此时会话恢复消息已排在发送队列最前
+DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnConnectorSessionResumed);
+
+// 分帧模式下每收到一帧触发（在 I/O 线程触发！）；payload 指向复用的接收缓冲区，仅在回调内有效
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnConnectorFrameNative, TArrayView<const uint8>);
+
+// 线程安全的发送句柄（仅 C++）：可在任意线程使用且不访问 AConnector 本身，适合后台采样线程直接发送
+// 句柄绑定获取时的连接，Stop 或重新 TryConnectServer 后失效，需重新获取
+class SOCKETCONNECTIONS_API FConnectorSender
+{
+public:
+	// 发送一帧数据，语义同 AConnector::SendFrame；replaceable 为 true 时等同 SendStringLatest 的覆盖语义
+	bool SendFrame(TArrayView<const uint8> payload, bool replaceable = false) const;
+
+	bool IsConnected() const;
+
+	// 数据流中断的累计次数（发送队列丢弃/拒绝/覆盖消息，或 TCP 重连），增加时说明对端可能缺失了部分帧
+	// 有状态的编码（如增量帧）据此判断是否需要重发关键帧；UDP 下对端的丢包无法在本端感知
+	int64 GetLossCount() const;
+
+	// 对端能否按帧还原消息边界（UDP，或 TCP 的 LengthPrefixed 分帧）；二进制帧只能在此时发送
+	bool PreservesFrameBoundaries() const;
+
+	bool IsValid() const
+	{
+		return worker.IsValid();
+	}
+
+private:
+	friend class AConnector;
+	TWeakPtr<class FSocketWorker, ESPMode::ThreadSafe> worker;
+};
+
 UCLASS()
 class SOCKETCONNECTIONS_API AConnector : public AActor
 {
@@ -37,6 +137,9 @@ protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
 
+	// 销毁或关卡切换时释放连接，避免反应器继续持有已失效的连接
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 public:	
 	// Called every frame
 	virtual void Tick(float DeltaTime) override;
@@ -53,14 +156,82 @@ public:
 	UPROPERTY(BlueprintAssignable)
 	FOnConnectorError onConnectorError;
 
+	// 自动重连成功后广播（蓝图可绑定），首次连接不触发
+	UPROPERTY(BlueprintAssignable)
+	FOnConnectorSessionResumed onSessionResumed;
+
+	// 消息交付策略：I/O 线程收到的消息先进入无锁队列，游戏线程每帧 Tick 时统一广播
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="SocketConnections")
+	EConnectorDelivery deliveryPolicy = EConnectorDelivery::AllMessages;
+
+	// 发送队列上限（字节，含帧头）；发送由 I/O 线程完成，SendString 只负责入队
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="SocketConnections", meta=(ClampMin="1"))
+	int32 maxSendQueueBytes = 4 * 1024 * 1024;
+
+	// 发送队列已满时的处理策略
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="SocketConnections")
+	EConnectorSendOverflow sendOverflow = EConnectorSendOverflow::DropOldest;
+
+	// 分帧模式（在 TryConnectServer 之前设置，对当次连接生效）；UDP 下每个数据报即为一帧，不加长度前缀
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="SocketConnections")
+	EConnectorFraming framingMode = EConnectorFraming::String;
+
+	// 分帧模式下单帧 payload 上限（字节），超出视为数据异常并断开
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="SocketConnections", meta=(ClampMin="1"))
+	int32 maxFrameSize = 16 * 1024 * 1024;
+
+	// 分帧模式下是否同时将每帧按 UTF-8 转为字符串通过 onMessageReceived 广播；纯 C++ 消费者可关闭以避免逐帧分配
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="SocketConnections")
+	bool deliverFramesAsString = true;
+
+	// TCP 断线或握手失败后自动重连（在 TryConnectServer 之前设置）；重连期间状态为 Connecting，不再广播 Unconnect
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="SocketConnections")
+	bool autoReconnect = false;
+
+	// 重连间隔按 2 倍递增：首次等待 reconnectInitialDelay 秒，最长 reconnectMaxDelay 秒
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="SocketConnections", meta=(ClampMin="0"))
+	float reconnectInitialDelay = 0.5f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="SocketConnections", meta=(ClampMin="0"))
+	float reconnectMaxDelay = 30.0f;
+
+	// 重连间隔的随机抖动比例（0-1），避免多台设备在服务端重启后同时重连
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="SocketConnections", meta=(ClampMin="0", ClampMax="1"))
+	float reconnectJitter = 0.2f;
+
+	// 自动重连时额外保持一条已握手的备用连接，断线后直接接管，省去重连握手时间
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="SocketConnections")
+	bool keepSpareConnection = false;
+
+	// 分帧模式下的原生帧回调（仅 C++），需在 TryConnectServer 之前绑定，连接期间使用绑定时的快照
+	FOnConnectorFrameNative onFrameReceivedNative;
+
 	// 尝试连接到服务端（可在蓝图调用）。address 示例："127.0.0.1"，端口范围 1-65535
 	UFUNCTION(BlueprintCallable, Category="SocketConnections")
 	void TryConnectServer(const FString& address, int32 port, bool useUdp);
 
-	// 发送字符串到服务端（可在蓝图调用）。返回是否发送成功
+	// 发送字符串到服务端（可在蓝图调用）。消息进入发送队列后由 I/O 线程写出，返回是否成功入队
 	UFUNCTION(BlueprintCallable, Category="SocketConnections")
 	bool SendString(const FString& message);
 
+	// 发送可被覆盖的字符串（如追踪器帧）：若队列中已有一条尚未开始发送的同类消息，则直接替换它，避免过期数据堆积
+	UFUNCTION(BlueprintCallable, Category="SocketConnections")
+	bool SendStringLatest(const FString& message);
+
+	// 设置会话恢复消息（如 GlobalConfigCommand 生成的配置指令）：每次自动重连成功后先于其它消息自动重发，传空字符串取消
+	UFUNCTION(BlueprintCallable, Category="SocketConnections")
+	void SetResumeMessage(const FString& message);
+
+	// 查询发送队列统计（可在蓝图查询）
+	UFUNCTION(BlueprintPure, Category="SocketConnections")
+	FConnectorSendStats GetSendStats() const;
+
+	// 发送一帧二进制数据（仅 C++）；分帧模式下自动添加长度前缀
+	bool SendFrame(TArrayView<const uint8> payload);
+
+	// 获取当前连接的线程安全发送句柄（仅 C++），未连接时返回无效句柄
+	FConnectorSender GetSender() const;
+
 	// 停止并释放连接资源（可在蓝图调用）
 	UFUNCTION(BlueprintCallable, Category="SocketConnections")
 	void Stop();
@@ -70,16 +241,18 @@ public:
 	bool IsConnected() const;
 
 private:
-	// 线程对象与工作者，用于后台接收数据；注意只在主线程创建与销毁
-	class FSocketWorker* worker;
-	class FRunnableThread* thread;
+	// 工作者：注册到共享 I/O 反应器，由反应器线程驱动连接与收发；注意只在主线程创建与释放
+	TSharedPtr<class FSocketWorker, ESPMode::ThreadSafe> worker;
 
 	// 连接参数（最新一次调用 TryConnectServer 设置）
 	FString connectAddress;
 	int32 connectPort;
 	bool useUdp;
 
-	// 发送互斥，保护 socket 发送并发
+	// 会话恢复消息，重新连接时传给新的 worker
+	FString resumeMessage;
+
+	// 发送互斥，保护多线程调用发送接口时对 worker 的访问
 	FCriticalSection sendMutex;
 
 };
@@ -1,5 +1,6 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
+using System.IO;
 using UnrealBuildTool;
 
 public class SocketConnections : ModuleRules
@@ -20,6 +21,25 @@ public class SocketConnections : ModuleRules
 				// ... add other private include paths required here ...
 			}
 			);
+
+		// SocketReactor 需要 FSocketBSD::GetNativeSocket 取得原生句柄交给 epoll/poll，该头文件位于引擎私有目录
+		// 仅在平台 Socket 子系统基于 BSD Socket 且头文件存在时启用，否则反应器退化为不依赖原生句柄的轮询后端
+		string SocketsPrivatePath = Path.Combine(EngineDirectory, "Source/Runtime/Sockets/Private");
+		bool bBSDSocketPlatform = Target.Platform == UnrealTargetPlatform.Win64 ||
+			Target.Platform == UnrealTargetPlatform.Linux ||
+			Target.Platform == UnrealTargetPlatform.LinuxArm64 ||
+			Target.Platform == UnrealTargetPlatform.Android ||
+			Target.Platform == UnrealTargetPlatform.Mac ||
+			Target.Platform == UnrealTargetPlatform.IOS;
+		if (bBSDSocketPlatform && File.Exists(Path.Combine(SocketsPrivatePath, "BSDSockets/SocketsBSD.h")))
+		{
+			PrivateIncludePaths.Add(SocketsPrivatePath);
+			PrivateDefinitions.Add("SOCKET_REACTOR_NATIVE_HANDLES=1");
+		}
+		else
+		{
+			PrivateDefinitions.Add("SOCKET_REACTOR_NATIVE_HANDLES=0");
+		}
 			
 		
 		PublicDependencyModuleNames.AddRange(